@@ -0,0 +1,272 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Measures what SteerLibraryMixin's statically dispatched vehicle state
+ * reads gain over virtual ones for the flocking of the Boids plug-in.
+ *
+ * Both boid types below run the same flocking code. The first instantiates
+ * SteerLibraryMixin without a concrete class so the steering behaviors read
+ * position, forward, speed, ... through the virtual AbstractVehicle
+ * interface; the second passes itself as concrete class so these reads are
+ * inlined. Neighbors are seen through AbstractVehicle by both.
+ *
+ * Build from the repository root, e.g.:
+ *
+ *     gcc -O2 -Iinclude -c src/lq.c
+ *     g++ -O2 -Iinclude benchmark/BoidsDispatchBenchmark.cpp src/[A-Z]*.cpp lq.o
+ *
+ * Usage: BoidsDispatchBenchmark [boidCount [frameCount]]
+ */
+
+// Include std::cout, std::endl
+#include <iostream>
+
+// Include std::atoi
+#include <cstdlib>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::conditional
+#include <type_traits>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::SteerLibraryMixin
+#include "OpenSteer/SteerLibrary.h"
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    typedef AbstractProximityDatabase< AbstractVehicle* > ProximityDatabase;
+    typedef AbstractTokenForProximityDatabase< AbstractVehicle* > ProximityToken;
+
+    float const worldRadius = 50.0f;
+
+    template< bool StaticDispatch > class BenchmarkBoid;
+
+    /**
+     * SteerLibraryMixin reading the boid state virtually or statically.
+     */
+    template< bool StaticDispatch >
+    struct BenchmarkBoidBase {
+        typedef typename std::conditional< StaticDispatch,
+                                           BenchmarkBoid< StaticDispatch >,
+                                           void >::type Concrete;
+        typedef SteerLibraryMixin< LocalSpaceMixin< AbstractVehicle >, Concrete > type;
+    };
+
+
+    /**
+     * Flocking boid with the state, parameters and update of @c Boid of the
+     * Boids plug-in, without obstacles, annotation and banking.
+     */
+    template< bool StaticDispatch >
+    class BenchmarkBoid final : public BenchmarkBoidBase< StaticDispatch >::type {
+    public:
+        typedef typename BenchmarkBoidBase< StaticDispatch >::type Super;
+
+        BenchmarkBoid( ProximityDatabase& pd, unsigned long long seed )
+            : mass_( 1.0f ), radius_( 0.5f ), speed_( 0.0f ),
+              maxForce_( 27.0f ), maxSpeed_( 9.0f ),
+              proximityToken_( pd.allocateToken( this ) )
+        {
+            this->seedRandomGenerator( seed );
+            setSpeed( maxSpeed() * 0.3f );
+            this->regenerateOrthonormalBasisUF( this->randomGenerator().unitVector() );
+            this->setPosition( this->randomGenerator().vectorInUnitRadiusSphere() * 20.0f );
+            proximityToken_->updateForNewPosition( this->position() );
+        }
+
+        ~BenchmarkBoid()
+        {
+            delete proximityToken_;
+        }
+
+        float mass() const { return mass_; }
+        float setMass( float m ) { return mass_ = m; }
+        float radius() const { return radius_; }
+        float setRadius( float r ) { return radius_ = r; }
+        Vec3 velocity() const { return this->forward() * speed_; }
+        float speed() const { return speed_; }
+        float setSpeed( float s ) { return speed_ = s; }
+        float maxForce() const { return maxForce_; }
+        float setMaxForce( float mf ) { return maxForce_ = mf; }
+        float maxSpeed() const { return maxSpeed_; }
+        float setMaxSpeed( float ms ) { return maxSpeed_ = ms; }
+
+        Vec3 predictFuturePosition( float const predictionTime ) const
+        {
+            return this->position() + ( velocity() * predictionTime );
+        }
+
+        void update( float const /* currentTime */, float const elapsedTime )
+        {
+            applySteeringForce( steerToFlock(), elapsedTime );
+
+            if ( this->position().length() > worldRadius ) {
+                this->setPosition( this->position().sphericalWrapAround( Vec3::zero, worldRadius ) );
+            }
+
+            proximityToken_->updateForNewPosition( this->position() );
+        }
+
+    private:
+
+        Vec3 steerToFlock()
+        {
+            neighbors_.clear();
+            proximityToken_->findNeighbors( this->position(), 9.0f, neighbors_ );
+
+            Vec3 const separation = this->steerForSeparation( 5.0f, -0.707f, neighbors_ );
+            Vec3 const alignment = this->steerForAlignment( 7.5f, 0.7f, neighbors_ );
+            Vec3 const cohesion = this->steerForCohesion( 9.0f, -0.15f, neighbors_ );
+
+            return ( separation * 12.0f ) + ( alignment * 8.0f ) + ( cohesion * 8.0f );
+        }
+
+        void applySteeringForce( Vec3 const& force, float const elapsedTime )
+        {
+            Vec3 const clippedForce = force.truncateLength( maxForce() );
+            Vec3 const acceleration = clippedForce / mass();
+            Vec3 const newVelocity = ( velocity() + ( acceleration * elapsedTime ) ).truncateLength( maxSpeed() );
+
+            setSpeed( newVelocity.length() );
+            this->setPosition( this->position() + ( newVelocity * elapsedTime ) );
+            if ( speed() > 0.0f ) {
+                this->regenerateOrthonormalBasisUF( newVelocity / speed() );
+            }
+        }
+
+        float mass_;
+        float radius_;
+        float speed_;
+        float maxForce_;
+        float maxSpeed_;
+        ProximityToken* proximityToken_;
+        AVGroup neighbors_;
+    }; // class BenchmarkBoid
+
+
+    struct Result {
+        double seconds;
+        Vec3 positionSum;
+    };
+
+
+    /**
+     * Simulates @a boidCount boids for @a frameCount frames at 60 Hz.
+     */
+    template< bool StaticDispatch >
+    Result run( int boidCount, int frameCount )
+    {
+        typedef BenchmarkBoid< StaticDispatch > Boid;
+
+        float const diameter = worldRadius * 1.1f * 2.0f;
+        LQProximityDatabase< AbstractVehicle* > pd( Vec3::zero,
+                                                     Vec3( diameter, diameter, diameter ),
+                                                     Vec3( 10.0f, 10.0f, 10.0f ) );
+
+        std::vector< Boid* > flock;
+        for ( int i = 0; i < boidCount; ++i ) {
+            flock.push_back( new Boid( pd, static_cast< unsigned long long >( i ) ) );
+        }
+
+        float const elapsedTime = 1.0f / 60.0f;
+        std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+        for ( int frame = 0; frame < frameCount; ++frame ) {
+            float const currentTime = frame * elapsedTime;
+            for ( int i = 0; i < boidCount; ++i ) {
+                flock[ i ]->update( currentTime, elapsedTime );
+            }
+        }
+        std::chrono::steady_clock::time_point const stop = std::chrono::steady_clock::now();
+
+        Result result;
+        result.seconds = std::chrono::duration< double >( stop - start ).count();
+        result.positionSum = Vec3::zero;
+        for ( int i = 0; i < boidCount; ++i ) {
+            result.positionSum += flock[ i ]->position();
+            delete flock[ i ];
+        }
+        return result;
+    }
+
+
+    void report( char const* name, Result const& result, int boidCount, int frameCount )
+    {
+        std::cout << name
+                  << ": " << ( result.seconds * 1000.0 / frameCount ) << " ms/frame, "
+                  << ( boidCount * static_cast< double >( frameCount ) / result.seconds ) << " boid updates/s"
+                  << " (position sum " << result.positionSum.x << " "
+                  << result.positionSum.y << " " << result.positionSum.z << ")"
+                  << std::endl;
+    }
+
+} // anonymous namespace
+
+
+
+int
+main( int argc, char* argv[] )
+{
+    int const boidCount = ( argc > 1 ) ? std::atoi( argv[ 1 ] ) : 1000;
+    int const frameCount = ( argc > 2 ) ? std::atoi( argv[ 2 ] ) : 600;
+
+    std::cout << boidCount << " boids, " << frameCount << " frames" << std::endl;
+
+    // Warm up caches and clock rates, then keep the best of three runs.
+    run< false >( boidCount, frameCount / 10 + 1 );
+
+    Result virtualBest = run< false >( boidCount, frameCount );
+    Result staticBest = run< true >( boidCount, frameCount );
+    for ( int i = 0; i < 2; ++i ) {
+        Result const virtualResult = run< false >( boidCount, frameCount );
+        Result const staticResult = run< true >( boidCount, frameCount );
+        if ( virtualResult.seconds < virtualBest.seconds ) virtualBest = virtualResult;
+        if ( staticResult.seconds < staticBest.seconds ) staticBest = staticResult;
+    }
+
+    report( "virtual dispatch", virtualBest, boidCount, frameCount );
+    report( "static dispatch ", staticBest, boidCount, frameCount );
+    std::cout << "speedup: " << ( virtualBest.seconds / staticBest.seconds ) << std::endl;
+
+    return 0;
+}
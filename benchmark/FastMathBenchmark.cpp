@@ -0,0 +1,263 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ *
+ * Measures the approximations of OpenSteer/FastMath.h.
+ *
+ * "kernels" times normalizing vectors and pow( x, 20 ) of the low speed
+ * adjustment with the exact and the approximate functions, both are
+ * available in every build.
+ *
+ * "boids" runs frames of the Boids plug-in's steering (separation,
+ * alignment, cohesion, the low speed adjustment and integration of
+ * applySteeringForce) with HeadlessVehicle, which uses the approximations
+ * only if built with OPENSTEER_FAST_MATH. Build it both ways to compare:
+ *
+ *     gcc -O2 -Iinclude -c src/lq.c
+ *     g++ -O2 -Iinclude benchmark/FastMathBenchmark.cpp src/[A-Z]*.cpp lq.o
+ *     g++ -O2 -Iinclude -DOPENSTEER_FAST_MATH benchmark/FastMathBenchmark.cpp src/[A-Z]*.cpp lq.o
+ *
+ * Usage: FastMathBenchmark [vehicleCount [frameCount]]
+ */
+
+// Include std::cout, std::endl
+#include <iostream>
+
+// Include std::atoi
+#include <cstdlib>
+
+// Include std::pow
+#include <cmath>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::fastInverseSqrt, OpenSteer::fastPow
+#include "OpenSteer/FastMath.h"
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    typedef std::chrono::steady_clock Clock;
+
+    double secondsSince( Clock::time_point start )
+    {
+        return std::chrono::duration< double >( Clock::now() - start ).count();
+    }
+
+
+    /**
+     * Best of three runs of @a kernel over @a passCount passes, in
+     * nanoseconds per element.
+     */
+    template< class Kernel >
+    double best( Kernel kernel, size_t elementCount, int passCount )
+    {
+        double bestSeconds = 0.0;
+        for ( int run = 0; run < 3; ++run ) {
+            Clock::time_point const start = Clock::now();
+            for ( int pass = 0; pass < passCount; ++pass ) {
+                kernel();
+            }
+            double const seconds = secondsSince( start );
+            if ( run == 0 || seconds < bestSeconds ) bestSeconds = seconds;
+        }
+        return bestSeconds * 1.0e9 / ( static_cast< double >( elementCount ) * passCount );
+    }
+
+
+    void runKernels()
+    {
+        size_t const count = 4096;
+        int const passCount = 2000;
+
+        RandomGenerator random( 1 );
+        std::vector< Vec3 > vectors( count );
+        std::vector< float > ranges( count );
+        for ( size_t i = 0; i < count; ++i ) {
+            vectors[ i ] = random.vectorInUnitRadiusSphere() * 10.0f;
+            ranges[ i ] = random.random01();
+        }
+
+        std::vector< Vec3 > normalized( count );
+        std::vector< float > powers( count );
+        float checksum = 0.0f;
+
+        double const exactNormalize = best( [&]() {
+            for ( size_t i = 0; i < count; ++i ) {
+                Vec3 const& v = vectors[ i ];
+                normalized[ i ] = v / std::sqrt( v.lengthSquared() );
+            }
+            checksum += normalized[ count / 2 ].x;
+        }, count, passCount );
+
+        double const fastNormalize = best( [&]() {
+            for ( size_t i = 0; i < count; ++i ) {
+                Vec3 const& v = vectors[ i ];
+                normalized[ i ] = v * fastInverseSqrt( v.lengthSquared() );
+            }
+            checksum += normalized[ count / 2 ].x;
+        }, count, passCount );
+
+        double const exactPow = best( [&]() {
+            for ( size_t i = 0; i < count; ++i ) {
+                powers[ i ] = static_cast< float >( std::pow( static_cast< double >( ranges[ i ] ), 20.0 ) );
+            }
+            checksum += powers[ count / 2 ];
+        }, count, passCount );
+
+        double const fastPowTime = best( [&]() {
+            for ( size_t i = 0; i < count; ++i ) {
+                powers[ i ] = fastPow( ranges[ i ], 20.0f );
+            }
+            checksum += powers[ count / 2 ];
+        }, count, passCount );
+
+        std::cout << "kernels (ns/element, checksum " << checksum << ")" << std::endl
+                  << "  normalize  exact " << exactNormalize << ", fast " << fastNormalize << std::endl
+                  << "  pow(x, 20) exact " << exactPow << ", fast " << fastPowTime << std::endl;
+    }
+
+
+    /**
+     * Boid steered by @c boidsFrame.
+     */
+    class Boid : public HeadlessVehicle {
+    public:
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) {}
+    };
+
+
+    float const worldRadius = 50.0f;
+
+
+    /**
+     * One Boids frame: collect neighbors, flock and integrate, the
+     * steering of the Boids plug-in without its drawing.
+     */
+    void boidsFrame( std::vector< Boid* > const& boids,
+                     std::vector< AbstractTokenForProximityDatabase< AbstractVehicle* >* > const& tokens,
+                     AVGroup& neighbors,
+                     float elapsedTime )
+    {
+        for ( size_t i = 0; i < boids.size(); ++i ) {
+            Boid& boid = *boids[ i ];
+
+            neighbors.clear();
+            tokens[ i ]->findNeighbors( boid.position(), 9.0f, neighbors );
+
+            Vec3 const separation = boid.steerForSeparation( 5.0f, -0.707f, neighbors );
+            Vec3 const alignment = boid.steerForAlignment( 7.5f, 0.7f, neighbors );
+            Vec3 const cohesion = boid.steerForCohesion( 9.0f, -0.15f, neighbors );
+
+            // Keep the flock together like the plug-in's sphere wrap-around.
+            Vec3 const home = ( boid.position().length() > worldRadius ) ?
+                boid.steerForSeek( Vec3::zero ) :
+                Vec3::zero;
+
+            boid.applySteeringForce( ( separation * 12.0f ) + ( alignment * 8.0f ) + ( cohesion * 8.0f ) + home,
+                                     elapsedTime );
+            tokens[ i ]->updateForNewPosition( boid.position() );
+        }
+    }
+
+
+    void runBoids( int vehicleCount, int frameCount )
+    {
+        LQProximityDatabase< AbstractVehicle* > pd( Vec3::zero,
+                                                     Vec3( 2.0f, 2.0f, 2.0f ) * worldRadius,
+                                                     Vec3( 10.0f, 10.0f, 10.0f ) );
+
+        RandomGenerator random( 1 );
+        std::vector< Boid* > boids;
+        std::vector< AbstractTokenForProximityDatabase< AbstractVehicle* >* > tokens;
+        for ( int i = 0; i < vehicleCount; ++i ) {
+            Boid* boid = new Boid;
+            boid->setMaxForce( 27.0f );
+            boid->setMaxSpeed( 9.0f );
+            boid->setSpeed( boid->maxSpeed() * 0.1f );
+            boid->regenerateOrthonormalBasisUF( random.unitVector() );
+            boid->setPosition( random.vectorInUnitRadiusSphere() * worldRadius );
+            boids.push_back( boid );
+            tokens.push_back( pd.allocateToken( boid ) );
+            tokens.back()->updateForNewPosition( boid->position() );
+        }
+
+        AVGroup neighbors;
+        Clock::time_point const start = Clock::now();
+        for ( int frame = 0; frame < frameCount; ++frame ) {
+            boidsFrame( boids, tokens, neighbors, 1.0f / 60.0f );
+        }
+        double const seconds = secondsSince( start );
+
+        Vec3 sum;
+        for ( size_t i = 0; i < boids.size(); ++i ) {
+            sum += boids[ i ]->position();
+            delete tokens[ i ];
+            delete boids[ i ];
+        }
+
+#ifdef OPENSTEER_FAST_MATH
+        char const* const mode = "fast math";
+#else
+        char const* const mode = "exact math";
+#endif
+        std::cout << "boids, " << mode << ": "
+                  << ( seconds * 1.0e9 / ( static_cast< double >( vehicleCount ) * frameCount ) ) << " ns/update"
+                  << " (mean position " << ( sum / static_cast< float >( vehicleCount ) ) << ")" << std::endl;
+    }
+
+} // anonymous namespace
+
+
+
+int
+main( int argc, char* argv[] )
+{
+    int const vehicleCount = ( argc > 1 ) ? std::atoi( argv[ 1 ] ) : 2000;
+    int const frameCount = ( argc > 2 ) ? std::atoi( argv[ 2 ] ) : 300;
+
+    runKernels();
+    runBoids( vehicleCount, frameCount );
+
+    return 0;
+}
@@ -0,0 +1,318 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Measures what keeping the state neighbors read in the first cache line
+ * of a vehicle (see HotStateMixin) gains for neighbor scans.
+ *
+ * Both vehicle types below carry the state of HeadlessVehicle and run the
+ * same code. The first stores speed and radius behind the steering library
+ * state, like SimpleVehicle did before HotStateMixin, so reading position,
+ * velocity and radius of a neighbor touches two cache lines; the second
+ * reads them from one.
+ *
+ * Every vehicle's neighbors are looked up once, then the timed loop scans
+ * all neighbor lists: "raw" only sums what it reads through AbstractVehicle,
+ * "flocking" runs separation, alignment and cohesion on the lists. The
+ * vehicles don't move so both layouts do exactly the same work.
+ *
+ * Build from the repository root, e.g.:
+ *
+ *     gcc -O2 -Iinclude -c src/lq.c
+ *     g++ -O2 -Iinclude benchmark/NeighborScanBenchmark.cpp src/[A-Z]*.cpp lq.o
+ *
+ * Usage: NeighborScanBenchmark [vehicleCount [passCount]]
+ */
+
+// Include std::cout, std::endl
+#include <iostream>
+
+// Include std::atoi
+#include <cstdlib>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::vector
+#include <vector>
+
+// Include std::conditional
+#include <type_traits>
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::SteerLibraryMixin
+#include "OpenSteer/SteerLibrary.h"
+
+// Include OpenSteer::HotStateMixin
+#include "OpenSteer/HotState.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    template< bool HotState > class BenchmarkVehicle;
+
+    /**
+     * Local space, steering library, speed and radius of the benchmark
+     * vehicles. Layered directly on the local space HotStateMixin keeps
+     * speed and radius in the first cache line, layered on the steering
+     * library it stores them after the steering library state.
+     */
+    template< bool HotState >
+    struct BenchmarkVehicleBase {
+        typedef LocalSpaceMixin< AbstractVehicle > LocalSpace;
+        typedef BenchmarkVehicle< HotState > Concrete;
+        typedef typename std::conditional< HotState,
+                                           SteerLibraryMixin< HotStateMixin< LocalSpace >, Concrete >,
+                                           HotStateMixin< SteerLibraryMixin< LocalSpace, Concrete > > >::type type;
+    };
+
+
+    /**
+     * Vehicle with the state of HeadlessVehicle.
+     */
+    template< bool HotState >
+    class BenchmarkVehicle final : public BenchmarkVehicleBase< HotState >::type {
+    public:
+        typedef typename BenchmarkVehicleBase< HotState >::type Super;
+
+        BenchmarkVehicle()
+            : mass_( 1.0f ), maxForce_( 0.1f ), maxSpeed_( 1.0f ),
+              curvature_( 0.0f ), smoothedCurvature_( 0.0f )
+        {
+            // Nothing to do.
+        }
+
+        Vec3 side() const final { return Super::side(); }
+        Vec3 up() const final { return Super::up(); }
+        Vec3 forward() const final { return Super::forward(); }
+        Vec3 position() const final { return Super::position(); }
+
+        float mass() const final { return mass_; }
+        float setMass( float m ) final { return mass_ = m; }
+        float radius() const final { return Super::radius(); }
+        float setRadius( float r ) final { return Super::setRadius( r ); }
+        Vec3 velocity() const final { return forward() * speed(); }
+        float speed() const final { return Super::speed(); }
+        float setSpeed( float s ) final { return Super::setSpeed( s ); }
+        float maxForce() const final { return maxForce_; }
+        float setMaxForce( float mf ) final { return maxForce_ = mf; }
+        float maxSpeed() const final { return maxSpeed_; }
+        float setMaxSpeed( float ms ) final { return maxSpeed_ = ms; }
+
+        Vec3 predictFuturePosition( float const predictionTime ) const final
+        {
+            return position() + ( velocity() * predictionTime );
+        }
+
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) final {}
+
+        void annotationLine( Vec3 const&, Vec3 const&, Color const& ) const {}
+
+    private:
+        float mass_;
+        float maxForce_;
+        float maxSpeed_;
+
+        float curvature_;
+        float smoothedCurvature_;
+        Vec3 lastForward_;
+        Vec3 lastPosition_;
+        Vec3 smoothedPosition_;
+        Vec3 smoothedAcceleration_;
+    }; // class BenchmarkVehicle
+
+
+    float const worldSize = 100.0f;
+    float const neighborRadius = 6.0f;
+
+
+    /**
+     * @a count vehicles at random places, headings and speeds, allocated
+     * one by one like the plug-ins do.
+     */
+    template< class Vehicle >
+    std::vector< Vehicle* > makeVehicles( int count )
+    {
+        RandomGenerator random( 1 );
+        std::vector< Vehicle* > vehicles;
+        for ( int i = 0; i < count; ++i ) {
+            Vehicle* vehicle = new Vehicle;
+            vehicle->regenerateOrthonormalBasisUF( random.unitVector() );
+            vehicle->setPosition( Vec3( random.random01(), random.random01(), random.random01() ) * worldSize );
+            vehicle->setSpeed( random.random01() );
+            vehicle->setRadius( random.random2( 0.4f, 0.6f ) );
+            vehicles.push_back( vehicle );
+        }
+        return vehicles;
+    }
+
+
+    /**
+     * Neighbor lists of all vehicles, in random order of the vehicles so
+     * consecutive neighbors are not neighbors in memory.
+     */
+    template< class Vehicle >
+    std::vector< AVGroup > findNeighbors( std::vector< Vehicle* > const& vehicles )
+    {
+        LQProximityDatabase< AbstractVehicle* > pd( Vec3( worldSize, worldSize, worldSize ) * 0.5f,
+                                                     Vec3( worldSize, worldSize, worldSize ),
+                                                     Vec3( 10.0f, 10.0f, 10.0f ) );
+        std::vector< AbstractTokenForProximityDatabase< AbstractVehicle* >* > tokens;
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            tokens.push_back( pd.allocateToken( vehicles[ i ] ) );
+            tokens.back()->updateForNewPosition( vehicles[ i ]->position() );
+        }
+
+        std::vector< AVGroup > neighbors( vehicles.size() );
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            tokens[ i ]->findNeighbors( vehicles[ i ]->position(), neighborRadius, neighbors[ i ] );
+            delete tokens[ i ];
+        }
+        return neighbors;
+    }
+
+
+    struct Result {
+        double seconds;
+        size_t neighborCount;
+        float checksum;
+    };
+
+
+    template< class Vehicle >
+    Result rawScan( std::vector< Vehicle* > const& vehicles, std::vector< AVGroup > const& neighbors, int passCount )
+    {
+        Result result = { 0.0, 0, 0.0f };
+        Vec3 sum;
+        std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+        for ( int pass = 0; pass < passCount; ++pass ) {
+            for ( size_t i = 0; i < vehicles.size(); ++i ) {
+                for ( AVIterator n = neighbors[ i ].begin(); n != neighbors[ i ].end(); ++n ) {
+                    AbstractVehicle const& other = **n;
+                    sum += other.position() + other.velocity() * other.radius();
+                }
+                result.neighborCount += neighbors[ i ].size();
+            }
+        }
+        result.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        result.checksum = sum.x + sum.y + sum.z;
+        return result;
+    }
+
+
+    template< class Vehicle >
+    Result flockingScan( std::vector< Vehicle* > const& vehicles, std::vector< AVGroup > const& neighbors, int passCount )
+    {
+        Result result = { 0.0, 0, 0.0f };
+        Vec3 sum;
+        std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+        for ( int pass = 0; pass < passCount; ++pass ) {
+            for ( size_t i = 0; i < vehicles.size(); ++i ) {
+                Vehicle& vehicle = *vehicles[ i ];
+                sum += vehicle.steerForSeparation( 5.0f, -0.707f, neighbors[ i ] );
+                sum += vehicle.steerForAlignment( 6.0f, 0.7f, neighbors[ i ] );
+                sum += vehicle.steerForCohesion( 6.0f, -0.15f, neighbors[ i ] );
+                result.neighborCount += neighbors[ i ].size();
+            }
+        }
+        result.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        result.checksum = sum.x + sum.y + sum.z;
+        return result;
+    }
+
+
+    /**
+     * Best of three runs of @a scan.
+     */
+    template< class Vehicle, class Scan >
+    Result best( Scan scan, std::vector< Vehicle* > const& vehicles, std::vector< AVGroup > const& neighbors, int passCount )
+    {
+        Result bestResult = scan( vehicles, neighbors, passCount );
+        for ( int i = 0; i < 2; ++i ) {
+            Result const result = scan( vehicles, neighbors, passCount );
+            if ( result.seconds < bestResult.seconds ) bestResult = result;
+        }
+        return bestResult;
+    }
+
+
+    void report( char const* name, Result const& result )
+    {
+        std::cout << name << ": "
+                  << ( result.seconds * 1.0e9 / result.neighborCount ) << " ns/neighbor, "
+                  << ( result.neighborCount / result.seconds ) << " neighbors/s"
+                  << " (checksum " << result.checksum << ")" << std::endl;
+    }
+
+
+    template< class Vehicle >
+    void run( char const* name, int vehicleCount, int passCount )
+    {
+        std::vector< Vehicle* > const vehicles = makeVehicles< Vehicle >( vehicleCount );
+        std::vector< AVGroup > const neighbors = findNeighbors( vehicles );
+
+        std::cout << name << " (" << sizeof( Vehicle ) << " bytes per vehicle)" << std::endl;
+        report( "  raw     ", best( rawScan< Vehicle >, vehicles, neighbors, passCount ) );
+        report( "  flocking", best( flockingScan< Vehicle >, vehicles, neighbors, passCount ) );
+
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            delete vehicles[ i ];
+        }
+    }
+
+} // anonymous namespace
+
+
+
+int
+main( int argc, char* argv[] )
+{
+    int const vehicleCount = ( argc > 1 ) ? std::atoi( argv[ 1 ] ) : 100000;
+    int const passCount = ( argc > 2 ) ? std::atoi( argv[ 2 ] ) : 5;
+
+    std::cout << vehicleCount << " vehicles, " << passCount << " passes" << std::endl;
+
+    run< BenchmarkVehicle< false > >( "scattered layout", vehicleCount, passCount );
+    run< BenchmarkVehicle< true > >( "hot state layout ", vehicleCount, passCount );
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Measures how the two phase update of the Boids plug-in (see
+ * OpenSteer/ParallelUpdate.h) scales with the number of threads.
+ *
+ * A flock of HeadlessVehicle boids with the flocking parameters of the
+ * Boids plug-in steers in parallel from the positions at the start of each
+ * frame, then the boids are moved in parallel while the proximity database
+ * is updated one boid after the other. The final positions are printed as
+ * a checksum, they are the same for every thread count. The lowest and
+ * highest thread utilization show how evenly the work was spread.
+ *
+ * Build from the repository root, e.g.:
+ *
+ *     gcc -O2 -Iinclude -c src/lq.c
+ *     g++ -O2 -pthread -Iinclude benchmark/ParallelUpdateBenchmark.cpp src/[A-Z]*.cpp lq.o
+ *
+ * Usage: ParallelUpdateBenchmark [boidCount [frameCount [maxThreadCount]]]
+ *
+ * Thread counts double from 1 up to maxThreadCount (default 64).
+ */
+
+// Include std::cout, std::endl
+#include <iostream>
+
+// Include std::atoi
+#include <cstdlib>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::vector
+#include <vector>
+
+// Include std::min, std::max
+#include <algorithm>
+
+// Include std::thread::hardware_concurrency
+#include <thread>
+
+// Include OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::ScratchBuffer
+#include "OpenSteer/ScratchBuffer.h"
+
+// Include OpenSteer::ThreadPool
+#include "OpenSteer/ThreadPool.h"
+
+// Include OpenSteer::computeSteeringForces
+#include "OpenSteer/ParallelUpdate.h"
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    typedef AbstractProximityDatabase< AbstractVehicle* > ProximityDatabase;
+    typedef AbstractTokenForProximityDatabase< AbstractVehicle* > ProximityToken;
+
+    float const worldRadius = 50.0f;
+
+
+    /**
+     * Flocking boid with the parameters of @c Boid of the Boids plug-in,
+     * without obstacles.
+     */
+    class BenchmarkBoid : public HeadlessVehicle {
+    public:
+        BenchmarkBoid( ProximityDatabase& pd, unsigned long long seed )
+            : proximityToken_( pd.allocateToken( this ) )
+        {
+            seedRandomGenerator( seed );
+            setMaxForce( 27.0f );
+            setMaxSpeed( 9.0f );
+            setSpeed( maxSpeed() * 0.3f );
+            regenerateOrthonormalBasisUF( randomGenerator().unitVector() );
+            setPosition( randomGenerator().vectorInUnitRadiusSphere() * 20.0f );
+            proximityToken_->updateForNewPosition( position() );
+        }
+
+        ~BenchmarkBoid()
+        {
+            delete proximityToken_;
+        }
+
+        void update( float const /* currentTime */, float const elapsedTime )
+        {
+            applySteeringForce( steerToFlock(), elapsedTime );
+            commit();
+        }
+
+        /**
+         * Steering phase, reads the other boids.
+         */
+        Vec3 steerToFlock()
+        {
+            ScratchBuffer< AVGroup > neighbors;
+            proximityToken_->findNeighbors( position(), 9.0f, *neighbors );
+
+            Vec3 const separation = steerForSeparation( 5.0f, -0.707f, *neighbors );
+            Vec3 const alignment = steerForAlignment( 7.5f, 0.7f, *neighbors );
+            Vec3 const cohesion = steerForCohesion( 9.0f, -0.15f, *neighbors );
+
+            return ( separation * 12.0f ) + ( alignment * 8.0f ) + ( cohesion * 8.0f );
+        }
+
+        /**
+         * End of the apply phase, run for one boid after the other.
+         */
+        void commit()
+        {
+            if ( position().length() > worldRadius ) {
+                setPosition( position().sphericalWrapAround( Vec3::zero, worldRadius ) );
+            }
+
+            proximityToken_->updateForNewPosition( position() );
+        }
+
+    private:
+        ProximityToken* proximityToken_;
+    }; // class BenchmarkBoid
+
+
+    struct Result {
+        double seconds;
+        Vec3 positionSum;
+        float minUtilization;
+        float maxUtilization;
+    };
+
+
+    /**
+     * Simulates @a boidCount boids for @a frameCount frames at 60 Hz,
+     * steering with @a threadCount threads.
+     */
+    Result run( int boidCount, int frameCount, size_t threadCount )
+    {
+        float const diameter = worldRadius * 1.1f * 2.0f;
+        LQProximityDatabase< AbstractVehicle* > pd( Vec3::zero,
+                                                     Vec3( diameter, diameter, diameter ),
+                                                     Vec3( 10.0f, 10.0f, 10.0f ) );
+
+        std::vector< BenchmarkBoid* > flock;
+        for ( int i = 0; i < boidCount; ++i ) {
+            flock.push_back( new BenchmarkBoid( pd, static_cast< unsigned long long >( i ) ) );
+        }
+
+        ThreadPool pool( threadCount );
+        std::vector< Vec3 > forces;
+        float const elapsedTime = 1.0f / 60.0f;
+
+        // The first loop starts the workers, don't time that.
+        computeSteeringForces( &pool, flock, forces, []( BenchmarkBoid& boid ) { return boid.steerToFlock(); } );
+        pool.resetStatistics();
+
+        std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+        for ( int frame = 0; frame < frameCount; ++frame ) {
+            computeSteeringForces( &pool, flock, forces, []( BenchmarkBoid& boid ) { return boid.steerToFlock(); } );
+            applySteeringForces( &pool, flock, [ &forces, elapsedTime ]( BenchmarkBoid& boid, size_t i ) {
+                boid.applySteeringForce( forces[ i ], elapsedTime );
+            }, []( BenchmarkBoid& boid, size_t ) {
+                boid.commit();
+            } );
+        }
+        std::chrono::steady_clock::time_point const stop = std::chrono::steady_clock::now();
+
+        Result result;
+        result.seconds = std::chrono::duration< double >( stop - start ).count();
+
+        std::vector< ThreadStatistics > const statistics = pool.statistics();
+        result.minUtilization = result.maxUtilization = statistics[ 0 ].utilization;
+        for ( size_t i = 1; i < statistics.size(); ++i ) {
+            result.minUtilization = std::min( result.minUtilization, statistics[ i ].utilization );
+            result.maxUtilization = std::max( result.maxUtilization, statistics[ i ].utilization );
+        }
+
+        result.positionSum = Vec3::zero;
+        for ( int i = 0; i < boidCount; ++i ) {
+            result.positionSum += flock[ i ]->position();
+            delete flock[ i ];
+        }
+        return result;
+    }
+
+} // anonymous namespace
+
+
+
+int
+main( int argc, char* argv[] )
+{
+    int const boidCount = ( argc > 1 ) ? std::atoi( argv[ 1 ] ) : 4000;
+    int const frameCount = ( argc > 2 ) ? std::atoi( argv[ 2 ] ) : 300;
+    size_t const maxThreadCount = ( argc > 3 ) ? std::atoi( argv[ 3 ] ) : 64;
+
+    std::cout << boidCount << " boids, " << frameCount << " frames, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    // Warm up caches and clock rates.
+    run( boidCount, frameCount / 10 + 1, 1 );
+
+    double serialSeconds = 0.0;
+    for ( size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2 ) {
+        // Keep the best of three runs.
+        Result best = run( boidCount, frameCount, threadCount );
+        for ( int i = 0; i < 2; ++i ) {
+            Result const result = run( boidCount, frameCount, threadCount );
+            if ( result.seconds < best.seconds ) best = result;
+        }
+        if ( 1 == threadCount ) {
+            serialSeconds = best.seconds;
+        }
+
+        std::cout << threadCount << " threads: "
+                  << ( best.seconds * 1000.0 / frameCount ) << " ms/frame, "
+                  << ( boidCount * static_cast< double >( frameCount ) / best.seconds ) << " boid updates/s, "
+                  << "speedup " << ( serialSeconds / best.seconds ) << ", "
+                  << "utilization " << ( 100.0f * best.minUtilization ) << "-"
+                  << ( 100.0f * best.maxUtilization ) << "%"
+                  << " (position sum " << best.positionSum.x << " "
+                  << best.positionSum.y << " " << best.positionSum.z << ")"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -49,30 +49,47 @@
 
 
 #include "Clock.h"
+#include <cmath>
+#include <thread>
 
 
 // ----------------------------------------------------------------------------
-// XXX This is a bit ad hoc.  Need to revisit conditionalization on operating
-// XXX system.  As of 5-5-03, this module knows about Win32 (code thanks to
-// XXX Leaf Garland and Bruce Mitchener) and Linux/Unix (Craig's original
-// XXX version).  It tests for Xbox and Win32 and assumes Linux/Unix 
-// XXX otherwise.
+// Real time is read from std::chrono::steady_clock (QueryPerformanceCounter
+// on Windows, clock_gettime (CLOCK_MONOTONIC) on Linux and Mac OS X), which
+// unlike gettimeofday never jumps when the system time is adjusted.
+//
+// Windows sleeps in steps of the system timer period, 15.6 milliseconds by
+// default, so the period is lowered to 1 millisecond while a Clock sleeps
+// and a larger spin margin is used.
 
 
-#if defined (_XBOX)
-	#include <xtl.h>
-#elif defined (_WIN32)
+#if defined (_WIN32)
 	#include <windows.h>
+	#include <mmsystem.h>
+	#pragma comment (lib, "winmm.lib")
+    namespace {const float defaultPacingSpinMargin = 0.002f;}
 #else
-	#include <sys/time.h> 
+    namespace {const float defaultPacingSpinMargin = 0.0005f;}
 #endif
 
 
+// ----------------------------------------------------------------------------
+// frame time window: 10 segments of 60 frames, the oldest 60 frames are
+// dropped at once
+
+
+namespace {const int frameTimeSegmentFrames = 60;}
+const int Clock::frameTimeWindowFrames = 10 * frameTimeSegmentFrames;
+
+
 // ----------------------------------------------------------------------------
 // Constructor
 
 
 Clock::Clock (void)
+    : frameTimes (frameTimeWindowFrames / frameTimeSegmentFrames,
+                  frameTimeSegmentFrames,
+                  1.5f / 60)
 {
     // default is "real time, variable frame rate" and not paused
     setFixedFrameRate (0);
@@ -105,13 +122,13 @@ Clock::Clock (void)
     // "manually" advance clock by this amount on next update
     newAdvanceTime = 0;
 
-    // "Calendar time" when this clock was first updated
-#ifdef _WIN32
-    basePerformanceCounter = 0;  // from QueryPerformanceCounter on Windows
-#else
-    baseRealTimeSec = 0;         // from gettimeofday on Linux and Mac OS X
-    baseRealTimeUsec = 0;
-#endif
+    // monotonic time when this clock was first updated
+    baseRealTimeRecorded = false;
+
+    // wait for frame boundaries mostly by sleeping
+    setSleepPacing (true);
+    setPacingSpinMargin (defaultPacingSpinMargin);
+    resetPacingStatistics ();
 
     // clock keeps track of "smoothed" running average of recent frame rates.
     // When a fixed frame rate is used, a running average of "CPU load" is
@@ -119,6 +136,7 @@ Clock::Clock (void)
     // step) that the CPU is busy).
     smoothedFPS = 0;
     smoothedUsage = 0;
+    smoothedPacingJitter = 0;
 }
 
 
@@ -150,6 +168,13 @@ Clock::update (void)
     // time since last clock update
     elapsedRealTime = totalRealTime - previousRealTime;
 
+    // keep frame time distribution (the first update has no frame time)
+    if (previousRealTime > 0)
+    {
+        frameTimes.setStallThreshold (1.5f * getTargetFrameTime ());
+        frameTimes.record (elapsedRealTime);
+    }
+
     // accumulate paused time
     if (paused) totalPausedTime += elapsedRealTime;
 
@@ -187,11 +212,9 @@ Clock::update (void)
 
 
 // ----------------------------------------------------------------------------
-// "wait" until next frame time (actually spin around this tight loop)
-//
-//
-// (xxx there are probably a smarter ways to do this (using events or
-// thread waits (eg usleep)) but they are likely to be unportable. xxx)
+// "wait" until next frame time: sleep for most of the wait, then spin around
+// a tight loop for the last pacingSpinMargin seconds (the whole wait when
+// sleep pacing is off)
 
 
 void 
@@ -201,21 +224,70 @@ Clock::frameRateSync (void)
     // (not animation mode and not variable frame rate mode)
     if ((! getAnimationMode ()) && (! getVariableFrameRateMode ()))
     {
-        // find next (real time) frame start time
-        const float targetStepSize = 1.0f / getFixedFrameRate ();
+        // find next (real time) frame start time (in double precision, a
+        // float loses the microseconds after a few minutes of run time)
         const float now = realTimeSinceFirstClockUpdate ();
-        const int lastFrameCount = (int) (now / targetStepSize);
-        const float nextFrameTime = (lastFrameCount + 1) * targetStepSize;
+        const double targetStepSize = 1.0 / getFixedFrameRate ();
+        const double sinceBase =
+            std::chrono::duration<double> (RealTimeClock::now () - baseRealTime).count ();
+        const double nextFrameTime =
+            (std::floor (sinceBase / targetStepSize) + 1) * targetStepSize;
+        const RealTimeClock::time_point nextFrame = baseRealTime +
+            std::chrono::duration_cast<RealTimeClock::duration>
+                (std::chrono::duration<double> (nextFrameTime));
 
         // record usage ("busy time", "non-wait time") for OpenSteerDemo app
         elapsedNonWaitRealTime = now - totalRealTime;
 
-        // wait until next frame time
-        do {} while (realTimeSinceFirstClockUpdate () < nextFrameTime); 
+        // sleep until shortly before next frame time
+        if (sleepPacing)
+        {
+#ifdef _WIN32
+            // lower the system timer period once (reset by Windows on exit)
+            static const bool timerPeriodLowered =
+                (timeBeginPeriod (1) == TIMERR_NOERROR);
+            (void) timerPeriodLowered;
+#endif
+            std::this_thread::sleep_until (nextFrame -
+                std::chrono::duration_cast<RealTimeClock::duration>
+                    (std::chrono::duration<float> (pacingSpinMargin)));
+        }
+
+        // spin until next frame time
+        RealTimeClock::time_point wakeTime;
+        do {wakeTime = RealTimeClock::now ();} while (wakeTime < nextFrame);
+
+        recordPacingJitter (std::chrono::duration<float> (wakeTime - nextFrame).count ());
     }
 }
 
 
+// ----------------------------------------------------------------------------
+// keep track of how late frameRateSync returned
+
+
+void 
+Clock::recordPacingJitter (const float jitter)
+{
+    pacingJitter = jitter;
+    if (pacedFrameCount == 0) smoothedPacingJitter = jitter;
+    OpenSteer::blendIntoAccumulator (getSmoothingRate (), jitter, smoothedPacingJitter);
+    if (jitter > maxPacingJitter) maxPacingJitter = jitter;
+    totalPacingJitter += jitter;
+    pacedFrameCount++;
+}
+
+
+void 
+Clock::resetPacingStatistics (void)
+{
+    pacingJitter = 0;
+    maxPacingJitter = 0;
+    totalPacingJitter = 0;
+    pacedFrameCount = 0;
+}
+
+
 // ----------------------------------------------------------------------------
 // force simulation time ahead, ignoring passage of real time.
 // Used for OpenSteerDemo's "single step forward" and animation mode
@@ -250,61 +322,26 @@ Clock::advanceSimulationTime (const float seconds)
 }
 
 
-namespace {
-
 // ----------------------------------------------------------------------------
 // Returns the number of seconds of real time (represented as a float) since
 // the clock was first updated.
-//
-// XXX Need to revisit conditionalization on operating system.
-
-
 
-    float 
-    clockErrorExit (void)
-    {
-        /// @todo - throw? how to handle error conditions? Not by crashing an app!
-        std::cerr << "Problem reading system clock - results will not be valid";
-        return 0.0f;
-    }
-
-} // anonymous namespace
 
 float 
 Clock::realTimeSinceFirstClockUpdate (void)
-#ifdef _WIN32
-{
-    // get time from Windows
-    LONGLONG counter, frequency;
-    bool clockOK = (QueryPerformanceCounter ((LARGE_INTEGER *)&counter)  &&
-                    QueryPerformanceFrequency ((LARGE_INTEGER *)&frequency));
-    if (!clockOK) return clockErrorExit ();
-
-    // ensure the base counter is recorded once after launch
-    if (basePerformanceCounter == 0) basePerformanceCounter = counter;
-
-    // real "wall clock" time since launch
-    const LONGLONG counterDifference = counter - basePerformanceCounter;
-    return ((float) counterDifference) / ((float)frequency);
-}
-#else
 {
-    // get time from Linux (Unix, Mac OS X, ...)
-    timeval t;
-    if (gettimeofday (&t, 0) != 0) return clockErrorExit ();
+    const RealTimeClock::time_point now = RealTimeClock::now ();
 
     // ensure the base time is recorded once after launch
-    if (baseRealTimeSec == 0)
+    if (! baseRealTimeRecorded)
     {
-        baseRealTimeSec = t.tv_sec;
-        baseRealTimeUsec = t.tv_usec;
+        baseRealTime = now;
+        baseRealTimeRecorded = true;
     }
 
     // real "wall clock" time since launch
-    return (( t.tv_sec  - baseRealTimeSec) +
-            ((t.tv_usec - baseRealTimeUsec) / 1000000.0f));
+    return std::chrono::duration<float> (now - baseRealTime).count ();
 }
-#endif
 
 
 // ----------------------------------------------------------------------------
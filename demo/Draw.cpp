@@ -768,25 +768,26 @@ drawBoxOutline  (const OpenSteer::AbstractLocalSpace& localSpace,
 {
     const OpenSteer::Vec3 s = size / 2.0f;  // half of main diagonal
 
-    const OpenSteer::Vec3 a (+s.x, +s.y, +s.z);
-    const OpenSteer::Vec3 b (+s.x, -s.y, +s.z);
-    const OpenSteer::Vec3 c (-s.x, -s.y, +s.z);
-    const OpenSteer::Vec3 d (-s.x, +s.y, +s.z);
-
-    const OpenSteer::Vec3 e (+s.x, +s.y, -s.z);
-    const OpenSteer::Vec3 f (+s.x, -s.y, -s.z);
-    const OpenSteer::Vec3 g (-s.x, -s.y, -s.z);
-    const OpenSteer::Vec3 h (-s.x, +s.y, -s.z);
-
-    const OpenSteer::Vec3 A = localSpace.globalizePosition (a);
-    const OpenSteer::Vec3 B = localSpace.globalizePosition (b);
-    const OpenSteer::Vec3 C = localSpace.globalizePosition (c);
-    const OpenSteer::Vec3 D = localSpace.globalizePosition (d);
-
-    const OpenSteer::Vec3 E = localSpace.globalizePosition (e);
-    const OpenSteer::Vec3 F = localSpace.globalizePosition (f);
-    const OpenSteer::Vec3 G = localSpace.globalizePosition (g);
-    const OpenSteer::Vec3 H = localSpace.globalizePosition (h);
+    // corners in local space, globalized with one call
+    OpenSteer::Vec3 corners [8] = {OpenSteer::Vec3 (+s.x, +s.y, +s.z),
+                                   OpenSteer::Vec3 (+s.x, -s.y, +s.z),
+                                   OpenSteer::Vec3 (-s.x, -s.y, +s.z),
+                                   OpenSteer::Vec3 (-s.x, +s.y, +s.z),
+                                   OpenSteer::Vec3 (+s.x, +s.y, -s.z),
+                                   OpenSteer::Vec3 (+s.x, -s.y, -s.z),
+                                   OpenSteer::Vec3 (-s.x, -s.y, -s.z),
+                                   OpenSteer::Vec3 (-s.x, +s.y, -s.z)};
+    localSpace.globalizePositions (corners, corners, 8);
+
+    const OpenSteer::Vec3& A = corners[0];
+    const OpenSteer::Vec3& B = corners[1];
+    const OpenSteer::Vec3& C = corners[2];
+    const OpenSteer::Vec3& D = corners[3];
+
+    const OpenSteer::Vec3& E = corners[4];
+    const OpenSteer::Vec3& F = corners[5];
+    const OpenSteer::Vec3& G = corners[6];
+    const OpenSteer::Vec3& H = corners[7];
 
     iDrawLine (A, B, color);
     iDrawLine (B, C, color);
@@ -950,7 +951,9 @@ namespace {
     // deferred draw line
     //
     // For use during simulation phase.
-    // Stores description of lines to be drawn later.
+    // Stores description of lines to be drawn later.  The lines of an update
+    // are drawn after "publish" (see publishDeferredDrawing), so an update
+    // can add lines while the redraw of the previous one draws its lines.
 
 
     class DeferredLine
@@ -969,11 +972,17 @@ namespace {
             lines.push_back (dl);
         }
 
+        static void publish (void)
+        {
+            published.clear ();
+            published.swap (lines);
+        }
+
         static void drawAll (void)
         {
-            // draw all deferred lines
-            for (DeferredLines::iterator i = lines.begin();
-                 i < lines.end();
+            // draw all published deferred lines
+            for (DeferredLines::iterator i = published.begin();
+                 i < published.end();
                  i++)
             {
                 DeferredLine& dl = *i;
@@ -981,7 +990,7 @@ namespace {
             }
 
             // clear list of deferred lines
-            lines.clear ();
+            published.clear ();
         }
 
         typedef std::vector<DeferredLine> DeferredLines;
@@ -993,10 +1002,12 @@ namespace {
         OpenSteer::Color color;
 
         static DeferredLines lines;
+        static DeferredLines published;
     };
 
 
 DeferredLine::DeferredLines DeferredLine::lines;
+DeferredLine::DeferredLines DeferredLine::published;
 
 
 } // anonymous namespace
@@ -1025,7 +1036,7 @@ namespace {
     // XXX for now, just a modified copy of DeferredLine
     //
     // For use during simulation phase.
-    // Stores description of circles to be drawn later.
+    // Stores description of circles to be drawn later, after "publish".
 
 
     class DeferredCircle
@@ -1051,11 +1062,17 @@ namespace {
             circles.push_back (dc);
         }
 
+        static void publish (void)
+        {
+            published.clear ();
+            published.swap (circles);
+        }
+
         static void drawAll (void)
         {
-            // draw all deferred circles
-            for (DeferredCircles::iterator i = circles.begin();
-                 i < circles.end();
+            // draw all published deferred circles
+            for (DeferredCircles::iterator i = published.begin();
+                 i < published.end();
                  i++)
             {
                 DeferredCircle& dc = *i;
@@ -1064,7 +1081,7 @@ namespace {
             }
 
             // clear list of deferred circles
-            circles.clear ();
+            published.clear ();
         }
 
         typedef std::vector<DeferredCircle> DeferredCircles;
@@ -1080,10 +1097,12 @@ namespace {
         bool in3d;
 
         static DeferredCircles circles;
+        static DeferredCircles published;
     };
 
 
 DeferredCircle::DeferredCircles DeferredCircle::circles;
+DeferredCircle::DeferredCircles DeferredCircle::published;
 
 
 } // anonymous namesopace
@@ -1110,6 +1129,14 @@ drawAllDeferredCirclesOrDisks (void)
 }
 
 
+void 
+publishDeferredDrawing (void)
+{
+    DeferredLine::publish ();
+    DeferredCircle::publish ();
+}
+
+
 // ------------------------------------------------------------------------
 // Functions for drawing text (in GLUT's 9x15 bitmap font) in a given
 // color, starting at a location on the screen which can be specified
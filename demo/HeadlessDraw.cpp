@@ -0,0 +1,363 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// HeadlessDraw
+//
+// Implements the functions of Draw.h without drawing anything.  Linked in
+// place of Draw.cpp into the headless runner (see HeadlessMain.cpp), so the
+// PlugIns run without OpenGL, GLUT or a window.  Annotation is switched off
+// there, so none of these should be called during a simulation update.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "Draw.h"
+#include <sstream>
+
+
+// ----------------------------------------------------------------------------
+// warn when draw functions are called during OpenSteerDemo's update phase
+
+
+void 
+warnIfInUpdatePhase2 (const char* /*name*/)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// primitives
+
+
+void 
+glVertexVec3 (const OpenSteer::Vec3& /*v*/)
+{
+}
+
+
+void 
+drawLine (const OpenSteer::Vec3& /*startPoint*/,
+          const OpenSteer::Vec3& /*endPoint*/,
+          const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawLineAlpha (const OpenSteer::Vec3& /*startPoint*/,
+               const OpenSteer::Vec3& /*endPoint*/,
+               const OpenSteer::Color& /*color*/,
+               const float /*alpha*/)
+{
+}
+
+
+void 
+draw2dLine (const OpenSteer::Vec3& /*startPoint*/,
+            const OpenSteer::Vec3& /*endPoint*/,
+            const OpenSteer::Color& /*color*/,
+            float /*w*/, float /*h*/)
+{
+}
+
+
+void 
+drawTriangle (const OpenSteer::Vec3& /*a*/,
+              const OpenSteer::Vec3& /*b*/,
+              const OpenSteer::Vec3& /*c*/,
+              const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawQuadrangle (const OpenSteer::Vec3& /*a*/,
+                const OpenSteer::Vec3& /*b*/,
+                const OpenSteer::Vec3& /*c*/,
+                const OpenSteer::Vec3& /*d*/,
+                const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawXZWideLine (const OpenSteer::Vec3& /*startPoint*/,
+                const OpenSteer::Vec3& /*endPoint*/,
+                const OpenSteer::Color& /*color*/,
+                float /*width*/)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// circles, arcs and spheres
+
+
+void 
+drawCircleOrDisk (const float /*radius*/,
+                  const OpenSteer::Vec3& /*axis*/,
+                  const OpenSteer::Vec3& /*center*/,
+                  const OpenSteer::Color& /*color*/,
+                  const int /*segments*/,
+                  const bool /*filled*/,
+                  const bool /*in3d*/)
+{
+}
+
+
+void 
+drawXZCircleOrDisk (const float /*radius*/,
+                    const OpenSteer::Vec3& /*center*/,
+                    const OpenSteer::Color& /*color*/,
+                    const int /*segments*/,
+                    const bool /*filled*/)
+{
+}
+
+
+void 
+draw3dCircleOrDisk (const float /*radius*/,
+                    const OpenSteer::Vec3& /*center*/,
+                    const OpenSteer::Vec3& /*axis*/,
+                    const OpenSteer::Color& /*color*/,
+                    const int /*segments*/,
+                    const bool /*filled*/)
+{
+}
+
+
+void 
+drawXZArc (const OpenSteer::Vec3& /*start*/,
+           const OpenSteer::Vec3& /*center*/,
+           const float /*arcLength*/,
+           const int /*segments*/,
+           const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawSphere (const OpenSteer::Vec3 /*center*/,
+            const float /*radius*/,
+            const float /*maxEdgeLength*/,
+            const bool /*filled*/,
+            const OpenSteer::Color& /*color*/,
+            const bool /*drawFrontFacing*/,
+            const bool /*drawBackFacing*/,
+            const OpenSteer::Vec3& /*viewpoint*/)
+{
+}
+
+
+void 
+drawSphereObstacle (const OpenSteer::SphereObstacle& /*so*/,
+                    const float /*maxEdgeLength*/,
+                    const bool /*filled*/,
+                    const OpenSteer::Color& /*color*/,
+                    const OpenSteer::Vec3& /*viewpoint*/)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// vehicles, grids and boxes
+
+
+void 
+drawBasic2dCircularVehicle (const OpenSteer::AbstractVehicle& /*bv*/,
+                            const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawBasic3dSphericalVehicle (const OpenSteer::AbstractVehicle& /*bv*/,
+                             const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawBasic3dSphericalVehicle (drawTriangleRoutine /*draw*/,
+                             const OpenSteer::AbstractVehicle& /*bv*/,
+                             const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawXZCheckerboardGrid (const float /*size*/,
+                        const int /*subsquares*/,
+                        const OpenSteer::Vec3& /*center*/,
+                        const OpenSteer::Color& /*color1*/,
+                        const OpenSteer::Color& /*color2*/)
+{
+}
+
+
+void 
+drawXZLineGrid (const float /*size*/,
+                const int /*subsquares*/,
+                const OpenSteer::Vec3& /*center*/,
+                const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawAxes (const OpenSteer::AbstractLocalSpace& /*localSpace*/,
+          const OpenSteer::Vec3& /*size*/,
+          const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawBoxOutline (const OpenSteer::AbstractLocalSpace& /*localSpace*/,
+                const OpenSteer::Vec3& /*size*/,
+                const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+drawReticle (float /*w*/, float /*h*/)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// deferred drawing of lines, circles and (filled) disks
+
+
+void 
+deferredDrawLine (const OpenSteer::Vec3& /*startPoint*/,
+                  const OpenSteer::Vec3& /*endPoint*/,
+                  const OpenSteer::Color& /*color*/)
+{
+}
+
+
+void 
+deferredDrawCircleOrDisk (const float /*radius*/,
+                          const OpenSteer::Vec3& /*axis*/,
+                          const OpenSteer::Vec3& /*center*/,
+                          const OpenSteer::Color& /*color*/,
+                          const int /*segments*/,
+                          const bool /*filled*/,
+                          const bool /*in3d*/)
+{
+}
+
+
+void 
+drawAllDeferredLines (void)
+{
+}
+
+
+void 
+drawAllDeferredCirclesOrDisks (void)
+{
+}
+
+
+void 
+publishDeferredDrawing (void)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// text
+
+
+void 
+draw2dTextAt3dLocation (const char& /*text*/,
+                        const OpenSteer::Vec3& /*location*/,
+                        const OpenSteer::Color& /*color*/, float /*w*/, float /*h*/)
+{
+}
+
+
+void 
+draw2dTextAt3dLocation (const std::ostringstream& /*text*/,
+                        const OpenSteer::Vec3& /*location*/,
+                        const OpenSteer::Color& /*color*/, float /*w*/, float /*h*/)
+{
+}
+
+
+void 
+draw2dTextAt2dLocation (const char& /*text*/,
+                        const OpenSteer::Vec3 /*location*/,
+                        const OpenSteer::Color& /*color*/, float /*w*/, float /*h*/)
+{
+}
+
+
+void 
+draw2dTextAt2dLocation (const std::ostringstream& /*text*/,
+                        const OpenSteer::Vec3 /*location*/,
+                        const OpenSteer::Color& /*color*/, float /*w*/, float /*h*/)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// camera and window
+
+
+void 
+drawCameraLookAt (const OpenSteer::Vec3& /*cameraPosition*/,
+                  const OpenSteer::Vec3& /*pointToLookAt*/,
+                  const OpenSteer::Vec3& /*up*/)
+{
+}
+
+
+void 
+checkForDrawError (const char* /*locationDescription*/)
+{
+}
+
+
+// there is no screen: every pixel looks down the Z axis
+
+
+OpenSteer::Vec3 
+directionFromCameraToScreenPosition (int /*x*/, int /*y*/, int /*h*/)
+{
+    return OpenSteer::Vec3::forward;
+}
+
+
+// ----------------------------------------------------------------------------
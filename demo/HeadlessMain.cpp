@@ -0,0 +1,693 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// HeadlessMain: top level routine for running a PlugIn without graphics
+//
+// Runs the update of one PlugIn for a number of frames with a fixed time
+// step, as fast as possible, and reports the throughput.  Linked with
+// HeadlessDraw.cpp instead of Draw.cpp and the GLUT modules, for simulation
+// servers and performance regression runs:
+//
+//     OpenSteerHeadless Boids --population 2000 --frames 1000 --threads 8
+//
+// prints agent steps per second (vehicles times frames divided by the time
+// spent updating), frame time percentiles, the number of stalls (frames
+// slower than "--stall <ms>", by default the frame time of 60 fps or of
+// "--fps") and the peak memory use.  Frame times are counted in a fixed
+// memory LatencyHistogram, "--histogram" prints its buckets.
+//
+// With "--worlds <n>" it runs n independent instances of the PlugIn side by
+// side (see World.h) instead, each frame steps every World once, and also
+// reports World steps per second; comparing runs with different "--threads"
+// gives the throughput in Worlds per core:
+//
+//     OpenSteerHeadless Pedestrians --worlds 64 --frames 500 --threads 8
+//
+// "--fps <n>" paces the timed frames to n per second like the demo's fixed
+// frame rate mode (sleeping between frames, "--spin" busy-waits instead) and
+// reports the pacing jitter and the CPU time used, for simulation servers
+// sharing their cores:
+//
+//     OpenSteerHeadless Pedestrians --frames 600 --fps 60 --threads 1
+//
+// "--profile" enables the Profiler for the timed frames and prints the time
+// per frame of every zone, "--trace <file>" also writes every zone call of
+// the timed frames as Chrome trace-event JSON (open it in chrome://tracing
+// or Perfetto).  Profiling adds some overhead to the reported timings.
+//
+// "--key <n>" presses function key n of the PlugIn before the first frame
+// (repeat it to press several keys in turn), e.g. to run the benchmark
+// scene of the Stress Test PlugIn with a million agents and its next
+// steering engine:
+//
+//     OpenSteerHeadless "Stress Test" --population 1000000 --key 4
+//
+// "--record <file>" logs the run (see Recording.h), "--replay <file>" runs
+// a run recorded here or in OpenSteerDemo again bit for bit, with the
+// recorded PlugIn, commands and frame times, and reports whether the
+// vehicle states stayed identical to the recording.  "--warmup" and
+// "--frames" select the window of the recording to time and profile, e.g.
+// the 3 seconds from frame 5400 on where the frame time spiked:
+//
+//     OpenSteerHeadless --replay spike.osr --warmup 5400 --frames 180 --profile
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteerDemo.h"
+#include "PlugIn.h"
+#include "World.h"
+#include "Clock.h"
+#include "Annotation.h"
+#include "OpenSteer/Profiler.h"
+#include "OpenSteer/LatencyHistogram.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+
+namespace {
+
+
+    // ------------------------------------------------------------------------
+    // command line options
+
+
+    struct Options
+    {
+        Options (void)
+            : plugInName (NULL), population (-1), frames (0),
+              warmupFrames (10), timeStep (1.0f / 60.0f), threads (0),
+              worlds (0), fps (0), spin (false), stallMilliseconds (0),
+              histogram (false), profile (false), traceFile (NULL),
+              recordFile (NULL), replayFile (NULL), list (false) {}
+
+        const char* plugInName;
+        int population;        // -1: keep the PlugIn's default
+        int frames;            // 0: 1000, or all frames of a replay
+        int warmupFrames;      // run before timing starts
+        float timeStep;
+        int threads;           // 0: one per hardware thread
+        int worlds;            // 0: run the registered PlugIn itself
+        int fps;               // 0: run frames back to back
+        bool spin;             // busy-wait instead of sleeping when pacing
+        float stallMilliseconds; // 0: frame time at fps (or 60 fps)
+        bool histogram;        // print the frame time histogram
+        bool profile;          // print the Profiler zones of the timed frames
+        const char* traceFile; // NULL: no Chrome trace
+        const char* recordFile; // NULL: don't record the run
+        const char* replayFile; // NULL: run the named PlugIn
+        std::vector<int> keys; // function keys pressed before the first frame
+        bool list;
+    };
+
+
+    void printUsage (void)
+    {
+        std::cout
+            << "usage: OpenSteerHeadless <plugin name> [options]" << std::endl
+            << "       OpenSteerHeadless --replay <file> [options]" << std::endl
+            << "       OpenSteerHeadless --list" << std::endl
+            << std::endl
+            << "  --population <n>   number of vehicles (if the PlugIn supports it)" << std::endl
+            << "  --frames <n>       timed frames (default 1000, replay: all)" << std::endl
+            << "  --warmup <n>       untimed frames run first (default 10)" << std::endl
+            << "  --dt <seconds>     simulation time step (default 1/60)" << std::endl
+            << "  --threads <n>      threads for the steering phase (default: all cores)" << std::endl
+            << "  --worlds <n>       run n independent Worlds of the PlugIn side by side" << std::endl
+            << "  --fps <n>          pace timed frames to n per second, report jitter" << std::endl
+            << "  --spin             pace by busy-waiting instead of sleeping" << std::endl
+            << "  --stall <ms>       count frames slower than this as stalls" << std::endl
+            << "  --histogram        print the frame time histogram" << std::endl
+            << "  --profile          print time per frame of every profiler zone" << std::endl
+            << "  --trace <file>     write the profiler zones as Chrome trace JSON" << std::endl
+            << "  --record <file>    record the run for replaying it" << std::endl
+            << "  --replay <file>    replay a recorded run, check it stays identical" << std::endl
+            << "  --key <n>          press function key n of the PlugIn first (repeatable)" << std::endl
+            << "  --list             print the names of all PlugIns" << std::endl;
+    }
+
+
+    bool parseOptions (int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char* arg = argv[i];
+            const bool hasValue = (i + 1 < argc);
+
+            if (std::strcmp (arg, "--list") == 0)
+                options.list = true;
+            else if (std::strcmp (arg, "--population") == 0 && hasValue)
+                options.population = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--frames") == 0 && hasValue)
+                options.frames = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--warmup") == 0 && hasValue)
+                options.warmupFrames = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--dt") == 0 && hasValue)
+                options.timeStep = (float) std::atof (argv[++i]);
+            else if (std::strcmp (arg, "--threads") == 0 && hasValue)
+                options.threads = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--worlds") == 0 && hasValue)
+                options.worlds = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--fps") == 0 && hasValue)
+                options.fps = std::atoi (argv[++i]);
+            else if (std::strcmp (arg, "--spin") == 0)
+                options.spin = true;
+            else if (std::strcmp (arg, "--stall") == 0 && hasValue)
+                options.stallMilliseconds = (float) std::atof (argv[++i]);
+            else if (std::strcmp (arg, "--histogram") == 0)
+                options.histogram = true;
+            else if (std::strcmp (arg, "--profile") == 0)
+                options.profile = true;
+            else if (std::strcmp (arg, "--trace") == 0 && hasValue)
+                options.traceFile = argv[++i];
+            else if (std::strcmp (arg, "--record") == 0 && hasValue)
+                options.recordFile = argv[++i];
+            else if (std::strcmp (arg, "--replay") == 0 && hasValue)
+                options.replayFile = argv[++i];
+            else if (std::strcmp (arg, "--key") == 0 && hasValue)
+                options.keys.push_back (std::atoi (argv[++i]));
+            else if (arg[0] != '-' && options.plugInName == NULL)
+                options.plugInName = arg;
+            else
+                return false;
+        }
+        // a replay repeats the recorded PlugIn, population and keys in one
+        // World
+        const bool replay = (options.replayFile != NULL);
+        const bool record = (options.recordFile != NULL);
+        if (replay && (options.plugInName != NULL || options.population >= 0 ||
+                       record || !options.keys.empty ()))
+            return false;
+        for (size_t i = 0; i < options.keys.size (); i++)
+            if (options.keys[i] < 1) return false;
+        if ((replay || record) && options.worlds > 0)
+            return false;
+
+        return (options.list || options.plugInName != NULL || replay) &&
+               options.frames >= 0 && options.warmupFrames >= 0 &&
+               options.timeStep > 0 && options.threads >= 0 &&
+               options.worlds >= 0 && options.fps >= 0 &&
+               options.stallMilliseconds >= 0;
+    }
+
+
+    void printPlugInName (PlugIn& pi) {std::cout << "  " << pi.name () << std::endl;}
+
+
+    // ------------------------------------------------------------------------
+    // the PlugIns being run: the selected PlugIn itself, the PlugIn
+    // instances of several Worlds, or the PlugIn of a replayed recording
+
+
+    class Simulation
+    {
+    public:
+
+        // "plugIn" is NULL when replaying, the recording opens its PlugIn
+        Simulation (PlugIn* plugIn, const Options& options)
+        {
+            if (plugIn == NULL)
+            {
+                OpenSteerDemo::replayCommands ();
+                if (OpenSteerDemo::selectedPlugIn)
+                    instances.push_back (OpenSteerDemo::selectedPlugIn);
+                return;
+            }
+
+            OpenSteer::ThreadPool* pool = &OpenSteerDemo::threadPool;
+            for (int i = 0; i < options.worlds; i++)
+            {
+                World* world = World::make (*plugIn, pool);
+                if (world == NULL) break;
+                worlds.push_back (world);
+                instances.push_back (&world->plugIn ());
+            }
+
+            if (instances.empty ())
+            {
+                if (options.worlds > 0)
+                    std::cerr << "OpenSteerHeadless: \"" << plugIn->name ()
+                              << "\" can't run in Worlds, running it once"
+                              << std::endl;
+                OpenSteerDemo::selectedPlugIn = plugIn;
+                OpenSteerDemo::openSelectedPlugIn ();
+                instances.push_back (plugIn);
+            }
+        }
+
+        ~Simulation ()
+        {
+            if (worlds.empty () && OpenSteerDemo::selectedPlugIn)
+                OpenSteerDemo::closeSelectedPlugIn ();
+            for (size_t i = 0; i < worlds.size (); i++) delete worlds[i];
+        }
+
+        // returns false at the end of a replayed recording
+        bool step (const float currentTime, const float elapsedTime)
+        {
+            if (OpenSteerDemo::isReplaying ())
+            {
+                if (!OpenSteerDemo::replayNextFrame ()) return false;
+            }
+            else if (worlds.empty ())
+                OpenSteerDemo::updateSelectedPlugIn (currentTime, elapsedTime);
+            else
+                World::stepAll (worlds, elapsedTime, &OpenSteerDemo::threadPool);
+
+            // collect the zones of this frame (no-op while profiling is off)
+            OpenSteer::Profiler::endFrame ();
+            return true;
+        }
+
+        // vehicles of all PlugIns
+        size_t agentCount (void)
+        {
+            if (worlds.empty ())
+                return OpenSteerDemo::allVehiclesOfSelectedPlugIn ().size ();
+            size_t count = 0;
+            for (size_t i = 0; i < instances.size (); i++)
+                count += instances[i]->allVehicles ().size ();
+            return count;
+        }
+
+        std::vector<PlugIn*> instances;
+        std::vector<World*> worlds;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // peak resident memory of this process in bytes (0 if unknown)
+
+
+    double peakMemoryBytes (void)
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo (GetCurrentProcess (), &counters, sizeof (counters)))
+            return (double) counters.PeakWorkingSetSize;
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage (RUSAGE_SELF, &usage) != 0) return 0;
+    #if __APPLE__ && __MACH__
+        return (double) usage.ru_maxrss;            // bytes
+    #else
+        return (double) usage.ru_maxrss * 1024;     // kilobytes
+    #endif
+#endif
+    }
+
+
+    // ------------------------------------------------------------------------
+    // CPU time (user and system, all threads) used by this process in seconds
+
+
+    double processCpuSeconds (void)
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes (GetCurrentProcess (), &creation, &exit, &kernel, &user))
+            return 0;
+        const double hundredNanoseconds = 1.0e-7;
+        return hundredNanoseconds *
+            ((((ULONGLONG) kernel.dwHighDateTime << 32) | kernel.dwLowDateTime) +
+             (((ULONGLONG) user.dwHighDateTime << 32) | user.dwLowDateTime));
+#else
+        struct rusage usage;
+        if (getrusage (RUSAGE_SELF, &usage) != 0) return 0;
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1.0e-6;
+#endif
+    }
+
+
+    // ------------------------------------------------------------------------
+    // non-empty buckets of a frame time histogram with cumulative share
+
+
+    void printHistogram (const OpenSteer::LatencyHistogram& histogram)
+    {
+        const double ms = 1000;
+        size_t cumulativeCount = 0;
+        std::cout << "frame time histogram (ms):" << std::endl;
+        for (size_t i = 0; i < OpenSteer::LatencyHistogram::bucketCount; i++)
+        {
+            const size_t count = histogram.bucketSampleCount (i);
+            if (count == 0) continue;
+            cumulativeCount += count;
+            std::cout << std::setprecision (4)
+                      << std::setw (12) << ms * OpenSteer::LatencyHistogram::bucketLowerBound (i)
+                      << " - " << std::setw (10) << ms * OpenSteer::LatencyHistogram::bucketUpperBound (i)
+                      << std::setw (10) << count
+                      << std::setprecision (2)
+                      << std::setw (10) << 100.0 * cumulativeCount / histogram.count () << "%"
+                      << std::endl;
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // per frame time of every profiler zone, nested zones indented
+
+
+    void printProfile (const std::vector<OpenSteer::ProfileZoneStatistics>& zones,
+                       const int frames)
+    {
+        std::vector<std::string> names;
+        size_t nameWidth = 20;
+        for (size_t i = 0; i < zones.size (); i++)
+        {
+            names.push_back (std::string (2 + 2 * zones[i].depth, ' ') + zones[i].name);
+            nameWidth = std::max (nameWidth, names.back ().size ());
+        }
+
+        const double ms = 1000.0 / frames;
+        std::cout << std::left << std::setw (nameWidth) << "profile (per frame):"
+                  << std::right
+                  << std::setw (12) << "total ms"
+                  << std::setw (12) << "self ms"
+                  << std::setw (12) << "calls" << std::endl;
+        for (size_t i = 0; i < zones.size (); i++)
+        {
+            const OpenSteer::ProfileZoneStatistics& zone = zones[i];
+            std::cout << std::left << std::setw (nameWidth) << names[i]
+                      << std::right << std::setprecision (3)
+                      << std::setw (12) << ms * zone.seconds
+                      << std::setw (12) << ms * zone.selfSeconds
+                      << std::setprecision (1)
+                      << std::setw (12) << (double) zone.calls / frames
+                      << std::endl;
+        }
+    }
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+int main (int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions (argc, argv, options))
+    {
+        printUsage ();
+        return EXIT_FAILURE;
+    }
+
+    PlugIn::sortBySelectionOrder ();
+    if (options.list)
+    {
+        PlugIn::applyToAll (printPlugInName);
+        return EXIT_SUCCESS;
+    }
+
+    // the named PlugIn, or NULL to replay the recorded one
+    PlugIn* plugIn = NULL;
+    if (options.replayFile != NULL)
+    {
+        if (!OpenSteerDemo::startReplay (options.replayFile))
+        {
+            std::cerr << "OpenSteerHeadless: could not read recording \""
+                      << options.replayFile << "\"" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        plugIn = PlugIn::findByName (options.plugInName);
+        if (plugIn == NULL)
+        {
+            std::cerr << "OpenSteerHeadless: no PlugIn named \""
+                      << options.plugInName << "\", known PlugIns:" << std::endl;
+            PlugIn::applyToAll (printPlugInName);
+            return EXIT_FAILURE;
+        }
+
+        // start before the PlugIn is opened to record its seed
+        if (options.recordFile != NULL &&
+            !OpenSteerDemo::startRecording (options.recordFile))
+        {
+            std::cerr << "OpenSteerHeadless: could not write recording \""
+                      << options.recordFile << "\"" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // nothing is drawn, so do not collect annotation either
+    enableAnnotation = false;
+    OpenSteerDemo::threadPool.setThreadCount (options.threads);
+
+    Simulation simulation (plugIn, options);
+    const std::vector<PlugIn*>& instances = simulation.instances;
+    if (instances.empty ())
+    {
+        std::cerr << "OpenSteerHeadless: recording \"" << options.replayFile
+                  << "\" opens no PlugIn" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < instances.size () && options.population >= 0; i++)
+    {
+        const bool changed = simulation.worlds.empty () ?
+            OpenSteerDemo::setPopulationOfSelectedPlugIn (options.population) :
+            instances[i]->setPopulation (options.population);
+        if (!changed)
+        {
+            std::cerr << "OpenSteerHeadless: \"" << instances[i]->name ()
+                      << "\" has a fixed population of "
+                      << instances[i]->allVehicles ().size () << std::endl;
+            break;
+        }
+    }
+
+    // function keys, recorded like the demo's when running one PlugIn
+    for (size_t i = 0; i < options.keys.size (); i++)
+    {
+        if (simulation.worlds.empty ())
+            OpenSteerDemo::functionKeyForPlugIn (options.keys[i]);
+        else
+            for (size_t j = 0; j < instances.size (); j++)
+                instances[j]->handleFunctionKeys (options.keys[i]);
+    }
+
+    // step the simulation with a fixed time step, timing every update
+    typedef std::chrono::steady_clock TimerClock;
+    const float dt = options.timeStep;
+    float simulationTime = 0;
+    for (int frame = 0; frame < options.warmupFrames; frame++)
+    {
+        simulationTime += dt;
+        if (!simulation.step (simulationTime, dt)) break;
+    }
+
+    const double stallSeconds = (options.stallMilliseconds > 0) ?
+        options.stallMilliseconds / 1000.0 :
+        1.0 / ((options.fps > 0) ? options.fps : 60);
+    OpenSteer::LatencyHistogram frameTimes;
+    double totalSeconds = 0;
+    size_t stallCount = 0;
+    double agentSteps = 0;
+    OpenSteerDemo::threadPool.resetStatistics ();
+
+    // profile only the timed frames
+    const bool profiling = options.profile || options.traceFile != NULL;
+    OpenSteer::Profiler::setEnabled (profiling);
+    OpenSteer::Profiler::resetStatistics ();
+    OpenSteer::Profiler::setTraceRecording (options.traceFile != NULL);
+
+    // optionally wait for 1/fps boundaries like the demo's real-time fixed
+    // frame rate mode
+    Clock pacer;
+    pacer.setFixedFrameRate (options.fps);
+    pacer.setVariableFrameRateMode (options.fps == 0);
+    pacer.setSleepPacing (!options.spin);
+
+    const int frameLimit = (options.frames > 0) ? options.frames :
+                           (options.replayFile != NULL) ? INT_MAX : 1000;
+    int frames = 0;
+    const double cpuStart = processCpuSeconds ();
+    const TimerClock::time_point wallStart = TimerClock::now ();
+    for (; frames < frameLimit; frames++)
+    {
+        if (options.fps > 0) pacer.update ();
+
+        simulationTime += dt;
+        const double agents = (double) simulation.agentCount ();
+
+        const TimerClock::time_point start = TimerClock::now ();
+        const bool stepped = simulation.step (simulationTime, dt);
+        const TimerClock::time_point end = TimerClock::now ();
+        if (!stepped) break;
+        agentSteps += agents;
+
+        const double seconds = std::chrono::duration<double> (end - start).count ();
+        frameTimes.record (seconds);
+        totalSeconds += seconds;
+        if (seconds > stallSeconds) stallCount++;
+    }
+
+    const double wallSeconds =
+        std::chrono::duration<double> (TimerClock::now () - wallStart).count ();
+    const double cpuSeconds = processCpuSeconds () - cpuStart;
+    const std::vector<OpenSteer::ThreadStatistics> threadStatistics =
+        OpenSteerDemo::threadPool.statistics ();
+    OpenSteer::Profiler::setEnabled (false);
+    OpenSteerDemo::stopRecording ();
+
+    const double ms = 1000;
+    std::cout << std::fixed << std::setprecision (3)
+              << "plugin:             "
+              << (simulation.worlds.empty () ?
+                  OpenSteerDemo::nameOfSelectedPlugIn () : plugIn->name ())
+              << std::endl;
+    if (!simulation.worlds.empty ())
+    {
+        const size_t worldCount = simulation.worlds.size ();
+        const double worldSteps = (double) worldCount * frames;
+        std::cout << "worlds:             " << worldCount << std::endl
+                  << "world steps/s:      " << std::setprecision (1)
+                  << ((totalSeconds > 0) ? worldSteps / totalSeconds : 0)
+                  << std::setprecision (3) << std::endl;
+    }
+    std::cout << "agents:             " << simulation.agentCount () << std::endl
+              << "threads:            " << OpenSteerDemo::threadPool.threadCount () << std::endl
+              << "frames:             " << frames << " (";
+    if (options.replayFile != NULL)
+        std::cout << "recorded dt, ";
+    else
+        std::cout << "dt " << dt << " s, ";
+    std::cout << options.warmupFrames << " warmup)" << std::endl
+              << "update time:        " << totalSeconds << " s" << std::endl
+              << "agent steps/s:      " << std::setprecision (0)
+              << ((totalSeconds > 0) ? agentSteps / totalSeconds : 0) << std::endl
+              << "time per agent:     " << std::setprecision (1)
+              << ((agentSteps > 0) ? 1.0e9 * totalSeconds / agentSteps : 0)
+              << " ns" << std::endl
+              << std::setprecision (3)
+              << "frame time (ms):    mean " << ms * totalSeconds / std::max (frames, 1)
+              << "  p50 " << ms * frameTimes.percentile (0.50)
+              << "  p90 " << ms * frameTimes.percentile (0.90)
+              << "  p95 " << ms * frameTimes.percentile (0.95)
+              << "  p99 " << ms * frameTimes.percentile (0.99)
+              << "  max " << ms * frameTimes.max () << std::endl
+              << "stalls:             " << stallCount << " frames over "
+              << ms * stallSeconds << " ms" << std::endl
+              << "peak memory:        " << std::setprecision (1)
+              << peakMemoryBytes () / (1024 * 1024) << " MB" << std::endl
+              << "cpu time:           " << std::setprecision (3) << cpuSeconds
+              << " s (" << std::setprecision (1)
+              << ((wallSeconds > 0) ? 100 * cpuSeconds / wallSeconds : 0)
+              << "% of " << std::setprecision (3) << wallSeconds << " s wall time)"
+              << std::endl;
+    if (options.fps > 0)
+    {
+        std::cout << "pacing:             " << options.fps << " fps, "
+                  << (pacer.getSleepPacing () ? "sleep+spin" : "spin")
+                  << ", jitter mean " << ms * pacer.getMeanPacingJitter ()
+                  << " ms, max " << ms * pacer.getMaxPacingJitter () << " ms"
+                  << std::endl;
+    }
+
+    // share of the timed frames each thread spent running tasks of the
+    // parallel update phases, uneven values point to imbalanced work
+    std::cout << "thread utilization:" << std::endl;
+    for (size_t i = 0; i < threadStatistics.size (); i++)
+    {
+        const OpenSteer::ThreadStatistics& t = threadStatistics[i];
+        std::cout << "  thread " << i << ":  " << std::setprecision (1)
+                  << 100 * t.utilization << "%, "
+                  << t.taskCount << " tasks, "
+                  << t.stealCount << " stolen" << std::endl;
+    }
+
+    if (options.histogram)
+        printHistogram (frameTimes);
+
+    if (options.profile)
+        printProfile (OpenSteer::Profiler::statistics (), std::max (frames, 1));
+
+    if (options.traceFile != NULL)
+    {
+        std::ofstream trace (options.traceFile);
+        OpenSteer::Profiler::writeChromeTrace (trace);
+        if (!trace)
+        {
+            std::cerr << "OpenSteerHeadless: could not write trace \""
+                      << options.traceFile << "\"" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "trace:              " << options.traceFile << " ("
+                  << OpenSteer::Profiler::traceEventCount () << " zone calls)"
+                  << std::endl;
+    }
+
+    if (options.recordFile != NULL)
+    {
+        std::cout << "recording:          " << options.recordFile << " ("
+                  << OpenSteerDemo::recordedFrameCount () << " frames)"
+                  << std::endl;
+    }
+
+    // a replay differing from its recording means lost determinism
+    if (options.replayFile != NULL)
+    {
+        const int divergentFrame = OpenSteerDemo::firstDivergentFrame ();
+        std::cout << "replay:             " << options.replayFile << ", "
+                  << OpenSteerDemo::replayedFrameCount () << " frames, ";
+        if (divergentFrame < 0)
+            std::cout << "identical to the recording" << std::endl;
+        else
+            std::cout << "diverged at frame " << divergentFrame << std::endl;
+        if (divergentFrame >= 0) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -45,8 +45,17 @@
 #include "Annotation.h"
 #include "Color.h"
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/Profiler.h"
+#include "Recording.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -56,10 +65,15 @@
 //
 // XXX In Mac OS X these headers are located in a different directory.
 // XXX Need to revisit conditionalization on operating system.
-#if __APPLE__ && __MACH__
-#include <GLUT/glut.h>   // for Mac OS X
-#else
-#include <GL/glut.h>     // for Linux and Windows
+//
+// Without GLUT (HAVE_NO_GLUT, as in Draw.cpp) there is no window, e.g. in the
+// headless runner.
+#ifndef HAVE_NO_GLUT
+    #if __APPLE__ && __MACH__
+        #include <GLUT/glut.h>   // for Mac OS X
+    #else
+        #include <GL/glut.h>     // for Linux and Windows
+    #endif
 #endif
 
 // ----------------------------------------------------------------------------
@@ -76,6 +90,24 @@ Clock OpenSteerDemo::clock;
 Camera OpenSteerDemo::camera;
 
 
+// ----------------------------------------------------------------------------
+// worker threads for the steering phase of the PlugIns' updates
+
+
+OpenSteer::ThreadPool OpenSteerDemo::threadPool;
+
+
+OpenSteer::ThreadPool*
+OpenSteerDemo::updateThreadPool (void)
+{
+#ifdef OPENSTEER_NO_ANNOTATION
+    return &threadPool;
+#else
+    return annotationIsOn () ? NULL : &threadPool;
+#endif
+}
+
+
 // ----------------------------------------------------------------------------
 // currently selected plug-in (user can choose or cycle through them)
 
@@ -106,6 +138,152 @@ int OpenSteerDemo::phase = OpenSteerDemo::overheadPhase;
 bool enableAnnotation = true;
 
 
+// ----------------------------------------------------------------------------
+// recording and replay of runs (see Recording.h)
+
+
+namespace {
+
+    RecordingWriter recorder;
+
+    RecordingReader player;
+    bool replaying = false;
+    RecordedEvent nextRecordedEvent;
+    bool hasNextRecordedEvent = false;
+    int replayedFrames = 0;
+    int divergentFrame = -1;
+
+    // index of the selected vehicle in allVehicles, -1 if none
+    int selectedVehicleIndex (void)
+    {
+        const OpenSteer::AVGroup& all =
+            OpenSteerDemo::allVehiclesOfSelectedPlugIn ();
+        const OpenSteer::AVGroup::const_iterator s =
+            std::find (all.begin (), all.end (), OpenSteerDemo::selectedVehicle);
+        return (s == all.end ()) ? -1 : (int) (s - all.begin ());
+    }
+
+    void recordSelectedVehicle (void)
+    {
+        if (recorder.isOpen ()) recorder.vehicleSelected (selectedVehicleIndex ());
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// pipelined mode: a thread running the update of the next frame while the
+// main thread draws
+
+
+namespace {
+
+    // true on the pipeline thread, its updates leave the phase stack and
+    // timers of the main thread alone
+    thread_local bool onPipelineThread = false;
+
+    class PipelineThread
+    {
+    public:
+
+        PipelineThread () : busy (false), quit (false), jobSeconds (0) {}
+
+        ~PipelineThread ()
+        {
+            if (! thread.joinable ()) return;
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                quit = true;
+            }
+            wake.notify_all ();
+            thread.join ();
+        }
+
+        // run "job" on the pipeline thread, the previous one must be done
+        void start (const std::function<void ()>& job)
+        {
+            if (! thread.joinable ())
+                thread = std::thread (&PipelineThread::run, this);
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                nextJob = job;
+                busy = true;
+            }
+            wake.notify_all ();
+        }
+
+        // wait until the job started last is done
+        void finish (void)
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            done.wait (lock, [this] {return ! busy;});
+        }
+
+        // seconds the job took (valid after finish)
+        float lastJobSeconds (void) const {return jobSeconds;}
+
+    private:
+
+        void run (void)
+        {
+            onPipelineThread = true;
+            updatePhaseActive = true;
+
+            std::unique_lock<std::mutex> lock (mutex);
+            for (;;)
+            {
+                wake.wait (lock, [this] {return busy || quit;});
+                if (quit) return;
+
+                const std::function<void ()> job = nextJob;
+                lock.unlock ();
+                const std::chrono::steady_clock::time_point start =
+                    std::chrono::steady_clock::now ();
+                job ();
+                const float seconds = std::chrono::duration<float>
+                    (std::chrono::steady_clock::now () - start).count ();
+                lock.lock ();
+
+                jobSeconds = seconds;
+                busy = false;
+                done.notify_all ();
+            }
+        }
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::function<void ()> nextJob;
+        bool busy;
+        bool quit;
+        float jobSeconds;
+    };
+
+    PipelineThread pipeline;
+    bool pipelinedMode = false;
+    bool pipelineActive = false;
+    float pipelineUpdateSeconds = 0;
+    float pipelineWaitSeconds = 0;
+
+    // whether the selected PlugIn's last snapshotForRedraw took a snapshot
+    bool plugInHasSnapshots = false;
+
+    // if no vehicle is selected, and some exist, select the first one
+    void selectFirstVehicleIfNone (void)
+    {
+        if (OpenSteerDemo::selectedVehicle == NULL)
+        {
+            const OpenSteer::AVGroup& vehicles =
+                OpenSteerDemo::allVehiclesOfSelectedPlugIn ();
+            if (vehicles.size() > 0)
+                OpenSteerDemo::selectedVehicle = vehicles.front();
+        }
+    }
+
+} // anonymous namespace
+
+
 // ----------------------------------------------------------------------------
 // XXX apparently MS VC6 cannot handle initialized static const members,
 // XXX so they have to be initialized not-inline.
@@ -146,8 +324,17 @@ OpenSteerDemo::initialize (void)
         std::cout << std::endl;                                    // xxx?
     }
 
-    // initialize the default PlugIn
-    openSelectedPlugIn ();
+    // initialize the default PlugIn, or the first one of a replayed run
+    if (isReplaying ())
+    {
+        selectedPlugIn = NULL;
+        replayCommands ();
+        if (!selectedPlugIn) errorExit ("recording opens no PlugIn");
+    }
+    else
+    {
+        openSelectedPlugIn ();
+    }
 }
 
 
@@ -166,13 +353,64 @@ OpenSteerDemo::updateSimulationAndRedraw (void)
     //  routine)
     initPhaseTimers ();
 
-    // run selected PlugIn (with simulation's current time and step size)
-    updateSelectedPlugIn (clock.getTotalSimulationTime (),
-                          clock.getElapsedSimulationTime ());
+    // wait for the update the previous frame started in pipelined mode,
+    // the main thread's update phase is this wait
+    if (pipelineActive)
+    {
+        pushPhase (updatePhase);
+        const float waitStart = clock.realTimeSinceFirstClockUpdate ();
+        finishPipelinedUpdate ();
+        pipelineWaitSeconds = clock.realTimeSinceFirstClockUpdate () - waitStart;
+        popPhase ();
+
+        // fold its profiler zones into the per-zone statistics
+        OpenSteer::Profiler::endFrame ();
+    }
+
+    pipelineActive = pipelinedMode && plugInHasSnapshots && !isReplaying ();
+    if (pipelineActive)
+    {
+        // snapshot the last update for this redraw, then start the next
+        // update on the pipeline thread (with simulation's current time
+        // and step size)
+        publishDeferredDrawing ();
+        selectFirstVehicleIfNone ();
+        plugInHasSnapshots = selectedPlugIn->snapshotForRedraw ();
+
+        const float currentTime = clock.getTotalSimulationTime ();
+        const float elapsedTime = clock.getElapsedSimulationTime ();
+        pipeline.start ([currentTime, elapsedTime] ()
+                        {updateSelectedPlugIn (currentTime, elapsedTime);});
+    }
+    else
+    {
+        // run selected PlugIn (with simulation's current time and step
+        // size), or the next frame of a replayed run (unless paused),
+        // stopping at the end of the recording
+        if (isReplaying ())
+        {
+            if (!clock.getPausedState () && !replayNextFrame ())
+                clock.setPausedState (true);
+        }
+        else
+        {
+            updateSelectedPlugIn (clock.getTotalSimulationTime (),
+                                  clock.getElapsedSimulationTime ());
+        }
+        publishDeferredDrawing ();
+        plugInHasSnapshots = selectedPlugIn->snapshotForRedraw ();
+    }
 
     // redraw selected PlugIn (based on real time)
     redrawSelectedPlugIn (clock.getTotalRealTime (),
                           clock.getElapsedRealTime ());
+
+    // add this frame's phase times to their distributions
+    recordPhaseTimes ();
+
+    // fold this frame's profiler zones into the per-zone statistics (in
+    // pipelined mode once the update is done)
+    if (!pipelineActive) OpenSteer::Profiler::endFrame ();
 }
 
 
@@ -230,6 +468,7 @@ OpenSteerDemo::selectNextPlugIn (void)
 void 
 OpenSteerDemo::functionKeyForPlugIn (int keyNumber)
 {
+    if (recorder.isOpen ()) recorder.functionKey (keyNumber);
     selectedPlugIn->handleFunctionKeys (keyNumber);
 }
 
@@ -265,6 +504,8 @@ OpenSteerDemo::openSelectedPlugIn (void)
 {
     camera.reset ();
     selectedVehicle = NULL;
+    plugInHasSnapshots = false;
+    if (recorder.isOpen ()) recorder.plugInSelected (selectedPlugIn->name ());
     selectedPlugIn->open ();
 }
 
@@ -279,20 +520,22 @@ OpenSteerDemo::updateSelectedPlugIn (const float currentTime,
 {
     // switch to Update phase
     pushPhase (updatePhase);
+    OPENSTEER_PROFILE_ZONE ("update");
 
     // service queued reset request, if any
     doDelayedResetPlugInXXX ();
 
     // if no vehicle is selected, and some exist, select the first one
-    if (selectedVehicle == NULL)
-    {
-        const OpenSteer::AVGroup& vehicles = allVehiclesOfSelectedPlugIn();
-        if (vehicles.size() > 0) selectedVehicle = vehicles.front();
-    }
+    selectFirstVehicleIfNone ();
 
     // invoke selected PlugIn's Update method
     selectedPlugIn->update (currentTime, elapsedTime);
 
+    // log the frame's time and resulting state
+    if (recorder.isOpen ())
+        recorder.frame (currentTime, elapsedTime,
+                        vehicleStateChecksum (allVehiclesOfSelectedPlugIn ()));
+
     // return to previous phase
     popPhase ();
 }
@@ -308,6 +551,7 @@ OpenSteerDemo::redrawSelectedPlugIn (const float currentTime,
 {
     // switch to Draw phase
     pushPhase (drawPhase);
+    OPENSTEER_PROFILE_ZONE ("draw");
 
     // invoke selected PlugIn's Draw method
     selectedPlugIn->redraw (currentTime, elapsedTime);
@@ -340,6 +584,7 @@ OpenSteerDemo::closeSelectedPlugIn (void)
 void 
 OpenSteerDemo::resetSelectedPlugIn (void)
 {
+    if (recorder.isOpen ()) recorder.reset ();
     selectedPlugIn->reset ();
 }
 
@@ -370,7 +615,8 @@ OpenSteerDemo::doDelayedResetPlugInXXX (void)
 {
     if (gDelayedResetPlugInXXX)
     {
-        resetSelectedPlugIn ();
+        // requested by the PlugIn itself, so not recorded as a command
+        selectedPlugIn->reset ();
         gDelayedResetPlugInXXX = false;
     }
 }
@@ -410,19 +656,21 @@ OpenSteerDemo::selectNextVehicle (void)
         if (s == last - 1) 
         {
            selectedVehicle = *first; 
-           return;
         }
 
         // if the search failed, use NULL
-        if (s == last) 
+        else if (s == last) 
         {
            selectedVehicle = NULL; 
-           return;
         }
 
         // normally select the next vehicle in container
-        selectedVehicle = *(s + 1);
+        else
+        {
+           selectedVehicle = *(s + 1);
+        }
 
+        recordSelectedVehicle ();
     }
 }
 
@@ -435,6 +683,251 @@ void
 OpenSteerDemo::selectVehicleNearestScreenPosition (int x, int y)
 {
     selectedVehicle = findVehicleNearestScreenPosition (x, y);
+    recordSelectedVehicle ();
+}
+
+
+// ----------------------------------------------------------------------------
+// pipelined mode: update the next frame while drawing this one
+
+
+void 
+OpenSteerDemo::setPipelinedMode (bool pipelined)
+{
+    finishPipelinedUpdate ();
+    pipelinedMode = pipelined;
+}
+
+
+bool 
+OpenSteerDemo::getPipelinedMode (void)
+{
+    return pipelinedMode;
+}
+
+
+bool 
+OpenSteerDemo::togglePipelinedMode (void)
+{
+    setPipelinedMode (!pipelinedMode);
+    return pipelinedMode;
+}
+
+
+bool 
+OpenSteerDemo::pipelineIsActive (void)
+{
+    return pipelineActive;
+}
+
+
+void 
+OpenSteerDemo::finishPipelinedUpdate (void)
+{
+    if (onPipelineThread) return;
+    pipeline.finish ();
+    pipelineUpdateSeconds = pipeline.lastJobSeconds ();
+}
+
+
+float 
+OpenSteerDemo::pipelinedUpdateTime (void)
+{
+    return pipelineUpdateSeconds;
+}
+
+
+float 
+OpenSteerDemo::pipelineWaitTime (void)
+{
+    return pipelineWaitSeconds;
+}
+
+
+// ----------------------------------------------------------------------------
+// record the run to a file
+
+
+bool 
+OpenSteerDemo::startRecording (const char* fileName)
+{
+    if (replaying) return false;
+
+    // a fresh seed for the global rand, kept in the recording
+    const unsigned int seed = std::random_device () ();
+    if (!recorder.open (fileName, seed)) return false;
+    srand (seed);
+    return true;
+}
+
+
+void 
+OpenSteerDemo::stopRecording (void)
+{
+    recorder.close ();
+}
+
+
+bool 
+OpenSteerDemo::isRecording (void)
+{
+    return recorder.isOpen ();
+}
+
+
+int 
+OpenSteerDemo::recordedFrameCount (void)
+{
+    return recorder.frameCount ();
+}
+
+
+// ----------------------------------------------------------------------------
+// replay a recorded run
+
+
+bool 
+OpenSteerDemo::startReplay (const char* fileName)
+{
+    if (recorder.isOpen () || !player.open (fileName)) return false;
+    srand (player.seed ());
+    replaying = true;
+    hasNextRecordedEvent = false;
+    replayedFrames = 0;
+    divergentFrame = -1;
+    return true;
+}
+
+
+bool 
+OpenSteerDemo::isReplaying (void)
+{
+    return replaying;
+}
+
+
+bool 
+OpenSteerDemo::replayCommands (void)
+{
+    while (replaying)
+    {
+        if (!hasNextRecordedEvent)
+        {
+            hasNextRecordedEvent = player.next (nextRecordedEvent);
+            if (!hasNextRecordedEvent) return false;
+        }
+
+        const RecordedEvent& event = nextRecordedEvent;
+        if (event.type == RecordedEvent::frame) return true;
+        hasNextRecordedEvent = false;
+
+        switch (event.type)
+        {
+        case RecordedEvent::plugInSelected:
+            {
+                PlugIn* plugIn = PlugIn::findByName (event.name.c_str ());
+                if (plugIn == NULL)
+                {
+                    std::ostringstream message;
+                    message << "recording opens unknown PlugIn \""
+                            << event.name << "\"";
+                    printWarning (message);
+                    return false;
+                }
+                if (selectedPlugIn) closeSelectedPlugIn ();
+                selectedPlugIn = plugIn;
+                openSelectedPlugIn ();
+            }
+            break;
+        case RecordedEvent::functionKey:
+            functionKeyForPlugIn (event.value);
+            break;
+        case RecordedEvent::reset:
+            resetSelectedPlugIn ();
+            break;
+        case RecordedEvent::vehicleSelected:
+            {
+                const OpenSteer::AVGroup& all = allVehiclesOfSelectedPlugIn ();
+                selectedVehicle = ((event.value >= 0) &&
+                                   (event.value < (int) all.size ())) ?
+                                  all[event.value] : NULL;
+            }
+            break;
+        case RecordedEvent::population:
+            selectedPlugIn->setPopulation (event.value);
+            break;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+
+bool 
+OpenSteerDemo::replayNextFrame (void)
+{
+    if (!replaying) return false;
+
+    if (!replayCommands () || !selectedPlugIn)
+    {
+        // end of the recording: report and stop
+        replaying = false;
+        player.close ();
+
+        std::ostringstream message;
+        message << "replayed " << replayedFrames << " frames, ";
+        if (divergentFrame < 0)
+            message << "identical to the recording";
+        else
+            message << "diverged from the recording at frame " << divergentFrame;
+        printMessage (message);
+        return false;
+    }
+
+    const RecordedEvent frame = nextRecordedEvent;
+    hasNextRecordedEvent = false;
+    updateSelectedPlugIn (frame.currentTime, frame.elapsedTime);
+
+    const unsigned int checksum =
+        vehicleStateChecksum (allVehiclesOfSelectedPlugIn ());
+    if ((checksum != frame.checksum) && (divergentFrame < 0))
+    {
+        divergentFrame = replayedFrames;
+        std::ostringstream message;
+        message << "replay diverged from the recording at frame "
+                << divergentFrame;
+        printWarning (message);
+    }
+    replayedFrames++;
+    return true;
+}
+
+
+int 
+OpenSteerDemo::replayedFrameCount (void)
+{
+    return replayedFrames;
+}
+
+
+int 
+OpenSteerDemo::firstDivergentFrame (void)
+{
+    return divergentFrame;
+}
+
+
+// ----------------------------------------------------------------------------
+// change the population of the selected PlugIn
+
+
+bool 
+OpenSteerDemo::setPopulationOfSelectedPlugIn (int count)
+{
+    if (!selectedPlugIn->setPopulation (count)) return false;
+    if (recorder.isOpen ()) recorder.population (count);
+    return true;
 }
 
 
@@ -446,9 +939,16 @@ OpenSteerDemo::selectVehicleNearestScreenPosition (int x, int y)
 
 OpenSteer::AbstractVehicle* 
 OpenSteerDemo::vehicleNearestToMouse (void)
+{
+    return vehicleNearestToMouse (allVehiclesOfSelectedPlugIn ());
+}
+
+
+OpenSteer::AbstractVehicle* 
+OpenSteerDemo::vehicleNearestToMouse (const OpenSteer::AVGroup& vehicles)
 {
     return (mouseInWindow ? 
-            findVehicleNearestScreenPosition (mouseX, mouseY) :
+            findVehicleNearestScreenPosition (mouseX, mouseY, vehicles) :
             NULL);
 }
 
@@ -470,15 +970,27 @@ OpenSteerDemo::vehicleNearestToMouse (void)
 
 OpenSteer::AbstractVehicle* 
 OpenSteerDemo::findVehicleNearestScreenPosition (int x, int y)
+{
+    return findVehicleNearestScreenPosition (x, y, allVehiclesOfSelectedPlugIn ());
+}
+
+
+OpenSteer::AbstractVehicle* 
+OpenSteerDemo::findVehicleNearestScreenPosition (int x, int y,
+                                                 const OpenSteer::AVGroup& vehicles)
 {
     // find the direction from the camera position to the given pixel
-    const OpenSteer::Vec3 direction = directionFromCameraToScreenPosition (x, y, glutGet (GLUT_WINDOW_HEIGHT));
+#ifndef HAVE_NO_GLUT
+    const int windowHeight = glutGet (GLUT_WINDOW_HEIGHT);
+#else
+    const int windowHeight = 0;
+#endif
+    const OpenSteer::Vec3 direction = directionFromCameraToScreenPosition (x, y, windowHeight);
 
     // iterate over all vehicles to find the one whose center is nearest the
     // "eye-mouse" selection line
     float minDistance = FLT_MAX;       // smallest distance found so far
     OpenSteer::AbstractVehicle* nearest = NULL;   // vehicle whose distance is smallest
-    const OpenSteer::AVGroup& vehicles = allVehiclesOfSelectedPlugIn();
     for (OpenSteer::AVIterator i = vehicles.begin(); i != vehicles.end(); i++)
     {
         // distance from this vehicle's center to the selection line:
@@ -765,6 +1277,8 @@ OpenSteerDemo::keyboardMiniHelp (void)
     printMessage (getDemoKeyHelp(7));
     printMessage (getDemoKeyHelp(8));
     printMessage (getDemoKeyHelp(9));
+    printMessage (getDemoKeyHelp(10));
+    printMessage (getDemoKeyHelp(11));
     printMessage ("");
 
     // allow PlugIn to print mini help for the function keys it handles
@@ -785,10 +1299,12 @@ const char* OpenSteerDemo::getDemoKeyHelp(int nth)
    case 3:   return "  f      select next preset frame rate";
    case 4:   return "  Tab    select next PlugIn.";
    case 5:   return "  a      toggle annotation on/off.";
-   case 6:   return "  Space  toggle between Run and Pause.";
-   case 7:   return "  ->     step forward one frame.";
-   case 8:   return "  ?      print mini-help in console";
-   case 9:   return "  Esc    exit.";
+   case 6:   return "  p      toggle profiler zone breakdown.";
+   case 7:   return "  u      toggle pipelined update/draw.";
+   case 8:   return "  Space  toggle between Run and Pause.";
+   case 9:   return "  ->     step forward one frame.";
+   case 10:  return "  ?      print mini-help in console";
+   case 11:  return "  Esc    exit.";
    }
 
    return NULL;
@@ -811,13 +1327,16 @@ int OpenSteerDemo::phaseStackIndex = 0;
 const int OpenSteerDemo::phaseStackSize = 5;
 int OpenSteerDemo::phaseStack [OpenSteerDemo::phaseStackSize];
 
-bool updatePhaseActive = false;
-bool drawPhaseActive = false;
+thread_local bool updatePhaseActive = false;
+thread_local bool drawPhaseActive = false;
 
 
 void 
 OpenSteerDemo::pushPhase (const int newPhase)
 {
+    // the pipeline thread is always in its update phase
+    if (onPipelineThread) return;
+
     updatePhaseActive = newPhase == OpenSteerDemo::updatePhase;
     drawPhaseActive = newPhase == OpenSteerDemo::drawPhase;
 
@@ -838,6 +1357,8 @@ OpenSteerDemo::pushPhase (const int newPhase)
 void 
 OpenSteerDemo::popPhase (void)
 {
+    if (onPipelineThread) return;
+
     // update timer for current (old) phase: add in time since last switch
     updatePhaseTimers ();
 
@@ -872,3 +1393,30 @@ OpenSteerDemo::updatePhaseTimers (void)
     phaseTimers[phase] += currentRealTime - phaseTimerBase;
     phaseTimerBase = currentRealTime;
 }
+
+
+// ----------------------------------------------------------------------------
+// distributions of the update and draw phase times over the last frames
+
+
+OpenSteer::LatencyWindow OpenSteerDemo::drawPhaseTimes (10, 60, 1.0f / 60);
+OpenSteer::LatencyWindow OpenSteerDemo::updatePhaseTimes (10, 60, 1.0f / 60);
+
+
+void 
+OpenSteerDemo::recordPhaseTimes (void)
+{
+    const float targetFrameTime = clock.getTargetFrameTime ();
+    drawPhaseTimes.setStallThreshold (targetFrameTime);
+    updatePhaseTimes.setStallThreshold (targetFrameTime);
+    drawPhaseTimes.record (phaseTimerDraw ());
+    updatePhaseTimes.record (phaseTimerUpdate ());
+}
+
+
+void 
+OpenSteerDemo::resetPhaseTimes (void)
+{
+    drawPhaseTimes.clear ();
+    updatePhaseTimes.clear ();
+}
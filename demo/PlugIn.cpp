@@ -38,6 +38,8 @@
 
 
 #include "PlugIn.h"
+#include "OpenSteerDemo.h"
+#include "World.h"
 #include <cstring>
 
 // ----------------------------------------------------------------------------
@@ -55,10 +57,11 @@ PlugIn* PlugIn::registry [totalSizeOfRegistry];
 // constructor
 
 
-PlugIn::PlugIn (void)
+PlugIn::PlugIn (Registration registration)
+    : myWorld (NULL)
 {
     // save this new instance in the registry
-    addToRegistry ();
+    if (registration == registered) addToRegistry ();
 }
 
 
@@ -69,6 +72,17 @@ PlugIn::PlugIn (void)
 PlugIn::~PlugIn() {}
 
 
+// ----------------------------------------------------------------------------
+// threads for the parallel phases of update
+
+
+OpenSteer::ThreadPool*
+PlugIn::updateThreadPool (void)
+{
+    return myWorld ? myWorld->threadPool () : OpenSteerDemo::updateThreadPool ();
+}
+
+
 // ----------------------------------------------------------------------------
 // returns pointer to the next PlugIn in "selection order"
 
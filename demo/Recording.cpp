@@ -0,0 +1,315 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Recording: compact binary log of a simulation run (see Recording.h)
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "Recording.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace {
+
+    const char magic[4] = {'O', 'S', 'R', 'P'};
+    const int version = 1;
+
+    // record tags
+    const int plugInTag = 'P';
+    const int functionKeyTag = 'K';
+    const int resetTag = 'R';
+    const int vehicleTag = 'V';
+    const int populationTag = 'N';
+    const int frameTag = 'F';
+
+    unsigned int floatBits (const float value)
+    {
+        unsigned int bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        return bits;
+    }
+
+    float bitsFloat (const unsigned int bits)
+    {
+        float value;
+        std::memcpy (&value, &bits, sizeof (value));
+        return value;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// RecordingWriter
+
+
+bool
+RecordingWriter::open (const char* fileName, const unsigned int seed)
+{
+    close ();
+    file.open (fileName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open ()) return false;
+    file.write (magic, sizeof (magic));
+    writeByte (version);
+    writeWord (seed);
+    frames = 0;
+    return (bool) file;
+}
+
+
+void
+RecordingWriter::close (void)
+{
+    if (file.is_open ()) file.close ();
+}
+
+
+void
+RecordingWriter::plugInSelected (const char* name)
+{
+    const size_t length = std::min (std::strlen (name), (size_t) 0xffff);
+    writeByte (plugInTag);
+    writeByte ((int) (length & 0xff));
+    writeByte ((int) (length >> 8));
+    file.write (name, length);
+}
+
+
+void
+RecordingWriter::functionKey (const int keyNumber)
+{
+    writeByte (functionKeyTag);
+    writeByte (keyNumber);
+}
+
+
+void
+RecordingWriter::reset (void)
+{
+    writeByte (resetTag);
+}
+
+
+void
+RecordingWriter::vehicleSelected (const int index)
+{
+    writeByte (vehicleTag);
+    writeWord ((unsigned int) index);
+}
+
+
+void
+RecordingWriter::population (const int count)
+{
+    writeByte (populationTag);
+    writeWord ((unsigned int) count);
+}
+
+
+void
+RecordingWriter::frame (const float currentTime,
+                        const float elapsedTime,
+                        const unsigned int checksum)
+{
+    writeByte (frameTag);
+    writeWord (floatBits (currentTime));
+    writeWord (floatBits (elapsedTime));
+    writeWord (checksum);
+    frames++;
+}
+
+
+void
+RecordingWriter::writeByte (const int value)
+{
+    file.put ((char) (value & 0xff));
+}
+
+
+void
+RecordingWriter::writeWord (const unsigned int value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+        writeByte ((int) (value >> shift));
+}
+
+
+// ----------------------------------------------------------------------------
+// RecordingReader
+
+
+bool
+RecordingReader::open (const char* fileName)
+{
+    close ();
+    file.open (fileName, std::ios::binary);
+    if (!file.is_open ()) return false;
+
+    char header[sizeof (magic)];
+    int fileVersion;
+    if (!file.read (header, sizeof (header)) ||
+        std::memcmp (header, magic, sizeof (magic)) != 0 ||
+        !readByte (fileVersion) || fileVersion != version ||
+        !readWord (seedValue))
+    {
+        close ();
+        return false;
+    }
+    return true;
+}
+
+
+void
+RecordingReader::close (void)
+{
+    if (file.is_open ()) file.close ();
+}
+
+
+bool
+RecordingReader::next (RecordedEvent& event)
+{
+    int tag;
+    if (!file.is_open () || !readByte (tag)) return false;
+
+    unsigned int word;
+    switch (tag)
+    {
+    case plugInTag:
+        {
+            int low, high;
+            if (!readByte (low) || !readByte (high)) return false;
+            event.type = RecordedEvent::plugInSelected;
+            event.name.resize (low | (high << 8));
+            if (!event.name.empty () &&
+                !file.read (&event.name[0], event.name.size ())) return false;
+            return true;
+        }
+    case functionKeyTag:
+        event.type = RecordedEvent::functionKey;
+        return readByte (event.value);
+    case resetTag:
+        event.type = RecordedEvent::reset;
+        return true;
+    case vehicleTag:
+        event.type = RecordedEvent::vehicleSelected;
+        if (!readWord (word)) return false;
+        event.value = (int) word;
+        return true;
+    case populationTag:
+        event.type = RecordedEvent::population;
+        if (!readWord (word)) return false;
+        event.value = (int) word;
+        return true;
+    case frameTag:
+        {
+            unsigned int currentBits, elapsedBits;
+            if (!readWord (currentBits) || !readWord (elapsedBits) ||
+                !readWord (event.checksum)) return false;
+            event.type = RecordedEvent::frame;
+            event.currentTime = bitsFloat (currentBits);
+            event.elapsedTime = bitsFloat (elapsedBits);
+            return true;
+        }
+    default:
+        // unknown record: the rest can't be parsed
+        return false;
+    }
+}
+
+
+bool
+RecordingReader::readByte (int& value)
+{
+    const int c = file.get ();
+    if (c == std::char_traits<char>::eof ()) return false;
+    value = c & 0xff;
+    return true;
+}
+
+
+bool
+RecordingReader::readWord (unsigned int& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int byte;
+        if (!readByte (byte)) return false;
+        value |= (unsigned int) byte << shift;
+    }
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// checksum of the vehicles' states
+
+
+namespace {
+
+    void hashWord (unsigned int& hash, const unsigned int word)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            hash ^= (word >> shift) & 0xff;
+            hash *= 16777619u;
+        }
+    }
+
+    void hashVector (unsigned int& hash, const OpenSteer::Vec3& v)
+    {
+        hashWord (hash, floatBits (v.x));
+        hashWord (hash, floatBits (v.y));
+        hashWord (hash, floatBits (v.z));
+    }
+
+} // anonymous namespace
+
+
+unsigned int
+vehicleStateChecksum (const OpenSteer::AVGroup& vehicles)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        const OpenSteer::AbstractVehicle& v = *vehicles[i];
+        hashVector (hash, v.position ());
+        hashVector (hash, v.forward ());
+        hashWord (hash, floatBits (v.speed ()));
+    }
+    return hash;
+}
+
+
+// ----------------------------------------------------------------------------
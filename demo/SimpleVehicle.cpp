@@ -68,7 +68,7 @@
 // serial numbers  (XXX should this be part of a "OpenSteerDemo vehicle mixin"?)
 
 
-int SimpleVehicle::serialNumberCounter = 0;
+std::atomic<int> SimpleVehicle::serialNumberCounter (0);
 
 
 // ----------------------------------------------------------------------------
@@ -82,6 +82,9 @@ SimpleVehicle::SimpleVehicle (void)
 
     // maintain unique serial numbers
     serialNumber = serialNumberCounter++;
+
+    // give each vehicle its own (repeatable) random number stream
+    seedRandomGenerator (serialNumber);
 }
 
 
@@ -110,23 +113,8 @@ OpenSteer::Vec3
 SimpleVehicle::adjustRawSteeringForce (const OpenSteer::Vec3& force,
                                                   const float /* deltaTime */)
 {
-    const float maxAdjustedSpeed = 0.2f * maxSpeed ();
-
-    if ((speed () > maxAdjustedSpeed) || (force == OpenSteer::Vec3::zero))
-    {
-        return force;
-    }
-    else
-    {
-        const float range = speed() / maxAdjustedSpeed;
-        // const float cosine = interpolate (pow (range, 6), 1.0f, -1.0f);
-        // const float cosine = interpolate (pow (range, 10), 1.0f, -1.0f);
-        // const float cosine = interpolate (pow (range, 20), 1.0f, -1.0f);
-        // const float cosine = interpolate (pow (range, 100), 1.0f, -1.0f);
-        // const float cosine = interpolate (pow (range, 50), 1.0f, -1.0f);
-        const float cosine = OpenSteer::interpolate (pow (range, 20), 1.0f, -1.0f);
-        return limitMaxDeviationAngle (force, cosine, forward());
-    }
+    // (shared with BatchIntegrator, see OpenSteer::adjustRawSteeringForce)
+    return OpenSteer::adjustRawSteeringForce (force, forward (), speed (), maxSpeed ());
 }
 
 
@@ -166,49 +154,80 @@ void
 SimpleVehicle::applySteeringForce (const OpenSteer::Vec3& force,
                                               const float elapsedTime)
 {
+    OPENSTEER_PROFILE_ZONE ("SimpleVehicle::applySteeringForce");
 
-    const OpenSteer::Vec3 adjustedForce = adjustRawSteeringForce (force, elapsedTime);
-
-    // enforce limit on magnitude of steering force
-    const OpenSteer::Vec3 clippedForce = adjustedForce.truncateLength (maxForce ());
+    // the steps are shared with BatchIntegrator (see BatchIntegrator.h),
+    // only adjustRawSteeringForce and regenerateLocalSpace are our own
+    OpenSteer::MotionState state = motionState ();
 
-    // compute acceleration and velocity
-    OpenSteer::Vec3 newAcceleration = (clippedForce / mass());
-    OpenSteer::Vec3 newVelocity = velocity();
+    // enforce limit on magnitude of steering force, damp out abrupt changes
+    // and oscillations in steering acceleration, Euler integrate velocity
+    // (enforcing the speed limit) and position
+    const OpenSteer::Vec3 newVelocity =
+        OpenSteer::integrateSteeringForce (state,
+                                           adjustRawSteeringForce (force, elapsedTime),
+                                           elapsedTime);
+    setMotionState (state);
 
-    // damp out abrupt changes and oscillations in steering acceleration
-    // (rate is proportional to time step, then clipped into useful range)
-    if (elapsedTime > 0)
-    {
-        const float smoothRate = OpenSteer::clip (9 * elapsedTime, 0.15f, 0.4f);
-        OpenSteer::blendIntoAccumulator (smoothRate,
-                              newAcceleration,
-                              _smoothedAcceleration);
-    }
+    // regenerate local space (by default: align vehicle's forward axis with
+    // new velocity, but this behavior may be overridden by derived classes.)
+    regenerateLocalSpace (newVelocity, elapsedTime);
 
-    // Euler integrate (per frame) acceleration into velocity
-    newVelocity += _smoothedAcceleration * elapsedTime;
+    // maintain path curvature information and running average of recent
+    // positions
+    state.side = side ();
+    state.up = up ();
+    state.forward = forward ();
+    OpenSteer::measurePathCurvature (state, elapsedTime);
+    setMotionState (state);
+}
 
-    // enforce speed limit
-    newVelocity = newVelocity.truncateLength (maxSpeed ());
 
-    // update Speed
-    setSpeed (newVelocity.length());
+// ----------------------------------------------------------------------------
+// get/set the state advanced by applySteeringForce
 
-    // Euler integrate (per frame) velocity into position
-    setPosition (position() + (newVelocity * elapsedTime));
 
-    // regenerate local space (by default: align vehicle's forward axis with
-    // new velocity, but this behavior may be overridden by derived classes.)
-    regenerateLocalSpace (newVelocity, elapsedTime);
+OpenSteer::MotionState 
+SimpleVehicle::motionState (void) const
+{
+    OpenSteer::MotionState state;
+    state.side = side ();
+    state.up = up ();
+    state.forward = forward ();
+    state.position = position ();
+    state.mass = _mass;
+    state.speed = speed ();
+    state.maxForce = _maxForce;
+    state.maxSpeed = _maxSpeed;
+    state.smoothedAcceleration = _smoothedAcceleration;
+    state.smoothedPosition = _smoothedPosition;
+    state.curvature = _curvature;
+    state.smoothedCurvature = _smoothedCurvature;
+    state.lastForward = _lastForward;
+    state.lastPosition = _lastPosition;
+    state.basisTolerance = _basisTolerance;
+    return state;
+}
 
-    // maintain path curvature information
-    measurePathCurvature (elapsedTime);
 
-    // running average of recent positions
-    OpenSteer::blendIntoAccumulator (elapsedTime * 0.06f, // QQQ
-                          position (),
-                          _smoothedPosition);
+void 
+SimpleVehicle::setMotionState (const OpenSteer::MotionState& state)
+{
+    setSide (state.side);
+    setUp (state.up);
+    setForward (state.forward);
+    setPosition (state.position);
+    _mass = state.mass;
+    setSpeed (state.speed);
+    _maxForce = state.maxForce;
+    _maxSpeed = state.maxSpeed;
+    _smoothedAcceleration = state.smoothedAcceleration;
+    _smoothedPosition = state.smoothedPosition;
+    _curvature = state.curvature;
+    _smoothedCurvature = state.smoothedCurvature;
+    _lastForward = state.lastForward;
+    _lastPosition = state.lastPosition;
+    _basisTolerance = state.basisTolerance;
 }
 
 
@@ -224,7 +243,14 @@ SimpleVehicle::regenerateLocalSpace (const OpenSteer::Vec3& newVelocity,
                                                 const float /* elapsedTime */)
 {
     // adjust orthonormal basis vectors to be aligned with new velocity
-    if (speed() > 0) regenerateOrthonormalBasisUF (newVelocity / speed());
+    if (speed() > 0)
+    {
+        const OpenSteer::Vec3 newForward = newVelocity / speed();
+        if (_basisTolerance > 0)
+            lazyRegenerateOrthonormalBasisUF (newForward, _basisTolerance);
+        else
+            regenerateOrthonormalBasisUF (newForward);
+    }
 }
 
 
@@ -267,29 +293,6 @@ SimpleVehicle::regenerateLocalSpaceForBanking (const OpenSteer::Vec3& newVelocit
 }
 
 
-// ----------------------------------------------------------------------------
-// measure path curvature (1/turning-radius), maintain smoothed version
-
-
-void 
-SimpleVehicle::measurePathCurvature (const float elapsedTime)
-{
-    if (elapsedTime > 0)
-    {
-        const OpenSteer::Vec3 dP = _lastPosition - position ();
-        const OpenSteer::Vec3 dF = (_lastForward - forward ()) / dP.length ();
-        const OpenSteer::Vec3 lateral = dF.perpendicularComponent (forward ());
-        const float sign = (lateral.dot (side ()) < 0) ? 1.0f : -1.0f;
-        _curvature = lateral.length() * sign;
-        OpenSteer::blendIntoAccumulator (elapsedTime * 4.0f,
-                              _curvature,
-                              _smoothedCurvature);
-        _lastForward = forward ();
-        _lastPosition = position ();
-    }
-}
-
-
 // ----------------------------------------------------------------------------
 // draw lines from vehicle's position showing its velocity and acceleration
 
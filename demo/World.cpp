@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// World: one independent simulation, a private instance of a PlugIn with
+// its own clock (see World.h)
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "World.h"
+#include "Annotation.h"
+#include <cassert>
+
+
+// ----------------------------------------------------------------------------
+// make a World for a new instance of a registered PlugIn
+
+
+World*
+World::make (PlugIn& prototype, OpenSteer::ThreadPool* threadPool)
+{
+    PlugIn* instance = prototype.makeWorldInstance ();
+    if (instance == NULL) return NULL;
+    return new World (instance, threadPool);
+}
+
+
+World::World (PlugIn* plugIn, OpenSteer::ThreadPool* threadPool)
+    : instance (plugIn), pool (threadPool), simulationTime (0), frames (0)
+{
+    instance->myWorld = this;
+    instance->open ();
+}
+
+
+World::~World ()
+{
+    instance->close ();
+    delete instance;
+}
+
+
+// ----------------------------------------------------------------------------
+// advance the clock of this World and update its PlugIn
+
+
+void
+World::step (const float elapsedTime)
+{
+    // annotation is collected in buffers shared by all vehicles
+    assert (!annotationIsOn () && "Worlds run without annotation");
+    OPENSTEER_PROFILE_ZONE ("World::step");
+
+    simulationTime += elapsedTime;
+    frames++;
+    instance->update (simulationTime, elapsedTime);
+}
+
+
+// ----------------------------------------------------------------------------
+// step several Worlds side by side
+
+
+void
+World::stepAll (const std::vector<World*>& worlds,
+                const float elapsedTime,
+                OpenSteer::ThreadPool* threadPool)
+{
+    const size_t count = worlds.size ();
+    if (threadPool == NULL)
+    {
+        for (size_t i = 0; i < count; i++) worlds[i]->step (elapsedTime);
+        return;
+    }
+
+    // one World per task, the parallel phases inside each World's update
+    // are spread over the same threads as nested loops
+    threadPool->parallelFor (count,
+                             [&worlds, elapsedTime] (size_t begin, size_t end)
+                             {
+                                 for (size_t i = begin; i < end; i++)
+                                     worlds[i]->step (elapsedTime);
+                             },
+                             1);
+}
+
+
+// ----------------------------------------------------------------------------
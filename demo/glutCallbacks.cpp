@@ -47,11 +47,13 @@
 #include "Annotation.h"
 //#include "Color.h"
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/Profiler.h"
 
 #include <algorithm>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 // Include headers for OpenGL (gl.h), OpenGL Utility Library (glu.h) and
 // OpenGL Utility Toolkit (glut.h).
@@ -183,6 +185,7 @@
             // mouse-left (with no modifiers): select vehicle
             if (modNone && mouseL)
             {
+                OpenSteerDemo::finishPipelinedUpdate ();
                 OpenSteerDemo::selectVehicleNearestScreenPosition (x, y);
             }
 
@@ -378,6 +381,26 @@
     }
 
 
+    // ----------------------------------------------------------------------------
+    // helper for drawDisplayFPS: percentiles (in milliseconds) and stalls of
+    // the times in a LatencyWindow
+
+
+    void 
+    writeLatencyReportToStream (const OpenSteer::LatencyWindow& times,
+                                std::ostringstream& stream)
+    {
+        const OpenSteer::LatencyHistogram histogram = times.histogram ();
+        const double ms = 1000;
+        stream << std::setprecision (2) << std::setiosflags (std::ios::fixed);
+        stream << "p50 " << ms * histogram.percentile (0.50);
+        stream << "  p95 " << ms * histogram.percentile (0.95);
+        stream << "  p99 " << ms * histogram.percentile (0.99);
+        stream << "  max " << ms * histogram.max ();
+        stream << "  stalls " << times.stallCount () << "\n";
+    }
+
+
     // ----------------------------------------------------------------------------
     // draw text showing (smoothed, rounded) "frames per second" rate
     // (and later a bunch of related stuff was dumped here, a reorg would be nice)
@@ -473,7 +496,6 @@
             OpenSteer::blendIntoAccumulator (smoothRate, pto, gSmoothedTimerOverhead);
 
             // display phase timer information
-            screenLocation.y += lh * 4;
             std::ostringstream timerStr;
             timerStr << "update: ";
             writePhaseTimerReportToStream (gSmoothedTimerUpdate, timerStr);
@@ -481,12 +503,112 @@
             writePhaseTimerReportToStream (gSmoothedTimerDraw, timerStr);
             timerStr << "other:  ";
             writePhaseTimerReportToStream (gSmoothedTimerOverhead, timerStr);
+
+            // in pipelined mode "update" is the wait for the pipeline thread
+            if (OpenSteerDemo::pipelineIsActive ())
+            {
+                timerStr << "pipelined: update " << std::setprecision (3)
+                         << 1000 * OpenSteerDemo::pipelinedUpdateTime ()
+                         << " ms alongside draw, waited "
+                         << 1000 * OpenSteerDemo::pipelineWaitTime ()
+                         << " ms\n";
+            }
+            else if (OpenSteerDemo::getPipelinedMode ())
+            {
+                timerStr << "pipelined: not supported by this PlugIn\n";
+            }
+
+            // in real-time fixed frame rate mode: how late frames start
+            if ((! OpenSteerDemo::clock.getAnimationMode ()) &&
+                (! OpenSteerDemo::clock.getVariableFrameRateMode ()))
+            {
+                timerStr << "pacing: "
+                         << (OpenSteerDemo::clock.getSleepPacing () ? "sleep+spin" : "spin")
+                         << std::setprecision (3)
+                         << ", jitter " << 1000 * OpenSteerDemo::clock.getSmoothedPacingJitter ()
+                         << " ms (max " << 1000 * OpenSteerDemo::clock.getMaxPacingJitter ()
+                         << " ms)\n";
+            }
+
+            // tail of the frame and phase time distributions
+            timerStr << "frame ms:  ";
+            writeLatencyReportToStream (OpenSteerDemo::clock.getFrameTimes (), timerStr);
+            timerStr << "update ms: ";
+            writeLatencyReportToStream (OpenSteerDemo::phaseTimesUpdate (), timerStr);
+            timerStr << "draw ms:   ";
+            writeLatencyReportToStream (OpenSteerDemo::phaseTimesDraw (), timerStr);
+
+            // place the lines above the clock line
+            const std::string timerLines = timerStr.str ();
+            const int lineCount = (int) std::count (timerLines.begin (), timerLines.end (), '\n');
+            screenLocation.y += lh * (lineCount + 1);
             timerStr << std::ends;
             draw2dTextAt2dLocation (timerStr, screenLocation, OpenSteer::gGreen, drawGetWindowWidth(), drawGetWindowHeight());
         }
     }
 
 
+    // ------------------------------------------------------------------------
+    // draw per-zone breakdown of the profiler in lower righthand corner of
+    // screen (only while the profiler is enabled, toggled by the "p" key)
+    //
+    // the statistics are collected and reset every profilerReportFrames
+    // frames, so the numbers are averages over the last few frames
+
+
+    const int profilerReportFrames = 30;
+    std::vector<OpenSteer::ProfileZoneStatistics> gProfilerReport;
+    size_t gProfilerReportFrames = 0;
+
+    void
+    drawDisplayProfiler (void)
+    {
+        if (! OpenSteer::Profiler::enabled ()) return;
+
+        // take a new snapshot when enough frames were collected
+        const size_t frames = OpenSteer::Profiler::frameCount ();
+        if (frames >= (size_t) profilerReportFrames)
+        {
+            gProfilerReport = OpenSteer::Profiler::statistics ();
+            gProfilerReportFrames = frames;
+            OpenSteer::Profiler::resetStatistics ();
+        }
+        if (gProfilerReportFrames == 0) return;
+
+        // one line per zone, indented by nesting depth: milliseconds per
+        // frame (total and without nested zones) and calls per frame
+        const int lh = 16; // xxx line height
+        const float perFrame = 1.0f / gProfilerReportFrames;
+        std::ostringstream report;
+        const size_t nameWidth = 36;
+        report << std::setiosflags (std::ios::fixed)
+               << std::left << std::setw (nameWidth) << "zone" << std::right
+               << std::setw (7) << "ms" << " "
+               << std::setw (7) << "self" << " "
+               << std::setw (7) << "calls" << "\n";
+        for (size_t i = 0; i < gProfilerReport.size (); i++)
+        {
+            const OpenSteer::ProfileZoneStatistics& zone = gProfilerReport[i];
+            std::string name (2 * zone.depth, ' ');
+            name += zone.name;
+            name.resize (nameWidth, ' ');
+            report << name
+                   << std::setprecision (3)
+                   << std::setw (7) << 1000 * zone.seconds * perFrame << " "
+                   << std::setw (7) << 1000 * zone.selfSeconds * perFrame << " "
+                   << std::setprecision (1)
+                   << std::setw (7) << zone.calls * perFrame << "\n";
+        }
+        report << std::ends;
+
+        const int lines = (int) gProfilerReport.size () + 1;
+        const OpenSteer::Vec3 screenLocation (drawGetWindowWidth () - 560,
+                                              10 + lh * (lines - 1),
+                                              0);
+        draw2dTextAt2dLocation (report, screenLocation, OpenSteer::gGreen, drawGetWindowWidth(), drawGetWindowHeight());
+    }
+
+
     // ------------------------------------------------------------------------
     // cycle through frame rate presets  (XXX move this to OpenSteerDemo)
 
@@ -526,6 +648,11 @@
             OpenSteerDemo::clock.setVariableFrameRateMode (true);
             break;
         }
+
+        // start pacing and frame time statistics over for the new frame rate
+        OpenSteerDemo::clock.resetPacingStatistics ();
+        OpenSteerDemo::clock.resetFrameTimes ();
+        OpenSteerDemo::resetPhaseTimes ();
     }
 
 
@@ -542,6 +669,9 @@
     {
         std::ostringstream message;
 
+        // commands change what the pipelined update reads: let it finish
+        OpenSteerDemo::finishPipelinedUpdate ();
+
         // ascii codes
         const int tab = 9;
         const int space = 32;
@@ -613,6 +743,22 @@
             OpenSteerDemo::printMessage (message);
             break;
 
+        // toggle profiler and its per-zone breakdown
+        case 'p':
+            OpenSteer::Profiler::setEnabled (! OpenSteer::Profiler::enabled ());
+            OpenSteer::Profiler::resetStatistics ();
+            gProfilerReportFrames = 0;
+            OpenSteerDemo::printMessage (OpenSteer::Profiler::enabled () ?
+                                         "profiler ON" : "profiler OFF");
+            break;
+
+        // toggle pipelined update and draw
+        case 'u':
+            OpenSteerDemo::printMessage (OpenSteerDemo::togglePipelinedMode () ?
+                                         "pipelined update/draw ON" :
+                                         "pipelined update/draw OFF");
+            break;
+
         // print minimal help for single key commands
         case '?':
             OpenSteerDemo::keyboardMiniHelp ();
@@ -646,6 +792,9 @@
     {
         std::ostringstream message;
 
+        // commands change what the pipelined update reads: let it finish
+        OpenSteerDemo::finishPipelinedUpdate ();
+
         switch (key)
         {
         case GLUT_KEY_F1:  OpenSteerDemo::functionKeyForPlugIn (1);  break;
@@ -690,6 +839,9 @@
         // draw text showing (smoothed, rounded) "frames per second" rate
         drawDisplayFPS ();
 
+        // draw per-zone profiler breakdown (when enabled)
+        drawDisplayProfiler ();
+
         // draw the name of the selected PlugIn
         drawDisplayPlugInName ();
 
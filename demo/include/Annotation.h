@@ -34,6 +34,18 @@
 // graphical annotation functionality to a given base class, which is
 // typically something that supports the AbstractVehicle interface.
 //
+// When built with OPENSTEER_NO_ANNOTATION defined the annotation functions
+// do nothing and no trail is recorded (no trail buffers are allocated), so
+// vehicles can keep their annotation calls at no cost.
+//
+// Vehicles created by OpenSteer::Arena::create allocate their trail buffers
+// from that arena, right behind the vehicle, instead of from the heap, and
+// release them to the arena for reuse when destroyed.  The arena is found
+// with OpenSteer::Arena::creating, so only the created object itself (or a
+// vehicle it holds as a member) uses it: a vehicle its constructor makes
+// with plain new gets heap buffers, which stay valid after the arena is
+// cleared.
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 04-01-03 cwr: made into a mixin
 // 07-01-02 cwr: created (as Annotation.h) 
@@ -50,10 +62,16 @@
 #endif // NOT_OPENSTEERDEMO
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/UnusedParameter.h"
+#include "OpenSteer/Arena.h"
 
 // ----------------------------------------------------------------------------
     extern bool enableAnnotation;
-    extern bool drawPhaseActive;
+
+    // per thread: in pipelined mode (see OpenSteerDemo::setPipelinedMode)
+    // updates run on another thread than redraws, their annotation is
+    // always deferred
+    extern thread_local bool drawPhaseActive;
 
     // graphical annotation: master on/off switch
     inline bool annotationIsOn (void) {return enableAnnotation;}
@@ -202,6 +220,7 @@
 
         // trails
         int trailVertexCount;       // number of vertices in array (ring buffer)
+        int trailCapacity;          // number of vertices allocated
         int trailIndex;             // array index of most recently recorded point
         float trailDuration;        // duration (in seconds) of entire trail
         float trailSampleInterval;  // desired interval between taking samples
@@ -210,6 +229,8 @@
         OpenSteer::Vec3 curPosition;           // last reported position of vehicle
         OpenSteer::Vec3* trailVertices;        // array (ring) of recent points along trail
         char* trailFlags;           // array (ring) of flag bits for trail points
+        OpenSteer::Arena* trailArena;  // owner of the arrays, NULL: the heap
+                                       // (arena must outlive this vehicle)
     };
 
 
@@ -222,6 +243,11 @@ AnnotationMixin<Super>::AnnotationMixin (void)
 {
     trailVertices = NULL;
     trailFlags = NULL;
+    trailCapacity = 0;
+
+    // when created by an arena allocate the trail from it as well (only if
+    // this vehicle is the object being created, see comment at top of file)
+    trailArena = OpenSteer::Arena::creating (this);
 
     // xxx I wonder if it makes more sense to NOT do this here, see if the
     // xxx vehicle class calls it to set custom parameters, and if not, set
@@ -235,14 +261,23 @@ AnnotationMixin<Super>::AnnotationMixin (void)
 template<class Super>
 AnnotationMixin<Super>::~AnnotationMixin (void)
 {
-    delete[] trailVertices;
-    delete[] trailFlags;
+    if (trailArena == NULL)
+    {
+        delete[] trailVertices;
+        delete[] trailFlags;
+    }
+    else
+    {
+        trailArena->releaseArray (trailVertices, trailCapacity);
+        trailArena->releaseArray (trailFlags, trailCapacity);
+    }
 }
 
 
 // ----------------------------------------------------------------------------
 // set trail parameters: the amount of time it represents and the number of
-// samples along its length.  re-allocates internal buffers.
+// samples along its length.  re-allocates internal buffers if they are too
+// small.
 
 
 template<class Super>
@@ -260,16 +295,35 @@ AnnotationMixin<Super>::setTrailParameters (const float duration,
     trailSampleInterval = trailDuration / trailVertexCount;
     trailDottedPhase = 1;
 
-    // prepare trailVertices array: free old one if needed, allocate new one
-    delete[] trailVertices;
-    trailVertices = new OpenSteer::Vec3[trailVertexCount];
-
-    // prepare trailFlags array: free old one if needed, allocate new one
-    delete[] trailFlags;
-    trailFlags = new char[trailVertexCount];
+#ifndef OPENSTEER_NO_ANNOTATION
+    // prepare trailVertices and trailFlags arrays: keep the old ones if
+    // large enough, otherwise free (or release to the arena) them if
+    // needed and allocate new ones
+    if (trailVertexCount > trailCapacity)
+    {
+        if (trailArena != NULL)
+        {
+            trailArena->releaseArray (trailVertices, trailCapacity);
+            trailArena->releaseArray (trailFlags, trailCapacity);
+        }
+        trailCapacity = trailVertexCount;
+        if (trailArena != NULL)
+        {
+            trailVertices = trailArena->allocateArray<OpenSteer::Vec3> (trailCapacity);
+            trailFlags = trailArena->allocateArray<char> (trailCapacity);
+        }
+        else
+        {
+            delete[] trailVertices;
+            trailVertices = new OpenSteer::Vec3[trailCapacity];
+            delete[] trailFlags;
+            trailFlags = new char[trailCapacity];
+        }
+    }
 
     // initializing all flags to zero means "do not draw this segment"
     for (int i = 0; i < trailVertexCount; i++) trailFlags[i] = 0;
+#endif // OPENSTEER_NO_ANNOTATION
 }
 
 
@@ -298,6 +352,7 @@ void
 AnnotationMixin<Super>::recordTrailVertex (const float currentTime,
                                                       const OpenSteer::Vec3& position)
 {
+#ifndef OPENSTEER_NO_ANNOTATION
     const float timeSinceLastTrailSample = currentTime - trailLastSampleTime;
     if (timeSinceLastTrailSample > trailSampleInterval)
     {
@@ -310,6 +365,10 @@ AnnotationMixin<Super>::recordTrailVertex (const float currentTime,
         trailLastSampleTime = currentTime;
     }
     curPosition = position;
+#else
+    OPENSTEER_UNUSED_PARAMETER (currentTime);
+    OPENSTEER_UNUSED_PARAMETER (position);
+#endif // OPENSTEER_NO_ANNOTATION
 }
 
 
@@ -322,6 +381,7 @@ void
 AnnotationMixin<Super>::drawTrail (const OpenSteer::Color& trailColor,
                                               const OpenSteer::Color& tickColor)
 {
+#ifndef OPENSTEER_NO_ANNOTATION
     if (enableAnnotation)
     {
         int index = trailIndex;
@@ -361,6 +421,10 @@ AnnotationMixin<Super>::drawTrail (const OpenSteer::Color& trailColor,
             index = next;
         }
     }
+#else
+    OPENSTEER_UNUSED_PARAMETER (trailColor);
+    OPENSTEER_UNUSED_PARAMETER (tickColor);
+#endif // OPENSTEER_NO_ANNOTATION
 }
 
 
@@ -372,7 +436,7 @@ AnnotationMixin<Super>::drawTrail (const OpenSteer::Color& trailColor,
 // segment is queued to be drawn during OpenSteerDemo's redraw phase.
 
 
-#ifndef NOT_OPENSTEERDEMO  // only when building OpenSteerDemo
+#if ! defined (NOT_OPENSTEERDEMO) && ! defined (OPENSTEER_NO_ANNOTATION)
 template<class Super>
 void 
 AnnotationMixin<Super>::annotationLine (const OpenSteer::Vec3& startPoint,
@@ -393,8 +457,8 @@ AnnotationMixin<Super>::annotationLine (const OpenSteer::Vec3& startPoint,
 }
 #else
 template<class Super> void AnnotationMixin<Super>::annotationLine
- (const OpenSteer::Vec3&, const OpenSteer::Vec3&, const OpenSteer::Vec3&) const {}
-#endif // NOT_OPENSTEERDEMO
+ (const OpenSteer::Vec3&, const OpenSteer::Vec3&, const OpenSteer::Color&) const {}
+#endif // NOT_OPENSTEERDEMO, OPENSTEER_NO_ANNOTATION
 
 
 // ----------------------------------------------------------------------------
@@ -405,7 +469,7 @@ template<class Super> void AnnotationMixin<Super>::annotationLine
 // "circle or disk" is queued to be drawn during OpenSteerDemo's redraw phase.
 
 
-#ifndef NOT_OPENSTEERDEMO  // only when building OpenSteerDemo
+#if ! defined (NOT_OPENSTEERDEMO) && ! defined (OPENSTEER_NO_ANNOTATION)
 template<class Super>
 void 
 AnnotationMixin<Super>::annotationCircleOrDisk (const float radius,
@@ -433,9 +497,9 @@ AnnotationMixin<Super>::annotationCircleOrDisk (const float radius,
 #else
 template<class Super>
 void AnnotationMixin<Super>::annotationCircleOrDisk
-(const float, const OpenSteer::Vec3&, const OpenSteer::Vec3&, const OpenSteer::Vec3&, const int,
+(const float, const OpenSteer::Vec3&, const OpenSteer::Vec3&, const OpenSteer::Color&, const int,
  const bool, const bool) const {}
-#endif // NOT_OPENSTEERDEMO
+#endif // NOT_OPENSTEERDEMO, OPENSTEER_NO_ANNOTATION
 
 
 // ----------------------------------------------------------------------------
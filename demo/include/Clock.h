@@ -41,6 +41,15 @@
 // Usage: allocate a clock, set its "paused" or "targetFPS" parameters, then
 // call updateGlobalSimulationClock before each simulation step.
 //
+// In fixed frame rate real-time mode the wait for the next frame boundary
+// sleeps for most of the time and only spins for the last moment (see
+// setSleepPacing), and the lateness of each frame start is kept as "pacing
+// jitter" statistics.
+//
+// The frame times of the last frames are kept in a fixed memory histogram
+// for percentiles and stall counts (see getFrameTimes), the tail of the
+// frame time distribution shows hitches the smoothed FPS averages away.
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 11-11-03 cwr: another overhaul: support aniamtion mode, switch to
 //               functional API, move smoothed stats inside this class
@@ -55,12 +64,8 @@
 #define OPENSTEER_CLOCK_H
 
 #include "OpenSteer/Utilities.h"
-
-#if defined (_XBOX)
-	#include <xtl.h>
-#elif defined (_WIN32)
-	#include <windows.h>
-#endif
+#include "OpenSteer/LatencyHistogram.h"
+#include <chrono>
 
     class Clock
     {
@@ -116,6 +121,44 @@
         bool setPausedState (bool newPS) {return paused = newPS;};
 
 
+        // how frameRateSync waits for the next frame boundary: sleep until
+        // pacingSpinMargin seconds before it, then spin (default), or spin
+        // for the whole wait (burns a full core, but never oversleeps).  The
+        // margin covers the wake-up latency of the operating system.
+    private:
+        bool sleepPacing;
+        float pacingSpinMargin;
+    public:
+        bool getSleepPacing (void) {return sleepPacing;}
+        bool setSleepPacing (bool sp) {return sleepPacing = sp;}
+
+        float getPacingSpinMargin (void) {return pacingSpinMargin;}
+        float setPacingSpinMargin (float psm) {return pacingSpinMargin = psm;}
+
+
+        // pacing jitter: how late (in seconds) frameRateSync returned after
+        // the frame boundary it waited for, for the latest frame, smoothed,
+        // and mean and maximum since the last resetPacingStatistics
+    private:
+        float pacingJitter;
+        float smoothedPacingJitter;
+        float maxPacingJitter;
+        double totalPacingJitter;
+        int pacedFrameCount;
+        void recordPacingJitter (const float jitter);
+    public:
+        float getPacingJitter (void) const {return pacingJitter;}
+        float getSmoothedPacingJitter (void) const {return smoothedPacingJitter;}
+        float getMaxPacingJitter (void) const {return maxPacingJitter;}
+        float getMeanPacingJitter (void) const
+        {
+            if (pacedFrameCount == 0) return 0;
+            return (float) (totalPacingJitter / pacedFrameCount);
+        }
+        int getPacedFrameCount (void) const {return pacedFrameCount;}
+        void resetPacingStatistics (void);
+
+
         // clock keeps track of "smoothed" running average of recent frame rates.
         // When a fixed frame rate is used, a running average of "CPU load" is
         // kept (aka "non-wait time", the percentage of each frame time (time
@@ -145,6 +188,23 @@
         }
 
 
+        // real time between updates over the last frameTimeWindowFrames
+        // frames.  A frame counts as a stall when it took more than 1.5
+        // target frame times (1/60 second in variable frame rate mode), at a
+        // fixed frame rate that is a missed frame boundary.
+    private:
+        OpenSteer::LatencyWindow frameTimes;
+    public:
+        static const int frameTimeWindowFrames;
+        const OpenSteer::LatencyWindow& getFrameTimes (void) const {return frameTimes;}
+        void resetFrameTimes (void) {frameTimes.clear ();}
+        float getTargetFrameTime (void)
+        {
+            if (getVariableFrameRateMode ()) return 1.0f / 60;
+            return 1.0f / getFixedFrameRate ();
+        }
+
+
         // clock state member variables and public accessors for them
     private:
         // real "wall clock" time since launch
@@ -184,15 +244,10 @@
         // "manually" advance clock by this amount on next update
         float newAdvanceTime;
 
-        // "Calendar time" when this clock was first updated
-    #ifdef _WIN32
-        // from QueryPerformanceCounter on Windows
-        LONGLONG basePerformanceCounter;
-    #else
-        // from gettimeofday on Linux and Mac OS X
-        int baseRealTimeSec;
-        int baseRealTimeUsec;
-    #endif
+        // monotonic high resolution time when this clock was first updated
+        typedef std::chrono::steady_clock RealTimeClock;
+        RealTimeClock::time_point baseRealTime;
+        bool baseRealTimeRecorded;
     };
 
 
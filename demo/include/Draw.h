@@ -68,7 +68,8 @@
     // false otherwise.
     // it has been externed as a first step in making the Draw library useful from
     // other applications besides OpenSteerDemo
-    extern bool updatePhaseActive;
+    // (per thread, like drawPhaseActive in Annotation.h)
+    extern thread_local bool updatePhaseActive;
 
     inline void warnIfInUpdatePhase (const char* name)
     {
@@ -332,6 +333,11 @@
     void drawAllDeferredLines (void);
     void drawAllDeferredCirclesOrDisks (void);
 
+    // hand the lines and circles deferred so far over to the drawAll
+    // functions, later ones wait for the next call (called between the
+    // update and the redraw of a frame)
+    void publishDeferredDrawing (void);
+
 
     // ------------------------------------------------------------------------
     // Draw a single OpenGL triangle given three OpenSteer::Vec3 vertices.
@@ -53,6 +53,7 @@
 #include "Camera.h"
 #include "OpenSteer/Utilities.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/ThreadPool.h"
 
     class OpenSteerDemo
     {
@@ -65,6 +66,14 @@
         // camera automatically tracks selected vehicle
         static Camera camera;
 
+        // worker threads for the steering phase of the PlugIns' updates
+        // (see OpenSteer/ParallelUpdate.h), one per hardware thread
+        static OpenSteer::ThreadPool threadPool;
+
+        // pool for the steering phase: NULL (steer on this thread) while
+        // annotation is on, as annotation is collected in shared buffers
+        static OpenSteer::ThreadPool* updateThreadPool (void);
+
         // ------------------------------------------ addresses of selected objects
 
         // currently selected plug-in (user can choose or cycle through them)
@@ -141,6 +150,15 @@
                     (phaseTimerDraw() + phaseTimerUpdate()));
         }
 
+        // update and draw phase times of the last frames (same window as
+        // Clock::getFrameTimes), a phase taking longer than the target frame
+        // time counts as a stall
+        static const OpenSteer::LatencyWindow& phaseTimesDraw (void)
+            {return drawPhaseTimes;}
+        static const OpenSteer::LatencyWindow& phaseTimesUpdate (void)
+            {return updatePhaseTimes;}
+        static void resetPhaseTimes (void);
+
         // ------------------------------------------------------ delayed reset XXX
 
         // XXX to be reconsidered
@@ -155,6 +173,68 @@
         // select vehicle nearest the given screen position (e.g.: of the mouse)
         static void selectVehicleNearestScreenPosition (int x, int y);
 
+        // ------------------------------------------------------ pipelined mode
+
+        // in pipelined mode the update of the next frame runs on a pipeline
+        // thread while the main thread draws the current frame from the
+        // PlugIn's snapshot (see PlugIn::snapshotForRedraw), so a frame
+        // takes about the longer of update and draw instead of their sum.
+        // What is drawn lags the simulation by one update.  PlugIns without
+        // snapshots are updated and drawn in turn as before.
+        static void setPipelinedMode (bool pipelined);
+        static bool getPipelinedMode (void);
+        static bool togglePipelinedMode (void);
+
+        // true if the last frame's update ran alongside its redraw
+        static bool pipelineIsActive (void);
+
+        // wait for the pipelined update in flight, if any.  Call before
+        // changing anything an update reads: the PlugIn, its settings, the
+        // selected vehicle, annotation or profiler state.
+        static void finishPipelinedUpdate (void);
+
+        // time the last pipelined update took on the pipeline thread, and
+        // the part of it the main thread waited for after drawing
+        static float pipelinedUpdateTime (void);
+        static float pipelineWaitTime (void);
+
+        // ------------------------------------------------ recording and replay
+
+        // log the run from now on to "fileName" (see Recording.h): seeds the
+        // global rand with a fresh seed, then records every PlugIn opened,
+        // the commands changing the simulation and the time of every frame.
+        // Start before the first PlugIn is opened.  Returns false if the
+        // file can't be written.
+        static bool startRecording (const char* fileName);
+        static void stopRecording (void);
+        static bool isRecording (void);
+        static int recordedFrameCount (void);
+
+        // replay the run recorded in "fileName": seeds the global rand like
+        // the recorded run, replayNextFrame then repeats it frame by frame.
+        // Returns false if the file can't be read.
+        static bool startReplay (const char* fileName);
+        static bool isReplaying (void);
+
+        // apply the recorded commands preceding the next frame (the first
+        // call opens the recorded PlugIn), returns false at the end
+        static bool replayCommands (void);
+
+        // apply the recorded commands, then update the selected PlugIn with
+        // the recorded time of the next frame and compare the vehicle state
+        // checksum with the recorded one.  Returns false (and ends the
+        // replay) at the end of the recording.
+        static bool replayNextFrame (void);
+
+        // frames replayed so far, and the first of them whose vehicle states
+        // differ from the recording (-1 if none)
+        static int replayedFrameCount (void);
+        static int firstDivergentFrame (void);
+
+        // change the population of the selected PlugIn (see
+        // PlugIn::setPopulation), recorded like the other commands
+        static bool setPopulationOfSelectedPlugIn (int count);
+
         // ---------------------------------------------------------- mouse support
 
         // Find the AbstractVehicle whose screen position is nearest the
@@ -162,10 +242,15 @@
         // this window or if there are no AbstractVehicles.
         static OpenSteer::AbstractVehicle* vehicleNearestToMouse (void);
 
+        // same among "vehicles", e.g. the VehicleSnapshots a PlugIn draws
+        static OpenSteer::AbstractVehicle* vehicleNearestToMouse (const OpenSteer::AVGroup& vehicles);
+
         // Find the AbstractVehicle whose screen position is nearest the
         // given window coordinates, typically the mouse position.  Note
         // this will return NULL if there are no AbstractVehicles.
         static OpenSteer::AbstractVehicle* findVehicleNearestScreenPosition (int x, int y);
+        static OpenSteer::AbstractVehicle* findVehicleNearestScreenPosition (int x, int y,
+                                                                              const OpenSteer::AVGroup& vehicles);
 
         // for storing most recent mouse state
         static int mouseX;
@@ -261,6 +346,9 @@
         static void popPhase (void);
         static void initPhaseTimers (void);
         static void updatePhaseTimers (void);
+        static OpenSteer::LatencyWindow drawPhaseTimes;
+        static OpenSteer::LatencyWindow updatePhaseTimes;
+        static void recordPhaseTimes (void);
 
         // XXX apparently MS VC6 cannot handle initialized static const members,
         // XXX so they have to be initialized not-inline.
@@ -56,6 +56,9 @@ class FooPlugIn : public PlugIn
 
     // optional methods (see comments in AbstractPlugIn for explanation):
     void reset (void) {...} // default is to reset by doing close-then-open
+    bool setPopulation (int count) {...} // default is a fixed population
+    PlugIn* makeWorldInstance (void) {...} // default: no Worlds (World.h)
+    bool snapshotForRedraw (void) {...} // default: no pipelined redraw
     float selectionOrderSortKey (void) {return 1234;}
     bool requestInitialSelection (void) {return true;}
     void handleFunctionKeys (int keyNumber) {...} // fkeys reserved for PlugIns
@@ -74,10 +77,15 @@ FooPlugIn gFooPlugIn;
 
 #include <iostream>
 #include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/ThreadPool.h"
 
 
 // ----------------------------------------------------------------------------
 
+    class PlugIn;
+    class World;
+
+
     class AbstractPlugIn
     {
     public:
@@ -114,6 +122,24 @@ FooPlugIn gFooPlugIn;
         // return an AVGroup (an STL vector of AbstractVehicle pointers) of
         // all vehicles(/agents/characters) defined by the PlugIn
         virtual const OpenSteer::AVGroup& allVehicles (void) = 0;
+
+        // add or remove vehicles until there are "count" of them (used by
+        // the headless runner), returns false if the PlugIn does not support
+        // changing its population
+        virtual bool setPopulation (int count) = 0;
+
+        // returns a new, unregistered instance of this PlugIn to run in a
+        // World (see World.h), or NULL if the PlugIn keeps state in globals
+        // and so can't run in several Worlds side by side
+        virtual PlugIn* makeWorldInstance (void) = 0;
+
+        // pipelined mode (see OpenSteerDemo::setPipelinedMode) draws frame
+        // N while the update of frame N+1 runs on another thread.  Called
+        // on the main thread after each update, this copies everything
+        // redraw reads that update changes (e.g. the vehicles' poses into
+        // VehicleSnapshots, see VehicleSnapshot.h).  Returns false if
+        // redraw reads the live state, then update and redraw run in turn.
+        virtual bool snapshotForRedraw (void) = 0;
     };
 
 
@@ -126,8 +152,12 @@ FooPlugIn gFooPlugIn;
         typedef void (* timestepCallBackFunction) (const float currentTime,
                                                    const float elapsedTime);
 
+        // whether a new PlugIn is added to the registry: the singletons
+        // are, instances made for Worlds are not
+        enum Registration {registered, unregistered};
+
         // constructor
-        PlugIn (void);
+        PlugIn (Registration registration = registered);
 
         // destructor
         virtual ~PlugIn();
@@ -150,6 +180,28 @@ FooPlugIn gFooPlugIn;
 
         const char* getFunctionKeyHelp(int /*keyNumber*/) { return NULL; }
 
+        // default population: fixed
+        bool setPopulation (int /*count*/) {return false;}
+
+        // default: can't run in Worlds
+        PlugIn* makeWorldInstance (void) {return NULL;}
+
+        // default: redraw reads the live state, no pipelining
+        bool snapshotForRedraw (void) {return false;}
+
+        // the World this instance runs in, NULL for the registered ones
+        // which run in OpenSteerDemo
+        World* world (void) {return myWorld;}
+
+        // only PlugIns running in OpenSteerDemo may use its camera, selected
+        // vehicle and messages, the ones in Worlds have no display
+        bool ownsDisplay (void) {return myWorld == NULL;}
+
+        // threads for the parallel phases of update (see
+        // OpenSteer/ParallelUpdate.h): the World's or OpenSteerDemo's,
+        // NULL to run them on the calling thread
+        OpenSteer::ThreadPool* updateThreadPool (void);
+
         // returns pointer to the next PlugIn in "selection order"
         PlugIn* next (void);
 
@@ -176,6 +228,10 @@ FooPlugIn gFooPlugIn;
 
     private:
 
+        // set by World for the instances it runs
+        friend class World;
+        World* myWorld;
+
         // save this instance in the class's registry of instances
         void addToRegistry (void);
 
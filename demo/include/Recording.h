@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Recording: compact binary log of a simulation run, for replaying it
+// bit for bit
+//
+// A run is reproducible from its inputs: the seed of the global rand (the
+// per-vehicle RandomGenerators are seeded from serial numbers), the
+// selected PlugIns, the user's commands that change the simulation
+// (function keys, reset, vehicle selection, population) and the simulation
+// time of every frame.  RecordingWriter logs these as they happen, each
+// command before the frame it precedes, and a checksum of the vehicle
+// states after every frame.  RecordingReader returns them in the same
+// order, comparing the checksums tells where a replay diverged.
+//
+// Layout (little endian): "OSRP", version byte, seed (uint32), then one
+// record per event: a tag byte and its payload.
+//
+//     'P' plugin selected      uint16 name length, name bytes
+//     'K' function key         uint8 key number
+//     'R' reset
+//     'V' vehicle selected     int32 index in allVehicles (-1: none)
+//     'N' population           int32 vehicle count
+//     'F' frame                float32 current time, float32 elapsed time,
+//                              uint32 vehicle state checksum
+//
+// Times are stored with their exact bits, 12 bytes per frame.  Annotation
+// and camera state are not recorded: they only change what is drawn.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_RECORDING_H
+#define OPENSTEER_RECORDING_H
+
+#include <fstream>
+#include <string>
+#include "OpenSteer/AbstractVehicle.h"
+
+
+    // one entry of a recording
+
+
+    struct RecordedEvent
+    {
+        enum Type {plugInSelected, functionKey, reset, vehicleSelected,
+                   population, frame};
+
+        Type type;
+        std::string name;          // plugInSelected: PlugIn name
+        int value;                 // functionKey, vehicleSelected, population
+        float currentTime;         // frame
+        float elapsedTime;         // frame
+        unsigned int checksum;     // frame
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class RecordingWriter
+    {
+    public:
+
+        RecordingWriter () : frames (0) {}
+
+        // start a new recording file, returns false if it can't be written
+        bool open (const char* fileName, const unsigned int seed);
+        void close (void);
+        bool isOpen (void) const {return file.is_open ();}
+
+        // log one event
+        void plugInSelected (const char* name);
+        void functionKey (const int keyNumber);
+        void reset (void);
+        void vehicleSelected (const int index);
+        void population (const int count);
+        void frame (const float currentTime,
+                    const float elapsedTime,
+                    const unsigned int checksum);
+
+        int frameCount (void) const {return frames;}
+
+    private:
+
+        void writeByte (const int value);
+        void writeWord (const unsigned int value);
+
+        std::ofstream file;
+        int frames;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class RecordingReader
+    {
+    public:
+
+        RecordingReader () : seedValue (0) {}
+
+        // open a recording written by RecordingWriter, returns false if it
+        // can't be read or has an unknown format
+        bool open (const char* fileName);
+        void close (void);
+        bool isOpen (void) const {return file.is_open ();}
+
+        // seed of the global rand at the start of the recorded run
+        unsigned int seed (void) const {return seedValue;}
+
+        // read the next event, returns false at the end of the recording
+        // (a truncated last record counts as the end)
+        bool next (RecordedEvent& event);
+
+    private:
+
+        bool readByte (int& value);
+        bool readWord (unsigned int& value);
+
+        std::ifstream file;
+        unsigned int seedValue;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // checksum of the positions, orientations and speeds of "vehicles"
+    // (FNV-1a of their bits), equal for bitwise equal states
+
+
+    unsigned int vehicleStateChecksum (const OpenSteer::AVGroup& vehicles);
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_RECORDING_H
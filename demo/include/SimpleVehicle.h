@@ -65,22 +65,31 @@
 
 
 #include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/HotState.h"
 #include "OpenSteer/SteerLibrary.h"
+#include "OpenSteer/BatchIntegrator.h"
 #include "Annotation.h"
+#include <atomic>
 
     // ----------------------------------------------------------------------------
 
 
-    // SimpleVehicle_1 adds concrete LocalSpace methods to AbstractVehicle
-    typedef OpenSteer::LocalSpaceMixin<OpenSteer::AbstractVehicle> SimpleVehicle_1;
+    // SimpleVehicle_1 adds concrete LocalSpace methods to AbstractVehicle,
+    // followed by speed and radius so all that neighbors read of a vehicle
+    // shares one cache line (see HotState.h)
+    typedef OpenSteer::HotStateMixin<OpenSteer::LocalSpaceMixin<OpenSteer::AbstractVehicle> > SimpleVehicle_1;
 
 
     // SimpleVehicle_2 adds concrete annotation methods to SimpleVehicle_1
     typedef AnnotationMixin<SimpleVehicle_1> SimpleVehicle_2;
 
 
-    // SimpleVehicle_3 adds concrete steering methods to SimpleVehicle_2
-    typedef OpenSteer::SteerLibraryMixin<SimpleVehicle_2> SimpleVehicle_3;
+    // SimpleVehicle_3 adds concrete steering methods to SimpleVehicle_2.
+    // SimpleVehicle is passed as concrete class so the steering behaviors
+    // read the vehicle state through SimpleVehicle's final accessors which
+    // the compiler can inline instead of calling them virtually.
+    class SimpleVehicle;
+    typedef OpenSteer::SteerLibraryMixin<SimpleVehicle_2, SimpleVehicle> SimpleVehicle_3;
 
 
     // SimpleVehicle adds concrete vehicle methods to SimpleVehicle_3
@@ -112,33 +121,42 @@
             setMaxForce (0.1f);   // steering force is clipped to this magnitude
             setMaxSpeed (1.0f);   // velocity is clipped to this magnitude
 
+            setBasisTolerance (0); // regenerate local space every update
+
             // reset bookkeeping to do running averages of these quanities
             resetSmoothedPosition ();
             resetSmoothedCurvature ();
             resetSmoothedAcceleration ();
         }
 
+        // get local space state (final versions of the LocalSpaceMixin
+        // accessors, see SimpleVehicle_3 above)
+        OpenSteer::Vec3 side (void) const final {return SimpleVehicle_1::side ();}
+        OpenSteer::Vec3 up (void) const final {return SimpleVehicle_1::up ();}
+        OpenSteer::Vec3 forward (void) const final {return SimpleVehicle_1::forward ();}
+        OpenSteer::Vec3 position (void) const final {return SimpleVehicle_1::position ();}
+
         // get/set mass
-        float mass (void) const {return _mass;}
+        float mass (void) const final {return _mass;}
         float setMass (float m) {return _mass = m;}
 
         // get velocity of vehicle
-        OpenSteer::Vec3 velocity (void) const {return forward() * _speed;}
+        OpenSteer::Vec3 velocity (void) const final {return forward() * speed ();}
 
         // get/set speed of vehicle  (may be faster than taking mag of velocity)
-        float speed (void) const {return _speed;}
-        float setSpeed (float s) {return _speed = s;}
+        float speed (void) const final {return SimpleVehicle_1::speed ();}
+        float setSpeed (float s) {return SimpleVehicle_1::setSpeed (s);}
 
         // size of bounding sphere, for obstacle avoidance, etc.
-        float radius (void) const {return _radius;}
-        float setRadius (float m) {return _radius = m;}
+        float radius (void) const final {return SimpleVehicle_1::radius ();}
+        float setRadius (float m) {return SimpleVehicle_1::setRadius (m);}
 
         // get/set maxForce
-        float maxForce (void) const {return _maxForce;}
+        float maxForce (void) const final {return _maxForce;}
         float setMaxForce (float mf) {return _maxForce = mf;}
 
         // get/set maxSpeed
-        float maxSpeed (void) const {return _maxSpeed;}
+        float maxSpeed (void) const final {return _maxSpeed;}
         float setMaxSpeed (float ms) {return _maxSpeed = ms;}
 
         // ratio of speed to max possible speed (0 slowest, 1 fastest)
@@ -154,6 +172,16 @@
         virtual void regenerateLocalSpace (const OpenSteer::Vec3& newVelocity,
                                            const float elapsedTime);
 
+        // get/set how far side and up may drift from being perpendicular to
+        // forward before regenerateLocalSpace regenerates them (see
+        // LocalSpaceMixin::lazyRegenerateOrthonormalBasisUF), zero means
+        // regenerate them every update.  Pays off for vehicles turning
+        // slowly compared to the update rate, e.g. crowds on the ground plane
+        // (with 0.01 a fifth of the Pedestrian updates and half of the
+        // Stress Test commuter updates only set forward).
+        float basisTolerance (void) const {return _basisTolerance;}
+        float setBasisTolerance (float t) {return _basisTolerance = t;}
+
         // alternate version: keep FORWARD parallel to velocity, adjust UP
         // according to a no-basis-in-reality "banking" behavior, something
         // like what birds and airplanes do.  (XXX experimental cwr 6-5-03)
@@ -197,9 +225,17 @@
             return _smoothedPosition = value;
         }
 
-        // give each vehicle a unique number
+        // get/set the state advanced by applySteeringForce, to apply the
+        // steering forces of many vehicles at once with a BatchIntegrator
+        // (only for vehicles keeping the default adjustRawSteeringForce and
+        // regenerateLocalSpace)
+        OpenSteer::MotionState motionState (void) const;
+        void setMotionState (const OpenSteer::MotionState& state);
+
+        // give each vehicle a unique number (atomic counter: vehicles of
+        // different Worlds may be created concurrently)
         int serialNumber;
-        static int serialNumberCounter;
+        static std::atomic<int> serialNumberCounter;
 
         // draw lines from vehicle's position showing its velocity and acceleration
         void annotationVelocityAcceleration (float maxLengthA, float maxLengthV);
@@ -213,18 +249,15 @@
         void randomizeHeadingOnXZPlane (void)
         {
             setUp (OpenSteer::Vec3::up);
-            setForward (OpenSteer::RandomUnitVectorOnXZPlane ());
+            setForward (randomGenerator().unitVectorOnXZPlane ());
             setSide (localRotateForwardToSide (forward()));
         }
 
     private:
 
-        float _mass;       // mass (defaults to unity so acceleration=force)
+        // (speed and radius are kept by SimpleVehicle_1)
 
-        float _radius;     // size of bounding sphere, for obstacle avoidance, etc.
-
-        float _speed;      // speed along Forward direction.  Because local space
-                           // is velocity-aligned, velocity = Forward * Speed
+        float _mass;       // mass (defaults to unity so acceleration=force)
 
         float _maxForce;   // the maximum steering force this vehicle can apply
                            // (steering force is clipped to this magnitude)
@@ -232,15 +265,14 @@
         float _maxSpeed;   // the maximum speed this vehicle is allowed to move
                            // (velocity is clipped to this magnitude)
 
+        float _basisTolerance; // see basisTolerance
+
         float _curvature;
         OpenSteer::Vec3 _lastForward;
         OpenSteer::Vec3 _lastPosition;
         OpenSteer::Vec3 _smoothedPosition;
         float _smoothedCurvature;
         OpenSteer::Vec3 _smoothedAcceleration;
-
-        // measure path curvature (1/turning-radius), maintain smoothed version
-        void measurePathCurvature (const float elapsedTime);
     };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// VehicleSnapshot: frozen copy of a vehicle's pose and motion, drawn in its
+// place while the vehicle itself is being updated
+//
+// In pipelined mode (see OpenSteerDemo::setPipelinedMode) a PlugIn redraws
+// frame N while the update of frame N+1 moves its vehicles on another
+// thread.  Its snapshotForRedraw copies the vehicles into VehicleSnapshots,
+// and redraw, the camera and the highlight utilities use the copies, which
+// are AbstractVehicles themselves:
+//
+//     bool snapshotForRedraw (void) {snapshots.capture (flock); return true;}
+//
+//     void redraw (const float currentTime, const float elapsedTime)
+//     {
+//         AbstractVehicle* selected =
+//             snapshots.find (OpenSteerDemo::selectedVehicle);
+//         OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
+//         for (AVIterator i = snapshots.all ().begin ();
+//              i != snapshots.all ().end (); i++)
+//             drawBasic2dCircularVehicle (**i, gGray50);
+//     }
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_VEHICLESNAPSHOT_H
+#define OPENSTEER_VEHICLESNAPSHOT_H
+
+#include <algorithm>
+#include <vector>
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/LocalSpace.h"
+
+
+    class VehicleSnapshot
+        : public OpenSteer::LocalSpaceMixin<OpenSteer::AbstractVehicle>
+    {
+    public:
+
+        VehicleSnapshot ()
+            : _mass (1), _radius (0.5f), _speed (0), _maxForce (0),
+              _maxSpeed (0) {}
+
+        // copy the local space, size and motion of "vehicle"
+        void copy (const OpenSteer::AbstractVehicle& vehicle)
+        {
+            setSide (vehicle.side ());
+            setUp (vehicle.up ());
+            setForward (vehicle.forward ());
+            setPosition (vehicle.position ());
+            _mass = vehicle.mass ();
+            _radius = vehicle.radius ();
+            _speed = vehicle.speed ();
+            _maxForce = vehicle.maxForce ();
+            _maxSpeed = vehicle.maxSpeed ();
+        }
+
+        float mass (void) const {return _mass;}
+        float setMass (float m) {return _mass = m;}
+        float radius (void) const {return _radius;}
+        float setRadius (float r) {return _radius = r;}
+        OpenSteer::Vec3 velocity (void) const {return forward () * _speed;}
+        float speed (void) const {return _speed;}
+        float setSpeed (float s) {return _speed = s;}
+        float maxForce (void) const {return _maxForce;}
+        float setMaxForce (float mf) {return _maxForce = mf;}
+        float maxSpeed (void) const {return _maxSpeed;}
+        float setMaxSpeed (float ms) {return _maxSpeed = ms;}
+
+        // same linear prediction as SimpleVehicle
+        OpenSteer::Vec3 predictFuturePosition (const float predictionTime) const
+        {
+            return position () + (velocity () * predictionTime);
+        }
+
+        // a snapshot doesn't move
+        void update (const float, const float) {}
+
+    private:
+
+        float _mass;
+        float _radius;
+        float _speed;
+        float _maxForce;
+        float _maxSpeed;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // snapshots of a group of vehicles, taken again every frame
+
+
+    class VehicleSnapshots
+    {
+    public:
+
+        // replace the snapshots with copies of "vehicles", reusing memory
+        template <class Vehicles>
+        void capture (const Vehicles& vehicles)
+        {
+            const size_t count = vehicles.size ();
+            copies.resize (count);
+            sources.resize (count);
+            group.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                copies[i].copy (*vehicles[i]);
+                sources[i] = vehicles[i];
+                group[i] = &copies[i];
+            }
+        }
+
+        void clear (void) {copies.clear (); sources.clear (); group.clear ();}
+
+        // the snapshots, in the order of the captured vehicles
+        const OpenSteer::AVGroup& all (void) const {return group;}
+        size_t size (void) const {return copies.size ();}
+
+        // snapshot of "vehicle", NULL if it wasn't captured
+        OpenSteer::AbstractVehicle* find (const OpenSteer::AbstractVehicle* vehicle) const
+        {
+            const std::vector<const OpenSteer::AbstractVehicle*>::const_iterator i =
+                std::find (sources.begin (), sources.end (), vehicle);
+            return (i == sources.end ()) ? NULL : group[i - sources.begin ()];
+        }
+
+    private:
+
+        std::vector<VehicleSnapshot> copies;
+        std::vector<const OpenSteer::AbstractVehicle*> sources;
+        OpenSteer::AVGroup group;
+    };
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_VEHICLESNAPSHOT_H
@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// World: one independent simulation, a private instance of a PlugIn with
+// its own clock
+//
+// OpenSteerDemo runs the registered PlugIn singletons one at a time, with
+// its global clock, camera and selection.  A World instead makes its own
+// instance of a PlugIn (see PlugIn::makeWorldInstance) which owns all of
+// its vehicles, proximity databases, obstacles and settings, so a process
+// can run many Worlds (e.g. independent matches on a simulation server)
+// side by side:
+//
+//     std::vector<World*> worlds;
+//     for (int i = 0; i < 64; i++)
+//         worlds.push_back (World::make (*PlugIn::findByName ("Boids"), &pool));
+//     for (int frame = 0; frame < 1000; frame++)
+//         World::stepAll (worlds, 1.0f / 60, &pool);
+//
+// Worlds have no display: they are meant for headless runs with annotation
+// switched off.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_WORLD_H
+#define OPENSTEER_WORLD_H
+
+#include <vector>
+#include "PlugIn.h"
+#include "OpenSteer/ThreadPool.h"
+
+
+    class World
+    {
+    public:
+
+        // returns a new World running a fresh instance of the registered
+        // PlugIn "prototype", or NULL if that PlugIn can't run in Worlds.
+        // "threadPool" runs the parallel phases of the PlugIn's update,
+        // NULL to run them on the thread stepping the World.
+        static World* make (PlugIn& prototype,
+                            OpenSteer::ThreadPool* threadPool = NULL);
+
+        // closes and deletes the PlugIn instance
+        ~World ();
+
+        // the PlugIn instance of this World
+        PlugIn& plugIn (void) {return *instance;}
+
+        // threads for the parallel phases of the PlugIn's update
+        OpenSteer::ThreadPool* threadPool (void) {return pool;}
+
+        // simulation time of this World and number of steps taken
+        float currentTime (void) const {return simulationTime;}
+        int frameCount (void) const {return frames;}
+
+        // advance this World's clock by "elapsedTime" and update its PlugIn
+        void step (const float elapsedTime);
+
+        // step each of "worlds" by "elapsedTime", the Worlds side by side
+        // on "threadPool" (or one after the other if NULL)
+        static void stepAll (const std::vector<World*>& worlds,
+                             const float elapsedTime,
+                             OpenSteer::ThreadPool* threadPool);
+
+    private:
+
+        World (PlugIn* instance, OpenSteer::ThreadPool* threadPool);
+
+        // not implemented to make it non-copyable
+        World (const World&);
+        World& operator= (const World&);
+
+        PlugIn* instance;
+        OpenSteer::ThreadPool* pool;
+        float simulationTime;
+        int frames;
+    };
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_WORLD_H
@@ -30,6 +30,10 @@
 //
 // Main: top level routine for OpenSteerDemo application
 //
+// "--record <file>" logs the run to a file, "--replay <file>" repeats a
+// recorded run bit for bit (see Recording.h), other arguments are passed
+// on to GLUT.
+//
 //  5-29-02 cwr: created
 //
 //
@@ -41,15 +45,44 @@
 #include "glutInitialize.h"
 // To include EXIT_SUCCESS
 #include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
 
 
 int main (int argc, char **argv) 
 {
+    // start recording or replay before the first PlugIn is opened
+    std::vector<char*> glutArguments;
+    for (int i = 0; i < argc; i++)
+    {
+        const bool record = (std::strcmp (argv[i], "--record") == 0);
+        const bool replay = (std::strcmp (argv[i], "--replay") == 0);
+        if ((record || replay) && (i + 1 < argc))
+        {
+            const char* fileName = argv[++i];
+            if (! (record ? OpenSteerDemo::startRecording (fileName)
+                          : OpenSteerDemo::startReplay (fileName)))
+            {
+                std::ostringstream message;
+                message << "can't " << (record ? "record to" : "replay")
+                        << " \"" << fileName << "\"";
+                OpenSteerDemo::errorExit (message.str ().c_str ());
+            }
+        }
+        else
+        {
+            glutArguments.push_back (argv[i]);
+        }
+    }
+    int glutArgumentCount = (int) glutArguments.size ();
+    glutArguments.push_back (NULL);
+
     // initialize OpenSteerDemo application
     OpenSteerDemo::initialize ();
 
     // initialize graphics
-    initializeGraphics (argc, argv);
+    initializeGraphics (glutArgumentCount, &glutArguments[0]);
 
     // run the main event processing loop
     runGraphics ();  
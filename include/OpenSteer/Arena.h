@@ -0,0 +1,308 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Arena allocator to keep the objects of a plug-in, e.g. its vehicles and
+ * their trail buffers, together in memory and to free them in one step.
+ */
+#ifndef OPENSTEER_ARENA_H
+#define OPENSTEER_ARENA_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::forward
+#include <utility>
+
+// Include std::is_trivially_destructible
+#include <type_traits>
+
+// Include placement new
+#include <new>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Allocates from large chunks in allocation order, so objects created
+     * one after the other (a vehicle, then the buffers its constructor
+     * allocates, then the next vehicle, ...) are adjacent in memory and
+     * iterating them in creation order walks memory forward.
+     *
+     * @c create constructs objects in place and remembers how to destroy
+     * them. @c clear destroys all objects still alive in reverse creation
+     * order and frees all chunks at once, the destructor does the same.
+     * @c destroy destroys a single object early and keeps its memory on a
+     * free list for blocks of its size and alignment, the next allocation
+     * of the same size and alignment (typically the next object of the
+     * same type) reuses it. @c releaseArray does the same for arrays, so a
+     * plug-in shrinking and regrowing its population does not grow the
+     * arena. Reused blocks are of course not adjacent to the objects
+     * created before them.
+     *
+     * While an object is constructed by @c create, @c current returns the
+     * creating arena and @c creating returns it for addresses inside the
+     * object, so members can allocate their buffers from it without
+     * changing constructor signatures (see @c AnnotationMixin). Such
+     * buffers live until the arena is cleared, so only objects whose
+     * lifetime ends with the created object may take them: members and
+     * bases, which @c creating accepts, but not objects the constructor
+     * allocates with plain @c new, for which @c current would still return
+     * the arena.
+     *
+     * Not thread safe, an arena belongs to one thread at a time.
+     */
+    class Arena {
+    public:
+        /**
+         * The first chunk holds @a initialChunkSize bytes, each further one
+         * twice as much as the one before, up to @c maxChunkSize.
+         */
+        explicit Arena( size_t initialChunkSize = 64 * 1024 );
+        ~Arena();
+
+        /**
+         * Returns @a size bytes aligned to @a alignment, which must be a
+         * power of two. Takes a released block of the same size and
+         * alignment if there is one. Throws @c std::bad_alloc if no new
+         * chunk can be allocated.
+         */
+        void* allocate( size_t size, size_t alignment );
+
+        /**
+         * Hands @a memory, which @c allocate returned for @a size and
+         * @a alignment, back for reuse by a later @c allocate.
+         */
+        void release( void* memory, size_t size, size_t alignment );
+
+        /**
+         * Returns @a count default constructed elements. Only for types
+         * which need no destructor, the memory is just dropped by @c clear.
+         */
+        template< typename T >
+        T* allocateArray( size_t count ) {
+            static_assert( std::is_trivially_destructible< T >::value,
+                           "Arena arrays are never destroyed." );
+            T* const elements = static_cast< T* >( allocate( sizeof( T ) * count, alignof( T ) ) );
+            for ( size_t i = 0; i < count; ++i ) {
+                new ( elements + i ) T();
+            }
+            return elements;
+        }
+
+        /**
+         * Hands an array returned by @c allocateArray with the same
+         * @a count back for reuse.
+         */
+        template< typename T >
+        void releaseArray( T* elements, size_t count ) {
+            if ( 0 != elements ) {
+                release( elements, sizeof( T ) * count, alignof( T ) );
+            }
+        }
+
+        /**
+         * Constructs a @c T from @a args in the arena, like <code>new T( args )</code>.
+         * If the constructor throws, the memory is released for reuse and
+         * @c current is restored before the exception propagates.
+         */
+        template< typename T, typename... Args >
+        T* create( Args&&... args ) {
+            void* const memory = allocate( sizeof( T ), alignof( T ) );
+
+            T* object = 0;
+            try {
+                CurrentScope const scope( this, memory, sizeof( T ) );
+                object = new ( memory ) T( std::forward< Args >( args )... );
+            } catch ( ... ) {
+                release( memory, sizeof( T ), alignof( T ) );
+                throw;
+            }
+
+            if ( ! std::is_trivially_destructible< T >::value ) {
+                try {
+                    objects_.push_back( Object( object, &destroyObject< T >, sizeof( T ), alignof( T ) ) );
+                } catch ( ... ) {
+                    object->~T();
+                    release( memory, sizeof( T ), alignof( T ) );
+                    throw;
+                }
+            }
+            return object;
+        }
+
+        /**
+         * Destroys @a object, which must have been created by @c create of
+         * this arena, and releases its memory for reuse. Finds the most
+         * recently created objects fastest.
+         */
+        template< typename T >
+        void destroy( T* object ) {
+            if ( 0 != object ) {
+                destroyCreated( static_cast< void const* >( object ) );
+            }
+        }
+
+        /**
+         * Destroys all objects and frees all memory.
+         */
+        void clear();
+
+        /**
+         * Bytes taken from the chunks by @c allocate since the last
+         * @c clear, including alignment padding. Reused blocks are not
+         * counted again.
+         */
+        size_t bytesAllocated() const { return bytesAllocated_; }
+
+        /**
+         * Chunks currently held.
+         */
+        size_t chunkCount() const { return chunks_.size(); }
+
+        /**
+         * Arena of the @c create call running on this thread, or @c 0.
+         * Also returned to every constructor the created object's
+         * constructor calls, including those of objects that outlive the
+         * arena, prefer @c creating.
+         */
+        static Arena* current() { return current_; }
+
+        /**
+         * Arena of the @c create call running on this thread if @a object
+         * lies inside the object it constructs (a base or member being
+         * constructed), otherwise @c 0.
+         */
+        static Arena* creating( void const* object );
+
+        enum { maxChunkSize = 4 * 1024 * 1024 };
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Arena( Arena const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Arena& operator=( Arena const& );
+
+        /**
+         * Makes an arena and the object it constructs the ones seen by
+         * @c current and @c creating for its lifetime and restores the
+         * previous ones when it goes out of scope, also when a constructor
+         * throws.
+         */
+        class CurrentScope {
+        public:
+            CurrentScope( Arena* arena, void* object, size_t size )
+                : previous_( current_ ), previousBegin_( creatingBegin_ ), previousEnd_( creatingEnd_ ) {
+                current_ = arena;
+                creatingBegin_ = static_cast< char const* >( object );
+                creatingEnd_ = creatingBegin_ + size;
+            }
+            ~CurrentScope() {
+                current_ = previous_;
+                creatingBegin_ = previousBegin_;
+                creatingEnd_ = previousEnd_;
+            }
+
+        private:
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            CurrentScope( CurrentScope const& );
+
+            /**
+             * Not implemented to make it non-copyable.
+             */
+            CurrentScope& operator=( CurrentScope const& );
+
+        private:
+            Arena* previous_;
+            char const* previousBegin_;
+            char const* previousEnd_;
+        }; // class CurrentScope
+
+        template< typename T >
+        static void destroyObject( void* object ) {
+            static_cast< T* >( object )->~T();
+        }
+
+        void destroyCreated( void const* object );
+
+        /**
+         * Allocates a chunk with at least @a size bytes, throws
+         * @c std::bad_alloc if there is not enough memory.
+         */
+        void addChunk( size_t size );
+
+    private:
+        struct Object {
+            Object( void* o, void ( *d )( void* ), size_t s, size_t a )
+                : object( o ), destroy( d ), size( s ), alignment( a ) {}
+            void* object;
+            void ( *destroy )( void* );
+            size_t size;
+            size_t alignment;
+        };
+
+        /**
+         * Released blocks of one size and alignment.
+         */
+        struct FreeList {
+            FreeList( size_t s, size_t a ) : size( s ), alignment( a ) {}
+            size_t size;
+            size_t alignment;
+            std::vector< void* > blocks;
+        };
+
+        FreeList* findFreeList( size_t size, size_t alignment );
+
+        size_t initialChunkSize_;
+        size_t nextChunkSize_;
+        char* position_;
+        char* end_;
+        size_t bytesAllocated_;
+        std::vector< char* > chunks_;
+        std::vector< Object > objects_;
+        std::vector< FreeList > freeLists_;
+
+        static thread_local Arena* current_;
+        static thread_local char const* creatingBegin_;
+        static thread_local char const* creatingEnd_;
+    }; // class Arena
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ARENA_H
@@ -0,0 +1,226 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Integration of steering forces into the motion of vehicles, one at a time
+ * or many at once.
+ */
+#ifndef OPENSTEER_BATCHINTEGRATOR_H
+#define OPENSTEER_BATCHINTEGRATOR_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Vehicle state read and written by @c SimpleVehicle::applySteeringForce.
+     */
+    struct MotionState {
+        Vec3 side;
+        Vec3 up;
+        Vec3 forward;
+        Vec3 position;
+
+        float mass;
+        float speed;
+        float maxForce;
+        float maxSpeed;
+
+        Vec3 smoothedAcceleration;
+        Vec3 smoothedPosition;
+
+        float curvature;
+        float smoothedCurvature;
+        Vec3 lastForward;
+        Vec3 lastPosition;
+
+        /**
+         * See @c SimpleVehicle::basisTolerance.
+         */
+        float basisTolerance;
+    };
+
+
+    /**
+     * Advances @a state by one step of @c SimpleVehicle::applySteeringForce
+     * with the default @c adjustRawSteeringForce and @c regenerateLocalSpace,
+     * like the scalar lanes of @c BatchIntegrator do.
+     *
+     * The vehicles share the single steps below with it, calling their own
+     * @c adjustRawSteeringForce and @c regenerateLocalSpace in between:
+     * @c integrateSteeringForce with the adjusted force, then
+     * @c regenerateLocalSpace, then @c measurePathCurvature.
+     */
+    void applySteeringForce( MotionState& state, Vec3 const& force, float elapsedTime );
+
+    /**
+     * Disallows backward facing steering at low speed: below a fifth of
+     * @a maxSpeed @a force is limited to a cone around @a forward which
+     * narrows as the speed drops. @c pow( range, 20 ) is computed by
+     * repeated squaring.
+     */
+    Vec3 adjustRawSteeringForce( Vec3 const& force, Vec3 const& forward, float speed, float maxSpeed );
+
+    /**
+     * Truncates @a adjustedForce to @c maxForce, blends the resulting
+     * acceleration into @c smoothedAcceleration, Euler integrates velocity
+     * (limited to @c maxSpeed) and position. Returns the new velocity, the
+     * local space is left to @c regenerateLocalSpace.
+     */
+    Vec3 integrateSteeringForce( MotionState& state, Vec3 const& adjustedForce, float elapsedTime );
+
+    /**
+     * Aligns forward with @a newVelocity, keeping side and up as long as
+     * they are perpendicular to it within @c basisTolerance like
+     * @c LocalSpaceMixin::lazyRegenerateOrthonormalBasisUF does.
+     */
+    void regenerateLocalSpace( MotionState& state, Vec3 const& newVelocity );
+
+    /**
+     * Measures the path curvature and blends it and the position into
+     * their running averages.
+     */
+    void measurePathCurvature( MotionState& state, float elapsedTime );
+
+
+    /**
+     * Applies steering forces to a batch of vehicles like
+     * @c applySteeringForce does for one: low speed adjustment and
+     * truncation of the force, smoothed acceleration, speed limit, Euler
+     * integration of velocity and position, velocity aligned basis
+     * (regenerated lazily within the @c basisTolerance of each vehicle),
+     * path curvature and smoothed position.
+     *
+     * The states are kept in blocks of @c width vehicles, each block a
+     * structure of arrays; with SSE @c integrate advances a block per step
+     * without branches. Without SSE each vehicle is advanced by
+     * @c applySteeringForce, with SSE the results match it up to rounding.
+     *
+     * Meant to be kept and refilled per frame, @c clear keeps the memory.
+     */
+    class BatchIntegrator {
+    public:
+        enum { width = 4 };
+
+        BatchIntegrator();
+
+        void clear();
+
+        /**
+         * Adds a vehicle in state @a state to be steered by @a force and
+         * returns its index.
+         */
+        size_t add( MotionState const& state, Vec3 const& force );
+
+        size_t size() const { return size_; }
+        bool empty() const { return 0 == size_; }
+
+        /**
+         * Advances all vehicles by @a elapsedTime.
+         */
+        void integrate( float elapsedTime );
+
+        /**
+         * State of vehicle @a index, after @c integrate the new state.
+         */
+        MotionState state( size_t index ) const;
+
+    private:
+        /**
+         * Coordinates of one vector of @c width vehicles.
+         */
+        struct Vec3Block {
+            Vec3 get( size_t lane ) const {
+                return Vec3( x[ lane ], y[ lane ], z[ lane ] );
+            }
+
+            void set( size_t lane, Vec3 const& v ) {
+                x[ lane ] = v.x;
+                y[ lane ] = v.y;
+                z[ lane ] = v.z;
+            }
+
+            float x[ width ];
+            float y[ width ];
+            float z[ width ];
+        };
+
+        /**
+         * Force and state of @c width vehicles, kept together so adding
+         * and reading a vehicle touches one block instead of thirty arrays.
+         */
+        struct Block {
+            Vec3Block force;
+            Vec3Block side;
+            Vec3Block up;
+            Vec3Block forward;
+            Vec3Block position;
+            Vec3Block smoothedAcceleration;
+            Vec3Block smoothedPosition;
+            Vec3Block lastForward;
+            Vec3Block lastPosition;
+
+            float mass[ width ];
+            float speed[ width ];
+            float maxForce[ width ];
+            float maxSpeed[ width ];
+            float curvature[ width ];
+            float smoothedCurvature[ width ];
+            float basisTolerance[ width ];
+        };
+
+        /**
+         * State of vehicle @a lane of @a block.
+         */
+        static MotionState get( Block const& block, size_t lane );
+        static void set( Block& block, size_t lane, MotionState const& state );
+
+        /**
+         * Advances vehicle @a lane of @a block, respectively all vehicles
+         * of @a block (only available with SSE).
+         */
+        static void integrateScalar( Block& block, size_t lane, float elapsedTime );
+        static void integrateLanes( Block& block, float elapsedTime );
+
+    private:
+        size_t size_;
+        std::vector< Block > blocks_;
+    }; // class BatchIntegrator
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_BATCHINTEGRATOR_H
@@ -0,0 +1,168 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Approximate math kernels with bounded error for the steering hot paths,
+ * and the @c OPENSTEER_FAST_MATH switch to use them.
+ *
+ * Build flags:
+ *
+ * - @c OPENSTEER_FAST_MATH: @c inverseSqrtXXX and @c powXXX (see
+ *   @c OpenSteer/Utilities.h) use the kernels below, and with them
+ *   @c normalize and @c truncateLength of @c Vec3, @c Vec3A and
+ *   @c Vec3Lanes, the random unit vectors and the low speed adjustment of
+ *   @c SimpleVehicle and @c HeadlessVehicle. These treat squared lengths
+ *   below @c FLT_MIN as zero then. @c length stays exact: paths and
+ *   obstacles rely on it, and a square root costs about as much as the
+ *   approximation.
+ * - @c OPENSTEER_NO_SIMD: @c fastInverseSqrt uses the portable bit trick
+ *   even if the target supports SSE.
+ *
+ * The kernels are available in both modes, so their accuracy can be
+ * tested and compared against the exact functions in every build.
+ */
+#ifndef OPENSTEER_FASTMATH_H
+#define OPENSTEER_FASTMATH_H
+
+
+// Include std::memcpy
+#include <cstring>
+
+
+// Same condition as OPENSTEER_VEC3A_SSE in OpenSteer/Vec3A.h.
+#if ! defined( OPENSTEER_NO_SIMD ) && ( defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) )
+    #define OPENSTEER_FAST_MATH_SSE 1
+#endif
+
+#ifdef OPENSTEER_FAST_MATH_SSE
+    // Include _mm_rsqrt_ss, ...
+    #include <xmmintrin.h>
+#endif
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Approximates <code>1 / sqrt( x )</code> for normal floats @a x > 0
+     * (at least @c FLT_MIN) with a relative error below 5e-6, below 5e-7
+     * with SSE.
+     *
+     * With SSE the hardware estimate (about 12 bits) is refined by one
+     * Newton-Raphson step, otherwise the integer estimate of the exponent
+     * trick by two. @c Vec3Lanes executes the same steps per lane.
+     */
+    inline float fastInverseSqrt( float x ) {
+#ifdef OPENSTEER_FAST_MATH_SSE
+        float const estimate = _mm_cvtss_f32( _mm_rsqrt_ss( _mm_set_ss( x ) ) );
+        return estimate * ( 1.5f - ( ( 0.5f * x ) * estimate * estimate ) );
+#else
+        unsigned int bits = 0;
+        std::memcpy( &bits, &x, sizeof( bits ) );
+        bits = 0x5f375a86u - ( bits >> 1 );
+        float estimate = 0.0f;
+        std::memcpy( &estimate, &bits, sizeof( estimate ) );
+        estimate = estimate * ( 1.5f - ( ( 0.5f * x ) * estimate * estimate ) );
+        return estimate * ( 1.5f - ( ( 0.5f * x ) * estimate * estimate ) );
+#endif
+    }
+
+
+    /**
+     * Approximates @c log2( x ) for normal floats @a x > 0 with an absolute
+     * error below 1.2e-6 for @a x in [0.5, 2) and below 5e-6 (the rounding
+     * of adding the exponent) for all of them.
+     *
+     * Splits @a x into exponent and mantissa m in [1, 2) and evaluates a
+     * polynomial t * p( t ) of degree 7, t = m - 1, fitted to log2( 1 + t ) at
+     * the Chebyshev nodes.
+     */
+    inline float fastLog2( float x ) {
+        unsigned int bits = 0;
+        std::memcpy( &bits, &x, sizeof( bits ) );
+        float const exponent = static_cast< float >( static_cast< int >( bits >> 23 ) - 127 );
+        bits = ( bits & 0x007fffffu ) | 0x3f800000u;
+        float mantissa = 0.0f;
+        std::memcpy( &mantissa, &bits, sizeof( mantissa ) );
+
+        float const t = mantissa - 1.0f;
+        float p = 0.02001665f;
+        p = p * t - 0.0946268097f;
+        p = p * t + 0.213943212f;
+        p = p * t - 0.338377198f;
+        p = p * t + 0.477496364f;
+        p = p * t - 0.721144092f;
+        p = p * t + 1.44269298f;
+        return exponent + ( t * p );
+    }
+
+
+    /**
+     * Approximates @c exp2( x ) with a relative error below 1e-6. Returns
+     * zero for @a x below -126 (no denormals) and is only defined for @a x
+     * below 128.
+     *
+     * Splits @a x into integer part i and fraction f in [0, 1), builds 2^i
+     * from its bits and evaluates a polynomial 1 + f * p( f ) of degree 5
+     * fitted to 2^f at the Chebyshev nodes, exact for integer @a x.
+     */
+    inline float fastExp2( float x ) {
+        // Without branches so calls in loops vectorize: clamp, and round
+        // down by truncating a positive number.
+        bool const underflow = ( x < -126.0f );
+        float const clamped = underflow ? -126.0f : x;
+        int const integer = static_cast< int >( clamped + 128.0f ) - 128;
+        float const f = clamped - static_cast< float >( integer );
+
+        float p = 0.00178836874f;
+        p = p * f + 0.0091993876f;
+        p = p * f + 0.0556570544f;
+        p = p * f + 0.240207194f;
+        p = p * f + 0.693147568f;
+        p = 1.0f + ( f * p );
+
+        unsigned int const bits = static_cast< unsigned int >( integer + 127 ) << 23;
+        float scale = 0.0f;
+        std::memcpy( &scale, &bits, sizeof( scale ) );
+        return underflow ? 0.0f : scale * p;
+    }
+
+
+    /**
+     * Approximates <code>pow( x, y )</code> for @a x >= 0 as
+     * <code>exp2( y * log2( x ) )</code>. The relative error stays below
+     * <code>4e-6 * ( |y| + 1 )</code>, e.g. 8.4e-5 for the exponent 20 of
+     * the low speed adjustment. Results below @c FLT_MIN are zero.
+     */
+    inline float fastPow( float x, float y ) {
+        float const result = fastExp2( y * fastLog2( x ) );
+        return ( x > 0.0f ) ? result : ( ( y == 0.0f ) ? 1.0f : 0.0f );
+    }
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FASTMATH_H
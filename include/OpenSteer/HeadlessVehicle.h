@@ -0,0 +1,209 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Vehicle with the state and motion of OpenSteerDemo's @c SimpleVehicle but
+ * without graphical annotation, for simulations that don't render.
+ */
+#ifndef OPENSTEER_HEADLESSVEHICLE_H
+#define OPENSTEER_HEADLESSVEHICLE_H
+
+
+// Include OpenSteer::AbstractVehicle
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::HotStateMixin
+#include "OpenSteer/HotState.h"
+
+// Include OpenSteer::SteerLibraryMixin
+#include "OpenSteer/SteerLibrary.h"
+
+// Include OpenSteer::MotionState
+#include "OpenSteer/BatchIntegrator.h"
+
+// Include OpenSteer::Color
+#include "OpenSteer/Color.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include std::atomic
+#include <atomic>
+
+
+
+namespace OpenSteer {
+
+    class HeadlessVehicle;
+
+    /**
+     * Local space, speed and radius (in one cache line, see
+     * @c HotStateMixin) and steering library of @c HeadlessVehicle. The
+     * steering behaviors read the vehicle state and call the annotation
+     * hooks through @c HeadlessVehicle's final functions.
+     */
+    typedef SteerLibraryMixin< HotStateMixin< LocalSpaceMixin< AbstractVehicle > >, HeadlessVehicle > HeadlessVehicleBase;
+
+
+    /**
+     * Steerable point mass with a velocity aligned local space, moving like
+     * @c SimpleVehicle, without @c AnnotationMixin.
+     *
+     * No trail buffers are allocated and the annotation hooks of the
+     * steering library are empty final functions the compiler drops, so
+     * the steering behaviors do no drawing work at all.
+     *
+     * Like @c SimpleVehicle it leaves @c update to derived classes.
+     */
+    class HeadlessVehicle : public HeadlessVehicleBase {
+    public:
+        HeadlessVehicle();
+        virtual ~HeadlessVehicle();
+
+        /**
+         * Resets local space, steering library and vehicle state to the
+         * defaults of @c SimpleVehicle.
+         */
+        void reset();
+
+        /**
+         * Local space accessors, final so the steering library inlines them.
+         */
+        Vec3 side() const final { return HeadlessVehicleBase::side(); }
+        Vec3 up() const final { return HeadlessVehicleBase::up(); }
+        Vec3 forward() const final { return HeadlessVehicleBase::forward(); }
+        Vec3 position() const final { return HeadlessVehicleBase::position(); }
+
+        float mass() const final { return mass_; }
+        float setMass( float m ) final { return mass_ = m; }
+
+        Vec3 velocity() const final { return forward() * speed(); }
+
+        float speed() const final { return HeadlessVehicleBase::speed(); }
+        float setSpeed( float s ) final { return HeadlessVehicleBase::setSpeed( s ); }
+
+        float radius() const final { return HeadlessVehicleBase::radius(); }
+        float setRadius( float r ) final { return HeadlessVehicleBase::setRadius( r ); }
+
+        float maxForce() const final { return maxForce_; }
+        float setMaxForce( float mf ) final { return maxForce_ = mf; }
+
+        float maxSpeed() const final { return maxSpeed_; }
+        float setMaxSpeed( float ms ) final { return maxSpeed_ = ms; }
+
+        /**
+         * Ratio of speed to maximum speed.
+         */
+        float relativeSpeed() const { return speed() / maxSpeed(); }
+
+        /**
+         * Position in @a predictionTime assuming the velocity stays the same.
+         */
+        Vec3 predictFuturePosition( float const predictionTime ) const;
+
+        /**
+         * Motion, see the functions of the same names of @c SimpleVehicle.
+         */
+        void applySteeringForce( Vec3 const& force, float elapsedTime );
+        void applyBrakingForce( float rate, float elapsedTime );
+        virtual Vec3 adjustRawSteeringForce( Vec3 const& force, float elapsedTime );
+        virtual void regenerateLocalSpace( Vec3 const& newVelocity, float elapsedTime );
+        void regenerateLocalSpaceForBanking( Vec3 const& newVelocity, float elapsedTime );
+
+        /**
+         * How far side and up may drift from being perpendicular to forward
+         * before @c regenerateLocalSpace regenerates them, see
+         * @c SimpleVehicle::basisTolerance. Zero (the default) regenerates
+         * them every update.
+         */
+        float basisTolerance() const { return basisTolerance_; }
+        float setBasisTolerance( float t ) { return basisTolerance_ = t; }
+
+        /**
+         * Path curvature and running averages, see @c SimpleVehicle.
+         */
+        float curvature() const { return curvature_; }
+        float smoothedCurvature() const { return smoothedCurvature_; }
+        float resetSmoothedCurvature( float value = 0.0f );
+        Vec3 smoothedAcceleration() const { return smoothedAcceleration_; }
+        Vec3 resetSmoothedAcceleration( Vec3 const& value = Vec3::zero ) { return smoothedAcceleration_ = value; }
+        Vec3 smoothedPosition() const { return smoothedPosition_; }
+        Vec3 resetSmoothedPosition( Vec3 const& value = Vec3::zero ) { return smoothedPosition_ = value; }
+
+        /**
+         * State advanced by @c applySteeringForce, to apply the steering
+         * forces of many vehicles at once with a @c BatchIntegrator (only
+         * for vehicles keeping the default @c adjustRawSteeringForce and
+         * @c regenerateLocalSpace).
+         */
+        MotionState motionState() const;
+        void setMotionState( MotionState const& state );
+
+        /**
+         * Sets local up to global up and heads in a random direction on the
+         * XZ plane.
+         */
+        void randomizeHeadingOnXZPlane();
+
+        /**
+         * Annotation hooks of the steering library, doing nothing.
+         */
+        void annotateAvoidObstacle( float const ) final {}
+        void annotatePathFollowing( Vec3 const&, Vec3 const&, Vec3 const&, float const ) final {}
+        void annotateAvoidCloseNeighbor( AbstractVehicle const&, float const ) final {}
+        void annotateAvoidNeighbor( AbstractVehicle const&, float const, Vec3 const&, Vec3 const& ) final {}
+        void annotationLine( Vec3 const&, Vec3 const&, Color const& ) const {}
+
+        /**
+         * Unique number of each vehicle, also seeds its random generator.
+         * The counter is atomic as vehicles may be created concurrently.
+         */
+        int serialNumber;
+        static std::atomic< int > serialNumberCounter;
+
+    private:
+        float mass_;
+        float maxForce_;
+        float maxSpeed_;
+        float basisTolerance_;
+
+        float curvature_;
+        float smoothedCurvature_;
+        Vec3 lastForward_;
+        Vec3 lastPosition_;
+        Vec3 smoothedPosition_;
+        Vec3 smoothedAcceleration_;
+    }; // class HeadlessVehicle
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_HEADLESSVEHICLE_H
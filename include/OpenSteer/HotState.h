@@ -0,0 +1,94 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Layout of vehicle state for cheap neighbor scans: the state other
+ * vehicles read shares the first cache line with the virtual table pointer.
+ */
+#ifndef OPENSTEER_HOTSTATE_H
+#define OPENSTEER_HOTSTATE_H
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Mixin layer keeping speed and radius directly behind the state of
+     * @a Super, meant to be layered on @c LocalSpaceMixin< AbstractVehicle >
+     * as the lowest layers of a vehicle.
+     *
+     * Steering behaviors scanning neighbors read their position, forward,
+     * velocity and radius through @c AbstractVehicle. Each of these virtual
+     * calls loads the virtual table pointer at the start of the neighbor
+     * object, so this "hot" state is kept next to it: aligned to 64 bytes,
+     * virtual table pointer, local space, speed and radius fill exactly the
+     * first cache line. Everything the higher layers add (annotation trail,
+     * wander and random generator state of the steering library, smoothed
+     * values, mass and limits of the vehicle) is "cold" and lives in the
+     * following lines, which a neighbor scan doesn't touch.
+     *
+     * With @c OPENSTEER_USE_VEC3A the local space takes 64 bytes on its own
+     * and the hot state spans two lines.
+     *
+     * Only C++17 (or later) @c new honors the 64 byte alignment of the
+     * class, the projects therefore build as C++17.
+     */
+    template< class Super >
+    class alignas( 64 ) HotStateMixin : public Super {
+    public:
+        HotStateMixin() : speed_( 0.0f ), radius_( 0.5f ) {}
+
+        virtual ~HotStateMixin() { /* Nothing to do. */ }
+
+        /**
+         * Speed along forward, the local space is aligned to the velocity.
+         */
+        float speed() const { return speed_; }
+        float setSpeed( float s ) { return speed_ = s; }
+
+        Vec3 velocity() const { return this->forward() * speed_; }
+
+        /**
+         * Radius of the bounding sphere.
+         */
+        float radius() const { return radius_; }
+        float setRadius( float r ) { return radius_ = r; }
+
+    private:
+        float speed_;
+        float radius_;
+    }; // class HotStateMixin
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_HOTSTATE_H
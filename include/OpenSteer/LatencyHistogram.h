@@ -0,0 +1,156 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Fixed memory latency histograms with percentile queries, for frame and
+ * phase times.
+ */
+#ifndef OPENSTEER_LATENCYHISTOGRAM_H
+#define OPENSTEER_LATENCYHISTOGRAM_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Histogram of durations with log-linear buckets in the style of
+     * HdrHistogram: durations are counted in nanoseconds, below
+     * <code>2 * subBucketCount</code> nanoseconds every value has its own
+     * bucket, above every power of two range is split into
+     * @c subBucketCount buckets of equal width. Percentiles are exact to
+     * the bucket width, at most <code>1 / subBucketCount</code> of the
+     * value, from nanoseconds to @c maxTrackedSeconds (larger durations
+     * are counted in the last bucket), in constant memory and with
+     * constant time recording.
+     *
+     * @c max and @c mean are exact.
+     */
+    class LatencyHistogram {
+    public:
+        enum { subBucketBits = 5,
+               subBucketCount = 1 << subBucketBits,
+               maxTrackedBits = 40,
+               bucketCount = ( maxTrackedBits - subBucketBits + 1 ) * subBucketCount };
+
+        LatencyHistogram();
+
+        /**
+         * Counts a duration of @a seconds, negative durations as @c 0.
+         */
+        void record( double seconds );
+
+        /**
+         * Adds the counts of @a other.
+         */
+        void add( LatencyHistogram const& other );
+
+        void clear();
+
+        size_t count() const { return count_; }
+        double max() const { return maxSeconds_; }
+        double mean() const;
+
+        /**
+         * Duration that @a fraction (in <code>[0, 1]</code>) of the
+         * recorded durations don't exceed, e.g. @c 0.99 for the 99th
+         * percentile: the upper end of the bucket holding that rank, but
+         * not more than @c max. @c 0 if nothing was recorded.
+         */
+        double percentile( double fraction ) const;
+
+        /**
+         * Recorded durations in buckets that start above @a seconds.
+         */
+        size_t countAbove( double seconds ) const;
+
+        /**
+         * Bucket access, e.g. to print the distribution. Bucket @a index
+         * counts the durations from @c bucketLowerBound up to, but not
+         * including, @c bucketUpperBound (in seconds).
+         */
+        size_t bucketSampleCount( size_t index ) const { return counts_[ index ]; }
+        static double bucketLowerBound( size_t index );
+        static double bucketUpperBound( size_t index );
+        static size_t bucketIndex( double seconds );
+
+    private:
+        typedef unsigned long long Nanoseconds;
+
+        static Nanoseconds bucketLowerNanoseconds( size_t index );
+
+    private:
+        unsigned int counts_[ bucketCount ];
+        size_t count_;
+        double totalSeconds_;
+        double maxSeconds_;
+    }; // class LatencyHistogram
+
+
+    /**
+     * Latency histogram over the last <code>segmentCount *
+     * samplesPerSegment</code> durations (a sliding window moving in steps
+     * of @a samplesPerSegment), and the number of stalls among them:
+     * durations above @c stallThreshold.
+     *
+     * Keeps one @c LatencyHistogram per segment and drops the oldest one
+     * when a segment is complete, so memory stays constant.
+     */
+    class LatencyWindow {
+    public:
+        LatencyWindow( size_t segmentCount, size_t samplesPerSegment, double stallThreshold );
+
+        void record( double seconds );
+        void clear();
+
+        /**
+         * Sum of the segment histograms.
+         */
+        LatencyHistogram histogram() const;
+
+        size_t stallCount() const;
+
+        double stallThreshold() const { return stallThreshold_; }
+        void setStallThreshold( double seconds ) { stallThreshold_ = seconds; }
+
+    private:
+        std::vector< LatencyHistogram > segments_;
+        std::vector< size_t > stalls_;
+        size_t current_;
+        size_t samplesPerSegment_;
+        double stallThreshold_;
+    }; // class LatencyWindow
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_LATENCYHISTOGRAM_H
@@ -65,6 +65,9 @@
 
 
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/Vec3A.h"
+#include "OpenSteer/Vec3Utilities.h"
+#include "OpenSteer/StandardTypes.h"
 
 
 // ----------------------------------------------------------------------------
@@ -107,6 +110,24 @@ namespace OpenSteer {
         // transform a direction in local space to its equivalent in global space
         virtual Vec3 globalizeDirection (const Vec3& localDirection) const = 0;
 
+        // batch versions of localizePosition and globalizePosition: transform
+        // "count" points with one call (input and output may be the same)
+        virtual void localizePositions (const Vec3 globalPositions[],
+                                        Vec3 localPositions[],
+                                        const size_t count) const = 0;
+        virtual void globalizePositions (const Vec3 localPositions[],
+                                         Vec3 globalPositions[],
+                                         const size_t count) const = 0;
+
+        // globalize the regular grid of points localOrigin + row * rowStep +
+        // column * columnStep, stored row by row in globalPositions
+        virtual void globalizePositionGrid (const Vec3& localOrigin,
+                                            const Vec3& localRowStep,
+                                            const size_t rowCount,
+                                            const Vec3& localColumnStep,
+                                            const size_t columnCount,
+                                            Vec3 globalPositions[]) const = 0;
+
         // set "side" basis vector to normalized cross product of forward and up
         virtual void setUnitSideFromForwardAndUp (void) = 0;
 
@@ -138,13 +159,14 @@ namespace OpenSteer {
         // transformation as three orthonormal unit basis vectors and the
         // origin of the local space.  These correspond to the "rows" of
         // a 3x4 transformation matrix with [0 0 0 1] as the final column
+        // (stored as Vec3A when building with OPENSTEER_USE_VEC3A)
 
     private:
 
-        Vec3 _side;     //    side-pointing unit basis vector
-        Vec3 _up;       //  upward-pointing unit basis vector
-        Vec3 _forward;  // forward-pointing unit basis vector
-        Vec3 _position; // origin of local space
+        ComputeVec3 _side;     //    side-pointing unit basis vector
+        ComputeVec3 _up;       //  upward-pointing unit basis vector
+        ComputeVec3 _forward;  // forward-pointing unit basis vector
+        ComputeVec3 _position; // origin of local space
 
     public:
 
@@ -226,9 +248,10 @@ namespace OpenSteer {
         Vec3 localizeDirection (const Vec3& globalDirection) const
         {
             // dot offset with local basis vectors to obtain local coordiantes
-            return Vec3 (globalDirection.dot (_side),
-                         globalDirection.dot (_up),
-                         globalDirection.dot (_forward));
+            const ComputeVec3 direction (globalDirection);
+            return Vec3 (direction.dot (_side),
+                         direction.dot (_up),
+                         direction.dot (_forward));
         };
 
 
@@ -239,7 +262,7 @@ namespace OpenSteer {
         Vec3 localizePosition (const Vec3& globalPosition) const
         {
             // global offset from local origin
-            Vec3 globalOffset = globalPosition - _position;
+            const ComputeVec3 globalOffset = ComputeVec3 (globalPosition) - _position;
 
             // dot offset with local basis vectors to obtain local coordiantes
             return localizeDirection (globalOffset);
@@ -252,7 +275,7 @@ namespace OpenSteer {
 
         Vec3 globalizePosition (const Vec3& localPosition) const
         {
-            return _position + globalizeDirection (localPosition);
+            return _position + ComputeVec3 (globalizeDirection (localPosition));
         };
 
 
@@ -268,6 +291,52 @@ namespace OpenSteer {
         };
 
 
+        // ------------------------------------------------------------------------
+        // batch transformations of many points, for example the samples of a
+        // scan pattern: one (virtual) call per batch instead of per point,
+        // computed with the array kernels of Vec3Utilities (four points at a
+        // time where SSE is available)
+
+
+        void localizePositions (const Vec3 globalPositions[],
+                                Vec3 localPositions[],
+                                const size_t count) const
+        {
+            OpenSteer::localizePositions (_side, _up, _forward, _position,
+                                          globalPositions, localPositions,
+                                          count);
+        }
+
+
+        void globalizePositions (const Vec3 localPositions[],
+                                 Vec3 globalPositions[],
+                                 const size_t count) const
+        {
+            OpenSteer::globalizePositions (_side, _up, _forward, _position,
+                                           localPositions, globalPositions,
+                                           count);
+        }
+
+
+        // only origin and steps are transformed, the grid points are stepped
+        // in global space (so they may differ from globalizePosition in the
+        // last bits)
+
+        void globalizePositionGrid (const Vec3& localOrigin,
+                                    const Vec3& localRowStep,
+                                    const size_t rowCount,
+                                    const Vec3& localColumnStep,
+                                    const size_t columnCount,
+                                    Vec3 globalPositions[]) const
+        {
+            OpenSteer::globalizePositionGrid (_side, _up, _forward, _position,
+                                              localOrigin,
+                                              localRowStep, rowCount,
+                                              localColumnStep, columnCount,
+                                              globalPositions);
+        }
+
+
         // ------------------------------------------------------------------------
         // set "side" basis vector to normalized cross product of forward and up
 
@@ -305,6 +374,35 @@ namespace OpenSteer {
         }
 
 
+        // lazy version: set the new forward (expected to have unit length)
+        // but keep side and up as long as they are still perpendicular to it
+        // within "tolerance" (the cosine of the angle between forward and
+        // side or up), which is the case for a new forward close to the one
+        // the basis was last regenerated for.  Saves the cross products and
+        // the normalization at the price of a basis which is orthonormal only
+        // up to "tolerance".  Returns true if side and up were regenerated.
+
+        bool lazyRegenerateOrthonormalBasisUF (const Vec3& newUnitForward,
+                                               const float tolerance)
+        {
+            // (a reversed forward is perpendicular to side and up as well,
+            // but flips the handedness of the basis)
+            const ComputeVec3 newForward (newUnitForward);
+            const float sideDrift = newForward.dot (_side);
+            const float upDrift = newForward.dot (_up);
+            if ((sideDrift * sideDrift <= tolerance * tolerance) &&
+                (upDrift * upDrift <= tolerance * tolerance) &&
+                (newForward.dot (_forward) > 0))
+            {
+                _forward = newForward;
+                return false;
+            }
+
+            regenerateOrthonormalBasisUF (newUnitForward);
+            return true;
+        }
+
+
         // for when the new forward is NOT know to have unit length
 
         void regenerateOrthonormalBasis (const Vec3& newForward)
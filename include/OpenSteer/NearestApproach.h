@@ -0,0 +1,161 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Nearest approach (collision prediction) of one vehicle against a batch of
+ * neighbors at once.
+ */
+#ifndef OPENSTEER_NEARESTAPPROACH_H
+#define OPENSTEER_NEARESTAPPROACH_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Positions and velocities of a group of neighbors stored coordinate by
+     * coordinate in separate arrays (structure of arrays) whose capacity is
+     * a multiple of @c width, so @c findMostImminentApproach can process
+     * @c width neighbors per step.
+     *
+     * Meant to be kept and refilled per frame, @c clear keeps the memory.
+     */
+    class NearestApproachBatch {
+    public:
+        enum { width = 8 };
+
+        NearestApproachBatch();
+
+        void clear() { size_ = 0; }
+
+        void add( Vec3 const& position, Vec3 const& velocity ) {
+            if ( size_ == positionsX_.size() ) {
+                grow();
+            }
+            positionsX_[ size_ ] = position.x;
+            positionsY_[ size_ ] = position.y;
+            positionsZ_[ size_ ] = position.z;
+            velocitiesX_[ size_ ] = velocity.x;
+            velocitiesY_[ size_ ] = velocity.y;
+            velocitiesZ_[ size_ ] = velocity.z;
+            ++size_;
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return 0 == size_; }
+
+        /**
+         * Makes room for @a count neighbors without further allocations.
+         */
+        void reserve( size_t count );
+        size_t capacity() const { return positionsX_.size(); }
+
+        Vec3 position( size_t index ) const;
+        Vec3 velocity( size_t index ) const;
+
+        /**
+         * Coordinate arrays, each holds at least @c size values rounded up
+         * to a multiple of @c width.
+         */
+        float const* positionsX() const { return &positionsX_[ 0 ]; }
+        float const* positionsY() const { return &positionsY_[ 0 ]; }
+        float const* positionsZ() const { return &positionsZ_[ 0 ]; }
+        float const* velocitiesX() const { return &velocitiesX_[ 0 ]; }
+        float const* velocitiesY() const { return &velocitiesY_[ 0 ]; }
+        float const* velocitiesZ() const { return &velocitiesZ_[ 0 ]; }
+
+    private:
+        void grow();
+
+    private:
+        size_t size_;
+        std::vector< float > positionsX_;
+        std::vector< float > positionsY_;
+        std::vector< float > positionsZ_;
+        std::vector< float > velocitiesX_;
+        std::vector< float > velocitiesY_;
+        std::vector< float > velocitiesZ_;
+    }; // class NearestApproachBatch
+
+
+    /**
+     * Most imminent threat found by @c findMostImminentApproach.
+     */
+    struct NearestApproach {
+        /// Index of the neighbor in the batch.
+        size_t index;
+
+        /// Time until the nearest approach.
+        float time;
+
+        /// Distance between vehicle and neighbor at the nearest approach.
+        float distance;
+
+        /// Positions of vehicle and neighbor at the nearest approach.
+        Vec3 ourPosition;
+        Vec3 neighborPosition;
+    };
+
+
+    /**
+     * Predicts for every neighbor in @a neighbors when it comes nearest to
+     * a vehicle at @a position moving with @a velocity (assuming both keep
+     * their velocities) and how near. Of the neighbors coming nearer than
+     * @a collisionDistance at a time in [0, @a maxTime) the one coming
+     * soonest (the first one of equally soon ones) is returned in
+     * @a approach.
+     *
+     * Returns @c false and leaves @a approach untouched if no neighbor comes
+     * that near in time.
+     *
+     * Gives the same results (up to rounding) as calling
+     * @c predictNearestApproachTime and @c computeNearestApproachPositions
+     * of @c SteerLibraryMixin neighbor by neighbor, but neighbor data is
+     * read from the packed arrays and @c NearestApproachBatch::width
+     * neighbors are computed per step in a loop without branches compilers
+     * can vectorize.
+     */
+    bool findMostImminentApproach( Vec3 const& position,
+                                   Vec3 const& velocity,
+                                   NearestApproachBatch const& neighbors,
+                                   float collisionDistance,
+                                   float maxTime,
+                                   NearestApproach& approach );
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_NEARESTAPPROACH_H
@@ -0,0 +1,181 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Two phase vehicle update: a parallel steering phase reading the state of
+ * all vehicles and a phase applying the steering forces.
+ */
+#ifndef OPENSTEER_PARALLELUPDATE_H
+#define OPENSTEER_PARALLELUPDATE_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::min
+#include <algorithm>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::ThreadPool
+#include "OpenSteer/ThreadPool.h"
+
+// Include OpenSteer::TaskGraph
+#include "OpenSteer/TaskGraph.h"
+
+// Include OpenSteer::ScratchBuffer
+#include "OpenSteer/ScratchBuffer.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Steering phase of a two phase update: stores
+     * <code>steer( *vehicles[ i ] )</code> in <code>forces[ i ]</code> for
+     * all @a vehicles, spread over the threads of @a pool, or on the calling
+     * thread if @a pool is @c 0.
+     *
+     * No vehicle moves during this phase, so all vehicles steer from the
+     * same snapshot, their state at the start of the frame, independent of
+     * the order and the number of threads. @a forces holds the results
+     * until the caller applies them (with @c applySteeringForces or a
+     * @c BatchIntegrator) and updates the proximity database.
+     *
+     * @a steer may read all vehicles but write only state of the vehicle
+     * it is called for (random generator, steering caches, wander state)
+     * and must borrow temporaries from @c ScratchBuffer. The vehicles are
+     * handed out in chunks, threads done early take over chunks of the
+     * others.
+     */
+    template< typename Group, typename Steer >
+    void computeSteeringForces( ThreadPool* pool,
+                                Group const& vehicles,
+                                std::vector< Vec3 >& forces,
+                                Steer const& steer ) {
+        OPENSTEER_PROFILE_ZONE( "computeSteeringForces" );
+
+        forces.resize( vehicles.size() );
+
+        auto steerRange = [ & ]( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i ) {
+                forces[ i ] = steer( *vehicles[ i ] );
+            }
+        };
+
+        if ( 0 != pool ) {
+            pool->parallelFor( vehicles.size(), steerRange );
+        } else {
+            steerRange( 0, vehicles.size() );
+        }
+    }
+
+
+    /**
+     * Apply phase of a two phase update: calls
+     * <code>integrate( *vehicles[ i ], i )</code> and then
+     * <code>commit( *vehicles[ i ], i )</code> for all @a vehicles.
+     *
+     * @a integrate may only change the vehicle it is called for, typically
+     * it applies the force from @c computeSteeringForces, and runs in
+     * parallel on the threads of @a pool. @a commit runs for one vehicle
+     * after the other in index order, for work touching shared state like
+     * updating the proximity database. Commits of the first vehicles
+     * overlap with the integration of the later ones.
+     *
+     * Without @a pool both run on the calling thread, vehicle by vehicle.
+     * The results are the same.
+     */
+    template< typename Group, typename Integrate, typename Commit >
+    void applySteeringForces( ThreadPool* pool,
+                              Group const& vehicles,
+                              Integrate const& integrate,
+                              Commit const& commit ) {
+        OPENSTEER_PROFILE_ZONE( "applySteeringForces" );
+
+        size_t const count = vehicles.size();
+
+        if ( 0 == pool ) {
+            for ( size_t i = 0; i < count; ++i ) {
+                integrate( *vehicles[ i ], i );
+                commit( *vehicles[ i ], i );
+            }
+            return;
+        }
+
+        // Chunk k is integrated in parallel with the others and committed
+        // after its own integration and the commit of chunk k - 1:
+        //
+        //     integrate 0   integrate 1   integrate 2   ...
+        //          |             |             |
+        //      commit 0  -->  commit 1  -->  commit 2  --> ...
+        struct Chunks {
+            Group const& vehicles;
+            Integrate const& integrate;
+            Commit const& commit;
+            size_t count;
+            size_t grainSize;
+
+            void integrateChunk( size_t chunk ) const {
+                size_t const end = std::min( count, ( chunk + 1 ) * grainSize );
+                for ( size_t i = chunk * grainSize; i < end; ++i ) {
+                    integrate( *vehicles[ i ], i );
+                }
+            }
+
+            void commitChunk( size_t chunk ) const {
+                size_t const end = std::min( count, ( chunk + 1 ) * grainSize );
+                for ( size_t i = chunk * grainSize; i < end; ++i ) {
+                    commit( *vehicles[ i ], i );
+                }
+            }
+        };
+        Chunks const chunks = { vehicles, integrate, commit, count, pool->grainSize( count ) };
+        size_t const chunkCount = ( count + chunks.grainSize - 1 ) / chunks.grainSize;
+
+        ScratchBuffer< TaskGraph > graph;
+        TaskGraph::Task previousCommit = 0;
+        for ( size_t chunk = 0; chunk < chunkCount; ++chunk ) {
+            Chunks const* const context = &chunks;
+            TaskGraph::Task const integrateTask = graph->add( [ context, chunk ]() { context->integrateChunk( chunk ); } );
+            TaskGraph::Task const commitTask = graph->add( [ context, chunk ]() { context->commitChunk( chunk ); } );
+            graph->precede( integrateTask, commitTask );
+            if ( 0 != chunk ) {
+                graph->precede( previousCommit, commitTask );
+            }
+            previousCommit = commitTask;
+        }
+        pool->run( *graph );
+    }
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PARALLELUPDATE_H
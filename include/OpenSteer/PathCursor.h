@@ -0,0 +1,189 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Per vehicle cursor on a segmented pathway to answer path queries by only
+ * looking at the segments around the last known position.
+ */
+#ifndef OPENSTEER_PATHCURSOR_H
+#define OPENSTEER_PATHCURSOR_H
+
+
+// Include OpenSteer::SegmentedPathway
+#include "OpenSteer/SegmentedPathway.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Remembers the segment and the distance along a @c SegmentedPathway a
+     * vehicle has been mapped to by the last call to @c track.
+     *
+     * Queries start at the remembered segment and only move on to the
+     * neighboring segments while these are nearer to the query point, so
+     * a vehicle moving steadily along the pathway pays for a few segment
+     * tests per query instead of a test of every segment. A global search
+     * over all segments (like @c mapPointToPathAlike does) is only done
+     *
+     * - for the first query or after @c reset,
+     * - if the tracked point moved farther than @c jumpDistance since the
+     *   last call to @c track (the vehicle jumped or was teleported), or
+     * - if the locally found point lies farther than a pathway radius
+     *   outside the pathway (the vehicle is lost, e.g. near a part of the
+     *   pathway folding back onto itself).
+     *
+     * Where parts of a pathway overlap the cursor prefers the part it is
+     * tracking, which might differ from the globally nearest one.
+     *
+     * The same cursor must not be used with different pathways without a
+     * call to @c reset in between.
+     */
+    class PathCursor {
+    public:
+        typedef SegmentedPathway::size_type size_type;
+
+        PathCursor();
+        explicit PathCursor( float jumpDistance );
+
+        /**
+         * Forgets the tracked position, the next query searches globally.
+         */
+        void reset();
+
+        /**
+         * Returns @c true if the cursor has been placed on a pathway by
+         * @c track.
+         */
+        bool isValid() const { return valid_; }
+
+        void setJumpDistance( float distance ) { jumpDistance_ = distance; }
+        float jumpDistance() const { return jumpDistance_; }
+
+        /**
+         * Index of the segment the cursor is placed on.
+         */
+        size_type segmentIndex() const { return segmentIndex_; }
+
+        /**
+         * Distance from the start of segment @c segmentIndex to the cursor.
+         */
+        float segmentDistance() const { return segmentDistance_; }
+
+        /**
+         * Distance along the pathway from its start to the cursor.
+         */
+        float pathDistance() const { return segmentStartDistance_ + segmentDistance_; }
+
+        /**
+         * Maps @a point to @a pathway, moves the cursor to the point on the
+         * pathway center line nearest to it and returns its distance along
+         * the pathway. Equivalent to @c Pathway::mapPointToPathDistance.
+         */
+        float track( SegmentedPathway const& pathway, Vec3 const& point );
+
+        /**
+         * Equivalent to @c Pathway::mapPointToPath but searches around the
+         * cursor position and additionally returns the distance along the
+         * pathway of the mapped point in @a pathDistance. Doesn't move the
+         * cursor.
+         */
+        Vec3 mapPointToPath( SegmentedPathway const& pathway,
+                             Vec3 const& point,
+                             Vec3& tangent,
+                             float& outside,
+                             float& pathDistance ) const;
+
+        /**
+         * Equivalent to @c Pathway::mapPathDistanceToPoint but walks the
+         * segments starting at the cursor position. Doesn't move the cursor.
+         */
+        Vec3 mapPathDistanceToPoint( SegmentedPathway const& pathway,
+                                     float pathDistance ) const;
+
+        /**
+         * Number of queries answered by searching around the cursor and by
+         * searching all segments.
+         */
+        size_t localSearchCount() const { return localSearchCount_; }
+        size_t globalSearchCount() const { return globalSearchCount_; }
+        void resetSearchCounts();
+
+    private:
+
+        /**
+         * Result of mapping a point to a single segment.
+         */
+        struct SegmentMapping {
+            size_type segmentIndex;
+            float segmentStartDistance;
+            float segmentDistance;
+            float radius;
+            float distancePointToPath;
+            Vec3 pointOnPathCenterLine;
+            Vec3 tangent;
+        };
+
+        static void mapPointToSegment( SegmentedPathway const& pathway,
+                                       size_type segmentIndex,
+                                       float segmentStartDistance,
+                                       Vec3 const& point,
+                                       SegmentMapping& mapping );
+
+        static void mapPointGlobally( SegmentedPathway const& pathway,
+                                      Vec3 const& point,
+                                      SegmentMapping& mapping );
+
+        static void mapPointLocally( SegmentedPathway const& pathway,
+                                     Vec3 const& point,
+                                     SegmentMapping& mapping );
+
+        void mapPoint( SegmentedPathway const& pathway,
+                       Vec3 const& point,
+                       bool jumped,
+                       SegmentMapping& mapping ) const;
+
+    private:
+        bool valid_;
+        float jumpDistance_;
+        size_type segmentIndex_;
+        float segmentStartDistance_;
+        float segmentDistance_;
+        Vec3 trackedPoint_;
+        mutable size_t localSearchCount_;
+        mutable size_t globalSearchCount_;
+    }; // class PathCursor
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PATHCURSOR_H
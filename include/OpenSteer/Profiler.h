@@ -0,0 +1,238 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Scoped profiler: nestable named zones timed per thread, aggregated into
+ * per-zone statistics and optionally recorded as a Chrome trace.
+ */
+#ifndef OPENSTEER_PROFILER_H
+#define OPENSTEER_PROFILER_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::ostream
+#include <iosfwd>
+
+// Include std::atomic
+#include <atomic>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Time spent in one zone since the last
+     * @c Profiler::resetStatistics, summed over all threads.
+     */
+    struct ProfileZoneStatistics {
+        char const* name;
+
+        /**
+         * Nesting level, @c 0 for outermost zones. Zones of tasks that a
+         * @c ThreadPool runs for a zone count as nested in that zone.
+         */
+        size_t depth;
+
+        size_t calls;
+
+        /**
+         * Time between entering and leaving the zone.
+         */
+        double seconds;
+
+        /**
+         * @c seconds without the time of zones nested on the same thread.
+         */
+        double selfSeconds;
+    };
+
+
+    /**
+     * Process wide profiler for zones marked with
+     * @c OPENSTEER_PROFILE_ZONE.
+     *
+     * Zones are identified by their name and the zone they are nested in,
+     * so the same name inside different zones is counted separately.
+     * Every thread records its zones with nanosecond timestamps into its
+     * own buffer without locking. @c endFrame, called between frames while
+     * no zone is open, collects the buffers into the statistics and, while
+     * recording, into the trace.
+     *
+     * Profiling is off until @c setEnabled is called. While off a zone
+     * costs a test of a flag, building with @c OPENSTEER_NO_PROFILER
+     * defined removes the zones altogether.
+     */
+    class Profiler {
+    public:
+        /**
+         * Handle of a zone (a name nested in a parent zone), @c 0 outside
+         * of all zones.
+         */
+        typedef size_t Zone;
+
+        static void setEnabled( bool enabled );
+        static bool enabled() { return enabled_.load( std::memory_order_relaxed ); }
+
+        /**
+         * Enter and leave a zone on the calling thread, @a name must stay
+         * valid (use string literals). Use @c ProfileZone instead.
+         */
+        static void beginZone( char const* name );
+        static void endZone();
+
+        /**
+         * Innermost zone open on the calling thread.
+         */
+        static Zone currentZone();
+
+        /**
+         * Collects the zones recorded by all threads since the last call.
+         * Must not run while zones are open on other threads.
+         */
+        static void endFrame();
+
+        /**
+         * Calls of @c endFrame since the last @c resetStatistics.
+         */
+        static size_t frameCount();
+
+        /**
+         * Statistics of all zones entered since the last
+         * @c resetStatistics, every zone followed by the zones nested in
+         * it.
+         */
+        static std::vector< ProfileZoneStatistics > statistics();
+        static void resetStatistics();
+
+        /**
+         * While recording @c endFrame keeps every zone call, up to
+         * @a maxEvents of them, for @c writeChromeTrace.
+         */
+        static void setTraceRecording( bool recording, size_t maxEvents = 1000000 );
+        static size_t traceEventCount();
+        static void clearTrace();
+
+        /**
+         * Writes the recorded zone calls in the Chrome trace event format
+         * (JSON, open with chrome://tracing or Perfetto), one track per
+         * thread.
+         */
+        static void writeChromeTrace( std::ostream& stream );
+
+    private:
+        /**
+         * Only static members.
+         */
+        Profiler();
+
+        static std::atomic< bool > enabled_;
+    }; // class Profiler
+
+
+    /**
+     * Times the zone @a name from construction to destruction if the
+     * profiler is enabled at construction.
+     */
+    class ProfileZone {
+    public:
+        explicit ProfileZone( char const* name )
+            : active_( Profiler::enabled() ) {
+            if ( active_ ) {
+                Profiler::beginZone( name );
+            }
+        }
+
+        ~ProfileZone() {
+            if ( active_ ) {
+                Profiler::endZone();
+            }
+        }
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProfileZone( ProfileZone const& );
+
+        /**
+         * Not implemented to make it non-assignable.
+         */
+        ProfileZone& operator=( ProfileZone const& );
+
+    private:
+        bool const active_;
+    }; // class ProfileZone
+
+
+    /**
+     * Makes zones entered on the calling thread nest in @a zone until
+     * destruction. Used by @c ThreadPool to attribute tasks to the zone
+     * of the thread that started them.
+     */
+    class ProfileZoneContext {
+    public:
+        explicit ProfileZoneContext( Profiler::Zone zone );
+        ~ProfileZoneContext();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProfileZoneContext( ProfileZoneContext const& );
+
+        /**
+         * Not implemented to make it non-assignable.
+         */
+        ProfileZoneContext& operator=( ProfileZoneContext const& );
+
+    private:
+        bool const active_;
+        Profiler::Zone previous_;
+    }; // class ProfileZoneContext
+
+} // namespace OpenSteer
+
+
+#define OPENSTEER_PROFILE_CONCATENATE_( a, b ) a ## b
+#define OPENSTEER_PROFILE_CONCATENATE( a, b ) OPENSTEER_PROFILE_CONCATENATE_( a, b )
+
+/**
+ * Times the rest of the enclosing scope as zone @a name (a string literal).
+ */
+#ifdef OPENSTEER_NO_PROFILER
+    #define OPENSTEER_PROFILE_ZONE( name ) ( ( void ) 0 )
+#else
+    #define OPENSTEER_PROFILE_ZONE( name ) \
+        ::OpenSteer::ProfileZone const OPENSTEER_PROFILE_CONCATENATE( openSteerProfileZone, __LINE__ )( name )
+#endif
+
+
+#endif // OPENSTEER_PROFILER_H
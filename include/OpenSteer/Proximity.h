@@ -47,6 +47,7 @@
 #include <vector>
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/lq.h"   // XXX temp?
+#include "OpenSteer/Profiler.h"
 
 
 namespace OpenSteer {
@@ -165,6 +166,8 @@ namespace OpenSteer {
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
+                OPENSTEER_PROFILE_ZONE ("BruteForceProximityDatabase::findNeighbors");
+
                 // loop over all tokens
                 const float r2 = radius * radius;
                 for (tokenIterator i = bfpd->group.begin();
@@ -258,6 +261,8 @@ namespace OpenSteer {
             // the client object calls this each time its position changes
             void updateForNewPosition (const Vec3& p)
             {
+                OPENSTEER_PROFILE_ZONE ("LQProximityDatabase::updateForNewPosition");
+
                 lqUpdateForNewLocation (lq, &proxy, p.x, p.y, p.z);
             }
 
@@ -266,6 +271,8 @@ namespace OpenSteer {
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
+                OPENSTEER_PROFILE_ZONE ("LQProximityDatabase::findNeighbors");
+
                 lqMapOverAllObjectsInLocality (lq, 
                                                center.x, center.y, center.z,
                                                radius,
@@ -0,0 +1,207 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Small and fast pseudo random number generator to give every vehicle its
+ * own random number stream.
+ */
+#ifndef OPENSTEER_RANDOMGENERATOR_H
+#define OPENSTEER_RANDOMGENERATOR_H
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * xoshiro256+ pseudo random number generator (David Blackman and
+     * Sebastiano Vigna, 2018) seeded via splitmix64.
+     *
+     * In contrast to @c frandom01 (which wraps the global @c rand) every
+     * instance is an independent stream: generators owned by different
+     * vehicles can be used from different threads, and a vehicle seeded
+     * with the same value always draws the same sequence.
+     *
+     * The float and vector functions draw from the same distributions as
+     * @c frandom01, @c scalarRandomWalk, @c RandomVectorInUnitRadiusSphere,
+     * @c randomVectorOnUnitRadiusXZDisk, @c RandomUnitVector and
+     * @c RandomUnitVectorOnXZPlane.
+     */
+    class RandomGenerator {
+    public:
+        typedef unsigned long long result_type;
+
+        explicit RandomGenerator( result_type seedValue = 0 ) {
+            seed( seedValue );
+        }
+
+        /**
+         * Restarts the stream. Different seeds, also consecutive ones like
+         * vehicle serial numbers, result in unrelated streams.
+         */
+        void seed( result_type seedValue ) {
+            for ( size_t i = 0; i < 4; ++i ) {
+                seedValue += 0x9e3779b97f4a7c15ULL;
+                result_type z = seedValue;
+                z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+                z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+                state_[ i ] = z ^ ( z >> 31 );
+            }
+        }
+
+        /**
+         * Returns the next 64 bit value of the stream.
+         */
+        result_type next() {
+            result_type const result = state_[ 0 ] + state_[ 3 ];
+            result_type const t = state_[ 1 ] << 17;
+
+            state_[ 2 ] ^= state_[ 0 ];
+            state_[ 3 ] ^= state_[ 1 ];
+            state_[ 1 ] ^= state_[ 2 ];
+            state_[ 0 ] ^= state_[ 3 ];
+            state_[ 2 ] ^= t;
+            state_[ 3 ] = rotateLeft( state_[ 3 ], 45 );
+
+            return result;
+        }
+
+        /**
+         * Returns a float randomly distributed in [0, 1).
+         */
+        float random01() {
+            // Upper 24 bits fill the float mantissa exactly.
+            return static_cast< float >( next() >> 40 ) * ( 1.0f / 16777216.0f );
+        }
+
+        /**
+         * Returns a float randomly distributed between @a lowerBound and
+         * @a upperBound.
+         */
+        float random2( float lowerBound, float upperBound ) {
+            return lowerBound + ( random01() * ( upperBound - lowerBound ) );
+        }
+
+        /**
+         * Random walk, see @c scalarRandomWalk.
+         */
+        float randomWalk( float initial, float walkspeed, float min, float max ) {
+            float const nextValue = initial + ( ( ( random01() * 2.0f ) - 1.0f ) * walkspeed );
+            if ( nextValue < min ) return min;
+            if ( nextValue > max ) return max;
+            return nextValue;
+        }
+
+        /**
+         * Returns a position randomly distributed inside a sphere of unit
+         * radius centered at the origin.
+         */
+        Vec3 vectorInUnitRadiusSphere() {
+            Vec3 v;
+            do {
+                v.set( random2( -1.0f, 1.0f ),
+                       random2( -1.0f, 1.0f ),
+                       random2( -1.0f, 1.0f ) );
+            } while ( v.lengthSquared() >= 1.0f );
+            return v;
+        }
+
+        /**
+         * Returns a position randomly distributed on a disk of unit radius
+         * on the XZ (Y=0) plane, centered at the origin.
+         */
+        Vec3 vectorOnUnitRadiusXZDisk() {
+            Vec3 v;
+            do {
+                v.set( random2( -1.0f, 1.0f ),
+                       0.0f,
+                       random2( -1.0f, 1.0f ) );
+            } while ( v.lengthSquared() >= 1.0f );
+            return v;
+        }
+
+        /**
+         * Returns a random direction in space.
+         */
+        Vec3 unitVector() {
+            Vec3 v;
+            float lengthSquared = 0.0f;
+            do {
+                v = vectorInUnitRadiusSphere();
+                lengthSquared = v.lengthSquared();
+            } while ( 0.0f == lengthSquared );
+            return v.normalize();
+        }
+
+        /**
+         * Returns a random direction on the XZ (Y=0) plane.
+         */
+        Vec3 unitVectorOnXZPlane() {
+            Vec3 v;
+            float lengthSquared = 0.0f;
+            do {
+                v = vectorOnUnitRadiusXZDisk();
+                lengthSquared = v.lengthSquared();
+            } while ( 0.0f == lengthSquared );
+            return v.normalize();
+        }
+
+        /**
+         * Batch versions: fill @a values with @a count random values.
+         *
+         * The unit vector versions draw all candidates first and normalize
+         * them with the array kernel @c normalizeVectors, they produce the
+         * same vectors as calling @c unitVector or @c unitVectorOnXZPlane
+         * @a count times. The overloads taking @a xs, @a ys and @a zs store
+         * the coordinates in separate arrays.
+         */
+        void random01s( float values[], size_t count );
+        void vectorsInUnitRadiusSphere( Vec3 vectors[], size_t count );
+        void vectorsOnUnitRadiusXZDisk( Vec3 vectors[], size_t count );
+        void unitVectors( Vec3 vectors[], size_t count );
+        void unitVectors( float xs[], float ys[], float zs[], size_t count );
+        void unitVectorsOnXZPlane( Vec3 vectors[], size_t count );
+        void unitVectorsOnXZPlane( float xs[], float ys[], float zs[], size_t count );
+
+    private:
+        static result_type rotateLeft( result_type x, int k ) {
+            return ( x << k ) | ( x >> ( 64 - k ) );
+        }
+
+    private:
+        result_type state_[ 4 ];
+    }; // class RandomGenerator
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_RANDOMGENERATOR_H
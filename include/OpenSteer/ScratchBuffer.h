@@ -0,0 +1,154 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Per-thread scratch buffers for temporaries of steering computations like
+ * neighbor query results.
+ */
+#ifndef OPENSTEER_SCRATCHBUFFER_H
+#define OPENSTEER_SCRATCHBUFFER_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Number of times a scratch buffer of any thread had to allocate memory:
+     * when a thread needed a further buffer of a type or when a buffer grew
+     * beyond its capacity. Stays constant once all threads have seen their
+     * largest neighborhoods, so comparing it before and after a frame
+     * verifies that steering runs without heap allocations.
+     */
+    size_t scratchBufferAllocationCount();
+
+    /**
+     * Called by @c ScratchBuffer, adds @a count to
+     * @c scratchBufferAllocationCount.
+     */
+    void countScratchBufferAllocations( size_t count );
+
+
+    /**
+     * Borrows an empty @c T from the pool of the calling thread for the
+     * lifetime of the @c ScratchBuffer and returns it to the pool when
+     * destroyed, keeping its capacity.
+     *
+     * Replaces buffers shared by all vehicles of a class (which serialize
+     * the update) and buffers owned by every vehicle (which cost memory per
+     * vehicle): each thread reuses the same few buffers for all vehicles it
+     * updates. Buffers can nest, a function borrowing a buffer can call
+     * functions borrowing further buffers of the same type.
+     *
+     * A new buffer reserves @c initialCapacity elements once. @c T needs a
+     * default constructor and @c clear, @c reserve and @c capacity like
+     * @c std::vector.
+     */
+    template< typename T >
+    class ScratchBuffer {
+    public:
+        enum { initialCapacity = 256 };
+
+        ScratchBuffer()
+            : buffer_( Pool::local().borrow() ), capacity_( buffer_->capacity() ) {
+            buffer_->clear();
+        }
+
+        ~ScratchBuffer() {
+            if ( buffer_->capacity() != capacity_ ) {
+                countScratchBufferAllocations( 1 );
+            }
+            Pool::local().giveBack( buffer_ );
+        }
+
+        T& operator*() const { return *buffer_; }
+        T* operator->() const { return buffer_; }
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ScratchBuffer( ScratchBuffer const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ScratchBuffer& operator=( ScratchBuffer const& );
+
+        /**
+         * Buffers of one thread not borrowed at the moment, deleted when
+         * the thread exits.
+         */
+        class Pool {
+        public:
+            Pool() { free_.reserve( 8 ); }
+
+            ~Pool() {
+                for ( size_t i = 0; i < free_.size(); ++i ) {
+                    delete free_[ i ];
+                }
+            }
+
+            static Pool& local() {
+                static thread_local Pool pool;
+                return pool;
+            }
+
+            T* borrow() {
+                if ( free_.empty() ) {
+                    countScratchBufferAllocations( 1 );
+                    T* const buffer = new T();
+                    buffer->reserve( initialCapacity );
+                    return buffer;
+                }
+                T* const buffer = free_.back();
+                free_.pop_back();
+                return buffer;
+            }
+
+            void giveBack( T* buffer ) {
+                free_.push_back( buffer );
+            }
+
+        private:
+            std::vector< T* > free_;
+        }; // class Pool
+
+    private:
+        T* buffer_;
+        size_t capacity_;
+    }; // class ScratchBuffer
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SCRATCHBUFFER_H
@@ -34,6 +34,21 @@
 // functionality to a given base class.  SteerLibraryMixin assumes its base
 // class supports the AbstractVehicle interface.
 //
+// The steering behaviors read the vehicle's own state (position, forward,
+// speed, ...) through self().  By default self() is the mixin itself and
+// each read is a virtual call of the AbstractVehicle interface.  A vehicle
+// class can pass itself as the optional second template argument (the
+// "curiously recurring template pattern"), then the reads are dispatched
+// on the concrete class instead and accessors declared "final" there are
+// inlined.  Other vehicles (neighbors, quarries, threats) are still only
+// seen through AbstractVehicle so heterogeneous groups keep working.
+//
+// The annotation hooks (annotateAvoidObstacle, annotatePathFollowing, ...
+// and annotationLine, which the base class must provide) are called through
+// self() as well, so a vehicle without annotation can declare them as empty
+// "final" functions and they vanish from the steering code.  Building with
+// OPENSTEER_NO_ANNOTATION defined removes the calls altogether.
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 02-06-03 cwr: create mixin (from "SteerMass")
 // 06-03-02 cwr: removed TS dependencies
@@ -49,8 +64,16 @@
 
 #include "OpenSteer/AbstractVehicle.h"
 #include "OpenSteer/Pathway.h"
+#include "OpenSteer/PathCursor.h"
+#include "OpenSteer/NearestApproach.h"
 #include "OpenSteer/Obstacle.h"
 #include "OpenSteer/Utilities.h"
+#include "OpenSteer/Color.h"
+#include "OpenSteer/SteeringCache.h"
+#include "OpenSteer/RandomGenerator.h"
+#include "OpenSteer/Vec3A.h"
+#include "OpenSteer/ScratchBuffer.h"
+#include "OpenSteer/Profiler.h"
 
 
 namespace OpenSteer {
@@ -58,10 +81,24 @@ namespace OpenSteer {
     // ----------------------------------------------------------------------------
 
 
-    template <class Super>
+    // maps SteerLibraryMixin's Concrete parameter to the type self() returns
+
+    template <class Mixin, class Concrete>
+    struct SteerLibrarySelf {typedef Concrete type;};
+
+    template <class Mixin>
+    struct SteerLibrarySelf<Mixin, void> {typedef Mixin type;};
+
+
+    // ----------------------------------------------------------------------------
+
+
+    template <class Super, class Concrete = void>
     class SteerLibraryMixin : public Super
     {
     public:
+        typedef typename SteerLibrarySelf<SteerLibraryMixin, Concrete>::type Self;
+
         using Super::velocity;
         using Super::maxSpeed;
         using Super::speed;
@@ -93,6 +130,10 @@ namespace OpenSteer {
             gaudyPursuitAnnotation = false;
         }
 
+        // the vehicle whose state the steering behaviors read, see above
+        Self& self (void) {return static_cast<Self&> (*this);}
+        const Self& self (void) const {return static_cast<const Self&> (*this);}
+
         // -------------------------------------------------- steering behaviors
 
         // Wander behavior
@@ -100,6 +141,16 @@ namespace OpenSteer {
         float WanderUp;
         Vec3 steerForWander (float dt);
 
+        // this vehicle's own random number stream, used by the randomized
+        // behaviors (wander) instead of the global frandom01 so vehicles
+        // can be updated concurrently and reproducibly.  Layered classes
+        // should seed it per vehicle (SimpleVehicle uses its serialNumber)
+        RandomGenerator& randomGenerator (void) {return _randomGenerator;}
+        void seedRandomGenerator (const RandomGenerator::result_type seed)
+        {
+            _randomGenerator.seed (seed);
+        }
+
         // Seek behavior
         Vec3 steerForSeek (const Vec3& target);
 
@@ -116,6 +167,17 @@ namespace OpenSteer {
                                 Pathway& path);
         Vec3 steerToStayOnPath (const float predictionTime, Pathway& path);
 
+        // versions for segmented pathways which keep track of this vehicle's
+        // position along the path in "cursor" (see PathCursor.h) to avoid
+        // searching all path segments several times per call
+        Vec3 steerToFollowPath (const int direction,
+                                const float predictionTime,
+                                SegmentedPathway& path,
+                                PathCursor& cursor);
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                SegmentedPathway& path,
+                                PathCursor& cursor);
+
         // ------------------------------------------------------------------------
         // Obstacle Avoidance behavior
         //
@@ -149,6 +211,14 @@ namespace OpenSteer {
         Vec3 steerToAvoidNeighbors (const float minTimeToCollision,
                                     const AVGroup& others);
 
+        // version which reuses the previous result stored in "cache" as
+        // long as the neighborhood has not changed beyond the cache's
+        // tolerances (see SteeringCache.h)
+
+        Vec3 steerToAvoidNeighbors (const float minTimeToCollision,
+                                    const AVGroup& others,
+                                    SteeringCache& cache);
+
 
         // Given two vehicles, based on their current positions and velocities,
         // determine the time until nearest approach
@@ -255,19 +325,19 @@ namespace OpenSteer {
 
         bool isAhead (const Vec3& target, float cosThreshold) const
         {
-            const Vec3 targetDirection = (target - position ()).normalize ();
-            return forward().dot(targetDirection) > cosThreshold;
+            const Vec3 targetDirection = (target - self().position ()).normalize ();
+            return self().forward().dot(targetDirection) > cosThreshold;
         };
         bool isAside (const Vec3& target, float cosThreshold) const
         {
-            const Vec3 targetDirection = (target - position ()).normalize ();
-            const float dp = forward().dot(targetDirection);
+            const Vec3 targetDirection = (target - self().position ()).normalize ();
+            const float dp = self().forward().dot(targetDirection);
             return (dp < cosThreshold) && (dp > -cosThreshold);
         };
         bool isBehind (const Vec3& target, float cosThreshold) const
         {
-            const Vec3 targetDirection = (target - position()).normalize ();
-            return forward().dot(targetDirection) < cosThreshold;
+            const Vec3 targetDirection = (target - self().position()).normalize ();
+            return self().forward().dot(targetDirection) < cosThreshold;
         };
 
 
@@ -305,6 +375,10 @@ namespace OpenSteer {
                                             const Vec3& /*threatFuture*/)
         {
         }
+
+    private:
+
+        RandomGenerator _randomGenerator;
     };
 
     
@@ -313,18 +387,20 @@ namespace OpenSteer {
 // ----------------------------------------------------------------------------
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForWander (float dt)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForWander");
+
     // random walk WanderSide and WanderUp between -1 and +1
     const float speed = 12.0f * dt; // maybe this (12) should be an argument?
-    WanderSide = scalarRandomWalk (WanderSide, speed, -1, +1);
-    WanderUp   = scalarRandomWalk (WanderUp,   speed, -1, +1);
+    WanderSide = _randomGenerator.randomWalk (WanderSide, speed, -1, +1);
+    WanderUp   = _randomGenerator.randomWalk (WanderUp,   speed, -1, +1);
 
     // return a pure lateral steering vector: (+/-Side) + (+/-Up)
-    return (side() * WanderSide) + (up() * WanderUp);
+    return (self().side() * WanderSide) + (self().up() * WanderUp);
 }
 
 
@@ -332,13 +408,15 @@ steerForWander (float dt)
 // Seek behavior
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForSeek (const Vec3& target)
 {
-    const Vec3 desiredVelocity = target - position();
-    return desiredVelocity - velocity();
+    OPENSTEER_PROFILE_ZONE ("steerForSeek");
+
+    const Vec3 desiredVelocity = target - self().position();
+    return desiredVelocity - self().velocity();
 }
 
 
@@ -346,13 +424,15 @@ steerForSeek (const Vec3& target)
 // Flee behavior
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForFlee (const Vec3& target)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForFlee");
+
     const Vec3 desiredVelocity = position - target;
-    return desiredVelocity - velocity();
+    return desiredVelocity - self().velocity();
 }
 
 
@@ -360,27 +440,31 @@ steerForFlee (const Vec3& target)
 // xxx proposed, experimental new seek/flee [cwr 9-16-02]
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 xxxsteerForFlee (const Vec3& target)
 {
+    OPENSTEER_PROFILE_ZONE ("xxxsteerForFlee");
+
 //  const Vec3 offset = position - target;
-    const Vec3 offset = position() - target;
-    const Vec3 desiredVelocity = offset.truncateLength (maxSpeed ()); //xxxnew
-    return desiredVelocity - velocity();
+    const Vec3 offset = self().position() - target;
+    const Vec3 desiredVelocity = offset.truncateLength (self().maxSpeed ()); //xxxnew
+    return desiredVelocity - self().velocity();
 }
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 xxxsteerForSeek (const Vec3& target)
 {
+    OPENSTEER_PROFILE_ZONE ("xxxsteerForSeek");
+
 //  const Vec3 offset = target - position;
-    const Vec3 offset = target - position();
-    const Vec3 desiredVelocity = offset.truncateLength (maxSpeed ()); //xxxnew
-    return desiredVelocity - velocity();
+    const Vec3 offset = target - self().position();
+    const Vec3 desiredVelocity = offset.truncateLength (self().maxSpeed ()); //xxxnew
+    return desiredVelocity - self().velocity();
 }
 
 
@@ -388,13 +472,15 @@ xxxsteerForSeek (const Vec3& target)
 // Path Following behaviors
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToStayOnPath (const float predictionTime, Pathway& path)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToStayOnPath");
+
     // predict our future position
-    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+    const Vec3 futurePosition = self().predictFuturePosition (predictionTime);
 
     // find the point on the path nearest the predicted future position
     Vec3 tangent;
@@ -414,28 +500,32 @@ steerToStayOnPath (const float predictionTime, Pathway& path)
         // our predicted future position was outside the path, need to
         // steer towards it.  Use onPath projection of futurePosition
         // as seek target
-        annotatePathFollowing (futurePosition, onPath, onPath, outside);
+#ifndef OPENSTEER_NO_ANNOTATION
+        self().annotatePathFollowing (futurePosition, onPath, onPath, outside);
+#endif
         return steerForSeek (onPath);
     }
 }
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToFollowPath (const int direction,
                    const float predictionTime,
                    Pathway& path)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToFollowPath");
+
     // our goal will be offset from our path distance by this amount
-    const float pathDistanceOffset = direction * predictionTime * speed();
+    const float pathDistanceOffset = direction * predictionTime * self().speed();
 
     // predict our future position
-    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+    const Vec3 futurePosition = self().predictFuturePosition (predictionTime);
 
     // measure distance along path of our current and predicted positions
     const float nowPathDistance =
-        path.mapPointToPathDistance (position ());
+        path.mapPointToPathDistance (self().position ());
     const float futurePathDistance =
         path.mapPointToPathDistance (futurePosition);
 
@@ -470,7 +560,114 @@ steerToFollowPath (const int direction,
         float const targetPathDistance = nowPathDistance + pathDistanceOffset;
         Vec3 const target = path.mapPathDistanceToPoint (targetPathDistance);
 
-        annotatePathFollowing (futurePosition, onPath, target, outside);
+#ifndef OPENSTEER_NO_ANNOTATION
+        self().annotatePathFollowing (futurePosition, onPath, target, outside);
+#endif
+
+        // return steering to seek target on path
+        return steerForSeek (target);
+    }
+}
+
+
+template<class Super, class Concrete>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
+steerToStayOnPath (const float predictionTime,
+                   SegmentedPathway& path,
+                   PathCursor& cursor)
+{
+    OPENSTEER_PROFILE_ZONE ("steerToStayOnPath");
+
+    // predict our future position
+    const Vec3 futurePosition = self().predictFuturePosition (predictionTime);
+
+    // move the cursor along with us, then find the point on the path
+    // nearest the predicted future position starting from there
+    cursor.track (path, self().position ());
+    Vec3 tangent;
+    float outside;
+    float futurePathDistance;
+    const Vec3 onPath = cursor.mapPointToPath (path,
+                                               futurePosition,
+                                               // output arguments:
+                                               tangent,
+                                               outside,
+                                               futurePathDistance);
+
+    if (outside < 0)
+    {
+        // our predicted future position was in the path,
+        // return zero steering.
+        return Vec3::zero;
+    }
+    else
+    {
+        // our predicted future position was outside the path, need to
+        // steer towards it.  Use onPath projection of futurePosition
+        // as seek target
+#ifndef OPENSTEER_NO_ANNOTATION
+        self().annotatePathFollowing (futurePosition, onPath, onPath, outside);
+#endif
+        return steerForSeek (onPath);
+    }
+}
+
+
+template<class Super, class Concrete>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
+steerToFollowPath (const int direction,
+                   const float predictionTime,
+                   SegmentedPathway& path,
+                   PathCursor& cursor)
+{
+    OPENSTEER_PROFILE_ZONE ("steerToFollowPath");
+
+    // our goal will be offset from our path distance by this amount
+    const float pathDistanceOffset = direction * predictionTime * self().speed();
+
+    // predict our future position
+    const Vec3 futurePosition = self().predictFuturePosition (predictionTime);
+
+    // measure distance along path of our current position (moving the
+    // cursor along with us) and of our predicted position, for the latter
+    // also find the nearest point on the path
+    const float nowPathDistance = cursor.track (path, self().position ());
+    Vec3 tangent;
+    float outside;
+    float futurePathDistance;
+    const Vec3 onPath = cursor.mapPointToPath (path,
+                                               futurePosition,
+                                               // output arguments:
+                                               tangent,
+                                               outside,
+                                               futurePathDistance);
+
+    // are we facing in the correction direction?
+    const bool rightway = ((pathDistanceOffset > 0) ?
+                           (nowPathDistance < futurePathDistance) :
+                           (nowPathDistance > futurePathDistance));
+
+    // no steering is required if (a) our future position is inside
+    // the path tube and (b) we are facing in the correct direction
+    if ((outside < 0) && rightway)
+    {
+        // all is well, return zero steering
+        return Vec3::zero;
+    }
+    else
+    {
+        // otherwise we need to steer towards a target point obtained
+        // by adding pathDistanceOffset to our current path position
+
+        float const targetPathDistance = nowPathDistance + pathDistanceOffset;
+        Vec3 const target = cursor.mapPathDistanceToPoint (path,
+                                                           targetPathDistance);
+
+#ifndef OPENSTEER_NO_ANNOTATION
+        self().annotatePathFollowing (futurePosition, onPath, target, outside);
+#endif
 
         // return steering to seek target on path
         return steerForSeek (target);
@@ -499,17 +696,21 @@ steerToFollowPath (const int direction,
 // XXX whose second arg is "const Obstacle& obstacle" just in case we want
 // XXX to avoid a non-grouped obstacle)
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToAvoidObstacle (const float minTimeToCollision,
                       const Obstacle& obstacle)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToAvoidObstacle");
+
     const Vec3 avoidance = obstacle.steerToAvoid (*this, minTimeToCollision);
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
+#ifndef OPENSTEER_NO_ANNOTATION
     if (avoidance != Vec3::zero)
-        annotateAvoidObstacle (minTimeToCollision * speed());
+        self().annotateAvoidObstacle (minTimeToCollision * self().speed());
+#endif
 
     return avoidance;
 }
@@ -517,19 +718,23 @@ steerToAvoidObstacle (const float minTimeToCollision,
 
 // this version avoids all of the obstacles in an ObstacleGroup
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToAvoidObstacles (const float minTimeToCollision,
                        const ObstacleGroup& obstacles)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToAvoidObstacles");
+
     const Vec3 avoidance = Obstacle::steerToAvoidObstacles (*this,
                                                             minTimeToCollision,
                                                             obstacles);
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
+#ifndef OPENSTEER_NO_ANNOTATION
     if (avoidance != Vec3::zero)
-        annotateAvoidObstacle (minTimeToCollision * speed());
+        self().annotateAvoidObstacle (minTimeToCollision * self().speed());
+#endif
 
     return avoidance;
 }
@@ -543,12 +748,14 @@ steerToAvoidObstacles (const float minTimeToCollision,
 // is zero length if there is no impending collision.
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToAvoidNeighbors (const float minTimeToCollision,
                        const AVGroup& others)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToAvoidNeighbors");
+
     // first priority is to prevent immediate interpenetration
     const Vec3 separation = steerToAvoidCloseNeighbors (0, others);
     if (separation != Vec3::zero) return separation;
@@ -557,61 +764,57 @@ steerToAvoidNeighbors (const float minTimeToCollision,
     float steer = 0;
     AbstractVehicle* threat = NULL;
 
-    // Time (in seconds) until the most immediate collision threat found
-    // so far.  Initial value is a threshold: don't look more than this
-    // many frames into the future.
-    float minTime = minTimeToCollision;
-
     // xxx solely for annotation
     Vec3 xxxThreatPositionAtNearestApproach;
     Vec3 xxxOurPositionAtNearestApproach;
 
-    // for each of the other vehicles, determine which (if any)
-    // pose the most immediate threat of collision.
+    // pack the positions and velocities of the other vehicles to determine
+    // which (if any) pose the most immediate threat of collision in one
+    // batch, see NearestApproach.h.  The buffers are borrowed from the
+    // calling thread, see ScratchBuffer.h.
+    ScratchBuffer<AVGroup> candidates;
+    ScratchBuffer<NearestApproachBatch> batch;
     for (AVIterator i = others.begin(); i != others.end(); i++)
     {
-        AbstractVehicle& other = **i;
-        if (&other != this)
-        {	
-            // avoid when future positions are this close (or less)
-            const float collisionDangerThreshold = radius() * 2;
-
-            // predicted time until nearest approach of "this" and "other"
-            const float time = predictNearestApproachTime (other);
-
-            // If the time is in the future, sooner than any other
-            // threatened collision...
-            if ((time >= 0) && (time < minTime))
-            {
-                // if the two will be close enough to collide,
-                // make a note of it
-                if (computeNearestApproachPositions (other, time)
-                    < collisionDangerThreshold)
-                {
-                    minTime = time;
-                    threat = &other;
-                    xxxThreatPositionAtNearestApproach
-                        = hisPositionAtNearestApproach;
-                    xxxOurPositionAtNearestApproach
-                        = ourPositionAtNearestApproach;
-                }
-            }
+        AbstractVehicle* other = *i;
+        if (other != this)
+        {
+            candidates->push_back (other);
+            batch->add (other->position(), other->velocity());
         }
     }
 
+    // avoid when future positions are this close (or less), don't look
+    // more than minTimeToCollision seconds into the future.
+    const float collisionDangerThreshold = self().radius() * 2;
+    NearestApproach approach;
+    if (findMostImminentApproach (self().position(),
+                                  self().velocity(),
+                                  *batch,
+                                  collisionDangerThreshold,
+                                  minTimeToCollision,
+                                  approach))
+    {
+        threat = (*candidates)[approach.index];
+        xxxThreatPositionAtNearestApproach = approach.neighborPosition;
+        xxxOurPositionAtNearestApproach = approach.ourPosition;
+        hisPositionAtNearestApproach = approach.neighborPosition;
+        ourPositionAtNearestApproach = approach.ourPosition;
+    }
+
     // if a potential collision was found, compute steering to avoid
     if (threat != NULL)
     {
         // parallel: +1, perpendicular: 0, anti-parallel: -1
-        float parallelness = forward().dot(threat->forward());
+        float parallelness = self().forward().dot(threat->forward());
         float angle = 0.707f;
 
         if (parallelness < -angle)
         {
             // anti-parallel "head on" paths:
             // steer away from future threat position
-            Vec3 offset = xxxThreatPositionAtNearestApproach - position();
-            float sideDot = offset.dot(side());
+            Vec3 offset = xxxThreatPositionAtNearestApproach - self().position();
+            float sideDot = offset.dot(self().side());
             steer = (sideDot > 0) ? -1.0f : 1.0f;
         }
         else
@@ -619,29 +822,51 @@ steerToAvoidNeighbors (const float minTimeToCollision,
             if (parallelness > angle)
             {
                 // parallel paths: steer away from threat
-                Vec3 offset = threat->position() - position();
-                float sideDot = offset.dot(side());
+                Vec3 offset = threat->position() - self().position();
+                float sideDot = offset.dot(self().side());
                 steer = (sideDot > 0) ? -1.0f : 1.0f;
             }
             else
             {
                 // perpendicular paths: steer behind threat
                 // (only the slower of the two does this)
-                if (threat->speed() <= speed())
+                if (threat->speed() <= self().speed())
                 {
-                    float sideDot = side().dot(threat->velocity());
+                    float sideDot = self().side().dot(threat->velocity());
                     steer = (sideDot > 0) ? -1.0f : 1.0f;
                 }
             }
         }
 
-        annotateAvoidNeighbor (*threat,
-                               steer,
-                               xxxOurPositionAtNearestApproach,
-                               xxxThreatPositionAtNearestApproach);
+#ifndef OPENSTEER_NO_ANNOTATION
+        self().annotateAvoidNeighbor (*threat,
+                                      steer,
+                                      xxxOurPositionAtNearestApproach,
+                                      xxxThreatPositionAtNearestApproach);
+#endif
     }
 
-    return side() * steer;
+    return self().side() * steer;
+}
+
+
+// version of steerToAvoidNeighbors which caches its result, the annotation
+// hook is only called when the steering is recomputed
+
+
+template<class Super, class Concrete>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
+steerToAvoidNeighbors (const float minTimeToCollision,
+                       const AVGroup& others,
+                       SteeringCache& cache)
+{
+    Vec3 steering;
+    if (cache.lookup (*this, others, steering)) return steering;
+
+    steering = steerToAvoidNeighbors (minTimeToCollision, others);
+    cache.store (steering);
+    return steering;
 }
 
 
@@ -651,14 +876,14 @@ steerToAvoidNeighbors (const float minTimeToCollision,
 //
 // XXX should this return zero if they are already in contact?
 
-template<class Super>
+template<class Super, class Concrete>
 float
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 predictNearestApproachTime (AbstractVehicle& otherVehicle)
 {
     // imagine we are at the origin with no velocity,
     // compute the relative velocity of the other vehicle
-    const Vec3 myVelocity = velocity();
+    const Vec3 myVelocity = self().velocity();
     const Vec3 otherVelocity = otherVehicle.velocity();
     const Vec3 relVelocity = otherVelocity - myVelocity;
     const float relSpeed = relVelocity.length();
@@ -677,7 +902,7 @@ predictNearestApproachTime (AbstractVehicle& otherVehicle)
 
     // find distance from its path to origin (compute offset from
     // other to us, find length of projection onto path)
-    const Vec3 relPosition = position() - otherVehicle.position();
+    const Vec3 relPosition = self().position() - otherVehicle.position();
     const float projection = relTangent.dot(relPosition);
 
     return projection / relSpeed;
@@ -689,16 +914,16 @@ predictNearestApproachTime (AbstractVehicle& otherVehicle)
 // between them
 
 
-template<class Super>
+template<class Super, class Concrete>
 float
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 computeNearestApproachPositions (AbstractVehicle& otherVehicle,
                                  float time)
 {
-    const Vec3    myTravel =       forward () *       speed () * time;
+    const Vec3    myTravel =       self().forward () *       self().speed () * time;
     const Vec3 otherTravel = otherVehicle.forward () * otherVehicle.speed () * time;
 
-    const Vec3    myFinal =       position () +    myTravel;
+    const Vec3    myFinal =       self().position () +    myTravel;
     const Vec3 otherFinal = otherVehicle.position () + otherTravel;
 
     // xxx for annotation
@@ -718,27 +943,31 @@ computeNearestApproachPositions (AbstractVehicle& otherVehicle,
 // XXX  to steerForSeparation.
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerToAvoidCloseNeighbors (const float minSeparationDistance,
                             const AVGroup& others)
 {
+    OPENSTEER_PROFILE_ZONE ("steerToAvoidCloseNeighbors");
+
     // for each of the other vehicles...
     for (AVIterator i = others.begin(); i != others.end(); i++)    
     {
         AbstractVehicle& other = **i;
         if (&other != this)
         {
-            const float sumOfRadii = radius() + other.radius();
+            const float sumOfRadii = self().radius() + other.radius();
             const float minCenterToCenter = minSeparationDistance + sumOfRadii;
-            const Vec3 offset = other.position() - position();
+            const Vec3 offset = other.position() - self().position();
             const float currentDistance = offset.length();
 
             if (currentDistance < minCenterToCenter)
             {
-                annotateAvoidCloseNeighbor (other, minSeparationDistance);
-                return (-offset).perpendicularComponent (forward());
+#ifndef OPENSTEER_NO_ANNOTATION
+                self().annotateAvoidCloseNeighbor (other, minSeparationDistance);
+#endif
+                return (-offset).perpendicularComponent (self().forward());
             }
         }
     }
@@ -752,9 +981,9 @@ steerToAvoidCloseNeighbors (const float minSeparationDistance,
 // used by boid behaviors: is a given vehicle within this boid's neighborhood?
 
 
-template<class Super>
+template<class Super, class Concrete>
 bool
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 inBoidNeighborhood (const AbstractVehicle& otherVehicle,
                     const float minDistance,
                     const float maxDistance,
@@ -766,7 +995,7 @@ inBoidNeighborhood (const AbstractVehicle& otherVehicle,
     }
     else
     {
-        const Vec3 offset = otherVehicle.position() - position();
+        const ComputeVec3 offset = ComputeVec3 (otherVehicle.position()) - ComputeVec3 (self().position());
         const float distanceSquared = offset.lengthSquared ();
 
         // definitely in neighborhood if inside minDistance sphere
@@ -784,8 +1013,8 @@ inBoidNeighborhood (const AbstractVehicle& otherVehicle,
             else
             {
                 // otherwise, test angular offset from forward axis
-                const Vec3 unitOffset = offset / sqrt (distanceSquared);
-                const float forwardness = forward().dot (unitOffset);
+                const ComputeVec3 unitOffset = offset / sqrt (distanceSquared);
+                const float forwardness = unitOffset.dot (self().forward());
                 return forwardness > cosMaxAngle;
             }
         }
@@ -797,27 +1026,29 @@ inBoidNeighborhood (const AbstractVehicle& otherVehicle,
 // Separation behavior: steer away from neighbors
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForSeparation (const float maxDistance,
                     const float cosMaxAngle,
                     const AVGroup& flock)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForSeparation");
+
     // steering accumulator and count of neighbors, both initially zero
-    Vec3 steering;
+    ComputeVec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
     AVIterator flockEndIter = flock.end();
     for (AVIterator otherVehicle = flock.begin(); otherVehicle != flockEndIter; ++otherVehicle )
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        if (inBoidNeighborhood (**otherVehicle, self().radius()*3, maxDistance, cosMaxAngle))
         {
             // add in steering contribution
             // (opposite of the offset direction, divided once by distance
             // to normalize, divided another time to get 1/d falloff)
-            const Vec3 offset = (**otherVehicle).position() - position();
+            const ComputeVec3 offset = ComputeVec3 ((**otherVehicle).position()) - ComputeVec3 (self().position());
             const float distanceSquared = offset.dot(offset);
             steering += (offset / -distanceSquared);
 
@@ -836,9 +1067,7 @@ steerForSeparation (const float maxDistance,
         steering = steering.normalize();
     }
     */
-    steering = steering.normalize();
-    
-    return steering;
+    return steering.normalize();
 }
 
 
@@ -846,24 +1075,26 @@ steerForSeparation (const float maxDistance,
 // Alignment behavior: steer to head in same direction as neighbors
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForAlignment (const float maxDistance,
                    const float cosMaxAngle,
                    const AVGroup& flock)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForAlignment");
+
     // steering accumulator and count of neighbors, both initially zero
-    Vec3 steering;
+    ComputeVec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
     for (AVIterator otherVehicle = flock.begin(); otherVehicle != flock.end(); otherVehicle++)
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        if (inBoidNeighborhood (**otherVehicle, self().radius()*3, maxDistance, cosMaxAngle))
         {
             // accumulate sum of neighbor's heading
-            steering += (**otherVehicle).forward();
+            steering += ComputeVec3 ((**otherVehicle).forward());
 
             // count neighbors
             neighbors++;
@@ -872,7 +1103,7 @@ steerForAlignment (const float maxDistance,
 
     // divide by neighbors, subtract off current heading to get error-
     // correcting direction, then normalize to pure direction
-    if (neighbors > 0) steering = ((steering / (float)neighbors) - forward()).normalize();
+    if (neighbors > 0) steering = ((steering / (float)neighbors) - ComputeVec3 (self().forward())).normalize();
 
     return steering;
 }
@@ -883,24 +1114,26 @@ steerForAlignment (const float maxDistance,
 
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForCohesion (const float maxDistance,
                   const float cosMaxAngle,
                   const AVGroup& flock)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForCohesion");
+
     // steering accumulator and count of neighbors, both initially zero
-    Vec3 steering;
+    ComputeVec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
     for (AVIterator otherVehicle = flock.begin(); otherVehicle != flock.end(); otherVehicle++)
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        if (inBoidNeighborhood (**otherVehicle, self().radius()*3, maxDistance, cosMaxAngle))
         {
             // accumulate sum of neighbor's positions
-            steering += (**otherVehicle).position();
+            steering += ComputeVec3 ((**otherVehicle).position());
 
             // count neighbors
             neighbors++;
@@ -909,7 +1142,7 @@ steerForCohesion (const float maxDistance,
 
     // divide by neighbors, subtract off current position to get error-
     // correcting direction, then normalize to pure direction
-    if (neighbors > 0) steering = ((steering / (float)neighbors) - position()).normalize();
+    if (neighbors > 0) steering = ((steering / (float)neighbors) - ComputeVec3 (self().position())).normalize();
 
     return steering;
 }
@@ -919,35 +1152,37 @@ steerForCohesion (const float maxDistance,
 // pursuit of another vehicle (& version with ceiling on prediction time)
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForPursuit (const AbstractVehicle& quarry)
 {
     return steerForPursuit (quarry, FLT_MAX);
 }
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForPursuit (const AbstractVehicle& quarry,
                  const float maxPredictionTime)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForPursuit");
+
     // offset from this to quarry, that distance, unit vector toward quarry
-    const Vec3 offset = quarry.position() - position();
+    const Vec3 offset = quarry.position() - self().position();
     const float distance = offset.length ();
     const Vec3 unitOffset = offset / distance;
 
     // how parallel are the paths of "this" and the quarry
     // (1 means parallel, 0 is pependicular, -1 is anti-parallel)
-    const float parallelness = forward().dot (quarry.forward());
+    const float parallelness = self().forward().dot (quarry.forward());
 
     // how "forward" is the direction to the quarry
     // (1 means dead ahead, 0 is directly to the side, -1 is straight back)
-    const float forwardness = forward().dot (unitOffset);
+    const float forwardness = self().forward().dot (unitOffset);
 
-    const float directTravelTime = distance / speed ();
+    const float directTravelTime = distance / self().speed ();
     const int f = intervalComparison (forwardness,  -0.707f, 0.707f);
     const int p = intervalComparison (parallelness, -0.707f, 0.707f);
 
@@ -1022,9 +1257,11 @@ steerForPursuit (const AbstractVehicle& quarry,
     const Vec3 target = quarry.predictFuturePosition (etl);
 
     // annotation
-    annotationLine (position(),
-                    target,
-                    gaudyPursuitAnnotation ? color : gGray40);
+#ifndef OPENSTEER_NO_ANNOTATION
+    self().annotationLine (self().position(),
+                           target,
+                           gaudyPursuitAnnotation ? color : gGray40);
+#endif
 
     return steerForSeek (target);
 }
@@ -1033,12 +1270,14 @@ steerForPursuit (const AbstractVehicle& quarry,
 // evasion of another vehicle
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForEvasion (const AbstractVehicle& menace,
                  const float maxPredictionTime)
 {
+    OPENSTEER_PROFILE_ZONE ("steerForEvasion");
+
     // offset from this to menace, that distance, unit vector toward menace
     const Vec3 offset = menace.position - position;
     const float distance = offset.length ();
@@ -1059,14 +1298,16 @@ steerForEvasion (const AbstractVehicle& menace,
 // force along the forward/backward axis
 
 
-template<class Super>
+template<class Super, class Concrete>
 OpenSteer::Vec3
-OpenSteer::SteerLibraryMixin<Super>::
+OpenSteer::SteerLibraryMixin<Super, Concrete>::
 steerForTargetSpeed (const float targetSpeed)
 {
-    const float mf = maxForce ();
-    const float speedError = targetSpeed - speed ();
-    return forward () * clip (speedError, -mf, +mf);
+    OPENSTEER_PROFILE_ZONE ("steerForTargetSpeed");
+
+    const float mf = self().maxForce ();
+    const float speedError = targetSpeed - self().speed ();
+    return self().forward () * clip (speedError, -mf, +mf);
 }
 
 
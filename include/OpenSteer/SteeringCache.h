@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+// Per-vehicle cache for neighborhood based steering results.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef OPENSTEER_STEERINGCACHE_H
+#define OPENSTEER_STEERINGCACHE_H
+
+
+// Include OpenSteer::AbstractVehicle, OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    /**
+     * Remembers the last result of a neighborhood based steering behavior
+     * (flocking, unaligned collision avoidance) together with a signature
+     * of its inputs.
+     *
+     * The signature combines the identities of the neighbors with their
+     * positions and headings relative to the steering vehicle, quantized by
+     * @c positionTolerance and @c headingTolerance. If the signature of the
+     * next query matches the stored one every input differs by less than
+     * its tolerance and the cached force is reused instead of recomputed.
+     * Entries older than @c maxAge queries are recomputed nevertheless to
+     * bound the drift.
+     *
+     * Caching is opt-in: a default constructed cache is disabled and always
+     * misses without touching its counters.
+     *
+     * Usage:
+     * @code
+     * Vec3 force;
+     * if ( ! cache.lookup( *this, neighbors, force ) ) {
+     *     force = computeExpensiveSteering( neighbors );
+     *     cache.store( force );
+     * }
+     * @endcode
+     */
+    class SteeringCache {
+    public:
+
+        SteeringCache();
+        SteeringCache( float positionTolerance,
+                       float headingTolerance,
+                       size_t maxAge );
+
+        void setEnabled( bool enable );
+        bool enabled() const { return enabled_; }
+
+        /**
+         * Sets the quantization step of relative positions (and speeds).
+         * @a tolerance must be greater than @c 0.
+         */
+        void setPositionTolerance( float tolerance );
+        float positionTolerance() const { return positionTolerance_; }
+
+        /**
+         * Sets the quantization step of the components of relative
+         * headings. @a tolerance must be greater than @c 0.
+         */
+        void setHeadingTolerance( float tolerance );
+        float headingTolerance() const { return headingTolerance_; }
+
+        /**
+         * Number of consecutive hits before a result is recomputed. @c 0
+         * means no age limit.
+         */
+        void setMaxAge( size_t maxAge ) { maxAge_ = maxAge; }
+        size_t maxAge() const { return maxAge_; }
+
+        /**
+         * Computes the signature for @a vehicle steering relative to
+         * @a neighbors (@a vehicle itself is ignored if contained). Returns
+         * @c true and writes the cached force to @a force if it is still
+         * valid, otherwise returns @c false and remembers the signature for
+         * the following call to @c store.
+         */
+        bool lookup( AbstractVehicle const& vehicle,
+                     AVGroup const& neighbors,
+                     Vec3& force );
+
+        /**
+         * Stores @a force as the result belonging to the signature of the
+         * last missed @c lookup.
+         */
+        void store( Vec3 const& force );
+
+        /**
+         * Drops the cached result, e.g. after a vehicle has been reset or
+         * teleported.
+         */
+        void invalidate();
+
+        size_t hits() const { return hits_; }
+        size_t misses() const { return misses_; }
+        void resetCounters();
+
+    private:
+
+        unsigned long long computeSignature( AbstractVehicle const& vehicle,
+                                             AVGroup const& neighbors ) const;
+
+    private:
+        bool enabled_;
+        bool valid_;
+        float positionTolerance_;
+        float headingTolerance_;
+        size_t maxAge_;
+        size_t age_;
+        unsigned long long signature_;
+        unsigned long long pendingSignature_;
+        Vec3 force_;
+        size_t hits_;
+        size_t misses_;
+    }; // class SteeringCache
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_STEERINGCACHE_H
@@ -0,0 +1,122 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Tasks with dependencies, run by @c OpenSteer::ThreadPool.
+ */
+#ifndef OPENSTEER_TASKGRAPH_H
+#define OPENSTEER_TASKGRAPH_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::function
+#include <functional>
+
+// Include std::atomic
+#include <atomic>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+
+    class ThreadPool;
+
+    /**
+     * Tasks and "runs before" relations between them, executed by
+     * @c ThreadPool::run: a task starts as soon as all tasks preceding it
+     * have finished, independent tasks run in parallel.
+     *
+     * @c clear keeps the memory of the tasks and their relations, a graph
+     * rebuilt every frame (e.g. borrowed from a @c ScratchBuffer) stops
+     * allocating once it reached its largest size. Works capturing at most
+     * two pointers are stored without allocation by common
+     * @c std::function implementations.
+     */
+    class TaskGraph {
+    public:
+        typedef size_t Task;
+
+        TaskGraph();
+
+        /**
+         * Adds a task calling @a work and returns its handle.
+         */
+        Task add( std::function< void () > const& work );
+
+        /**
+         * @a after starts only after @a before finished.
+         */
+        void precede( Task before, Task after );
+
+        size_t size() const { return size_; }
+        bool empty() const { return 0 == size_; }
+
+        /**
+         * Removes all tasks, keeping the memory.
+         */
+        void clear();
+
+        void reserve( size_t taskCount );
+        size_t capacity() const { return nodes_.capacity(); }
+
+    private:
+        friend class ThreadPool;
+
+        struct Node {
+            Node() : predecessorCount( 0 ), remainingPredecessors( 0 ) {}
+            Node( Node const& other )
+                : work( other.work ),
+                  successors( other.successors ),
+                  predecessorCount( other.predecessorCount ),
+                  remainingPredecessors( 0 ) {}
+
+            std::function< void () > work;
+            std::vector< Task > successors;
+            size_t predecessorCount;
+
+            // Counted down while the graph runs.
+            std::atomic< size_t > remainingPredecessors;
+
+        private:
+            /**
+             * Not implemented to make it non-assignable.
+             */
+            Node& operator=( Node const& );
+        };
+
+        std::vector< Node > nodes_;
+        size_t size_;
+    }; // class TaskGraph
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_TASKGRAPH_H
@@ -0,0 +1,293 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Work stealing scheduler to spread loops over all vehicles and graphs of
+ * tasks across cores.
+ */
+#ifndef OPENSTEER_THREADPOOL_H
+#define OPENSTEER_THREADPOOL_H
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::deque
+#include <deque>
+
+// Include std::thread
+#include <thread>
+
+// Include std::mutex
+#include <mutex>
+
+// Include std::condition_variable
+#include <condition_variable>
+
+// Include std::atomic
+#include <atomic>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::unique_ptr
+#include <memory>
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+// Include OpenSteer::Profiler
+#include "OpenSteer/Profiler.h"
+
+
+
+namespace OpenSteer {
+
+    class TaskGraph;
+
+    /**
+     * What one thread of a @c ThreadPool did since the last
+     * @c ThreadPool::resetStatistics.
+     */
+    struct ThreadStatistics {
+        /**
+         * Time spent running tasks.
+         */
+        double busySeconds;
+
+        /**
+         * @c busySeconds divided by the time since the last reset, a
+         * thread far below the others points to imbalanced work.
+         */
+        float utilization;
+
+        size_t taskCount;
+
+        /**
+         * Tasks taken from the queue of another thread.
+         */
+        size_t stealCount;
+    };
+
+
+    /**
+     * Work stealing scheduler running loops and task graphs on a fixed
+     * number of threads: the thread starting the work and
+     * <code>threadCount() - 1</code> workers, which are started on first
+     * use and sleep while there is nothing to do.
+     *
+     * Every thread has its own queue of tasks. It runs the newest task of
+     * its queue and, when the queue is empty, steals the oldest task of
+     * another thread's queue. A thread waiting for a loop or graph to
+     * finish runs tasks in the meantime, so loops and graphs can be started
+     * from inside tasks.
+     *
+     * @c parallelFor splits an index range into chunks and deals out
+     * contiguous runs of chunks to the queues. Threads that are done early
+     * steal the remaining chunks of the others, so vehicles with expensive
+     * neighborhoods don't leave the other cores idle.
+     *
+     * Threads which are not workers of the pool all run as thread @c 0 and
+     * share its queue and statistics, so only one of them may start work
+     * at a time (asserted). Different threads may start work one after the
+     * other, and tasks may start nested work on any thread.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * Chunks per thread @c parallelFor aims at if no grain size is
+         * given, enough to even out uneven chunk costs.
+         */
+        enum { chunksPerThread = 8 };
+
+        /**
+         * @a threadCount threads including the calling one, @c 0 for one
+         * per hardware thread.
+         */
+        explicit ThreadPool( size_t threadCount = 0 );
+        ~ThreadPool();
+
+        /**
+         * Changes the number of threads (@c 0: one per hardware thread),
+         * not allowed while work runs. Resets the statistics.
+         */
+        void setThreadCount( size_t threadCount );
+        size_t threadCount() const { return threadCount_; }
+
+        /**
+         * Calls <code>body( begin, end )</code> for disjoint ranges of at
+         * most @a grainSize indices covering <code>[0, count)</code> and
+         * returns when all calls returned. A @a grainSize of @c 0 selects
+         * @c grainSize( @a count ). The body must only write state owned
+         * by the indices it is given.
+         */
+        template< typename Body >
+        void parallelFor( size_t count, Body const& body, size_t grainSize = 0 ) {
+            RangeJobFor< Body > const job( body );
+            runRange( count, job, grainSize );
+        }
+
+        /**
+         * Default chunk size of @c parallelFor: about @c chunksPerThread
+         * chunks per thread.
+         */
+        size_t grainSize( size_t count ) const;
+
+        /**
+         * Runs all tasks of @a graph respecting their order and returns
+         * when all finished. The graph must not change while it runs and
+         * must be free of cycles.
+         */
+        void run( TaskGraph& graph );
+
+        /**
+         * Per thread statistics, index @c 0 is the thread starting the work.
+         */
+        std::vector< ThreadStatistics > statistics() const;
+        void resetStatistics();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ThreadPool( ThreadPool const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ThreadPool& operator=( ThreadPool const& );
+
+        /**
+         * Type erased work of a task, called for an index range.
+         */
+        class Job {
+        public:
+            virtual ~Job() {}
+            virtual void operator()( size_t begin, size_t end ) const = 0;
+        };
+
+        template< typename Body >
+        class RangeJobFor : public Job {
+        public:
+            explicit RangeJobFor( Body const& body ) : body_( body ) {}
+            virtual void operator()( size_t begin, size_t end ) const { body_( begin, end ); }
+        private:
+            Body const& body_;
+        };
+
+        class GraphJob;
+
+        /**
+         * Registers the calling thread as the non-worker thread starting
+         * work for the duration of a loop or graph.
+         */
+        class Submission;
+
+        /**
+         * Count of unfinished tasks of a loop or graph, lives on the stack
+         * of the thread waiting for it.
+         */
+        typedef std::atomic< size_t > Completion;
+
+        struct Task {
+            Job const* job;
+            size_t begin;
+            size_t end;
+            Completion* completion;
+
+            // Profiler zone of the thread that queued the task.
+            Profiler::Zone zone;
+        };
+
+        /**
+         * Task queue and statistics of one thread.
+         */
+        struct ThreadState {
+            ThreadState() : busyNanoseconds( 0 ), taskCount( 0 ), stealCount( 0 ) {}
+
+            std::mutex mutex;
+            std::deque< Task > tasks;
+
+            std::atomic< unsigned long long > busyNanoseconds;
+            std::atomic< size_t > taskCount;
+            std::atomic< size_t > stealCount;
+        };
+
+        void runRange( size_t count, Job const& job, size_t grainSize );
+
+        /**
+         * Queues @a task for thread @a thread and wakes up sleeping threads.
+         */
+        void push( size_t thread, Task const& task );
+
+        /**
+         * Runs a task of the queue of @a thread or, if empty, one stolen
+         * from another thread. Returns @c false if there was none.
+         */
+        bool runNextTask( size_t thread );
+        void execute( size_t thread, Task const& task, bool stolen );
+
+        /**
+         * Runs tasks on thread @a thread until @a completion reaches @c 0.
+         */
+        void wait( size_t thread, Completion& completion );
+
+        /**
+         * Index of the calling thread, @c 0 if it is not a worker.
+         */
+        size_t currentThread() const;
+
+        /**
+         * Starts the workers unless they are running.
+         */
+        void startWorkers();
+        void stopWorkers();
+        void workerLoop( size_t thread );
+
+    private:
+        size_t threadCount_;
+        std::vector< std::unique_ptr< ThreadState > > threads_;
+        std::vector< std::thread > workers_;
+
+        // Queued tasks of all threads. Increased under mutex_, threads
+        // sleep on wakeUp_ while it is zero.
+        std::atomic< size_t > queuedTasks_;
+        std::mutex mutex_;
+        std::condition_variable wakeUp_;
+        bool stopping_;
+
+        // Non-worker thread running as thread 0 and the number of its
+        // loops and graphs in progress, only changed by that thread.
+        std::atomic< std::thread::id > submitter_;
+        size_t submissionDepth_;
+
+        std::chrono::steady_clock::time_point statisticsStart_;
+    }; // class ThreadPool
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_THREADPOOL_H
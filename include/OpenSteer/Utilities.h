@@ -51,6 +51,8 @@
 #include <cassert>   // for assert
 #include <limits>    // for numeric_limits
 
+#include "OpenSteer/FastMath.h"  // for fastInverseSqrt, fastPow
+
 // ----------------------------------------------------------------------------
 // For the sake of Windows, apparently this is a "Linux/Unix thing"
 
@@ -290,6 +292,26 @@ namespace OpenSteer {
     #endif
 
 
+    // ----------------------------------------------------------------------------
+    // 1 / sqrt (x) and pow (x, y) for the steering hot paths.  Exact unless
+    // OPENSTEER_FAST_MATH is defined, then the approximations of FastMath.h
+    // with bounded error are used (inverseSqrtXXX then requires x >= FLT_MIN,
+    // powXXX requires x >= 0).
+
+
+    #ifdef OPENSTEER_FAST_MATH
+
+    inline float inverseSqrtXXX (float x)    {return fastInverseSqrt (x);}
+    inline float   powXXX (float x, float y) {return fastPow (x, y);}
+
+    #else
+
+    inline float inverseSqrtXXX (float x)    {return 1.0f / sqrtXXX (x);}
+    inline float   powXXX (float x, float y) {return (float) std::pow ((double) x, (double) y);}
+
+    #endif
+
+
     // ----------------------------------------------------------------------------
     // round (x)  "round off" x to the nearest integer (as a float value)
     //
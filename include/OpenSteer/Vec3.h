@@ -99,9 +99,17 @@ namespace OpenSteer {
         // normalize: returns normalized version (parallel to this, length = 1)
         Vec3 normalize (void) const
         {
+#ifdef OPENSTEER_FAST_MATH
+            // skip multiply if length is (about) zero
+            const float lengthSquared = this->lengthSquared ();
+            return (lengthSquared >= FLT_MIN) ?
+                (*this) * inverseSqrtXXX (lengthSquared) :
+                (*this);
+#else
             // skip divide if length is zero
             const float len = length ();
             return (len>0) ? (*this)/len : (*this);
+#endif
         }
 
         // cross product (modify "*this" to be A x B)
@@ -171,8 +179,15 @@ namespace OpenSteer {
             const float vecLengthSquared = this->lengthSquared ();
             if (vecLengthSquared <= maxLengthSquared)
                 return *this;
+#ifdef OPENSTEER_FAST_MATH
+            else if (vecLengthSquared < FLT_MIN)
+                return Vec3 (0, 0, 0);
+            else
+                return (*this) * (maxLength * inverseSqrtXXX (vecLengthSquared));
+#else
             else
                 return (*this) * (maxLength / sqrtXXX (vecLengthSquared));
+#endif
         }
 
         // forces a 3d position onto the XZ (aka y=0) plane
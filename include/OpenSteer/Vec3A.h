@@ -0,0 +1,223 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * 16 byte aligned 3d vector computed with SSE where available, and the
+ * @c ComputeVec3 switch to let the hot paths of the library use it.
+ *
+ * Build flags:
+ *
+ * - @c OPENSTEER_USE_VEC3A: @c ComputeVec3 is @c Vec3A instead of @c Vec3,
+ *   @c LocalSpaceMixin stores its basis in @c Vec3A and the local space
+ *   transformations, @c SimpleVehicle::applySteeringForce and the flocking
+ *   behaviors of @c SteerLibraryMixin compute with it.
+ * - @c OPENSTEER_NO_SIMD: @c Vec3A uses plain float math even if the target
+ *   supports SSE.
+ */
+#ifndef OPENSTEER_VEC3A_H
+#define OPENSTEER_VEC3A_H
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::sqrtXXX
+#include "OpenSteer/Utilities.h"
+
+
+#if ! defined( OPENSTEER_NO_SIMD ) && ( defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) )
+    #define OPENSTEER_VEC3A_SSE 1
+#endif
+
+#ifdef OPENSTEER_VEC3A_SSE
+    // Include __m128, _mm_add_ps, ...
+    #include <xmmintrin.h>
+#endif
+
+
+
+namespace OpenSteer {
+
+    /**
+     * 3d vector with the interface of @c Vec3 padded to four floats and
+     * aligned to 16 bytes so it maps to one SSE register.
+     *
+     * Converts implicitly from and to @c Vec3. Unlike @c Vec3 the compound
+     * assignments modify in place and return a reference.
+     *
+     * Results can differ from @c Vec3 in the last bits because the sums of
+     * @c dot are added in a different order when computed with SSE.
+     *
+     * With SSE the four floats are loaded into and stored from an
+     * @c __m128 with aligned moves, which the compiler folds away between
+     * inlined operations so values stay in registers. The coordinates are
+     * plain members, no union or anonymous struct is involved.
+     */
+    class alignas( 16 ) Vec3A {
+    public:
+        float x, y, z;
+
+        // Padding to four floats, always zero.
+        float w;
+
+        Vec3A() : x( 0.0f ), y( 0.0f ), z( 0.0f ), w( 0.0f ) {}
+        Vec3A( float X, float Y, float Z ) : x( X ), y( Y ), z( Z ), w( 0.0f ) {}
+        Vec3A( Vec3 const& v ) : x( v.x ), y( v.y ), z( v.z ), w( 0.0f ) {}
+
+        operator Vec3() const { return Vec3( x, y, z ); }
+        Vec3 toVec3() const { return Vec3( x, y, z ); }
+
+        Vec3A set( float X, float Y, float Z ) { x = X; y = Y; z = Z; w = 0.0f; return *this; }
+
+#ifdef OPENSTEER_VEC3A_SSE
+
+        explicit Vec3A( __m128 v ) { store( v ); }
+
+        __m128 load() const { return _mm_load_ps( &x ); }
+        void store( __m128 v ) { _mm_store_ps( &x, v ); }
+
+        Vec3A operator+( Vec3A const& v ) const { return Vec3A( _mm_add_ps( load(), v.load() ) ); }
+        Vec3A operator-( Vec3A const& v ) const { return Vec3A( _mm_sub_ps( load(), v.load() ) ); }
+        Vec3A operator-() const { return Vec3A( _mm_sub_ps( _mm_setzero_ps(), load() ) ); }
+        Vec3A operator*( float s ) const { return Vec3A( _mm_mul_ps( load(), _mm_set1_ps( s ) ) ); }
+        Vec3A operator/( float s ) const { return Vec3A( _mm_div_ps( load(), _mm_set_ps( 1.0f, s, s, s ) ) ); }
+
+        Vec3A& operator+=( Vec3A const& v ) { store( _mm_add_ps( load(), v.load() ) ); return *this; }
+        Vec3A& operator-=( Vec3A const& v ) { store( _mm_sub_ps( load(), v.load() ) ); return *this; }
+        Vec3A& operator*=( float s ) { store( _mm_mul_ps( load(), _mm_set1_ps( s ) ) ); return *this; }
+        Vec3A& operator/=( float s ) { store( _mm_div_ps( load(), _mm_set_ps( 1.0f, s, s, s ) ) ); return *this; }
+
+        float dot( Vec3A const& v ) const {
+            // The padding is zero, add up all four products.
+            __m128 const products = _mm_mul_ps( load(), v.load() );
+            __m128 const pairs = _mm_add_ps( products, _mm_movehl_ps( products, products ) );
+            return _mm_cvtss_f32( _mm_add_ss( pairs, _mm_shuffle_ps( pairs, pairs, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+        }
+
+        void cross( Vec3A const& a, Vec3A const& b ) {
+            __m128 const va = a.load();
+            __m128 const vb = b.load();
+            __m128 const aYZX = _mm_shuffle_ps( va, va, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+            __m128 const bYZX = _mm_shuffle_ps( vb, vb, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+            __m128 const zxy = _mm_sub_ps( _mm_mul_ps( va, bYZX ), _mm_mul_ps( aYZX, vb ) );
+            store( _mm_shuffle_ps( zxy, zxy, _MM_SHUFFLE( 3, 0, 2, 1 ) ) );
+        }
+
+#else
+
+        Vec3A operator+( Vec3A const& v ) const { return Vec3A( x + v.x, y + v.y, z + v.z ); }
+        Vec3A operator-( Vec3A const& v ) const { return Vec3A( x - v.x, y - v.y, z - v.z ); }
+        Vec3A operator-() const { return Vec3A( -x, -y, -z ); }
+        Vec3A operator*( float s ) const { return Vec3A( x * s, y * s, z * s ); }
+        Vec3A operator/( float s ) const { return Vec3A( x / s, y / s, z / s ); }
+
+        Vec3A& operator+=( Vec3A const& v ) { x += v.x; y += v.y; z += v.z; return *this; }
+        Vec3A& operator-=( Vec3A const& v ) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+        Vec3A& operator*=( float s ) { x *= s; y *= s; z *= s; return *this; }
+        Vec3A& operator/=( float s ) { x /= s; y /= s; z /= s; return *this; }
+
+        float dot( Vec3A const& v ) const { return ( x * v.x ) + ( y * v.y ) + ( z * v.z ); }
+
+        void cross( Vec3A const& a, Vec3A const& b ) {
+            set( ( a.y * b.z ) - ( a.z * b.y ),
+                 ( a.z * b.x ) - ( a.x * b.z ),
+                 ( a.x * b.y ) - ( a.y * b.x ) );
+        }
+
+#endif // OPENSTEER_VEC3A_SSE
+
+        bool operator==( Vec3A const& v ) const { return x == v.x && y == v.y && z == v.z; }
+        bool operator!=( Vec3A const& v ) const { return ! ( *this == v ); }
+
+        float lengthSquared() const { return dot( *this ); }
+        float length() const { return sqrtXXX( lengthSquared() ); }
+
+        static float distance( Vec3A const& a, Vec3A const& b ) { return ( a - b ).length(); }
+
+        /**
+         * Returns a vector parallel to this one with length one, or this
+         * vector if it has length zero.
+         */
+        Vec3A normalize() const {
+#ifdef OPENSTEER_FAST_MATH
+            float const lengthSquared = this->lengthSquared();
+            return ( lengthSquared >= FLT_MIN ) ? ( *this ) * inverseSqrtXXX( lengthSquared ) : ( *this );
+#else
+            float const len = length();
+            return ( len > 0.0f ) ? ( *this ) / len : ( *this );
+#endif
+        }
+
+        /**
+         * Returns this vector, clamped to a length of @a maxLength.
+         */
+        Vec3A truncateLength( float maxLength ) const {
+            float const maxLengthSquared = maxLength * maxLength;
+            float const vecLengthSquared = lengthSquared();
+            if ( vecLengthSquared <= maxLengthSquared ) {
+                return *this;
+            }
+#ifdef OPENSTEER_FAST_MATH
+            if ( vecLengthSquared < FLT_MIN ) {
+                return Vec3A();
+            }
+            return ( *this ) * ( maxLength * inverseSqrtXXX( vecLengthSquared ) );
+#else
+            return ( *this ) * ( maxLength / sqrtXXX( vecLengthSquared ) );
+#endif
+        }
+
+        /**
+         * Component parallel and perpendicular to a basis vector which must
+         * have unit length.
+         */
+        Vec3A parallelComponent( Vec3A const& unitBasis ) const { return unitBasis * dot( unitBasis ); }
+        Vec3A perpendicularComponent( Vec3A const& unitBasis ) const { return ( *this ) - parallelComponent( unitBasis ); }
+    }; // class Vec3A
+
+
+    inline Vec3A operator*( float s, Vec3A const& v ) { return v * s; }
+
+    inline Vec3A crossProduct( Vec3A const& a, Vec3A const& b ) {
+        Vec3A result;
+        result.cross( a, b );
+        return result;
+    }
+
+
+    /**
+     * Vector type the hot paths compute with, see the build flags above.
+     */
+#ifdef OPENSTEER_USE_VEC3A
+    typedef Vec3A ComputeVec3;
+#else
+    typedef Vec3 ComputeVec3;
+#endif
+
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_VEC3A_H
@@ -0,0 +1,257 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Four 3d vectors held in SSE registers, one register per coordinate, to
+ * write array kernels with the operations of @c Vec3.
+ *
+ * Only available if @c OPENSTEER_VEC3A_SSE is defined (see
+ * @c OpenSteer/Vec3A.h), kernels need a scalar path otherwise.
+ */
+#ifndef OPENSTEER_VEC3LANES_H
+#define OPENSTEER_VEC3LANES_H
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OPENSTEER_VEC3A_SSE, __m128, _mm_add_ps, ...
+#include "OpenSteer/Vec3A.h"
+
+
+#ifdef OPENSTEER_VEC3A_SSE
+
+namespace OpenSteer {
+
+    /**
+     * Lane by lane @a mask ? @a a : @a b.
+     */
+    inline __m128 select( __m128 mask, __m128 a, __m128 b ) {
+        return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+    }
+
+
+    /**
+     * Four vectors in structure of arrays form. The operations execute the
+     * float operations of their @c Vec3 counterparts in the same order, so
+     * every lane gets the same result a @c Vec3 computation would.
+     *
+     * Branches of the @c Vec3 operations become masks, both sides are
+     * computed and the results selected per lane. Discarded lanes may hold
+     * infinities or NaNs from divisions by zero.
+     */
+    class Vec3Lanes {
+    public:
+        __m128 x, y, z;
+
+        Vec3Lanes() {}
+        Vec3Lanes( __m128 X, __m128 Y, __m128 Z ) : x( X ), y( Y ), z( Z ) {}
+
+        /**
+         * The same vector in all four lanes.
+         */
+        static Vec3Lanes splat( Vec3 const& v ) {
+            return Vec3Lanes( _mm_set1_ps( v.x ), _mm_set1_ps( v.y ), _mm_set1_ps( v.z ) );
+        }
+
+        /**
+         * Loads four vectors from separate coordinate arrays.
+         */
+        static Vec3Lanes load( float const xs[], float const ys[], float const zs[] ) {
+            return Vec3Lanes( _mm_loadu_ps( xs ), _mm_loadu_ps( ys ), _mm_loadu_ps( zs ) );
+        }
+
+        void store( float xs[], float ys[], float zs[] ) const {
+            _mm_storeu_ps( xs, x );
+            _mm_storeu_ps( ys, y );
+            _mm_storeu_ps( zs, z );
+        }
+
+        /**
+         * Loads the four @c Vec3 starting at @a vectors, transposing them in
+         * registers.
+         */
+        static Vec3Lanes load( Vec3 const vectors[] ) {
+            float const* const floats = &vectors[ 0 ].x;
+            __m128 const a0 = _mm_loadu_ps( floats );     // x0 y0 z0 x1
+            __m128 const a1 = _mm_loadu_ps( floats + 4 ); // y1 z1 x2 y2
+            __m128 const a2 = _mm_loadu_ps( floats + 8 ); // z2 x3 y3 z3
+
+            __m128 const x2x3 = _mm_shuffle_ps( a1, a2, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+            __m128 const y0y1 = _mm_shuffle_ps( a0, a1, _MM_SHUFFLE( 0, 0, 1, 1 ) );
+            __m128 const y2y3 = _mm_shuffle_ps( a1, a2, _MM_SHUFFLE( 2, 2, 3, 3 ) );
+            __m128 const z0z1 = _mm_shuffle_ps( a0, a1, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+            __m128 const z2z3 = _mm_shuffle_ps( a2, a2, _MM_SHUFFLE( 3, 3, 0, 0 ) );
+
+            return Vec3Lanes( _mm_shuffle_ps( a0, x2x3, _MM_SHUFFLE( 2, 0, 3, 0 ) ),
+                              _mm_shuffle_ps( y0y1, y2y3, _MM_SHUFFLE( 2, 0, 2, 0 ) ),
+                              _mm_shuffle_ps( z0z1, z2z3, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        }
+
+        /**
+         * Inverse of loading from @c Vec3.
+         */
+        void store( Vec3 vectors[] ) const {
+            float* const floats = &vectors[ 0 ].x;
+
+            __m128 const x0y0 = _mm_shuffle_ps( x, y, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+            __m128 const z0x1 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) );
+            _mm_storeu_ps( floats, _mm_shuffle_ps( x0y0, z0x1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+
+            __m128 const y1z1 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+            __m128 const x2y2 = _mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+            _mm_storeu_ps( floats + 4, _mm_shuffle_ps( y1z1, x2y2, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+
+            __m128 const z2x3 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) );
+            __m128 const y3z3 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            _mm_storeu_ps( floats + 8, _mm_shuffle_ps( z2x3, y3z3, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        }
+
+        Vec3Lanes operator+( Vec3Lanes const& v ) const {
+            return Vec3Lanes( _mm_add_ps( x, v.x ), _mm_add_ps( y, v.y ), _mm_add_ps( z, v.z ) );
+        }
+
+        Vec3Lanes operator-( Vec3Lanes const& v ) const {
+            return Vec3Lanes( _mm_sub_ps( x, v.x ), _mm_sub_ps( y, v.y ), _mm_sub_ps( z, v.z ) );
+        }
+
+        Vec3Lanes operator*( __m128 s ) const {
+            return Vec3Lanes( _mm_mul_ps( x, s ), _mm_mul_ps( y, s ), _mm_mul_ps( z, s ) );
+        }
+
+        Vec3Lanes operator/( __m128 s ) const {
+            return Vec3Lanes( _mm_div_ps( x, s ), _mm_div_ps( y, s ), _mm_div_ps( z, s ) );
+        }
+
+        __m128 dot( Vec3Lanes const& v ) const {
+            return _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, v.x ), _mm_mul_ps( y, v.y ) ), _mm_mul_ps( z, v.z ) );
+        }
+
+        __m128 lengthSquared() const { return dot( *this ); }
+        __m128 length() const { return _mm_sqrt_ps( lengthSquared() ); }
+
+#ifdef OPENSTEER_FAST_MATH
+
+        /**
+         * @c fastInverseSqrt for four lanes, same steps.
+         */
+        static __m128 inverseSqrt( __m128 x ) {
+            __m128 const estimate = _mm_rsqrt_ps( x );
+            __m128 const correction = _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( 0.5f ), x ), estimate ), estimate );
+            return _mm_mul_ps( estimate, _mm_sub_ps( _mm_set1_ps( 1.5f ), correction ) );
+        }
+
+        /**
+         * Lanes whose squared length counts as non-zero in fast math mode.
+         */
+        static __m128 notTiny( __m128 lengthSquared ) {
+            return _mm_cmpge_ps( lengthSquared, _mm_set1_ps( FLT_MIN ) );
+        }
+
+#endif // OPENSTEER_FAST_MATH
+
+        /**
+         * Cross product @a a x @a b, see @c Vec3::cross.
+         */
+        static Vec3Lanes cross( Vec3Lanes const& a, Vec3Lanes const& b ) {
+            return Vec3Lanes( _mm_sub_ps( _mm_mul_ps( a.y, b.z ), _mm_mul_ps( a.z, b.y ) ),
+                              _mm_sub_ps( _mm_mul_ps( a.z, b.x ), _mm_mul_ps( a.x, b.z ) ),
+                              _mm_sub_ps( _mm_mul_ps( a.x, b.y ), _mm_mul_ps( a.y, b.x ) ) );
+        }
+
+        /**
+         * Lane by lane @a mask ? @a a : @a b.
+         */
+        static Vec3Lanes select( __m128 mask, Vec3Lanes const& a, Vec3Lanes const& b ) {
+            return Vec3Lanes( OpenSteer::select( mask, a.x, b.x ),
+                              OpenSteer::select( mask, a.y, b.y ),
+                              OpenSteer::select( mask, a.z, b.z ) );
+        }
+
+#ifdef OPENSTEER_FAST_MATH
+
+        Vec3Lanes normalize() const {
+            __m128 const lengthSquared = this->lengthSquared();
+            return select( notTiny( lengthSquared ), ( *this ) * inverseSqrt( lengthSquared ), *this );
+        }
+
+        Vec3Lanes truncateLength( __m128 maxLength ) const {
+            __m128 const vecLengthSquared = lengthSquared();
+            __m128 const keep = _mm_cmple_ps( vecLengthSquared, _mm_mul_ps( maxLength, maxLength ) );
+            __m128 const scale = _mm_and_ps( notTiny( vecLengthSquared ), _mm_mul_ps( maxLength, inverseSqrt( vecLengthSquared ) ) );
+            return select( keep, *this, ( *this ) * scale );
+        }
+
+#else
+
+        Vec3Lanes normalize() const {
+            __m128 const len = length();
+            return select( _mm_cmpgt_ps( len, _mm_setzero_ps() ), ( *this ) / len, *this );
+        }
+
+        Vec3Lanes truncateLength( __m128 maxLength ) const {
+            __m128 const vecLengthSquared = lengthSquared();
+            __m128 const keep = _mm_cmple_ps( vecLengthSquared, _mm_mul_ps( maxLength, maxLength ) );
+            return select( keep, *this, ( *this ) * _mm_div_ps( maxLength, _mm_sqrt_ps( vecLengthSquared ) ) );
+        }
+
+#endif // OPENSTEER_FAST_MATH
+
+        Vec3Lanes parallelComponent( Vec3Lanes const& unitBasis ) const {
+            return unitBasis * dot( unitBasis );
+        }
+
+        Vec3Lanes perpendicularComponent( Vec3Lanes const& unitBasis ) const {
+            return ( *this ) - parallelComponent( unitBasis );
+        }
+
+        /**
+         * @c limitMaxDeviationAngle for four lanes, @a sineOfConeAngle must
+         * be <code>sqrt( 1 - cosineOfConeAngle^2 )</code>.
+         */
+        Vec3Lanes limitMaxDeviationAngle( __m128 cosineOfConeAngle,
+                                          __m128 sineOfConeAngle,
+                                          Vec3Lanes const& basis ) const {
+            // Zero length sources and sources inside the cone are kept.
+            __m128 const sourceLength = length();
+            __m128 const cosineOfSourceAngle = ( ( *this ) / sourceLength ).dot( basis );
+            __m128 const keep = _mm_or_ps( _mm_cmpeq_ps( sourceLength, _mm_setzero_ps() ),
+                                           _mm_cmpge_ps( cosineOfSourceAngle, cosineOfConeAngle ) );
+
+            // Otherwise rotate the source onto the cone, in the plane of
+            // source and basis.
+            Vec3Lanes const unitPerp = perpendicularComponent( basis ).normalize();
+            Vec3Lanes const limited = ( ( basis * cosineOfConeAngle ) + ( unitPerp * sineOfConeAngle ) ) * sourceLength;
+            return select( keep, *this, limited );
+        }
+    }; // class Vec3Lanes
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_VEC3A_SSE
+
+
+#endif // OPENSTEER_VEC3LANES_H
@@ -91,6 +91,93 @@ namespace OpenSteer {
         return equalsRelative( lhs.x, rhs.x, tolerance ) && equalsRelative( lhs.y, rhs.y ) && equalsRelative( lhs.z, rhs.z );
     }
     
+    
+    /**
+     * Array kernels applying one of the @c Vec3 operations below to each of
+     * @a count vectors, e.g. to the forces or velocities of all agents.
+     *
+     * Every kernel comes in two forms: for an array of @c Vec3 (array of
+     * structures) and for separate arrays of x, y and z coordinates
+     * (structure of arrays). Arrays of the same call must not overlap.
+     *
+     * Where SSE is available (see @c OpenSteer/Vec3A.h) four vectors are
+     * processed per step. The results equal the ones of the scalar
+     * operations because the same correctly rounded float operations are
+     * executed in the same order. The array of structures form transposes
+     * four vectors at a time in registers.
+     */
+    
+    /**
+     * <code>vectors[ i ] = vectors[ i ].normalize()</code>
+     */
+    void normalizeVectors( Vec3 vectors[], size_t count );
+    void normalizeVectors( float xs[], float ys[], float zs[], size_t count );
+    
+    /**
+     * <code>vectors[ i ] = vectors[ i ].truncateLength( maxLengths[ i ] )</code>
+     */
+    void truncateLengths( Vec3 vectors[], float const maxLengths[], size_t count );
+    void truncateLengths( float xs[], float ys[], float zs[], float const maxLengths[], size_t count );
+    
+    /**
+     * <code>vectors[ i ] = vectors[ i ].setYtoZero()</code>
+     */
+    void setYsToZero( Vec3 vectors[], size_t count );
+    void setYsToZero( float ys[], size_t count );
+    
+    /**
+     * <code>sources[ i ] = limitMaxDeviationAngle( sources[ i ], cosineOfConeAngle, bases[ i ] )</code>
+     */
+    void limitMaxDeviationAngles( Vec3 sources[], 
+                                  float cosineOfConeAngle, 
+                                  Vec3 const bases[], 
+                                  size_t count );
+    void limitMaxDeviationAngles( float sourceXs[], float sourceYs[], float sourceZs[],
+                                  float cosineOfConeAngle, 
+                                  float const basisXs[], float const basisYs[], float const basisZs[],
+                                  size_t count );
+
+    /**
+     * Local space transformations of @a count positions, see
+     * @c LocalSpaceMixin::globalizePosition and
+     * @c LocalSpaceMixin::localizePosition. @a side, @a up, @a forward and
+     * @a position describe the local space. Unlike the other kernels input
+     * and output may be the same array.
+     */
+    void globalizePositions( Vec3 const& side,
+                             Vec3 const& up,
+                             Vec3 const& forward,
+                             Vec3 const& position,
+                             Vec3 const localPositions[],
+                             Vec3 globalPositions[],
+                             size_t count );
+    void localizePositions( Vec3 const& side,
+                            Vec3 const& up,
+                            Vec3 const& forward,
+                            Vec3 const& position,
+                            Vec3 const globalPositions[],
+                            Vec3 localPositions[],
+                            size_t count );
+
+    /**
+     * Globalizes the local grid
+     * <code>localOrigin + localRowStep * row + localColumnStep * column</code>
+     * row by row into the @a rowCount * @a columnCount elements of
+     * @a globalPositions. Only origin and steps are transformed, the grid
+     * points are stepped in global space, so results can differ from
+     * @c globalizePositions in the last bits.
+     */
+    void globalizePositionGrid( Vec3 const& side,
+                                Vec3 const& up,
+                                Vec3 const& forward,
+                                Vec3 const& position,
+                                Vec3 const& localOrigin,
+                                Vec3 const& localRowStep,
+                                size_t rowCount,
+                                Vec3 const& localColumnStep,
+                                size_t columnCount,
+                                Vec3 globalPositions[] );
+
 } // namespace OpenSteer
 
 #endif // OPENSTEER_VEC3UTILITIES_H
@@ -39,7 +39,11 @@
 #include <sstream>
 #include "SimpleVehicle.h"
 #include "OpenSteerDemo.h"
+#include "VehicleSnapshot.h"
 #include "OpenSteer/Proximity.h"
+#include "OpenSteer/Arena.h"
+#include "OpenSteer/ScratchBuffer.h"
+#include "OpenSteer/ParallelUpdate.h"
 #include "Color.h"
 #include "OpenSteer/UnusedParameter.h"
 
@@ -69,6 +73,28 @@ namespace {
     typedef OpenSteer::AbstractTokenForProximityDatabase<AbstractVehicle*> ProximityToken;
 
 
+    // ----------------------------------------------------------------------------
+    // state shared by the boids of one flock, owned by its BoidsPlugIn (so
+    // several flocks can run side by side in Worlds, see World.h)
+
+
+    struct FlockEnvironment
+    {
+        FlockEnvironment (void) : useSteeringCache (false), nextSeed (0) {}
+
+        // group of all obstacles to be avoided by each Boid
+        ObstacleGroup obstacles;
+
+        // opt-in: trade some accuracy for not recomputing flocking forces
+        // in steady neighborhoods
+        bool useSteeringCache;
+
+        // seeds the random generator of the next boid, so a flock develops
+        // the same way no matter how many vehicles exist elsewhere
+        RandomGenerator::result_type nextSeed;
+    };
+
+
     // ----------------------------------------------------------------------------
 
 
@@ -81,12 +107,16 @@ namespace {
 
 
         // constructor
-        Boid (ProximityDatabase& pd)
+        Boid (ProximityDatabase& pd, FlockEnvironment& flockEnvironment)
+            : environment (flockEnvironment)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
             newPD (pd);
 
+            // random stream of this boid
+            seedRandomGenerator (environment.nextSeed++);
+
             // reset all boid state
             reset ();
         }
@@ -116,10 +146,17 @@ namespace {
             setSpeed (maxSpeed() * 0.3f);
 
             // randomize initial orientation
-            regenerateOrthonormalBasisUF (RandomUnitVector ());
+            regenerateOrthonormalBasisUF (randomGenerator().unitVector ());
 
             // randomize initial position
-            setPosition (RandomVectorInUnitRadiusSphere () * 20);
+            setPosition (randomGenerator().vectorInUnitRadiusSphere () * 20);
+
+            // forget cached flocking force, (re)apply the user's setting
+            flockingCache.setEnabled (environment.useSteeringCache);
+
+    #ifndef NO_LQ_BIN_STATS
+            neighborCount = 0;
+    #endif // NO_LQ_BIN_STATS
 
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
@@ -142,11 +179,22 @@ namespace {
             // steer to flock and avoid obstacles if any
             applySteeringForce (steerToFlock (), elapsedTime);
 
+            finishUpdate ();
+        }
+
+
+        // per frame work after the steering force has been applied
+        // (BoidsPlugIn::update first determines the forces of all boids,
+        // then applies them, then calls this for one boid after the other),
+        // returns true if the boid wrapped around
+        bool finishUpdate (void)
+        {
             // wrap around to contrain boid within the spherical boundary
-            sphericalWrapAround ();
+            const bool wrapped = sphericalWrapAround ();
 
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
+            return wrapped;
         }
 
 
@@ -155,7 +203,7 @@ namespace {
         {
             // avoid obstacles if needed
             // XXX this should probably be moved elsewhere
-            const OpenSteer::Vec3 avoidance = steerToAvoidObstacles (1.0f, obstacles);
+            const OpenSteer::Vec3 avoidance = steerToAvoidObstacles (1.0f, environment.obstacles);
             if (avoidance != OpenSteer::Vec3::zero) return avoidance;
 
             const float separationRadius =  5.0f;
@@ -175,27 +223,31 @@ namespace {
                                                     cohesionRadius));
 
             // find all flockmates within maxRadius using proximity database
-            neighbors.clear();
-            proximityToken->findNeighbors (position(), maxRadius, neighbors);
+            // (into a buffer of the updating thread, see ScratchBuffer.h)
+            OpenSteer::ScratchBuffer<AVGroup> neighbors;
+            proximityToken->findNeighbors (position(), maxRadius, *neighbors);
 
     #ifndef NO_LQ_BIN_STATS
-            // maintain stats on max/min/ave neighbors per boids
-            size_t count = neighbors.size();
-            if (maxNeighbors < count) maxNeighbors = count;
-            if (minNeighbors > count) minNeighbors = count;
-            totalNeighbors += count;
+            // remember for the stats on max/min/ave neighbors per boid,
+            // BoidsPlugIn::update collects them after the steering phase
+            neighborCount = neighbors->size();
     #endif // NO_LQ_BIN_STATS
 
+            // reuse the previous flocking force if our neighborhood has not
+            // changed noticeably since it was computed (only when enabled)
+            OpenSteer::Vec3 flocking;
+            if (flockingCache.lookup (*this, *neighbors, flocking)) return flocking;
+
             // determine each of the three component behaviors of flocking
             const OpenSteer::Vec3 separation = steerForSeparation (separationRadius,
                                                         separationAngle,
-                                                        neighbors);
+                                                        *neighbors);
             const OpenSteer::Vec3 alignment  = steerForAlignment  (alignmentRadius,
                                                         alignmentAngle,
-                                                        neighbors);
+                                                        *neighbors);
             const OpenSteer::Vec3 cohesion   = steerForCohesion   (cohesionRadius,
                                                         cohesionAngle,
-                                                        neighbors);
+                                                        *neighbors);
 
             // apply weights to components (save in variables for annotation)
             const OpenSteer::Vec3 separationW = separation * separationWeight;
@@ -208,12 +260,15 @@ namespace {
             // annotationLine (position, position + (alignmentW  * s), gOrange);
             // annotationLine (position, position + (cohesionW   * s), gYellow);
 
-            return separationW + alignmentW + cohesionW;
+            flocking = separationW + alignmentW + cohesionW;
+            flockingCache.store (flocking);
+            return flocking;
         }
 
 
-        // constrain this boid to stay within sphereical boundary.
-        void sphericalWrapAround (void)
+        // constrain this boid to stay within sphereical boundary,
+        // returns true if it had to be moved
+        bool sphericalWrapAround (void)
         {
             // when outside the sphere
             if (position().length() > worldRadius)
@@ -221,13 +276,9 @@ namespace {
                 // wrap around (teleport)
                 setPosition (position().sphericalWrapAround (OpenSteer::Vec3::zero,
                                                              worldRadius));
-                if (this == OpenSteerDemo::selectedVehicle)
-                {
-                    OpenSteerDemo::position3dCamera
-                        (OpenSteerDemo::selectedVehicle); 
-                    OpenSteerDemo::camera.doNotSmoothNextMove ();
-                }
+                return true;
             }
+            return false;
         }
 
 
@@ -281,17 +332,16 @@ namespace {
         }
 
 
-        // group of all obstacles to be avoided by each Boid
-        static ObstacleGroup obstacles;
+        // obstacles and settings of the flock this boid belongs to
+        FlockEnvironment& environment;
 
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
+        static const float worldRadius;
 
-        static float worldRadius;
+        // last flocking force and the neighborhood it was computed for
+        SteeringCache flockingCache;
 
         // xxx perhaps this should be a call to a general purpose annotation for
         // xxx "local xxx axis aligned box in XZ plane" -- same code in in
@@ -312,17 +362,12 @@ namespace {
         }
 
     #ifndef NO_LQ_BIN_STATS
-            static size_t minNeighbors, maxNeighbors, totalNeighbors;
+            size_t neighborCount;
     #endif // NO_LQ_BIN_STATS
     };
 
 
-    AVGroup Boid::neighbors;
-    float Boid::worldRadius = 50.0f;
-    ObstacleGroup Boid::obstacles;
-    #ifndef NO_LQ_BIN_STATS
-    size_t Boid::minNeighbors, Boid::maxNeighbors, Boid::totalNeighbors;
-    #endif // NO_LQ_BIN_STATS
+    const float Boid::worldRadius = 50.0f;
 
 
     // ----------------------------------------------------------------------------
@@ -333,12 +378,19 @@ namespace {
     {
     public:
         
+        BoidsPlugIn (Registration registration = registered)
+            : PlugIn (registration), pd (NULL), population (0),
+              selectedBoidWrapped (false), cacheHitPercentage (0) {}
+
         const char* name (void) {return "Boids";}
 
         float selectionOrderSortKey (void) {return 0.03f;}
 
         virtual ~BoidsPlugIn() {} // be more "nice" to avoid a compiler warning
 
+        // all state is in the instance, a new one makes an independent flock
+        PlugIn* makeWorldInstance (void) {return new BoidsPlugIn (unregistered);}
+
         void open (void)
         {
             // make the database used to accelerate proximity queries
@@ -350,13 +402,16 @@ namespace {
             for (int i = 0; i < 200; i++) addBoidToFlock ();
 
             // initialize camera
-            OpenSteerDemo::init3dCamera (OpenSteerDemo::selectedVehicle);
-            OpenSteerDemo::camera.mode = Camera::cmFixed;
-            OpenSteerDemo::camera.fixedDistDistance = OpenSteerDemo::cameraTargetDistance;
-            OpenSteerDemo::camera.fixedDistVOffset = 0;
-            OpenSteerDemo::camera.lookdownDistance = 20;
-            OpenSteerDemo::camera.aimLeadTime = 0.5;
-            OpenSteerDemo::camera.povOffset.set (0, 0.5, -2);
+            if (ownsDisplay ())
+            {
+                OpenSteerDemo::init3dCamera (OpenSteerDemo::selectedVehicle);
+                OpenSteerDemo::camera.mode = Camera::cmFixed;
+                OpenSteerDemo::camera.fixedDistDistance = OpenSteerDemo::cameraTargetDistance;
+                OpenSteerDemo::camera.fixedDistVOffset = 0;
+                OpenSteerDemo::camera.lookdownDistance = 20;
+                OpenSteerDemo::camera.aimLeadTime = 0.5;
+                OpenSteerDemo::camera.povOffset.set (0, 0.5, -2);
+            }
 
             // set up obstacles
             initObstacles ();
@@ -365,30 +420,87 @@ namespace {
         void update (const float currentTime, const float elapsedTime)
         {
     #ifndef NO_LQ_BIN_STATS
-            Boid::maxNeighbors = Boid::totalNeighbors = 0;
-            Boid::minNeighbors = std::numeric_limits<int>::max();
+            maxNeighbors = totalNeighbors = 0;
+            minNeighbors = std::numeric_limits<int>::max();
     #endif // NO_LQ_BIN_STATS
 
-            // update flock simulation for each boid
-            for (iterator i = flock.begin(); i != flock.end(); i++)
+            OPENSTEER_UNUSED_PARAMETER(currentTime);
+
+            // determine the steering force of each boid from the positions
+            // at the start of the frame, in parallel unless annotating
+            OpenSteer::computeSteeringForces (updateThreadPool (),
+                                              flock,
+                                              steeringForces,
+                                              [] (Boid& boid)
+                                              {return boid.steerToFlock ();});
+
+            // then move the boids (in parallel) and update the proximity
+            // database (one boid after the other)
+            OpenSteer::applySteeringForces (updateThreadPool (),
+                                            flock,
+                                            [this, elapsedTime] (Boid& boid,
+                                                                 size_t i)
+                                            {boid.applySteeringForce
+                                                (steeringForces[i],
+                                                 elapsedTime);},
+                                            [this] (Boid& boid, size_t)
+                                            {commitBoid (boid);});
+        }
+
+        void commitBoid (Boid& boid)
+        {
+            // keep the camera on the selected boid when it wraps around
+            // (moved in snapshotForRedraw, the camera belongs to the redraw)
+            if (boid.finishUpdate () &&
+                ownsDisplay () &&
+                (&boid == OpenSteerDemo::selectedVehicle))
+            {
+                selectedBoidWrapped = true;
+            }
+
+    #ifndef NO_LQ_BIN_STATS
+            // maintain stats on max/min/ave neighbors per boids
+            const size_t count = boid.neighborCount;
+            if (maxNeighbors < count) maxNeighbors = count;
+            if (minNeighbors > count) minNeighbors = count;
+            totalNeighbors += count;
+    #endif // NO_LQ_BIN_STATS
+        }
+
+        // copy what redraw shows, so the next update can run meanwhile
+        bool snapshotForRedraw (void)
+        {
+            snapshots.capture (flock);
+            cacheHitPercentage = steeringCacheHitPercentage ();
+
+            if (selectedBoidWrapped)
             {
-                (**i).update (currentTime, elapsedTime);
+                OpenSteerDemo::position3dCamera (OpenSteerDemo::selectedVehicle);
+                OpenSteerDemo::camera.doNotSmoothNextMove ();
+                selectedBoidWrapped = false;
             }
+            return true;
         }
 
+        // draws the snapshots, the boids may already be in their next update
         void redraw (const float currentTime, const float elapsedTime)
         {
             // selected vehicle (user can mouse click to select another)
-            AbstractVehicle* selected = OpenSteerDemo::selectedVehicle;
+            AbstractVehicle* selected = snapshots.find (OpenSteerDemo::selectedVehicle);
 
             // vehicle nearest mouse (to be highlighted)
-            AbstractVehicle* nearMouse = OpenSteerDemo::vehicleNearestToMouse ();
+            AbstractVehicle* nearMouse = OpenSteerDemo::vehicleNearestToMouse (snapshots.all ());
 
             // update camera
             OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
 
             // draw each boid in flock
-            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).draw ();
+            for (AVIterator i = snapshots.all ().begin ();
+                 i != snapshots.all ().end ();
+                 i++)
+            {
+                drawBasic3dSphericalVehicle (**i, gGray70);
+            }
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::drawCircleHighlightOnVehicle (nearMouse, 1, gGray70);
@@ -427,6 +539,11 @@ namespace {
             case insideBox:
                 status << "inside a box" ; break;
             }
+            status << "\n[F6]    Steering cache: ";
+            if (environment.useSteeringCache)
+                status << "on, " << cacheHitPercentage << "% hits";
+            else
+                status << "off";
             status << std::endl;
             const float h = OpenSteerDemo::drawGetWindowHeight ();
             const OpenSteer::Vec3 screenLocation (10, h-50, 0);
@@ -437,8 +554,13 @@ namespace {
 
         void close (void)
         {
-            // delete each member of the flock
-            while (population > 0) removeBoidFromFlock ();
+            // delete the whole flock at once
+            if ((population > 0) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = NULL;
+            flock.clear ();
+            snapshots.clear ();
+            population = 0;
+            arena.clear ();
 
             // delete the proximity database
             delete pd;
@@ -450,11 +572,14 @@ namespace {
             // reset each boid in flock
             for (iterator i = flock.begin(); i != flock.end(); i++) (**i).reset();
 
-            // reset camera position
-            OpenSteerDemo::position3dCamera (OpenSteerDemo::selectedVehicle);
+            if (ownsDisplay ())
+            {
+                // reset camera position
+                OpenSteerDemo::position3dCamera (OpenSteerDemo::selectedVehicle);
 
-            // make camera jump immediately to new position
-            OpenSteerDemo::camera.doNotSmoothNextMove ();
+                // make camera jump immediately to new position
+                OpenSteerDemo::camera.doNotSmoothNextMove ();
+            }
         }
 
         // for purposes of demonstration, allow cycling through various
@@ -503,9 +628,17 @@ namespace {
             case 3:  nextPD ();                 break;
             case 4:  nextBoundaryCondition ();  break;
             case 5:  printLQbinStats ();        break;
+            case 6:  toggleSteeringCache ();    break;
             }
         }
 
+        bool setPopulation (int count)
+        {
+            while (population < count) addBoidToFlock ();
+            while (population > count) removeBoidFromFlock ();
+            return true;
+        }
+
         void printLQbinStats (void)
         {
     #ifndef NO_LQ_BIN_STATS
@@ -518,9 +651,9 @@ namespace {
                       << min << ", " << max << ", " << average
                       << " (non-empty bins)" << std::endl; 
             std::cout << "Boid neighbors:  min, max, average: "
-                      << Boid::minNeighbors << ", "
-                      << Boid::maxNeighbors << ", "
-                      << ((float)Boid::totalNeighbors) / ((float)population)
+                      << minNeighbors << ", "
+                      << maxNeighbors << ", "
+                      << ((float)totalNeighbors) / ((float)population)
                       << std::endl;
     #endif // NO_LQ_BIN_STATS
         }
@@ -533,6 +666,8 @@ namespace {
            case 2:   return "  F2     remove a boid from the flock.";
            case 3:   return "  F3     use next proximity database.";
            case 4:   return "  F4     next flock boundary condition.";
+           case 5:   return "  F5     print proximity database stats.";
+           case 6:   return "  F6     toggle caching of flocking forces.";
            }
 
            return NULL;
@@ -548,15 +683,40 @@ namespace {
             OpenSteerDemo::printMessage (getFunctionKeyHelp(2));
             OpenSteerDemo::printMessage (getFunctionKeyHelp(3));
             OpenSteerDemo::printMessage (getFunctionKeyHelp(4));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(6));
             OpenSteerDemo::printMessage ("");
         }
 
+        void toggleSteeringCache (void)
+        {
+            environment.useSteeringCache = !environment.useSteeringCache;
+            for (iterator i = flock.begin(); i != flock.end(); i++)
+                (**i).flockingCache.setEnabled (environment.useSteeringCache);
+        }
+
+        // percentage of flocking forces taken from the steering caches
+        // since the last call (counters are reset each time)
+        int steeringCacheHitPercentage (void)
+        {
+            size_t hits = 0;
+            size_t lookups = 0;
+            for (iterator i = flock.begin(); i != flock.end(); i++)
+            {
+                SteeringCache& cache = (**i).flockingCache;
+                hits += cache.hits ();
+                lookups += cache.hits () + cache.misses ();
+                cache.resetCounters ();
+            }
+            return (lookups > 0) ? (int) ((100 * hits) / lookups) : 0;
+        }
+
         void addBoidToFlock (void)
         {
             population++;
-            Boid* boid = new Boid (*pd);
+            Boid* boid = arena.create<Boid> (*pd, environment);
             flock.push_back (boid);
-            if (population == 1) OpenSteerDemo::selectedVehicle = boid;
+            if ((population == 1) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = boid;
         }
 
         void removeBoidFromFlock (void)
@@ -569,11 +729,11 @@ namespace {
                 population--;
 
                 // if it is OpenSteerDemo's selected vehicle, unselect it
-                if (boid == OpenSteerDemo::selectedVehicle)
+                if (ownsDisplay () && (boid == OpenSteerDemo::selectedVehicle))
                     OpenSteerDemo::selectedVehicle = NULL;
 
                 // delete the Boid
-                delete boid;
+                arena.destroy (boid);
             }
         }
 
@@ -584,6 +744,12 @@ namespace {
         Boid::groupType flock;
         typedef Boid::groupType::const_iterator iterator;
 
+        // steering force of each boid, in flock order (see update)
+        std::vector<OpenSteer::Vec3> steeringForces;
+
+        // memory of the boids and their trails, in flock order
+        OpenSteer::Arena arena;
+
         // pointer to database used to accelerate proximity queries
         ProximityDatabase* pd;
 
@@ -593,6 +759,19 @@ namespace {
         // which of the various proximity databases is currently in use
         int cyclePD;
 
+        // obstacles and settings shared by the boids of the flock
+        FlockEnvironment environment;
+
+    #ifndef NO_LQ_BIN_STATS
+        // neighbors per boid in the last update
+        size_t minNeighbors, maxNeighbors, totalNeighbors;
+    #endif // NO_LQ_BIN_STATS
+
+        // the flock as redraw shows it, taken after each update
+        VehicleSnapshots snapshots;
+        bool selectedBoidWrapped;
+        int cacheHitPercentage;
+
         // --------------------------------------------------------
         // the rest of this plug-in supports the various obstacles:
         // --------------------------------------------------------
@@ -682,11 +861,11 @@ namespace {
         }
 
 
-        // update Boid::obstacles list when constraint changes
+        // update the flock's obstacle list when constraint changes
         void updateObstacles (void)
         {
             // first clear out obstacle list
-            Boid::obstacles.clear ();
+            environment.obstacles.clear ();
 
             // add back obstacles based on mode
             switch (constraint)
@@ -697,34 +876,34 @@ namespace {
             case none:
                 break;
             case insideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
+                environment.obstacles.push_back (&insideBigSphere);
                 break;
             case outsideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideSphere0);
+                environment.obstacles.push_back (&insideBigSphere);
+                environment.obstacles.push_back (&outsideSphere0);
                 break;
             case outsideSpheres:
-                Boid::obstacles.push_back (&insideBigSphere);
+                environment.obstacles.push_back (&insideBigSphere);
             case outsideSpheresNoBig:
-                Boid::obstacles.push_back (&outsideSphere1);
-                Boid::obstacles.push_back (&outsideSphere2);
-                Boid::obstacles.push_back (&outsideSphere3);
-                Boid::obstacles.push_back (&outsideSphere4);
-                Boid::obstacles.push_back (&outsideSphere5);
-                Boid::obstacles.push_back (&outsideSphere6);
+                environment.obstacles.push_back (&outsideSphere1);
+                environment.obstacles.push_back (&outsideSphere2);
+                environment.obstacles.push_back (&outsideSphere3);
+                environment.obstacles.push_back (&outsideSphere4);
+                environment.obstacles.push_back (&outsideSphere5);
+                environment.obstacles.push_back (&outsideSphere6);
                 break;
             case rectangle:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&bigRectangle);
+                environment.obstacles.push_back (&insideBigSphere);
+                environment.obstacles.push_back (&bigRectangle);
             case rectangleNoBig:
-                Boid::obstacles.push_back (&bigRectangle);
+                environment.obstacles.push_back (&bigRectangle);
                 break;
             case outsideBox:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideBigBox);
+                environment.obstacles.push_back (&insideBigSphere);
+                environment.obstacles.push_back (&outsideBigBox);
                 break;
             case insideBox:
-                Boid::obstacles.push_back (&insideBigBox);
+                environment.obstacles.push_back (&insideBigBox);
                 break;
             }
         }
@@ -732,8 +911,8 @@ namespace {
 
         void drawObstacles (void)
         {
-            for (ObstacleIterator o = Boid::obstacles.begin();
-                 o != Boid::obstacles.end();
+            for (ObstacleIterator o = environment.obstacles.begin();
+                 o != environment.obstacles.end();
                  o++)
             {
                 (**o).draw (false, // draw in wireframe
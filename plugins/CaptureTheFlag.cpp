@@ -57,6 +57,7 @@
 #include "SimpleVehicle.h"
 #include "OpenSteerDemo.h"
 #include "Color.h"
+#include "OpenSteer/Arena.h"
 
 namespace {
 
@@ -72,6 +73,49 @@ namespace {
     typedef SOG::const_iterator SOI;           // SphereObstacle iterator
 
 
+    // ----------------------------------------------------------------------------
+    // state of one match: the vehicles, the obstacles and the bookkeeping
+    // shared by them, owned by its CtfPlugIn (so several matches can run side
+    // by side in Worlds, see World.h)
+
+
+    class CtfSeeker;
+    class CtfEnemy;
+    const int ctfEnemyCount = 4;
+
+
+    struct CtfMatch
+    {
+        CtfMatch (void);
+        ~CtfMatch ();
+
+        // dynamic obstacle registry
+        void initializeObstacles (void);
+        void addOneObstacle (void);
+        void removeOneObstacle (void);
+        int obstacleCount;
+        static const int maxObstacleCount;
+        SOG allObstacles;
+
+        CtfSeeker* seeker;
+        CtfEnemy* enemies [ctfEnemyCount];
+
+        float avoidancePredictTime;
+
+        // count the number of times the simulation has reset (e.g. for
+        // overnight runs)
+        int resetCount;
+
+        // set by the seeker when the match is over, the PlugIn resets the
+        // match at the start of its next update
+        bool resetRequested;
+
+        // random streams: obstacle placement and the seed of the next vehicle
+        RandomGenerator random;
+        RandomGenerator::result_type nextSeed;
+    };
+
+
     // ----------------------------------------------------------------------------
     // This PlugIn uses two vehicle types: CtfSeeker and CtfEnemy.  They have a
     // common base class: CtfBase which is a specialization of SimpleVehicle.
@@ -81,7 +125,11 @@ namespace {
     {
     public:
         // constructor
-        CtfBase () {reset ();}
+        CtfBase (CtfMatch& ctfMatch) : match (ctfMatch)
+        {
+            seedRandomGenerator (match.nextSeed++);
+            reset ();
+        }
 
         // reset state
         void reset (void);
@@ -103,14 +151,10 @@ namespace {
         // xxx store steer sub-state for anotation
         bool avoiding;
 
-        // dynamic obstacle registry
-        static void initializeObstacles (void);
-        static void addOneObstacle (void);
-        static void removeOneObstacle (void);
         float minDistanceToObstacle (const Vec3 point);
-        static int obstacleCount;
-        static const int maxObstacleCount;
-        static SOG allObstacles;
+
+        // the match this vehicle takes part in
+        CtfMatch& match;
     };
 
 
@@ -119,7 +163,7 @@ namespace {
     public:
 
         // constructor
-        CtfSeeker () {reset ();}
+        CtfSeeker (CtfMatch& ctfMatch) : CtfBase (ctfMatch) {reset ();}
 
         // reset state
         void reset (void);
@@ -151,7 +195,7 @@ namespace {
     public:
 
         // constructor
-        CtfEnemy () {reset ();}
+        CtfEnemy (CtfMatch& ctfMatch) : CtfBase (ctfMatch) {reset ();}
 
         // reset state
         void reset (void);
@@ -166,7 +210,7 @@ namespace {
     // (perhaps these should be member variables of a Vehicle or PlugIn class)
 
 
-    const int CtfBase::maxObstacleCount = 100;
+    const int CtfMatch::maxObstacleCount = 100;
 
     const Vec3 gHomeBaseCenter (0, 0, 0);
     const float gHomeBaseRadius = 1.5;
@@ -182,28 +226,32 @@ namespace {
 
     const float gAvoidancePredictTimeMin  = 0.9f;
     const float gAvoidancePredictTimeMax  = 2;
-    float gAvoidancePredictTime = gAvoidancePredictTimeMin;
 
     bool enableAttackSeek  = true; // for testing (perhaps retain for UI control?)
     bool enableAttackEvade = true; // for testing (perhaps retain for UI control?)
 
-    CtfSeeker* gSeeker = NULL;
-
 
-    // count the number of times the simulation has reset (e.g. for overnight runs)
-    int resetCount = 0;
+    // ----------------------------------------------------------------------------
+    // state of a match
 
 
-    // ----------------------------------------------------------------------------
-    // state for OpenSteerDemo PlugIn
-    //
-    // XXX consider moving this inside CtfPlugIn
-    // XXX consider using STL (any advantage? consistency?)
+    CtfMatch::CtfMatch (void)
+        : obstacleCount (-1), // this value means "uninitialized"
+          seeker (NULL),
+          avoidancePredictTime (gAvoidancePredictTimeMin),
+          resetCount (0),
+          resetRequested (false),
+          nextSeed (0)
+    {
+        for (int i = 0; i < ctfEnemyCount; i++) enemies[i] = NULL;
+    }
 
 
-    CtfSeeker* ctfSeeker;
-    const int ctfEnemyCount = 4;
-    CtfEnemy* ctfEnemies [ctfEnemyCount];
+    CtfMatch::~CtfMatch ()
+    {
+        for (SOI so = allObstacles.begin(); so != allObstacles.end(); so++)
+            delete *so;
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -230,7 +278,7 @@ namespace {
     {
         CtfBase::reset ();
         bodyColor.set (0.4f, 0.4f, 0.6f); // blueish
-        gSeeker = this;
+        match.seeker = this;
         state = running;
         evading = false;
     }
@@ -261,8 +309,9 @@ namespace {
     {
         // randomize position on a ring between inner and outer radii
         // centered around the home base
-        const float rRadius = frandom2 (gMinStartRadius, gMaxStartRadius);
-        const Vec3 randomOnRing = RandomUnitVectorOnXZPlane () * rRadius;
+        const float rRadius = randomGenerator().random2 (gMinStartRadius,
+                                                         gMaxStartRadius);
+        const Vec3 randomOnRing = randomGenerator().unitVectorOnXZPlane () * rRadius;
         setPosition (gHomeBaseCenter + randomOnRing);
 
         // are we are too close to an obstacle?
@@ -287,26 +336,26 @@ namespace {
     {
         // determine upper bound for pursuit prediction time
         const float seekerToGoalDist = Vec3::distance (gHomeBaseCenter,
-                                                       gSeeker->position());
+                                                       match.seeker->position());
         const float adjustedDistance = seekerToGoalDist - radius()-gHomeBaseRadius;
         const float seekerToGoalTime = ((adjustedDistance < 0 ) ?
                                         0 :
-                                        (adjustedDistance/gSeeker->speed()));
+                                        (adjustedDistance/match.seeker->speed()));
         const float maxPredictionTime = seekerToGoalTime * 0.9f;
 
         // determine steering (pursuit, obstacle avoidance, or braking)
         Vec3 steer (0, 0, 0);
-        if (gSeeker->state == running)
+        if (match.seeker->state == running)
         {
             const OpenSteer::Vec3 avoidance =
                 steerToAvoidObstacles (gAvoidancePredictTimeMin,
-                                       (ObstacleGroup&) allObstacles);
+                                       (ObstacleGroup&) match.allObstacles);
 
             // saved for annotation
             avoiding = (avoidance == OpenSteer::Vec3::zero);
 
             if (avoiding)
-                steer = steerForPursuit (*gSeeker, maxPredictionTime);
+                steer = steerForPursuit (*match.seeker, maxPredictionTime);
             else
                 steer = avoidance;
         }
@@ -323,18 +372,18 @@ namespace {
 
         // detect and record interceptions ("tags") of seeker
         const float seekerToMeDist = Vec3::distance (position(), 
-                                                     gSeeker->position());
-        const float sumOfRadii = radius() + gSeeker->radius();
+                                                     match.seeker->position());
+        const float sumOfRadii = radius() + match.seeker->radius();
         if (seekerToMeDist < sumOfRadii)
         {
-            if (gSeeker->state == running) gSeeker->state = tagged;
+            if (match.seeker->state == running) match.seeker->state = tagged;
 
             // annotation:
-            if (gSeeker->state == tagged)
+            if (match.seeker->state == tagged)
             {
                 const Color color (0.8f, 0.5f, 0.5f);
                 annotationXZDisk (sumOfRadii,
-                            (position() + gSeeker->position()) / 2,
+                            (position() + match.seeker->position()) / 2,
                             color,
                             20);
             }
@@ -364,7 +413,7 @@ namespace {
         for (int i = 0; i < ctfEnemyCount; i++)
         {
             // short name for this enemy
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *match.enemies[i];
             const float eDistance = Vec3::distance (position(), e.position());
             const float timeEstimate = 0.3f * eDistance / e.speed(); //xxx
             const Vec3 eFuture = e.predictFuturePosition (timeEstimate);
@@ -474,7 +523,7 @@ namespace {
         // sum up weighted evasion
         for (int i = 0; i < ctfEnemyCount; i++)
         {
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *match.enemies[i];
             const Vec3 eOffset = e.position() - position();
             const float eDistance = eOffset.length();
 
@@ -510,7 +559,7 @@ namespace {
         Vec3 evade (0, 0, 0);
         for (int i = 0; i < ctfEnemyCount; i++)
         {
-            const CtfEnemy& e = *ctfEnemies[i];
+            const CtfEnemy& e = *match.enemies[i];
             const Vec3 eOffset = e.position() - position();
             const float eDistance = eOffset.length();
 
@@ -548,8 +597,8 @@ namespace {
         const bool clearPath = clearPathToGoal ();
         adjustObstacleAvoidanceLookAhead (clearPath);
         const Vec3 obstacleAvoidance =
-            steerToAvoidObstacles (gAvoidancePredictTime,
-                                   (ObstacleGroup&) allObstacles);
+            steerToAvoidObstacles (match.avoidancePredictTime,
+                                   (ObstacleGroup&) match.allObstacles);
 
         // saved for annotation
         avoiding = (obstacleAvoidance != Vec3::zero);
@@ -619,13 +668,13 @@ namespace {
             const bool headingTowardGoal = isAhead (gHomeBaseCenter, 0.98f);
             const bool isNear = (goalDistance/speed()) < gAvoidancePredictTimeMax;
             const bool useMax = headingTowardGoal && !isNear;
-            gAvoidancePredictTime =
+            match.avoidancePredictTime =
                 (useMax ? gAvoidancePredictTimeMax : gAvoidancePredictTimeMin);
         }
         else
         {
             evading = true;
-            gAvoidancePredictTime = gAvoidancePredictTimeMin;
+            match.avoidancePredictTime = gAvoidancePredictTimeMin;
         }
     }
 
@@ -651,11 +700,7 @@ namespace {
         {
             const float resetDelay = 4;
             const float resetTime = lastRunningTime + resetDelay;
-            if (currentTime > resetTime) 
-            {
-                // xxx a royal hack (should do this internal to CTF):
-                OpenSteerDemo::queueDelayedResetPlugInXXX ();
-            }
+            if (currentTime > resetTime) match.resetRequested = true;
         }
     }
 
@@ -695,8 +740,8 @@ namespace {
         // display status in the upper left corner of the window
         std::ostringstream status;
         status << seekerStateString << std::endl;
-        status << obstacleCount << " obstacles [F1/F2]" << std::endl;
-        status << resetCount << " restarts" << std::ends;
+        status << match.obstacleCount << " obstacles [F1/F2]" << std::endl;
+        status << match.resetCount << " restarts" << std::ends;
         const float h = OpenSteerDemo::drawGetWindowHeight ();
         const Vec3 screenLocation (10, h-50, 0);
         draw2dTextAt2dLocation (status, screenLocation, gGray80, OpenSteerDemo::drawGetWindowWidth(), OpenSteerDemo::drawGetWindowHeight());
@@ -739,10 +784,6 @@ namespace {
     // xxx (but remember: obstacles a not necessarilty spheres!)
 
 
-    int CtfBase::obstacleCount = -1; // this value means "uninitialized"
-    SOG CtfBase::allObstacles;
-
-
     #define testOneObstacleOverlap(radius, center)               \
     {                                                            \
         float d = Vec3::distance (c, center);                    \
@@ -751,7 +792,7 @@ namespace {
     }
 
 
-    void CtfBase::initializeObstacles (void)
+    void CtfMatch::initializeObstacles (void)
     {
         // start with 40% of possible obstacles
         if (obstacleCount == -1)
@@ -762,7 +803,7 @@ namespace {
     }
 
 
-    void CtfBase::addOneObstacle (void)
+    void CtfMatch::addOneObstacle (void)
     {
         if (obstacleCount < maxObstacleCount)
         {
@@ -771,11 +812,11 @@ namespace {
             float r;
             Vec3 c;
             float minClearance;
-            const float requiredClearance = gSeeker->radius() * 4; // 2 x diameter
+            const float requiredClearance = seeker->radius() * 4; // 2 x diameter
             do
             {
-                r = frandom2 (1.5, 4);
-                c = randomVectorOnUnitRadiusXZDisk () * gMaxStartRadius * 1.1f;
+                r = random.random2 (1.5, 4);
+                c = random.vectorOnUnitRadiusXZDisk () * gMaxStartRadius * 1.1f;
                 minClearance = FLT_MAX;
 
                 for (SOI so = allObstacles.begin(); so != allObstacles.end(); so++)
@@ -800,6 +841,7 @@ namespace {
         float r = 0;
         Vec3 c = point;
         float minClearance = FLT_MAX;
+        const SOG& allObstacles = match.allObstacles;
         for (SOI so = allObstacles.begin(); so != allObstacles.end(); so++)
         {
             testOneObstacleOverlap ((**so).radius, (**so).center);
@@ -808,11 +850,12 @@ namespace {
     }
 
 
-    void CtfBase::removeOneObstacle (void)
+    void CtfMatch::removeOneObstacle (void)
     {
         if (obstacleCount > 0)
         {
             obstacleCount--;
+            delete allObstacles.back();
             allObstacles.pop_back();
         }
     }
@@ -826,44 +869,56 @@ namespace {
     {
     public:
 
+        CtfPlugIn (Registration registration = registered)
+            : PlugIn (registration) {}
+
         const char* name (void) {return "Capture the Flag";}
 
         float selectionOrderSortKey (void) {return 0.01f;}
 
         virtual ~CtfPlugIn() {} // be more "nice" to avoid a compiler warning
 
+        // all state is in the instance, a new one makes an independent match
+        PlugIn* makeWorldInstance (void) {return new CtfPlugIn (unregistered);}
+
         void open (void)
         {
             // create the seeker ("hero"/"attacker")
-            ctfSeeker = new CtfSeeker;
-            all.push_back (ctfSeeker);
+            match.seeker = arena.create<CtfSeeker> (match);
+            all.push_back (match.seeker);
 
             // create the specified number of enemies, 
             // storing pointers to them in an array.
             for (int i = 0; i<ctfEnemyCount; i++)
             {
-                ctfEnemies[i] = new CtfEnemy;
-                all.push_back (ctfEnemies[i]);
+                match.enemies[i] = arena.create<CtfEnemy> (match);
+                all.push_back (match.enemies[i]);
             }
 
             // initialize camera
-            OpenSteerDemo::init2dCamera (ctfSeeker);
-            OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
-            OpenSteerDemo::camera.fixedTarget.set (15, 0, 0);
-            OpenSteerDemo::camera.fixedPosition.set (80, 60, 0);
+            if (ownsDisplay ())
+            {
+                OpenSteerDemo::init2dCamera (match.seeker);
+                OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
+                OpenSteerDemo::camera.fixedTarget.set (15, 0, 0);
+                OpenSteerDemo::camera.fixedPosition.set (80, 60, 0);
+            }
 
-            CtfBase::initializeObstacles ();
+            match.initializeObstacles ();
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
+            // start over some time after the seeker was tagged or got home
+            if (match.resetRequested) reset ();
+
             // update the seeker
-            ctfSeeker->update (currentTime, elapsedTime);
+            match.seeker->update (currentTime, elapsedTime);
           
             // update each enemy
             for (int i = 0; i < ctfEnemyCount; i++)
             {
-                ctfEnemies[i]->update (currentTime, elapsedTime);
+                match.enemies[i]->update (currentTime, elapsedTime);
             }
         }
 
@@ -893,12 +948,12 @@ namespace {
             }
 
             // draw the seeker, obstacles and home base
-            ctfSeeker->draw();
+            match.seeker->draw();
             drawObstacles ();
             drawHomeBase();
 
             // draw each enemy
-            for (int i = 0; i < ctfEnemyCount; i++) ctfEnemies[i]->draw ();
+            for (int i = 0; i < ctfEnemyCount; i++) match.enemies[i]->draw ();
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::highlightVehicleUtility (nearMouse);
@@ -906,16 +961,10 @@ namespace {
 
         void close (void)
         {
-            // delete seeker
-            delete (ctfSeeker);
-            ctfSeeker = NULL;
-
-            // delete each enemy
-            for (int i = 0; i < ctfEnemyCount; i++)
-            {
-                delete (ctfEnemies[i]);
-                ctfEnemies[i] = NULL;
-            }
+            // delete seeker and enemies at once
+            arena.clear ();
+            match.seeker = NULL;
+            for (int i = 0; i < ctfEnemyCount; i++) match.enemies[i] = NULL;
 
             // clear the group of all vehicles
             all.clear();
@@ -924,25 +973,29 @@ namespace {
         void reset (void)
         {
             // count resets
-            resetCount++;
+            match.resetCount++;
+            match.resetRequested = false;
 
             // reset the seeker ("hero"/"attacker") and enemies
-            ctfSeeker->reset ();
-            for (int i = 0; i<ctfEnemyCount; i++) ctfEnemies[i]->reset ();
+            match.seeker->reset ();
+            for (int i = 0; i<ctfEnemyCount; i++) match.enemies[i]->reset ();
 
-            // reset camera position
-            OpenSteerDemo::position2dCamera (ctfSeeker);
+            if (ownsDisplay ())
+            {
+                // reset camera position
+                OpenSteerDemo::position2dCamera (match.seeker);
 
-            // make camera jump immediately to new position
-            OpenSteerDemo::camera.doNotSmoothNextMove ();
+                // make camera jump immediately to new position
+                OpenSteerDemo::camera.doNotSmoothNextMove ();
+            }
         }
 
         void handleFunctionKeys (int keyNumber)
         {
             switch (keyNumber)
             {
-            case 1: CtfBase::addOneObstacle ();    break;
-            case 2: CtfBase::removeOneObstacle (); break;
+            case 1: match.addOneObstacle ();    break;
+            case 2: match.removeOneObstacle (); break;
             }
         }
 
@@ -975,7 +1028,7 @@ namespace {
             const Vec3 up (0, 0.01f, 0);
             const Color atColor (0.3f, 0.3f, 0.5f);
             const Color noColor = gGray50;
-            const bool reached = ctfSeeker->state == CtfSeeker::atGoal;
+            const bool reached = match.seeker->state == CtfSeeker::atGoal;
             const Color baseColor = (reached ? atColor : noColor);
             drawXZDisk (gHomeBaseRadius,    gHomeBaseCenter, baseColor, 40);
             drawXZDisk (gHomeBaseRadius/15, gHomeBaseCenter+up, gBlack, 20);
@@ -984,7 +1037,7 @@ namespace {
         void drawObstacles (void)
         {
             const Color color (0.8f, 0.6f, 0.4f);
-            const SOG& allSO = CtfBase::allObstacles;
+            const SOG& allSO = match.allObstacles;
             for (SOI so = allSO.begin(); so != allSO.end(); so++)
             {
                 drawXZCircle ((**so).radius, (**so).center, color, 40);
@@ -993,6 +1046,12 @@ namespace {
 
         // a group (STL vector) of all vehicles in the PlugIn
         std::vector<CtfBase*> all;
+
+        // obstacles and vehicles of the match
+        CtfMatch match;
+
+        // memory of the seeker, the enemies and their trails
+        OpenSteer::Arena arena;
     };
 
 
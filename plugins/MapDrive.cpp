@@ -50,6 +50,8 @@
 // ----------------------------------------------------------------------------
 
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <cassert>
@@ -502,18 +504,68 @@ namespace {
         {
             const float spacing = minSpacing() / 2;
 
-            for (float x = xMin; x < xMax; x += spacing)
+            // sample grid: rows along local x, columns along local z
+            const size_t rowCount = sampleCount (xMin, xMax, spacing);
+            const size_t columnCount = sampleCount (zMin, zMax, spacing);
+            if ((rowCount == 0) || (columnCount == 0)) return false;
+            const Vec3 rowStep (spacing, 0, 0);
+            const Vec3 columnStep (0, 0, spacing);
+
+            // globalize as many whole rows as fit into the buffer at once
+            // (or a part of a row for very long rows) and stop at the first
+            // hit, like the former point by point scan
+            const size_t bufferSize = 256;
+            Vec3 samples [bufferSize];
+            const size_t columnsPerBatch = std::min (columnCount, bufferSize);
+            const size_t rowsPerBatch = bufferSize / columnsPerBatch;
+
+            for (size_t row = 0; row < rowCount; row += rowsPerBatch)
             {
-                for (float z = zMin; z < zMax; z += spacing)
+                const size_t rows = std::min (rowsPerBatch, rowCount - row);
+                for (size_t column = 0;
+                     column < columnCount;
+                     column += columnsPerBatch)
                 {
-                    const Vec3 sample (x, 0, z);
-                    const Vec3 global = localSpace.globalizePosition (sample);
-                    if (getMapValue (global)) return true;
+                    const size_t columns = std::min (columnsPerBatch,
+                                                     columnCount - column);
+                    const Vec3 origin (xMin + (row * spacing),
+                                       0,
+                                       zMin + (column * spacing));
+                    localSpace.globalizePositionGrid (origin,
+                                                      rowStep, rows,
+                                                      columnStep, columns,
+                                                      samples);
+                    for (size_t i = 0; i < rows * columns; i++)
+                    {
+                        if (getMapValue (samples[i])) return true;
+                    }
                 }
             }
             return false;
         }
 
+        // number of samples at min, min + spacing, ... below max, that is
+        // the number of i with (min + (i * spacing)) < max computed in
+        // float, the same way the scan computes the sample positions.  The
+        // far edge itself is never sampled: when max - min is a multiple of
+        // spacing this gives exactly (max - min) / spacing samples, whereas
+        // the former loop (x = xMin; x < xMax; x += spacing) accumulated
+        // rounding error and took one extra sample at the far edge for
+        // about a third of such rectangles.  Away from multiples of spacing
+        // both count the same.
+        static size_t sampleCount (float min, float max, float spacing)
+        {
+            if (max <= min) return 0;
+
+            // the quotient may be off by one in either direction, correct
+            // it against the sample positions
+            size_t count = (size_t) ceilf ((max - min) / spacing);
+            while ((count > 0) && ((min + ((count - 1) * spacing)) >= max))
+                count--;
+            while ((min + (count * spacing)) < max) count++;
+            return count;
+        }
+
         // Scans along a ray (directed line segment) on the XZ plane, sampling
         // the map for a "true" cell.  Returns the index of the first sample
         // that gets a "hit", or zero if no hits found.
@@ -145,8 +145,8 @@ namespace {
             // centered around the home base
             const float inner = 20;
             const float outer = 30;
-            const float radius = frandom2 (inner, outer);
-            const Vec3 randomOnRing = RandomUnitVectorOnXZPlane () * radius;
+            const float radius = randomGenerator().random2 (inner, outer);
+            const Vec3 randomOnRing = randomGenerator().unitVectorOnXZPlane () * radius;
             setPosition (wanderer->position() + randomOnRing);
 
             // randomize 2D heading
@@ -43,6 +43,9 @@
 #include "SimpleVehicle.h"
 #include "OpenSteerDemo.h"
 #include "OpenSteer/Proximity.h"
+#include "OpenSteer/Arena.h"
+#include "OpenSteer/ScratchBuffer.h"
+#include "OpenSteer/ParallelUpdate.h"
 #include "Color.h"
 
 namespace {
@@ -62,21 +65,43 @@ namespace {
 
     // How many pedestrians to create when the plugin starts first?
     int const gPedestrianStartCount = 100;
-    // creates a path for the PlugIn
-    PolylineSegmentedPathwaySingleRadius* getTestPath (void);
-    PolylineSegmentedPathwaySingleRadius* gTestPath = NULL;
-    SphereObstacle gObstacle1;
-    SphereObstacle gObstacle2;
-    ObstacleGroup gObstacles;
-    Vec3 gEndpoint0;
-    Vec3 gEndpoint1;
-    bool gUseDirectedPathFollowing = true;
-    // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
-    RectangleObstacle gObstacle3 (7,7);
-    // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
 
-    // this was added for debugging tool, but I might as well leave it in
-    bool gWanderSwitch = true;
+
+    // ----------------------------------------------------------------------------
+    // path, obstacles and settings shared by the Pedestrians of one crowd,
+    // owned by its PedestrianPlugIn (so several crowds can run side by side
+    // in Worlds, see World.h)
+
+
+    struct CrowdEnvironment
+    {
+        // creates the path and obstacles, see below
+        CrowdEnvironment (void);
+
+        PolylineSegmentedPathwaySingleRadius testPath;
+        SphereObstacle obstacle1;
+        SphereObstacle obstacle2;
+        ObstacleGroup obstacles;
+        Vec3 endpoint0;
+        Vec3 endpoint1;
+        bool useDirectedPathFollowing;
+        // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+        RectangleObstacle obstacle3;
+        // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
+
+        // this was added for debugging tool, but I might as well leave it in
+        bool wanderSwitch;
+
+        // reuse collision avoidance results in steady neighborhoods
+        bool useSteeringCache;
+
+        // integrate the steering forces of the whole crowd in one batch
+        bool useBatchIntegration;
+
+        // seeds the random generator of the next Pedestrian, so a crowd
+        // develops the same way no matter how many vehicles exist elsewhere
+        RandomGenerator::result_type nextSeed;
+    };
 
 
     // ----------------------------------------------------------------------------
@@ -90,12 +115,16 @@ namespace {
         typedef std::vector<Pedestrian*> groupType;
 
         // constructor
-        Pedestrian (ProximityDatabase& pd)
+        Pedestrian (ProximityDatabase& pd, CrowdEnvironment& crowdEnvironment)
+            : environment (crowdEnvironment)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
             newPD (pd);
 
+            // random stream of this Pedestrian
+            seedRandomGenerator (environment.nextSeed++);
+
             // reset Pedestrian state
             reset ();
         }
@@ -120,28 +149,39 @@ namespace {
             // initially stopped
             setSpeed (0);
 
+            // walking on the ground plane turns slowly compared to the
+            // update rate, many updates only need to set forward
+            setBasisTolerance (0.01f);
+
             // size of bounding sphere, for obstacle avoidance, etc.
             setRadius (0.5); // width = 0.7, add 0.3 margin, take half
 
             // set the path for this Pedestrian to follow
-            path = getTestPath ();
+            path = &environment.testPath;
 
             // set initial position
             // (random point on path + random horizontal offset)
-            const float d = path->length() * frandom01();
+            const float d = path->length() * randomGenerator().random01();
             const float r = path->radius();
-            const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk () * r;
+            const Vec3 randomOffset =
+                randomGenerator().vectorOnUnitRadiusXZDisk () * r;
             setPosition (path->mapPathDistanceToPoint (d) + randomOffset);
 
+            // we were just placed somewhere else on the path
+            pathCursor.reset ();
+
             // randomize 2D heading
             randomizeHeadingOnXZPlane ();
 
             // pick a random direction for path following (upstream or downstream)
-            pathDirection = (frandom01() > 0.5) ? -1 : +1;
+            pathDirection = (randomGenerator().random01() > 0.5) ? -1 : +1;
 
             // trail parameters: 3 seconds with 60 points along the trail
             setTrailParameters (3, 60);
 
+            // forget cached avoidance, (re)apply the user's setting
+            avoidanceCache.setEnabled (environment.useSteeringCache);
+
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
         }
@@ -153,21 +193,27 @@ namespace {
             applySteeringForce (determineCombinedSteering (elapsedTime),
                                 elapsedTime);
 
+            finishUpdate (currentTime);
+        }
+
+        // per frame work after the steering force has been applied
+        void finishUpdate (const float currentTime)
+        {
             // reverse direction when we reach an endpoint
-            if (gUseDirectedPathFollowing)
+            if (environment.useDirectedPathFollowing)
             {
                 const Color darkRed (0.7f, 0, 0);
                 float const pathRadius = path->radius();
                 
-                if (Vec3::distance (position(), gEndpoint0) < pathRadius )
+                if (Vec3::distance (position(), environment.endpoint0) < pathRadius )
                 {
                     pathDirection = +1;
-                    annotationXZCircle (pathRadius, gEndpoint0, darkRed, 20);
+                    annotationXZCircle (pathRadius, environment.endpoint0, darkRed, 20);
                 }
-                if (Vec3::distance (position(), gEndpoint1) < pathRadius )
+                if (Vec3::distance (position(), environment.endpoint1) < pathRadius )
                 {
                     pathDirection = -1;
-                    annotationXZCircle (pathRadius, gEndpoint1, darkRed, 20);
+                    annotationXZCircle (pathRadius, environment.endpoint1, darkRed, 20);
                 }
             }
 
@@ -193,15 +239,15 @@ namespace {
 
             // determine if obstacle avoidance is required
             Vec3 obstacleAvoidance;
-            if (leakThrough < frandom01())
+            if (leakThrough < randomGenerator().random01())
             {
                 const float oTime = 6; // minTimeToCollision = 6 seconds
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
     // just for testing
-    //             obstacleAvoidance = steerToAvoidObstacles (oTime, gObstacles);
-    //             obstacleAvoidance = steerToAvoidObstacle (oTime, gObstacle1);
-    //             obstacleAvoidance = steerToAvoidObstacle (oTime, gObstacle3);
-                obstacleAvoidance = steerToAvoidObstacles (oTime, gObstacles);
+    //             obstacleAvoidance = steerToAvoidObstacles (oTime, environment.obstacles);
+    //             obstacleAvoidance = steerToAvoidObstacle (oTime, environment.obstacle1);
+    //             obstacleAvoidance = steerToAvoidObstacle (oTime, environment.obstacle3);
+                obstacleAvoidance = steerToAvoidObstacles (oTime, environment.obstacles);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
             }
 
@@ -220,12 +266,14 @@ namespace {
                 // (radius is largest distance between vehicles traveling head-on
                 // where a collision is possible within caLeadTime seconds.)
                 const float maxRadius = caLeadTime * maxSpeed() * 2;
-                neighbors.clear();
-                proximityToken->findNeighbors (position(), maxRadius, neighbors);
+                OpenSteer::ScratchBuffer<AVGroup> neighbors;
+                proximityToken->findNeighbors (position(), maxRadius, *neighbors);
 
-                if (leakThrough < frandom01())
+                if (leakThrough < randomGenerator().random01())
                     collisionAvoidance =
-                        steerToAvoidNeighbors (caLeadTime, neighbors) * 10;
+                        steerToAvoidNeighbors (caLeadTime,
+                                               *neighbors,
+                                               avoidanceCache) * 10;
 
                 // if collision avoidance is needed, do it
                 if (collisionAvoidance != Vec3::zero)
@@ -235,15 +283,16 @@ namespace {
                 else
                 {
                     // add in wander component (according to user switch)
-                    if (gWanderSwitch)
+                    if (environment.wanderSwitch)
                         steeringForce += steerForWander (elapsedTime);
 
                     // do (interactively) selected type of path following
                     const float pfLeadTime = 3;
                     const Vec3 pathFollow =
-                        (gUseDirectedPathFollowing ?
-                         steerToFollowPath (pathDirection, pfLeadTime, *path) :
-                         steerToStayOnPath (pfLeadTime, *path));
+                        (environment.useDirectedPathFollowing ?
+                         steerToFollowPath (pathDirection, pfLeadTime,
+                                            *path, pathCursor) :
+                         steerToStayOnPath (pfLeadTime, *path, pathCursor));
 
                     // add in to steeringForce
                     steeringForce += pathFollow * 0.5;
@@ -352,9 +401,11 @@ namespace {
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
+        // last collision avoidance and the neighborhood it was computed for
+        SteeringCache avoidanceCache;
+
+        // path, obstacles and settings of the crowd
+        CrowdEnvironment& environment;
 
         // path to be followed by this pedestrian
         // XXX Ideally this should be a generic Pathway, but we use the
@@ -363,12 +414,14 @@ namespace {
         // XXX there be a "random position inside path" method on Pathway?
         PolylineSegmentedPathwaySingleRadius* path;
 
+        // our last known position along the path
+        PathCursor pathCursor;
+
         // direction for path following (upstream or downstream)
         int pathDirection;
     };
 
 
-    AVGroup Pedestrian::neighbors;
 
 
     // ----------------------------------------------------------------------------
@@ -393,74 +446,73 @@ namespace {
     //
 
 
-    PolylineSegmentedPathwaySingleRadius* getTestPath (void)
+    CrowdEnvironment::CrowdEnvironment (void)
+        : useDirectedPathFollowing (true),
+          obstacle3 (7,7),
+          wanderSwitch (true),
+          useSteeringCache (false),
+          useBatchIntegration (false),
+          nextSeed (0)
     {
-        if (gTestPath == NULL)
-        {
-            const float pathRadius = 2;
-
-            const PolylineSegmentedPathwaySingleRadius::size_type pathPointCount = 7;
-            const float size = 30;
-            const float top = 2 * size;
-            const float gap = 1.2f * size;
-            const float out = 2 * size;
-            const float h = 0.5;
-            const Vec3 pathPoints[pathPointCount] =
-                {Vec3 (h+gap-out,     0,  h+top-out),  // 0 a
-                 Vec3 (h+gap,         0,  h+top),      // 1 b
-                 Vec3 (h+gap+(top/2), 0,  h+top/2),    // 2 c
-                 Vec3 (h+gap,         0,  h),          // 3 d
-                 Vec3 (h,             0,  h),          // 4 e
-                 Vec3 (h,             0,  h+top),      // 5 f
-                 Vec3 (h+gap,         0,  h+top/2)};   // 6 g
-
-            gObstacle1.center = interpolate (0.2f, pathPoints[0], pathPoints[1]);
-            gObstacle2.center = interpolate (0.5f, pathPoints[2], pathPoints[3]);
-            gObstacle1.radius = 3;
-            gObstacle2.radius = 5;
-            gObstacles.push_back (&gObstacle1);
-            gObstacles.push_back (&gObstacle2);
+        const float pathRadius = 2;
+
+        const PolylineSegmentedPathwaySingleRadius::size_type pathPointCount = 7;
+        const float size = 30;
+        const float top = 2 * size;
+        const float gap = 1.2f * size;
+        const float out = 2 * size;
+        const float h = 0.5;
+        const Vec3 pathPoints[pathPointCount] =
+            {Vec3 (h+gap-out,     0,  h+top-out),  // 0 a
+             Vec3 (h+gap,         0,  h+top),      // 1 b
+             Vec3 (h+gap+(top/2), 0,  h+top/2),    // 2 c
+             Vec3 (h+gap,         0,  h),          // 3 d
+             Vec3 (h,             0,  h),          // 4 e
+             Vec3 (h,             0,  h+top),      // 5 f
+             Vec3 (h+gap,         0,  h+top/2)};   // 6 g
+
+        obstacle1.center = interpolate (0.2f, pathPoints[0], pathPoints[1]);
+        obstacle2.center = interpolate (0.5f, pathPoints[2], pathPoints[3]);
+        obstacle1.radius = 3;
+        obstacle2.radius = 5;
+        obstacles.push_back (&obstacle1);
+        obstacles.push_back (&obstacle2);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
 
-            gObstacles.push_back (&gObstacle3);
+        obstacles.push_back (&obstacle3);
 
-    //         // rotated to be perpendicular with path
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, 0, 1);
-    //         gObstacle3.setPosition (20, 0, h);
+    //     // rotated to be perpendicular with path
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, 0, 1);
+    //     obstacle3.setPosition (20, 0, h);
 
-    //         // moved up to test off-center
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, 0, 1);
-    //         gObstacle3.setPosition (20, 3, h);
+    //     // moved up to test off-center
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, 0, 1);
+    //     obstacle3.setPosition (20, 3, h);
 
-    //         // rotated 90 degrees around path to test other local axis
-    //         gObstacle3.setForward (1, 0, 0);
-    //         gObstacle3.setSide (0, -1, 0);
-    //         gObstacle3.setUp (0, 0, -1);
-    //         gObstacle3.setPosition (20, 0, h);
+    //     // rotated 90 degrees around path to test other local axis
+    //     obstacle3.setForward (1, 0, 0);
+    //     obstacle3.setSide (0, -1, 0);
+    //     obstacle3.setUp (0, 0, -1);
+    //     obstacle3.setPosition (20, 0, h);
 
-            // tilted 45 degrees
-            gObstacle3.setForward (Vec3(1,1,0).normalize());
-            gObstacle3.setSide (0,0,1);
-            gObstacle3.setUp (Vec3(-1,1,0).normalize());
-            gObstacle3.setPosition (20, 0, h);
+        // tilted 45 degrees
+        obstacle3.setForward (Vec3(1,1,0).normalize());
+        obstacle3.setSide (0,0,1);
+        obstacle3.setUp (Vec3(-1,1,0).normalize());
+        obstacle3.setPosition (20, 0, h);
 
-    //         gObstacle3.setSeenFrom (Obstacle::outside);
-    //         gObstacle3.setSeenFrom (Obstacle::inside);
-            gObstacle3.setSeenFrom (Obstacle::both);
+    //     obstacle3.setSeenFrom (Obstacle::outside);
+    //     obstacle3.setSeenFrom (Obstacle::inside);
+        obstacle3.setSeenFrom (Obstacle::both);
 
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
 
-            gEndpoint0 = pathPoints[0];
-            gEndpoint1 = pathPoints[pathPointCount-1];
+        endpoint0 = pathPoints[0];
+        endpoint1 = pathPoints[pathPointCount-1];
 
-            gTestPath = new PolylineSegmentedPathwaySingleRadius (pathPointCount,
-                                                                  pathPoints,
-                                                                  pathRadius,
-                                                                  false);
-        }
-        return gTestPath;
+        testPath.setPathway (pathPointCount, pathPoints, pathRadius, false);
     }
 
 
@@ -472,12 +524,18 @@ namespace {
     {
     public:
 
+        PedestrianPlugIn (Registration registration = registered)
+            : PlugIn (registration), pd (NULL), population (0) {}
+
         const char* name (void) {return "Pedestrians";}
 
         float selectionOrderSortKey (void) {return 0.02f;}
 
         virtual ~PedestrianPlugIn() {}// be more "nice" to avoid a compiler warning
 
+        // all state is in the instance, a new one makes an independent crowd
+        PlugIn* makeWorldInstance (void) {return new PedestrianPlugIn (unregistered);}
+
         void open (void)
         {
             // make the database used to accelerate proximity queries
@@ -489,19 +547,62 @@ namespace {
             for (int i = 0; i < gPedestrianStartCount; i++) addPedestrianToCrowd ();
 
             // initialize camera and selectedVehicle
-            Pedestrian* firstPedestrian = *crowd.begin();
-            OpenSteerDemo::init3dCamera (firstPedestrian);
-            OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
-            OpenSteerDemo::camera.fixedTarget.set (15, 0, 30);
-            OpenSteerDemo::camera.fixedPosition.set (15, 70, -70);
+            if (ownsDisplay ())
+            {
+                Pedestrian* firstPedestrian = *crowd.begin();
+                OpenSteerDemo::init3dCamera (firstPedestrian);
+                OpenSteerDemo::camera.mode = Camera::cmFixedDistanceOffset;
+                OpenSteerDemo::camera.fixedTarget.set (15, 0, 30);
+                OpenSteerDemo::camera.fixedPosition.set (15, 70, -70);
+            }
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            // determine the steering force of each Pedestrian from the state
+            // at the start of the frame, in parallel unless annotating
+            computeSteeringForces (updateThreadPool (),
+                                   crowd,
+                                   steeringForces,
+                                   [elapsedTime] (Pedestrian& pedestrian)
+                                   {return pedestrian.determineCombinedSteering
+                                       (elapsedTime);});
+
+            if (environment.useBatchIntegration)
             {
-                (**i).update (currentTime, elapsedTime);
+                applyBatched (currentTime, elapsedTime);
+                return;
+            }
+
+            // then move the Pedestrians (in parallel) and finish their
+            // update (one after the other, it updates the proximity database)
+            applySteeringForces (updateThreadPool (),
+                                 crowd,
+                                 [this, elapsedTime] (Pedestrian& pedestrian,
+                                                      size_t index)
+                                 {pedestrian.applySteeringForce
+                                     (steeringForces[index], elapsedTime);},
+                                 [currentTime] (Pedestrian& pedestrian, size_t)
+                                 {pedestrian.finishUpdate (currentTime);});
+        }
+
+        // like the end of update, but the steering forces are applied in
+        // one batch
+        void applyBatched (const float currentTime, const float elapsedTime)
+        {
+            integrator.clear ();
+            for (size_t index = 0; index < crowd.size(); index++)
+            {
+                integrator.add (crowd[index]->motionState (),
+                                steeringForces[index]);
+            }
+
+            integrator.integrate (elapsedTime);
+
+            for (size_t index = 0; index < crowd.size(); index++)
+            {
+                crowd[index]->setMotionState (integrator.state (index));
+                crowd[index]->finishUpdate (currentTime);
             }
         }
 
@@ -562,12 +663,19 @@ namespace {
             case 1: status << "brute force";    break;
             }
             status << "\n[F4] ";
-            if (gUseDirectedPathFollowing)
+            if (environment.useDirectedPathFollowing)
                 status << "Directed path following.";
             else
                 status << "Stay on the path.";
             status << "\n[F5] Wander: ";
-            if (gWanderSwitch) status << "yes"; else status << "no";
+            if (environment.wanderSwitch) status << "yes"; else status << "no";
+            status << "\n[F6] Steering cache: ";
+            if (environment.useSteeringCache)
+                status << "on, " << steeringCacheHitPercentage () << "% hits";
+            else
+                status << "off";
+            status << "\n[F7] Batched integration: ";
+            if (environment.useBatchIntegration) status << "on"; else status << "off";
             status << std::endl;
             const float h = OpenSteerDemo::drawGetWindowHeight ();
             const Vec3 screenLocation (10, h-50, 0);
@@ -610,25 +718,25 @@ namespace {
             typedef PolylineSegmentedPathwaySingleRadius::size_type size_type;
             
             // draw a line along each segment of path
-            const PolylineSegmentedPathwaySingleRadius& path = *getTestPath ();
+            const PolylineSegmentedPathwaySingleRadius& path = environment.testPath;
             for (size_type i = 1; i < path.pointCount(); ++i ) {
                 drawLine (path.point( i ), path.point( i-1) , gRed);
             }
             
             // draw obstacles
-            drawXZCircle (gObstacle1.radius, gObstacle1.center, gWhite, 40);
-            drawXZCircle (gObstacle2.radius, gObstacle2.center, gWhite, 40);
+            drawXZCircle (environment.obstacle1.radius, environment.obstacle1.center, gWhite, 40);
+            drawXZCircle (environment.obstacle2.radius, environment.obstacle2.center, gWhite, 40);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
             {
-                float w = gObstacle3.width * 0.5f;
-                Vec3 p = gObstacle3.position ();
-                Vec3 s = gObstacle3.side ();
+                float w = environment.obstacle3.width * 0.5f;
+                Vec3 p = environment.obstacle3.position ();
+                Vec3 s = environment.obstacle3.side ();
                 drawLine (p + (s * w), p + (s * -w), gWhite);
 
-                Vec3 v1 = gObstacle3.globalizePosition (Vec3 (w, w, 0));
-                Vec3 v2 = gObstacle3.globalizePosition (Vec3 (-w, w, 0));
-                Vec3 v3 = gObstacle3.globalizePosition (Vec3 (-w, -w, 0));
-                Vec3 v4 = gObstacle3.globalizePosition (Vec3 (w, -w, 0));
+                Vec3 v1 = environment.obstacle3.globalizePosition (Vec3 (w, w, 0));
+                Vec3 v2 = environment.obstacle3.globalizePosition (Vec3 (-w, w, 0));
+                Vec3 v3 = environment.obstacle3.globalizePosition (Vec3 (-w, -w, 0));
+                Vec3 v4 = environment.obstacle3.globalizePosition (Vec3 (w, -w, 0));
 
                 drawLine (v1, v2, gWhite);
                 drawLine (v2, v3, gWhite);
@@ -640,8 +748,16 @@ namespace {
 
         void close (void)
         {
-            // delete all Pedestrians
-           while (population > 0) removePedestrianFromCrowd ();
+            // delete all Pedestrians at once
+            if ((population > 0) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = NULL;
+            crowd.clear ();
+            population = 0;
+            arena.clear ();
+
+            // delete the proximity database
+            delete pd;
+            pd = NULL;
         }
 
         void reset (void)
@@ -649,11 +765,14 @@ namespace {
             // reset each Pedestrian
             for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).reset ();
 
-            // reset camera position
-            OpenSteerDemo::position2dCamera (OpenSteerDemo::selectedVehicle);
+            if (ownsDisplay ())
+            {
+                // reset camera position
+                OpenSteerDemo::position2dCamera (OpenSteerDemo::selectedVehicle);
 
-            // make camera jump immediately to new position
-            OpenSteerDemo::camera.doNotSmoothNextMove ();
+                // make camera jump immediately to new position
+                OpenSteerDemo::camera.doNotSmoothNextMove ();
+            }
         }
 
         void handleFunctionKeys (int keyNumber)
@@ -663,9 +782,43 @@ namespace {
             case 1:  addPedestrianToCrowd ();                               break;
             case 2:  removePedestrianFromCrowd ();                          break;
             case 3:  nextPD ();                                             break;
-            case 4: gUseDirectedPathFollowing = !gUseDirectedPathFollowing; break;
-            case 5: gWanderSwitch = !gWanderSwitch;                         break;
+            case 4:  toggle (environment.useDirectedPathFollowing);         break;
+            case 5:  toggle (environment.wanderSwitch);                     break;
+            case 6:  toggleSteeringCache ();                                break;
+            case 7:  toggle (environment.useBatchIntegration);              break;
+            }
+        }
+
+        static void toggle (bool& flag) {flag = !flag;}
+
+        bool setPopulation (int count)
+        {
+            while (population < count) addPedestrianToCrowd ();
+            while (population > count) removePedestrianFromCrowd ();
+            return true;
+        }
+
+        void toggleSteeringCache (void)
+        {
+            environment.useSteeringCache = !environment.useSteeringCache;
+            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+                (**i).avoidanceCache.setEnabled (environment.useSteeringCache);
+        }
+
+        // percentage of avoidance forces taken from the steering caches
+        // since the last call (counters are reset each time)
+        int steeringCacheHitPercentage (void)
+        {
+            size_t hits = 0;
+            size_t lookups = 0;
+            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            {
+                SteeringCache& cache = (**i).avoidanceCache;
+                hits += cache.hits ();
+                lookups += cache.hits () + cache.misses ();
+                cache.resetCounters ();
             }
+            return (lookups > 0) ? (int) ((100 * hits) / lookups) : 0;
         }
 
         const char* getFunctionKeyHelp(int keyNumber) 
@@ -677,6 +830,8 @@ namespace {
            case 3:   return "  F3     use next proximity database.";
            case 4:   return "  F4     toggle directed path follow.";
            case 5:   return "  F5     toggle wander component on/off.";
+           case 6:   return "  F6     toggle caching of avoidance forces.";
+           case 7:   return "  F7     toggle batched integration.";
            }
 
            return NULL; 
@@ -693,6 +848,8 @@ namespace {
             OpenSteerDemo::printMessage (getFunctionKeyHelp(3));
             OpenSteerDemo::printMessage (getFunctionKeyHelp(4));
             OpenSteerDemo::printMessage (getFunctionKeyHelp(5));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(6));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(7));
             OpenSteerDemo::printMessage ("");
         }
 
@@ -700,9 +857,10 @@ namespace {
         void addPedestrianToCrowd (void)
         {
             population++;
-            Pedestrian* pedestrian = new Pedestrian (*pd);
+            Pedestrian* pedestrian = arena.create<Pedestrian> (*pd, environment);
             crowd.push_back (pedestrian);
-            if (population == 1) OpenSteerDemo::selectedVehicle = pedestrian;
+            if ((population == 1) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = pedestrian;
         }
 
 
@@ -716,11 +874,11 @@ namespace {
                 population--;
 
                 // if it is OpenSteerDemo's selected vehicle, unselect it
-                if (pedestrian == OpenSteerDemo::selectedVehicle)
+                if (ownsDisplay () && (pedestrian == OpenSteerDemo::selectedVehicle))
                     OpenSteerDemo::selectedVehicle = NULL;
 
                 // delete the Pedestrian
-                delete pedestrian;
+                arena.destroy (pedestrian);
             }
         }
 
@@ -771,6 +929,15 @@ namespace {
 
         Vec3 gridCenter;
 
+        // steering force of each Pedestrian, in crowd order (see update)
+        std::vector<Vec3> steeringForces;
+
+        // applies the steering forces when useBatchIntegration is set
+        BatchIntegrator integrator;
+
+        // memory of the pedestrians and their trails, in crowd order
+        OpenSteer::Arena arena;
+
         // pointer to database used to accelerate proximity queries
         ProximityDatabase* pd;
 
@@ -779,6 +946,9 @@ namespace {
 
         // which of the various proximity databases is currently in use
         int cyclePD;
+
+        // path, obstacles and settings shared by the crowd
+        CrowdEnvironment environment;
     };
 
 
@@ -160,7 +160,11 @@ namespace {
             setMaxSpeed (10);         // velocity is clipped to this magnitude
 
             // Place me on my part of the field, looking at oponnents goal
-            setPosition(b_ImTeamA ? frandom01()*20 : -frandom01()*20, 0, (frandom01()-0.5f)*20);
+            // (drawn from the player's own random generator, one after the
+            // other, so a seeded run places the players the same way)
+            const float randomX = randomGenerator().random01() * 20;
+            const float randomZ = (randomGenerator().random01() - 0.5f) * 20;
+            setPosition(b_ImTeamA ? randomX : -randomX, 0, randomZ);
             if(m_MyID < 9)
                 {
                 if(b_ImTeamA)
@@ -0,0 +1,975 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Stress Test: a large mixed population as the benchmark scene for the
+// performance of the steering library, its proximity databases and the
+// update engines
+//
+// Half of the agents flock, the other half follow ring paths and avoid
+// each other, all of them avoid obstacles.  The world is a square of tiles,
+// each with an obstacle and a ring path around it, and grows and shrinks
+// with the population so the density and with it the work per agent stay
+// the same from 10 thousand to a million agents.  The function keys double
+// and halve the population and switch the proximity database and the
+// steering engine, the status text shows the update time per agent.
+//
+// Runs without graphics too, e.g. a million agents on 8 threads with the
+// coarse bin lattice:
+//
+//     OpenSteerHeadless "Stress Test" --population 1000000 --threads 8 --key 3
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include "OpenSteer/HeadlessVehicle.h"
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/Proximity.h"
+#include "OpenSteer/Arena.h"
+#include "OpenSteer/ScratchBuffer.h"
+#include "OpenSteer/ParallelUpdate.h"
+#include "OpenSteer/BatchIntegrator.h"
+#include "OpenSteer/UnusedParameter.h"
+#include "OpenSteerDemo.h"
+#include "Draw.h"
+#include "VehicleSnapshot.h"
+#include "Color.h"
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // ----------------------------------------------------------------------------
+
+
+    typedef AbstractProximityDatabase<AbstractVehicle*> ProximityDatabase;
+    typedef AbstractTokenForProximityDatabase<AbstractVehicle*> ProximityToken;
+
+
+    // ----------------------------------------------------------------------------
+
+
+    // How many agents to create when the plugin starts first?
+    int const gStressTestStartCount = 10000;
+
+
+    // ----------------------------------------------------------------------------
+    // the world shared by the agents of one StressTestPlugIn: a square of
+    // tilesPerSide x tilesPerSide tiles, each with a spherical obstacle at
+    // its center and a closed ring path around the obstacle
+
+
+    struct StressEnvironment
+    {
+        StressEnvironment (void)
+            : tilesPerSide (0), useSteeringCache (false), nextSeed (0) {}
+
+        // (re)build the obstacles and paths for a world of n x n tiles
+        void layOut (const int n);
+
+        // tiles per side keeping about agentsPerTile agents on each tile
+        static int tilesForPopulation (const int population)
+        {
+            const double tiles = std::ceil (std::sqrt ((double) population /
+                                                       agentsPerTile));
+            return (tiles > 1) ? (int) tiles : 1;
+        }
+
+        float size (void) const {return tilesPerSide * tileSize;}
+        float halfSize (void) const {return size () * 0.5f;}
+        size_t tileCount (void) const {return obstacles.size ();}
+
+        // tile coordinate i wrapped into [0, tilesPerSide)
+        int wrapTile (const int i) const
+        {
+            return ((i % tilesPerSide) + tilesPerSide) % tilesPerSide;
+        }
+
+        // the obstacles of the 2 x 2 tiles whose centers surround "p" (the
+        // only ones an agent can run into, obstacles are much smaller than
+        // tiles), so the cost of obstacle avoidance doesn't grow with the
+        // world
+        void findNearbyObstacles (const Vec3& p, ObstacleGroup& nearby)
+        {
+            if (tilesPerSide == 1)
+            {
+                nearby.push_back (&obstacles[0]);
+                return;
+            }
+            const float half = halfSize ();
+            const int x0 = (int) std::floor ((p.x + half) / tileSize - 0.5f);
+            const int z0 = (int) std::floor ((p.z + half) / tileSize - 0.5f);
+            for (int z = z0; z <= z0 + 1; z++)
+                for (int x = x0; x <= x0 + 1; x++)
+                    nearby.push_back (&obstacles[wrapTile (z) * tilesPerSide +
+                                                 wrapTile (x)]);
+        }
+
+        // "p" moved back into the world across the opposite edge
+        Vec3 wrapAround (const Vec3& p) const
+        {
+            const float half = halfSize ();
+            Vec3 wrapped = p;
+            if (wrapped.x < -half) wrapped.x += size ();
+            if (wrapped.x >= half) wrapped.x -= size ();
+            if (wrapped.z < -half) wrapped.z += size ();
+            if (wrapped.z >= half) wrapped.z -= size ();
+            return wrapped;
+        }
+
+        Vec3 randomPosition (RandomGenerator& random) const
+        {
+            const float half = halfSize ();
+            return Vec3 (random.random2 (-half, half),
+                         0,
+                         random.random2 (-half, half));
+        }
+
+        size_t randomTile (RandomGenerator& random) const
+        {
+            const size_t tile = (size_t) (random.random01 () * tileCount ());
+            return (tile < tileCount ()) ? tile : tileCount () - 1;
+        }
+
+        static const float tileSize;
+        static const float obstacleRadius;
+        static const float ringHalfSize;
+        static const float pathRadius;
+        static const int agentsPerTile;
+
+        int tilesPerSide;
+
+        // obstacle and ring path of each tile, row by row
+        std::vector<SphereObstacle> obstacles;
+        std::vector<PolylineSegmentedPathwaySingleRadius> paths;
+
+        // reuse neighborhood steering results in steady neighborhoods
+        bool useSteeringCache;
+
+        // seeds the random generator of the next agent, so a run develops
+        // the same way no matter how many vehicles exist elsewhere
+        RandomGenerator::result_type nextSeed;
+    };
+
+
+    const float StressEnvironment::tileSize = 40.0f;
+    const float StressEnvironment::obstacleRadius = 5.0f;
+    const float StressEnvironment::ringHalfSize = 13.0f;
+    const float StressEnvironment::pathRadius = 3.0f;
+    const int StressEnvironment::agentsPerTile = 50;
+
+
+    void StressEnvironment::layOut (const int n)
+    {
+        tilesPerSide = n;
+        obstacles.assign (n * n, SphereObstacle (obstacleRadius, Vec3::zero));
+        paths.resize (n * n);
+
+        const float half = halfSize ();
+        const float r = ringHalfSize;
+        for (int z = 0; z < n; z++)
+        {
+            for (int x = 0; x < n; x++)
+            {
+                const Vec3 center (((x + 0.5f) * tileSize) - half,
+                                   0,
+                                   ((z + 0.5f) * tileSize) - half);
+                const Vec3 ring[4] = {center + Vec3 (-r, 0, -r),
+                                      center + Vec3 ( r, 0, -r),
+                                      center + Vec3 ( r, 0,  r),
+                                      center + Vec3 (-r, 0,  r)};
+                obstacles[z * n + x].center = center;
+                paths[z * n + x].setPathway (4, ring, pathRadius, true);
+            }
+        }
+    }
+
+
+    // ----------------------------------------------------------------------------
+    // an agent is a HeadlessVehicle: at these populations nothing but a few
+    // hundred agents near the camera is drawn, so none of them carries
+    // annotation state or trails
+
+
+    class StressAgent : public HeadlessVehicle
+    {
+    public:
+
+        // type for a group of agents
+        typedef std::vector<StressAgent*> groupType;
+
+        enum Kind {flocker, commuter};
+
+        // constructor
+        StressAgent (ProximityDatabase& pd, StressEnvironment& stressEnvironment)
+            : environment (stressEnvironment), proximityToken (NULL),
+              path (NULL), pathDirection (1), neighborCount (0)
+        {
+            // random stream of this agent, every other one is a commuter
+            const RandomGenerator::result_type seed = environment.nextSeed++;
+            seedRandomGenerator (seed);
+            kind = ((seed % 2) == 0) ? flocker : commuter;
+
+            newPD (pd);
+            reset ();
+        }
+
+        // destructor
+        virtual ~StressAgent ()
+        {
+            // delete this agent's token in the proximity database
+            delete proximityToken;
+        }
+
+        // reset all instance state, placing the agent somewhere in the
+        // current world
+        void reset (void)
+        {
+            HeadlessVehicle::reset ();
+            setRadius (0.5f);
+
+            if (kind == flocker)
+            {
+                setMaxSpeed (4);
+                setMaxForce (12);
+                setPosition (environment.randomPosition (randomGenerator ()));
+                path = NULL;
+            }
+            else
+            {
+                // random point on the ring path of a random tile
+                setMaxSpeed (2);
+                setMaxForce (8);
+                path = &environment.paths[environment.randomTile (randomGenerator ())];
+                const float d = path->length () * randomGenerator ().random01 ();
+                const Vec3 offset =
+                    randomGenerator ().vectorOnUnitRadiusXZDisk () * path->radius ();
+                setPosition (path->mapPathDistanceToPoint (d) + offset);
+                pathDirection = (randomGenerator ().random01 () > 0.5f) ? -1 : +1;
+
+                // commuters walk on the ground plane and turn slowly,
+                // half of the updates only need to set forward
+                setBasisTolerance (0.01f);
+            }
+            pathCursor.reset ();
+
+            randomizeHeadingOnXZPlane ();
+            setSpeed (maxSpeed () * 0.3f);
+
+            // forget cached steering, (re)apply the user's setting
+            steeringCache.setEnabled (environment.useSteeringCache);
+            neighborCount = 0;
+
+            // notify proximity database that our position has changed
+            proximityToken->updateForNewPosition (position ());
+        }
+
+        // per frame simulation update (the serial engine)
+        void update (const float currentTime, const float elapsedTime)
+        {
+            OPENSTEER_UNUSED_PARAMETER(currentTime);
+            applySteeringForce (determineSteering (), elapsedTime);
+            finishUpdate ();
+        }
+
+        // per frame work after the steering force has been applied
+        void finishUpdate (void)
+        {
+            // flockers roam the whole world, leaving it at one edge they
+            // come back at the opposite one
+            if (kind == flocker) setPosition (environment.wrapAround (position ()));
+
+            // notify proximity database that our position has changed
+            proximityToken->updateForNewPosition (position ());
+        }
+
+        // avoid obstacles if needed, otherwise flock or avoid neighbors and
+        // follow the path, constrained to the XZ "ground" plane
+        Vec3 determineSteering (void)
+        {
+            ScratchBuffer<ObstacleGroup> obstacles;
+            environment.findNearbyObstacles (position (), *obstacles);
+            const Vec3 avoidance = steerToAvoidObstacles (2, *obstacles);
+            if (avoidance != Vec3::zero)
+            {
+                neighborCount = 0;
+                return avoidance.setYtoZero ();
+            }
+
+            // find neighbors within the radius of the agent's behavior
+            // (for commuters: the largest distance between a commuter and
+            // a flocker heading towards each other where a collision is
+            // possible within avoidanceTime)
+            const float radius = (kind == flocker) ? 9.0f :
+                                 avoidanceTime * (2.0f + 4.0f);
+            ScratchBuffer<AVGroup> neighbors;
+            proximityToken->findNeighbors (position (), radius, *neighbors);
+            neighborCount = neighbors->size ();
+
+            const Vec3 steering = ((kind == flocker) ?
+                                   steerToFlock (*neighbors) :
+                                   steerToCommute (*neighbors));
+            return steering.setYtoZero ();
+        }
+
+        // keep apart from everyone, align with and approach other flockers
+        Vec3 steerToFlock (const AVGroup& neighbors)
+        {
+            Vec3 flocking;
+            if (steeringCache.lookup (*this, neighbors, flocking)) return flocking;
+
+            ScratchBuffer<AVGroup> flockmates;
+            for (AVIterator i = neighbors.begin (); i != neighbors.end (); i++)
+                if (static_cast<StressAgent*> (*i)->kind == flocker)
+                    flockmates->push_back (*i);
+
+            const Vec3 separation = steerForSeparation (5.0f, -0.707f, neighbors);
+            const Vec3 alignment = steerForAlignment (7.5f, 0.7f, *flockmates);
+            const Vec3 cohesion = steerForCohesion (9.0f, -0.15f, *flockmates);
+
+            flocking = (separation * 12) + (alignment * 8) + (cohesion * 8);
+            steeringCache.store (flocking);
+            return flocking;
+        }
+
+        // avoid collisions with neighbors if needed, otherwise follow the
+        // ring path
+        Vec3 steerToCommute (const AVGroup& neighbors)
+        {
+            const Vec3 collisionAvoidance =
+                steerToAvoidNeighbors (avoidanceTime, neighbors, steeringCache);
+            if (collisionAvoidance != Vec3::zero)
+                return forward () + (collisionAvoidance * 10);
+
+            const float pfLeadTime = 3;
+            return forward () + (steerToFollowPath (pathDirection, pfLeadTime,
+                                                    *path, pathCursor) * 0.5f);
+        }
+
+        // switch to new proximity database
+        void newPD (ProximityDatabase& pd)
+        {
+            // delete this agent's token in the old proximity database
+            delete proximityToken;
+
+            // allocate a token for this agent in the proximity database
+            proximityToken = pd.allocateToken (this);
+            proximityToken->updateForNewPosition (position ());
+        }
+
+        // lead time of the commuters' collision avoidance
+        static const float avoidanceTime;
+
+        // obstacles, paths and settings of the world
+        StressEnvironment& environment;
+
+        // a pointer to this agent's interface object for the proximity database
+        ProximityToken* proximityToken;
+
+        Kind kind;
+
+        // ring path followed by a commuter, its last known position along
+        // the path and its direction
+        PolylineSegmentedPathwaySingleRadius* path;
+        PathCursor pathCursor;
+        int pathDirection;
+
+        // last flocking or collision avoidance force and the neighborhood
+        // it was computed for
+        SteeringCache steeringCache;
+
+        // size of the last neighborhood query
+        size_t neighborCount;
+    };
+
+
+    const float StressAgent::avoidanceTime = 2.0f;
+
+
+    // ----------------------------------------------------------------------------
+    // OpenSteerDemo PlugIn
+
+
+    class StressTestPlugIn : public PlugIn
+    {
+    public:
+
+        StressTestPlugIn (Registration registration = registered)
+            : PlugIn (registration), pd (NULL), population (0),
+              totalNeighbors (0), visibleFlockers (0) {}
+
+        const char* name (void) {return "Stress Test";}
+
+        float selectionOrderSortKey (void) {return 0.08f;}
+
+        virtual ~StressTestPlugIn() {} // be more "nice" to avoid a compiler warning
+
+        // all state is in the instance, a new one makes an independent world
+        PlugIn* makeWorldInstance (void) {return new StressTestPlugIn (unregistered);}
+
+        void open (void)
+        {
+            // lay out the world for the initial population, then make the
+            // database used to accelerate proximity queries
+            environment.layOut (StressEnvironment::tilesForPopulation
+                                (gStressTestStartCount));
+            pdType = fittedLattice;
+            makePD ();
+            engine = parallelEngine;
+            measured = UpdateCost ();
+            shown = UpdateCost ();
+
+            // create the initial population
+            population = 0;
+            for (int i = 0; i < gStressTestStartCount; i++) addAgent ();
+
+            // initialize camera, looking down on the first agent from afar
+            if (ownsDisplay ())
+            {
+                OpenSteerDemo::init2dCamera (OpenSteerDemo::selectedVehicle,
+                                             viewDistance, viewDistance);
+            }
+        }
+
+        void update (const float currentTime, const float elapsedTime)
+        {
+            OPENSTEER_UNUSED_PARAMETER(currentTime);
+
+            typedef std::chrono::steady_clock TimerClock;
+            const TimerClock::time_point start = TimerClock::now ();
+            TimerClock::time_point steered = start;
+            totalNeighbors = 0;
+
+            switch (engine)
+            {
+            case serialEngine:
+                // the classic OpenSteer update: each agent steers and moves
+                // before the next one steers, all on the calling thread
+                for (size_t i = 0; i < agents.size (); i++)
+                {
+                    agents[i]->update (currentTime, elapsedTime);
+                    totalNeighbors += agents[i]->neighborCount;
+                }
+                break;
+
+            case parallelEngine:
+                // determine all steering forces from the state at the start
+                // of the frame in parallel, then move the agents (in
+                // parallel) and update the proximity database (in order)
+                computeSteeringForces (steeringThreadPool (),
+                                       agents,
+                                       steeringForces,
+                                       [] (StressAgent& agent)
+                                       {return agent.determineSteering ();});
+                steered = TimerClock::now ();
+                applySteeringForces (steeringThreadPool (),
+                                     agents,
+                                     [this, elapsedTime] (StressAgent& agent,
+                                                          size_t index)
+                                     {agent.applySteeringForce
+                                         (steeringForces[index], elapsedTime);},
+                                     [this] (StressAgent& agent, size_t)
+                                     {commitAgent (agent);});
+                break;
+
+            case batchedEngine:
+                // like the parallel engine, but the steering forces are
+                // applied in one batch
+                computeSteeringForces (steeringThreadPool (),
+                                       agents,
+                                       steeringForces,
+                                       [] (StressAgent& agent)
+                                       {return agent.determineSteering ();});
+                steered = TimerClock::now ();
+                integrator.clear ();
+                for (size_t index = 0; index < agents.size (); index++)
+                {
+                    integrator.add (agents[index]->motionState (),
+                                    steeringForces[index]);
+                }
+                integrator.integrate (elapsedTime);
+                for (size_t index = 0; index < agents.size (); index++)
+                {
+                    agents[index]->setMotionState (integrator.state (index));
+                    commitAgent (*agents[index]);
+                }
+                break;
+            }
+
+            measureUpdate (start, steered, TimerClock::now ());
+        }
+
+        void commitAgent (StressAgent& agent)
+        {
+            agent.finishUpdate ();
+            totalNeighbors += agent.neighborCount;
+        }
+
+        // fold the timing of the last update into the per agent costs
+        // shown in the status text (restarting the average whenever the
+        // population has changed)
+        void measureUpdate (const std::chrono::steady_clock::time_point start,
+                            const std::chrono::steady_clock::time_point steered,
+                            const std::chrono::steady_clock::time_point end)
+        {
+            typedef std::chrono::duration<float, std::nano> Nanoseconds;
+            const float count = (float) std::max (population, 1);
+            const float updateTime = Nanoseconds (end - start).count ();
+            const float steeringTime = Nanoseconds (steered - start).count ();
+
+            UpdateCost cost;
+            cost.population = population;
+            cost.phases = (engine != serialEngine);
+            cost.updateMilliseconds = updateTime * 1.0e-6f;
+            cost.nanosecondsPerAgent = updateTime / count;
+            cost.steeringNanosecondsPerAgent = steeringTime / count;
+            cost.neighborsPerAgent = totalNeighbors / count;
+
+            if ((measured.population != cost.population) ||
+                (measured.phases != cost.phases))
+            {
+                measured = cost;
+                return;
+            }
+
+            const float smoothRate = 0.1f;
+            blendIntoAccumulator (smoothRate, cost.updateMilliseconds,
+                                  measured.updateMilliseconds);
+            blendIntoAccumulator (smoothRate, cost.nanosecondsPerAgent,
+                                  measured.nanosecondsPerAgent);
+            blendIntoAccumulator (smoothRate, cost.steeringNanosecondsPerAgent,
+                                  measured.steeringNanosecondsPerAgent);
+            blendIntoAccumulator (smoothRate, cost.neighborsPerAgent,
+                                  measured.neighborsPerAgent);
+        }
+
+        // copy the agents near the view center and the costs of the last
+        // update, so the next update can run meanwhile
+        bool snapshotForRedraw (void)
+        {
+            shown = measured;
+
+            AbstractVehicle* selected = OpenSteerDemo::selectedVehicle;
+            viewCenter = (selected != NULL) ?
+                selected->position () : OpenSteerDemo::camera.target;
+
+            // all flockers in view (and the selected agent) first, then the
+            // commuters
+            visible.clear ();
+            for (int pass = 0; pass < 2; pass++)
+            {
+                const StressAgent::Kind kind =
+                    (pass == 0) ? StressAgent::flocker : StressAgent::commuter;
+                for (size_t i = 0; i < agents.size (); i++)
+                {
+                    StressAgent* agent = agents[i];
+                    if ((agent->kind == kind) &&
+                        ((agent == selected) || isInView (agent->position ())))
+                        visible.push_back (agent);
+                }
+                if (pass == 0) visibleFlockers = visible.size ();
+            }
+            snapshots.capture (visible);
+            return true;
+        }
+
+        bool isInView (const Vec3& position) const
+        {
+            const Vec3 offset = position - viewCenter;
+            return ((offset.x * offset.x) + (offset.z * offset.z) <
+                    drawRadius * drawRadius);
+        }
+
+        // draws the snapshots, the agents may already be in their next update
+        void redraw (const float currentTime, const float elapsedTime)
+        {
+            // selected agent (user can mouse click to select another)
+            AbstractVehicle* selected = snapshots.find (OpenSteerDemo::selectedVehicle);
+
+            // agent nearest mouse (to be highlighted)
+            AbstractVehicle* nearMouse = OpenSteerDemo::vehicleNearestToMouse (snapshots.all ());
+
+            // update camera
+            OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
+
+            // draw "ground plane", the tiles and the agents in view
+            OpenSteerDemo::gridUtility (viewCenter);
+            drawTilesInView ();
+            const Color flockerColor (0.5f, 0.6f, 0.7f);
+            const Color commuterColor (0.7f, 0.6f, 0.4f);
+            for (size_t i = 0; i < snapshots.size (); i++)
+            {
+                drawBasic2dCircularVehicle (*snapshots.all ()[i],
+                                            (i < visibleFlockers) ?
+                                            flockerColor : commuterColor);
+            }
+
+            // highlight agent nearest mouse and selected agent
+            OpenSteerDemo::highlightVehicleUtility (nearMouse);
+            OpenSteerDemo::drawCircleHighlightOnVehicle (selected, 1, gGray50);
+
+            // display status in the upper left corner of the window
+            std::ostringstream status;
+            status << std::setiosflags (std::ios::fixed);
+            status << "[F1/F2] " << population << " agents (double/halve), "
+                   << snapshots.size () << " in view";
+            status << "\n[F3]    PD type: ";
+            switch (pdType)
+            {
+            case fittedLattice: status << "LQ bin lattice, bins fit neighborhoods"; break;
+            case coarseLattice: status << "LQ bin lattice, 10 x 10 bins";        break;
+            case bruteForce:    status << "brute force";                          break;
+            }
+            status << "\n[F4]    Steering: ";
+            switch (engine)
+            {
+            case serialEngine:   status << "one agent after another"; break;
+            case parallelEngine: status << "parallel, two phases";    break;
+            case batchedEngine:  status << "parallel, batched integration"; break;
+            }
+            if (engine != serialEngine)
+            {
+                OpenSteer::ThreadPool* pool = steeringThreadPool ();
+                status << " (" << (pool ? pool->threadCount () : 1) << " threads)";
+            }
+            status << "\n[F5]    Steering cache: "
+                   << (environment.useSteeringCache ? "on" : "off");
+            status << "\nWorld: " << std::setprecision (0)
+                   << environment.size () << " x " << environment.size ()
+                   << ", " << environment.tileCount () << " obstacles and paths";
+            status << "\nUpdate: " << std::setprecision (2)
+                   << shown.updateMilliseconds << " ms, "
+                   << std::setprecision (0)
+                   << shown.nanosecondsPerAgent << " ns per agent";
+            if (shown.phases)
+            {
+                status << " (steering "
+                       << shown.steeringNanosecondsPerAgent << ", moving "
+                       << (shown.nanosecondsPerAgent -
+                           shown.steeringNanosecondsPerAgent) << ")";
+            }
+            status << "\nNeighbors per agent: " << std::setprecision (1)
+                   << shown.neighborsPerAgent << std::endl;
+            const float h = OpenSteerDemo::drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            draw2dTextAt2dLocation (status, screenLocation, gGray80, OpenSteerDemo::drawGetWindowWidth(), OpenSteerDemo::drawGetWindowHeight());
+        }
+
+        // obstacles and ring paths of the tiles near the view center
+        void drawTilesInView (void)
+        {
+            const int n = environment.tilesPerSide;
+            const float half = environment.halfSize ();
+            const float tileSize = StressEnvironment::tileSize;
+            const int x0 = std::max (0, (int) ((viewCenter.x - drawRadius + half) / tileSize));
+            const int z0 = std::max (0, (int) ((viewCenter.z - drawRadius + half) / tileSize));
+            const int x1 = std::min (n - 1, (int) ((viewCenter.x + drawRadius + half) / tileSize));
+            const int z1 = std::min (n - 1, (int) ((viewCenter.z + drawRadius + half) / tileSize));
+            const Color pathColor (0.5f, 0.2f, 0.2f);
+
+            for (int z = z0; z <= z1; z++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    const SphereObstacle& obstacle = environment.obstacles[z * n + x];
+                    drawXZCircle (obstacle.radius, obstacle.center, gWhite, 20);
+
+                    const PolylineSegmentedPathwaySingleRadius& path =
+                        environment.paths[z * n + x];
+                    for (size_t i = 0; i < path.pointCount (); i++)
+                    {
+                        drawLine (path.point (i),
+                                  path.point ((i + 1) % path.pointCount ()),
+                                  pathColor);
+                    }
+                }
+            }
+        }
+
+        void close (void)
+        {
+            // delete all agents at once
+            if ((population > 0) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = NULL;
+            agents.clear ();
+            visible.clear ();
+            snapshots.clear ();
+            population = 0;
+            arena.clear ();
+
+            // delete the proximity database
+            delete pd;
+            pd = NULL;
+        }
+
+        void reset (void)
+        {
+            // reset each agent
+            for (iterator i = agents.begin (); i != agents.end (); i++) (**i).reset ();
+
+            if (ownsDisplay ())
+            {
+                // reset camera position
+                OpenSteerDemo::position2dCamera (OpenSteerDemo::selectedVehicle,
+                                                 viewDistance, viewDistance);
+
+                // make camera jump immediately to new position
+                OpenSteerDemo::camera.doNotSmoothNextMove ();
+            }
+        }
+
+        void handleFunctionKeys (int keyNumber)
+        {
+            switch (keyNumber)
+            {
+            case 1:  setPopulation (population * 2);                  break;
+            case 2:  setPopulation (std::max (1, population / 2));    break;
+            case 3:  nextPD ();                                       break;
+            case 4:  engine = (SteeringEngine) ((engine + 1) % (batchedEngine + 1)); break;
+            case 5:  toggleSteeringCache ();                          break;
+            }
+        }
+
+        // add or remove agents, then resize the world to keep the density
+        // (which resets all agents if the world changes)
+        bool setPopulation (int count)
+        {
+            while (population < count) addAgent ();
+            while (population > count) removeAgent ();
+
+            const int tiles = StressEnvironment::tilesForPopulation (population);
+            if (tiles != environment.tilesPerSide)
+            {
+                environment.layOut (tiles);
+                makePD ();
+                reset ();
+            }
+            return true;
+        }
+
+        void toggleSteeringCache (void)
+        {
+            environment.useSteeringCache = !environment.useSteeringCache;
+            for (iterator i = agents.begin (); i != agents.end (); i++)
+                (**i).steeringCache.setEnabled (environment.useSteeringCache);
+        }
+
+        const char* getFunctionKeyHelp (int keyNumber)
+        {
+           switch (keyNumber)
+           {
+           case 1:   return "  F1     double the population.";
+           case 2:   return "  F2     halve the population.";
+           case 3:   return "  F3     use next proximity database.";
+           case 4:   return "  F4     use next steering engine.";
+           case 5:   return "  F5     toggle caching of steering forces.";
+           }
+
+           return NULL;
+        }
+
+        void printMiniHelpForFunctionKeys (void)
+        {
+            std::ostringstream message;
+            message << "Function keys handled by ";
+            message << '"' << name() << '"' << ':' << std::ends;
+            OpenSteerDemo::printMessage (message);
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(1));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(2));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(3));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(4));
+            OpenSteerDemo::printMessage (getFunctionKeyHelp(5));
+            OpenSteerDemo::printMessage ("");
+        }
+
+        void addAgent (void)
+        {
+            population++;
+            StressAgent* agent = arena.create<StressAgent> (*pd, environment);
+            agents.push_back (agent);
+            if ((population == 1) && ownsDisplay ())
+                OpenSteerDemo::selectedVehicle = agent;
+        }
+
+        void removeAgent (void)
+        {
+            if (population > 0)
+            {
+                // save pointer to last agent, then remove it
+                const StressAgent* agent = agents.back ();
+                agents.pop_back ();
+                population--;
+
+                // if it is OpenSteerDemo's selected vehicle, unselect it
+                if (ownsDisplay () && (agent == OpenSteerDemo::selectedVehicle))
+                    OpenSteerDemo::selectedVehicle = NULL;
+
+                // delete the agent
+                arena.destroy (agent);
+            }
+        }
+
+        // cycle through the proximity databases, comparing them is one
+        // purpose of this PlugIn
+        void nextPD (void)
+        {
+            pdType = (ProximityType) ((pdType + 1) % (bruteForce + 1));
+            makePD ();
+        }
+
+        // replace the proximity database by a new one of type pdType
+        // covering the current world
+        void makePD (void)
+        {
+            // save pointer to old PD
+            ProximityDatabase* oldPD = pd;
+
+            // allocate new PD
+            const float size = environment.size ();
+            const Vec3 dimensions (size, size, size);
+            typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
+            switch (pdType)
+            {
+            case fittedLattice:
+                {
+                    // bins about as large as the largest neighborhood
+                    const float div = std::max (1.0f, std::floor (size / 12.0f));
+                    pd = new LQPDAV (Vec3::zero, dimensions, Vec3 (div, 1.0f, div));
+                    break;
+                }
+            case coarseLattice:
+                {
+                    pd = new LQPDAV (Vec3::zero, dimensions, Vec3 (10.0f, 1.0f, 10.0f));
+                    break;
+                }
+            case bruteForce:
+                {
+                    pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
+                    break;
+                }
+            }
+
+            // switch each agent to new PD
+            for (iterator i = agents.begin (); i != agents.end (); i++) (**i).newPD (*pd);
+
+            // delete old PD (if any)
+            delete oldPD;
+        }
+
+        // the agents never annotate, so unlike SimpleVehicles they steer
+        // in parallel also while OpenSteerDemo's annotation is on
+        OpenSteer::ThreadPool* steeringThreadPool (void)
+        {
+            return ownsDisplay () ? &OpenSteerDemo::threadPool : updateThreadPool ();
+        }
+
+        const AVGroup& allVehicles (void) {return (const AVGroup&) agents;}
+
+        // agents: a group (STL vector) of all agents
+        StressAgent::groupType agents;
+        typedef StressAgent::groupType::const_iterator iterator;
+
+        // steering force of each agent, in agents order (see update)
+        std::vector<Vec3> steeringForces;
+
+        // applies the steering forces with the batchedEngine
+        BatchIntegrator integrator;
+
+        // memory of the agents, in agents order
+        OpenSteer::Arena arena;
+
+        // pointer to database used to accelerate proximity queries
+        ProximityDatabase* pd;
+
+        // keep track of current population
+        int population;
+
+        // which of the various proximity databases is currently in use
+        enum ProximityType {fittedLattice, coarseLattice, bruteForce};
+        ProximityType pdType;
+
+        // how update steers and moves the agents
+        enum SteeringEngine {serialEngine, parallelEngine, batchedEngine};
+        SteeringEngine engine;
+
+        // obstacles, paths and settings shared by the agents
+        StressEnvironment environment;
+
+        // sum of the neighborhood sizes of the last update
+        size_t totalNeighbors;
+
+        // cost of the update, averaged over recent frames
+        struct UpdateCost
+        {
+            UpdateCost (void)
+                : population (0), phases (false), updateMilliseconds (0),
+                  nanosecondsPerAgent (0), steeringNanosecondsPerAgent (0),
+                  neighborsPerAgent (0) {}
+
+            int population;
+            bool phases; // false: the steering time is not measured
+            float updateMilliseconds;
+            float nanosecondsPerAgent;
+            float steeringNanosecondsPerAgent;
+            float neighborsPerAgent;
+        };
+        UpdateCost measured; // written by update
+        UpdateCost shown;    // copied for redraw
+
+        // the agents in view as redraw shows them, taken after each
+        // update, the first visibleFlockers of them are flockers
+        static const float drawRadius;
+        static const float viewDistance;
+        Vec3 viewCenter;
+        StressAgent::groupType visible;
+        size_t visibleFlockers;
+        VehicleSnapshots snapshots;
+    };
+
+
+    const float StressTestPlugIn::drawRadius = 100.0f;
+    const float StressTestPlugIn::viewDistance = 60.0f;
+
+
+    StressTestPlugIn gStressTestPlugIn;
+
+
+
+
+    // ----------------------------------------------------------------------------
+
+} // anonymous namespace
@@ -0,0 +1,213 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/Arena.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::malloc, std::free
+#include <cstdlib>
+
+// Include uintptr_t
+#include <cstdint>
+
+// Include std::bad_alloc
+#include <new>
+
+
+
+thread_local OpenSteer::Arena* OpenSteer::Arena::current_ = 0;
+thread_local char const* OpenSteer::Arena::creatingBegin_ = 0;
+thread_local char const* OpenSteer::Arena::creatingEnd_ = 0;
+
+
+
+OpenSteer::Arena::Arena( size_t initialChunkSize )
+    : initialChunkSize_( initialChunkSize ),
+      nextChunkSize_( initialChunkSize ),
+      position_( 0 ),
+      end_( 0 ),
+      bytesAllocated_( 0 )
+{
+    assert( initialChunkSize > 0 && "Chunks must not be empty." );
+}
+
+
+
+OpenSteer::Arena::~Arena()
+{
+    clear();
+}
+
+
+
+void*
+OpenSteer::Arena::allocate( size_t size, size_t alignment )
+{
+    assert( 0 != alignment && 0 == ( alignment & ( alignment - 1 ) ) && "Alignment must be a power of two." );
+
+    FreeList* const freeList = findFreeList( size, alignment );
+    if ( 0 != freeList && ! freeList->blocks.empty() ) {
+        void* const memory = freeList->blocks.back();
+        freeList->blocks.pop_back();
+        return memory;
+    }
+
+    size_t padding = ( alignment - ( reinterpret_cast< std::uintptr_t >( position_ ) & ( alignment - 1 ) ) ) & ( alignment - 1 );
+    if ( 0 == position_ || padding + size > static_cast< size_t >( end_ - position_ ) ) {
+        addChunk( size + alignment );
+        padding = ( alignment - ( reinterpret_cast< std::uintptr_t >( position_ ) & ( alignment - 1 ) ) ) & ( alignment - 1 );
+    }
+
+    char* const memory = position_ + padding;
+    position_ = memory + size;
+    bytesAllocated_ += padding + size;
+    return memory;
+}
+
+
+
+void
+OpenSteer::Arena::release( void* memory, size_t size, size_t alignment )
+{
+    assert( 0 != memory && "Only allocated memory can be released." );
+
+    FreeList* freeList = findFreeList( size, alignment );
+    if ( 0 == freeList ) {
+        freeLists_.push_back( FreeList( size, alignment ) );
+        freeList = &freeLists_.back();
+    }
+    freeList->blocks.push_back( memory );
+}
+
+
+
+void
+OpenSteer::Arena::clear()
+{
+    // Objects may still use memory created after them, destroy the newest
+    // first.
+    while ( ! objects_.empty() ) {
+        Object const object = objects_.back();
+        objects_.pop_back();
+        if ( 0 != object.object ) {
+            object.destroy( object.object );
+        }
+    }
+
+    for ( size_t i = 0; i < chunks_.size(); ++i ) {
+        std::free( chunks_[ i ] );
+    }
+    chunks_.clear();
+    freeLists_.clear();
+
+    position_ = 0;
+    end_ = 0;
+    bytesAllocated_ = 0;
+    nextChunkSize_ = initialChunkSize_;
+}
+
+
+
+OpenSteer::Arena*
+OpenSteer::Arena::creating( void const* object )
+{
+    std::uintptr_t const address = reinterpret_cast< std::uintptr_t >( object );
+    if ( address >= reinterpret_cast< std::uintptr_t >( creatingBegin_ ) &&
+         address < reinterpret_cast< std::uintptr_t >( creatingEnd_ ) ) {
+        return current_;
+    }
+    return 0;
+}
+
+
+
+void
+OpenSteer::Arena::destroyCreated( void const* object )
+{
+    for ( size_t i = objects_.size(); i > 0; --i ) {
+        Object& candidate = objects_[ i - 1 ];
+        if ( candidate.object == object ) {
+            void* const alive = candidate.object;
+            size_t const size = candidate.size;
+            size_t const alignment = candidate.alignment;
+            candidate.object = 0;
+            candidate.destroy( alive );
+            release( alive, size, alignment );
+
+            // Drop destroyed entries at the end, e.g. when a plug-in removes
+            // its vehicles newest first.
+            while ( ! objects_.empty() && 0 == objects_.back().object ) {
+                objects_.pop_back();
+            }
+            return;
+        }
+    }
+    assert( false && "Object not created by this arena." );
+}
+
+
+
+OpenSteer::Arena::FreeList*
+OpenSteer::Arena::findFreeList( size_t size, size_t alignment )
+{
+    // Few distinct sizes per arena (a vehicle type and its trail arrays),
+    // a linear search is fine.
+    for ( size_t i = 0; i < freeLists_.size(); ++i ) {
+        if ( freeLists_[ i ].size == size && freeLists_[ i ].alignment == alignment ) {
+            return &freeLists_[ i ];
+        }
+    }
+    return 0;
+}
+
+
+
+void
+OpenSteer::Arena::addChunk( size_t size )
+{
+    size_t const chunkSize = ( size > nextChunkSize_ ) ? size : nextChunkSize_;
+    char* const chunk = static_cast< char* >( std::malloc( chunkSize ) );
+    if ( 0 == chunk ) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        chunks_.push_back( chunk );
+    } catch ( ... ) {
+        std::free( chunk );
+        throw;
+    }
+
+    position_ = chunk;
+    end_ = chunk + chunkSize;
+
+    if ( nextChunkSize_ < maxChunkSize ) {
+        nextChunkSize_ *= 2;
+    }
+}
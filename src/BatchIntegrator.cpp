@@ -0,0 +1,410 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/BatchIntegrator.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::memset
+#include <cstring>
+
+// Include OpenSteer::limitMaxDeviationAngle
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::ComputeVec3
+#include "OpenSteer/Vec3A.h"
+
+// Include OpenSteer::clip, OpenSteer::blendIntoAccumulator
+#include "OpenSteer/Utilities.h"
+
+// Include OpenSteer::Vec3Lanes, OPENSTEER_VEC3A_SSE
+#include "OpenSteer/Vec3Lanes.h"
+
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
+
+
+namespace {
+
+    /**
+     * @c pow( x, 20 ) by repeated squaring.
+     */
+    template< typename Float >
+    Float pow20( Float x ) {
+        Float const x2 = x * x;
+        Float const x4 = x2 * x2;
+        Float const x8 = x4 * x4;
+        Float const x16 = x8 * x8;
+        return x16 * x4;
+    }
+
+#ifdef OPENSTEER_VEC3A_SSE
+
+    inline __m128 pow20( __m128 x ) {
+        __m128 const x2 = _mm_mul_ps( x, x );
+        __m128 const x4 = _mm_mul_ps( x2, x2 );
+        __m128 const x8 = _mm_mul_ps( x4, x4 );
+        __m128 const x16 = _mm_mul_ps( x8, x8 );
+        return _mm_mul_ps( x16, x4 );
+    }
+
+    /**
+     * @a accumulator blended towards @a newValue, see
+     * @c OpenSteer::blendIntoAccumulator. @a rate must already be clipped.
+     */
+    inline __m128 blend( __m128 rate, __m128 newValue, __m128 accumulator ) {
+        return _mm_add_ps( accumulator, _mm_mul_ps( _mm_sub_ps( newValue, accumulator ), rate ) );
+    }
+
+    inline OpenSteer::Vec3Lanes blend( __m128 rate, OpenSteer::Vec3Lanes const& newValue, OpenSteer::Vec3Lanes const& accumulator ) {
+        return accumulator + ( ( newValue - accumulator ) * rate );
+    }
+
+    template< typename Vec3Block >
+    OpenSteer::Vec3Lanes load( Vec3Block const& block ) {
+        return OpenSteer::Vec3Lanes::load( block.x, block.y, block.z );
+    }
+
+    template< typename Vec3Block >
+    void store( OpenSteer::Vec3Lanes const& v, Vec3Block& block ) {
+        v.store( block.x, block.y, block.z );
+    }
+
+#endif // OPENSTEER_VEC3A_SSE
+
+} // anonymous namespace
+
+
+
+void
+OpenSteer::applySteeringForce( MotionState& state, Vec3 const& force, float elapsedTime )
+{
+    Vec3 const adjustedForce = adjustRawSteeringForce( force, state.forward, state.speed, state.maxSpeed );
+    Vec3 const newVelocity = integrateSteeringForce( state, adjustedForce, elapsedTime );
+    regenerateLocalSpace( state, newVelocity );
+    measurePathCurvature( state, elapsedTime );
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::adjustRawSteeringForce( Vec3 const& force, Vec3 const& forward, float speed, float maxSpeed )
+{
+    float const maxAdjustedSpeed = 0.2f * maxSpeed;
+    if ( ( speed > maxAdjustedSpeed ) || ( force == Vec3::zero ) ) {
+        return force;
+    }
+
+    float const range = speed / maxAdjustedSpeed;
+    float const cosine = interpolate( pow20( range ), 1.0f, -1.0f );
+    return limitMaxDeviationAngle( force, cosine, forward );
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::integrateSteeringForce( MotionState& state, Vec3 const& adjustedForce, float elapsedTime )
+{
+    ComputeVec3 const clippedForce = ComputeVec3( adjustedForce ).truncateLength( state.maxForce );
+    Vec3 const newAcceleration = clippedForce / state.mass;
+
+    // Damp out abrupt changes and oscillations in steering acceleration.
+    if ( elapsedTime > 0 ) {
+        float const smoothRate = clip( 9 * elapsedTime, 0.15f, 0.4f );
+        blendIntoAccumulator( smoothRate, newAcceleration, state.smoothedAcceleration );
+    }
+
+    ComputeVec3 newVelocity = ComputeVec3( state.forward ) * state.speed;
+    newVelocity += ComputeVec3( state.smoothedAcceleration ) * elapsedTime;
+    newVelocity = newVelocity.truncateLength( state.maxSpeed );
+    state.speed = newVelocity.length();
+    state.position = ComputeVec3( state.position ) + ( newVelocity * elapsedTime );
+    return newVelocity;
+}
+
+
+
+void
+OpenSteer::regenerateLocalSpace( MotionState& state, Vec3 const& newVelocity )
+{
+    if ( state.speed > 0 ) {
+        ComputeVec3 const newForward = ComputeVec3( newVelocity ) / state.speed;
+        if ( state.basisTolerance > 0 ) {
+            float const tolerance = state.basisTolerance;
+            float const sideDrift = newForward.dot( state.side );
+            float const upDrift = newForward.dot( state.up );
+            if ( ( sideDrift * sideDrift <= tolerance * tolerance ) &&
+                 ( upDrift * upDrift <= tolerance * tolerance ) &&
+                 ( newForward.dot( state.forward ) > 0 ) ) {
+                state.forward = newForward;
+                return;
+            }
+        }
+
+        ComputeVec3 side;
+        side.cross( newForward, state.up );
+        side = side.normalize();
+        ComputeVec3 up;
+        up.cross( side, newForward );
+        state.forward = newForward;
+        state.side = side;
+        state.up = up;
+    }
+}
+
+
+
+void
+OpenSteer::measurePathCurvature( MotionState& state, float elapsedTime )
+{
+    if ( elapsedTime > 0 ) {
+        Vec3 const dP = state.lastPosition - state.position;
+        Vec3 const dF = ( state.lastForward - state.forward ) / dP.length();
+        Vec3 const lateral = dF.perpendicularComponent( state.forward );
+        float const sign = ( lateral.dot( state.side ) < 0 ) ? 1.0f : -1.0f;
+        state.curvature = lateral.length() * sign;
+        blendIntoAccumulator( elapsedTime * 4.0f, state.curvature, state.smoothedCurvature );
+        state.lastForward = state.forward;
+        state.lastPosition = state.position;
+    }
+
+    blendIntoAccumulator( elapsedTime * 0.06f, state.position, state.smoothedPosition );
+}
+
+
+
+OpenSteer::BatchIntegrator::BatchIntegrator()
+    : size_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::BatchIntegrator::clear()
+{
+    size_ = 0;
+}
+
+
+
+size_t
+OpenSteer::BatchIntegrator::add( MotionState const& state, Vec3 const& force )
+{
+    if ( size_ == blocks_.size() * width ) {
+        // Lanes past the last vehicle are integrated too, start them with
+        // harmless values.
+        blocks_.push_back( Block() );
+        std::memset( &blocks_.back(), 0, sizeof( Block ) );
+    }
+
+    size_t const index = size_++;
+    Block& block = blocks_[ index / width ];
+    size_t const lane = index % width;
+    block.force.set( lane, force );
+    set( block, lane, state );
+    return index;
+}
+
+
+
+OpenSteer::MotionState
+OpenSteer::BatchIntegrator::state( size_t index ) const
+{
+    assert( index < size_ && "index out of range." );
+
+    return get( blocks_[ index / width ], index % width );
+}
+
+
+
+void
+OpenSteer::BatchIntegrator::integrate( float elapsedTime )
+{
+    OPENSTEER_PROFILE_ZONE( "BatchIntegrator::integrate" );
+
+    size_t const blockCount = ( size_ + width - 1 ) / width;
+    for ( size_t b = 0; b < blockCount; ++b ) {
+#ifdef OPENSTEER_VEC3A_SSE
+        // Lanes past the last vehicle compute garbage which is never read.
+        integrateLanes( blocks_[ b ], elapsedTime );
+#else
+        for ( size_t lane = 0; lane < width; ++lane ) {
+            integrateScalar( blocks_[ b ], lane, elapsedTime );
+        }
+#endif // OPENSTEER_VEC3A_SSE
+    }
+}
+
+
+
+OpenSteer::MotionState
+OpenSteer::BatchIntegrator::get( Block const& block, size_t lane )
+{
+    MotionState state;
+    state.side = block.side.get( lane );
+    state.up = block.up.get( lane );
+    state.forward = block.forward.get( lane );
+    state.position = block.position.get( lane );
+    state.mass = block.mass[ lane ];
+    state.speed = block.speed[ lane ];
+    state.maxForce = block.maxForce[ lane ];
+    state.maxSpeed = block.maxSpeed[ lane ];
+    state.smoothedAcceleration = block.smoothedAcceleration.get( lane );
+    state.smoothedPosition = block.smoothedPosition.get( lane );
+    state.curvature = block.curvature[ lane ];
+    state.smoothedCurvature = block.smoothedCurvature[ lane ];
+    state.lastForward = block.lastForward.get( lane );
+    state.lastPosition = block.lastPosition.get( lane );
+    state.basisTolerance = block.basisTolerance[ lane ];
+    return state;
+}
+
+
+
+void
+OpenSteer::BatchIntegrator::set( Block& block, size_t lane, MotionState const& state )
+{
+    block.side.set( lane, state.side );
+    block.up.set( lane, state.up );
+    block.forward.set( lane, state.forward );
+    block.position.set( lane, state.position );
+    block.smoothedAcceleration.set( lane, state.smoothedAcceleration );
+    block.smoothedPosition.set( lane, state.smoothedPosition );
+    block.lastForward.set( lane, state.lastForward );
+    block.lastPosition.set( lane, state.lastPosition );
+    block.mass[ lane ] = state.mass;
+    block.speed[ lane ] = state.speed;
+    block.maxForce[ lane ] = state.maxForce;
+    block.maxSpeed[ lane ] = state.maxSpeed;
+    block.curvature[ lane ] = state.curvature;
+    block.smoothedCurvature[ lane ] = state.smoothedCurvature;
+    block.basisTolerance[ lane ] = state.basisTolerance;
+}
+
+
+
+void
+OpenSteer::BatchIntegrator::integrateScalar( Block& block, size_t lane, float elapsedTime )
+{
+    MotionState state = get( block, lane );
+    applySteeringForce( state, block.force.get( lane ), elapsedTime );
+    set( block, lane, state );
+}
+
+
+
+#ifdef OPENSTEER_VEC3A_SSE
+
+void
+OpenSteer::BatchIntegrator::integrateLanes( Block& block, float elapsedTime )
+{
+    // Same steps as applySteeringForce for all lanes of the block.
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps( 1.0f );
+    __m128 const dt = _mm_set1_ps( elapsedTime );
+
+    Vec3Lanes forward = load( block.forward );
+    Vec3Lanes side = load( block.side );
+    Vec3Lanes up = load( block.up );
+    Vec3Lanes position = load( block.position );
+    __m128 speed = _mm_loadu_ps( block.speed );
+    __m128 const maxSpeed = _mm_loadu_ps( block.maxSpeed );
+
+    // adjustRawSteeringForce
+    Vec3Lanes const force = load( block.force );
+    __m128 const maxAdjustedSpeed = _mm_mul_ps( _mm_set1_ps( 0.2f ), maxSpeed );
+    __m128 const range = _mm_div_ps( speed, maxAdjustedSpeed );
+    __m128 const cosine = _mm_add_ps( one, _mm_mul_ps( _mm_set1_ps( -2.0f ), pow20( range ) ) );
+    __m128 const sine = _mm_sqrt_ps( _mm_sub_ps( one, _mm_mul_ps( cosine, cosine ) ) );
+    Vec3Lanes const adjustedForce = Vec3Lanes::select( _mm_cmpgt_ps( speed, maxAdjustedSpeed ),
+                                                       force,
+                                                       force.limitMaxDeviationAngle( cosine, sine, forward ) );
+
+    Vec3Lanes const clippedForce = adjustedForce.truncateLength( _mm_loadu_ps( block.maxForce ) );
+    Vec3Lanes const newAcceleration = clippedForce / _mm_loadu_ps( block.mass );
+
+    Vec3Lanes smoothedAcceleration = load( block.smoothedAcceleration );
+    if ( elapsedTime > 0 ) {
+        float const smoothRate = clip( clip( 9 * elapsedTime, 0.15f, 0.4f ), 0, 1 );
+        smoothedAcceleration = blend( _mm_set1_ps( smoothRate ), newAcceleration, smoothedAcceleration );
+    }
+
+    Vec3Lanes newVelocity = forward * speed;
+    newVelocity = newVelocity + ( smoothedAcceleration * dt );
+    newVelocity = newVelocity.truncateLength( maxSpeed );
+    speed = newVelocity.length();
+    position = position + ( newVelocity * dt );
+
+    // regenerateLocalSpace, side and up are kept where they are still
+    // perpendicular to the new forward within the basis tolerance
+    __m128 const moving = _mm_cmpgt_ps( speed, zero );
+    Vec3Lanes const newForward = newVelocity / speed;
+    __m128 const tolerance = _mm_loadu_ps( block.basisTolerance );
+    __m128 const toleranceSquared = _mm_mul_ps( tolerance, tolerance );
+    __m128 const sideDrift = newForward.dot( side );
+    __m128 const upDrift = newForward.dot( up );
+    __m128 const keepBasis = _mm_and_ps( _mm_and_ps( _mm_cmpgt_ps( tolerance, zero ),
+                                                     _mm_cmpgt_ps( newForward.dot( forward ), zero ) ),
+                                         _mm_and_ps( _mm_cmple_ps( _mm_mul_ps( sideDrift, sideDrift ), toleranceSquared ),
+                                                     _mm_cmple_ps( _mm_mul_ps( upDrift, upDrift ), toleranceSquared ) ) );
+    __m128 const regenerate = _mm_andnot_ps( keepBasis, moving );
+    Vec3Lanes const newSide = Vec3Lanes::cross( newForward, up ).normalize();
+    Vec3Lanes const newUp = Vec3Lanes::cross( newSide, newForward );
+    forward = Vec3Lanes::select( moving, newForward, forward );
+    side = Vec3Lanes::select( regenerate, newSide, side );
+    up = Vec3Lanes::select( regenerate, newUp, up );
+
+    // measurePathCurvature
+    if ( elapsedTime > 0 ) {
+        Vec3Lanes const dP = load( block.lastPosition ) - position;
+        Vec3Lanes const dF = ( load( block.lastForward ) - forward ) / dP.length();
+        Vec3Lanes const lateral = dF.perpendicularComponent( forward );
+        __m128 const sign = select( _mm_cmplt_ps( lateral.dot( side ), zero ), one, _mm_set1_ps( -1.0f ) );
+        __m128 const curvature = _mm_mul_ps( lateral.length(), sign );
+        __m128 const curvatureRate = _mm_set1_ps( clip( elapsedTime * 4.0f, 0, 1 ) );
+        _mm_storeu_ps( block.curvature, curvature );
+        _mm_storeu_ps( block.smoothedCurvature, blend( curvatureRate, curvature, _mm_loadu_ps( block.smoothedCurvature ) ) );
+        store( forward, block.lastForward );
+        store( position, block.lastPosition );
+    }
+
+    __m128 const positionRate = _mm_set1_ps( clip( elapsedTime * 0.06f, 0, 1 ) );
+    store( blend( positionRate, position, load( block.smoothedPosition ) ), block.smoothedPosition );
+
+    store( forward, block.forward );
+    store( side, block.side );
+    store( up, block.up );
+    store( position, block.position );
+    _mm_storeu_ps( block.speed, speed );
+    store( smoothedAcceleration, block.smoothedAcceleration );
+}
+
+#endif // OPENSTEER_VEC3A_SSE
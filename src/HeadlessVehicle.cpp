@@ -0,0 +1,229 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::blendIntoAccumulator
+#include "OpenSteer/Utilities.h"
+
+// Include OpenSteer::integrateSteeringForce, OpenSteer::measurePathCurvature, OpenSteer::adjustRawSteeringForce
+#include "OpenSteer/BatchIntegrator.h"
+
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
+
+
+std::atomic< int > OpenSteer::HeadlessVehicle::serialNumberCounter( 0 );
+
+
+
+OpenSteer::HeadlessVehicle::HeadlessVehicle()
+{
+    reset();
+
+    serialNumber = serialNumberCounter++;
+    seedRandomGenerator( serialNumber );
+}
+
+
+
+OpenSteer::HeadlessVehicle::~HeadlessVehicle()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::reset()
+{
+    resetLocalSpace();
+    HeadlessVehicleBase::reset();
+
+    setMass( 1.0f );
+    setSpeed( 0.0f );
+    setRadius( 0.5f );
+    setMaxForce( 0.1f );
+    setMaxSpeed( 1.0f );
+    setBasisTolerance( 0.0f );
+
+    resetSmoothedPosition();
+    resetSmoothedCurvature();
+    resetSmoothedAcceleration();
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::HeadlessVehicle::predictFuturePosition( float const predictionTime ) const
+{
+    return position() + ( velocity() * predictionTime );
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::applySteeringForce( Vec3 const& force, float elapsedTime )
+{
+    OPENSTEER_PROFILE_ZONE( "HeadlessVehicle::applySteeringForce" );
+
+    // The steps are shared with BatchIntegrator, only adjustRawSteeringForce
+    // and regenerateLocalSpace are our own.
+    MotionState state = motionState();
+    Vec3 const newVelocity = OpenSteer::integrateSteeringForce( state, adjustRawSteeringForce( force, elapsedTime ), elapsedTime );
+    setMotionState( state );
+
+    regenerateLocalSpace( newVelocity, elapsedTime );
+
+    state.side = side();
+    state.up = up();
+    state.forward = forward();
+    OpenSteer::measurePathCurvature( state, elapsedTime );
+    setMotionState( state );
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::applyBrakingForce( float rate, float elapsedTime )
+{
+    float const rawBraking = speed() * rate;
+    float const clipBraking = ( rawBraking < maxForce() ) ? rawBraking : maxForce();
+    setSpeed( speed() - ( clipBraking * elapsedTime ) );
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::HeadlessVehicle::adjustRawSteeringForce( Vec3 const& force, float /* elapsedTime */ )
+{
+    return OpenSteer::adjustRawSteeringForce( force, forward(), speed(), maxSpeed() );
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::regenerateLocalSpace( Vec3 const& newVelocity, float /* elapsedTime */ )
+{
+    if ( speed() > 0 ) {
+        Vec3 const newForward = newVelocity / speed();
+        if ( basisTolerance_ > 0 ) {
+            lazyRegenerateOrthonormalBasisUF( newForward, basisTolerance_ );
+        } else {
+            regenerateOrthonormalBasisUF( newForward );
+        }
+    }
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::regenerateLocalSpaceForBanking( Vec3 const& newVelocity, float elapsedTime )
+{
+    // Roll towards the center of the path curvature, righting itself
+    // towards global up.
+    Vec3 const globalUp( 0, 0.2f, 0 );
+    Vec3 const accelUp = smoothedAcceleration_ * 0.05f;
+    Vec3 const bankUp = accelUp + globalUp;
+
+    float const smoothRate = elapsedTime * 3;
+    Vec3 tempUp = up();
+    blendIntoAccumulator( smoothRate, bankUp, tempUp );
+    setUp( tempUp.normalize() );
+
+    if ( speed() > 0 ) {
+        regenerateOrthonormalBasisUF( newVelocity / speed() );
+    }
+}
+
+
+
+float
+OpenSteer::HeadlessVehicle::resetSmoothedCurvature( float value )
+{
+    lastForward_ = Vec3::zero;
+    lastPosition_ = Vec3::zero;
+    return smoothedCurvature_ = curvature_ = value;
+}
+
+
+
+OpenSteer::MotionState
+OpenSteer::HeadlessVehicle::motionState() const
+{
+    MotionState state;
+    state.side = side();
+    state.up = up();
+    state.forward = forward();
+    state.position = position();
+    state.mass = mass_;
+    state.speed = speed();
+    state.maxForce = maxForce_;
+    state.maxSpeed = maxSpeed_;
+    state.smoothedAcceleration = smoothedAcceleration_;
+    state.smoothedPosition = smoothedPosition_;
+    state.curvature = curvature_;
+    state.smoothedCurvature = smoothedCurvature_;
+    state.lastForward = lastForward_;
+    state.lastPosition = lastPosition_;
+    state.basisTolerance = basisTolerance_;
+    return state;
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::setMotionState( MotionState const& state )
+{
+    setSide( state.side );
+    setUp( state.up );
+    setForward( state.forward );
+    setPosition( state.position );
+    mass_ = state.mass;
+    setSpeed( state.speed );
+    maxForce_ = state.maxForce;
+    maxSpeed_ = state.maxSpeed;
+    smoothedAcceleration_ = state.smoothedAcceleration;
+    smoothedPosition_ = state.smoothedPosition;
+    curvature_ = state.curvature;
+    smoothedCurvature_ = state.smoothedCurvature;
+    lastForward_ = state.lastForward;
+    lastPosition_ = state.lastPosition;
+    basisTolerance_ = state.basisTolerance;
+}
+
+
+
+void
+OpenSteer::HeadlessVehicle::randomizeHeadingOnXZPlane()
+{
+    setUp( Vec3::up );
+    setForward( randomGenerator().unitVectorOnXZPlane() );
+    setSide( localRotateForwardToSide( forward() ) );
+}
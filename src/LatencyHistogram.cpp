@@ -0,0 +1,245 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/LatencyHistogram.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::ceil
+#include <cmath>
+
+
+
+OpenSteer::LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+
+
+
+void
+OpenSteer::LatencyHistogram::record( double seconds )
+{
+    ++counts_[ bucketIndex( seconds ) ];
+    ++count_;
+    if ( seconds > 0.0 ) {
+        totalSeconds_ += seconds;
+        if ( seconds > maxSeconds_ ) {
+            maxSeconds_ = seconds;
+        }
+    }
+}
+
+
+
+void
+OpenSteer::LatencyHistogram::add( LatencyHistogram const& other )
+{
+    for ( size_t i = 0; i < bucketCount; ++i ) {
+        counts_[ i ] += other.counts_[ i ];
+    }
+    count_ += other.count_;
+    totalSeconds_ += other.totalSeconds_;
+    if ( other.maxSeconds_ > maxSeconds_ ) {
+        maxSeconds_ = other.maxSeconds_;
+    }
+}
+
+
+
+void
+OpenSteer::LatencyHistogram::clear()
+{
+    for ( size_t i = 0; i < bucketCount; ++i ) {
+        counts_[ i ] = 0;
+    }
+    count_ = 0;
+    totalSeconds_ = 0.0;
+    maxSeconds_ = 0.0;
+}
+
+
+
+double
+OpenSteer::LatencyHistogram::mean() const
+{
+    return ( 0 == count_ ) ? 0.0 : totalSeconds_ / count_;
+}
+
+
+
+double
+OpenSteer::LatencyHistogram::percentile( double fraction ) const
+{
+    if ( 0 == count_ ) {
+        return 0.0;
+    }
+
+    double const exactRank = std::ceil( fraction * count_ );
+    size_t const rank = ( exactRank < 1.0 ) ? 1 : ( ( exactRank > count_ ) ? count_ : static_cast< size_t >( exactRank ) );
+
+    size_t cumulativeCount = 0;
+    for ( size_t i = 0; i < bucketCount; ++i ) {
+        cumulativeCount += counts_[ i ];
+        if ( cumulativeCount >= rank ) {
+            double const upperBound = bucketUpperBound( i );
+            return ( upperBound < maxSeconds_ ) ? upperBound : maxSeconds_;
+        }
+    }
+
+    assert( false && "Bucket counts don't add up to count_." );
+    return maxSeconds_;
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::LatencyHistogram::countAbove( double seconds ) const
+{
+    size_t result = 0;
+    for ( size_t i = bucketCount; ( i > 0 ) && ( bucketLowerBound( i - 1 ) > seconds ); --i ) {
+        result += counts_[ i - 1 ];
+    }
+    return result;
+}
+
+
+
+double
+OpenSteer::LatencyHistogram::bucketLowerBound( size_t index )
+{
+    return bucketLowerNanoseconds( index ) * 1.0e-9;
+}
+
+
+
+double
+OpenSteer::LatencyHistogram::bucketUpperBound( size_t index )
+{
+    return bucketLowerNanoseconds( index + 1 ) * 1.0e-9;
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::LatencyHistogram::bucketIndex( double seconds )
+{
+    if ( ! ( seconds > 0.0 ) ) {
+        return 0;
+    }
+    if ( seconds * 1.0e9 >= static_cast< double >( 1ULL << maxTrackedBits ) ) {
+        return bucketCount - 1;
+    }
+
+    // index = subBucketCount * shift + ( nanoseconds >> shift ) with the
+    // shift that leaves subBucketBits + 1 significant bits.
+    Nanoseconds const nanoseconds = static_cast< Nanoseconds >( seconds * 1.0e9 );
+    size_t shift = 0;
+    while ( ( nanoseconds >> shift ) >= 2 * subBucketCount ) {
+        ++shift;
+    }
+    return subBucketCount * shift + static_cast< size_t >( nanoseconds >> shift );
+}
+
+
+
+OpenSteer::LatencyHistogram::Nanoseconds
+OpenSteer::LatencyHistogram::bucketLowerNanoseconds( size_t index )
+{
+    if ( index < 2 * subBucketCount ) {
+        return index;
+    }
+    size_t const shift = index / subBucketCount - 1;
+    return static_cast< Nanoseconds >( index - subBucketCount * shift ) << shift;
+}
+
+
+
+OpenSteer::LatencyWindow::LatencyWindow( size_t segmentCount, size_t samplesPerSegment, double stallThreshold )
+    : segments_( segmentCount ),
+      stalls_( segmentCount, 0 ),
+      current_( 0 ),
+      samplesPerSegment_( samplesPerSegment ),
+      stallThreshold_( stallThreshold )
+{
+    assert( ( 0 < segmentCount ) && "A window needs at least one segment." );
+    assert( ( 0 < samplesPerSegment ) && "Segments must hold samples." );
+}
+
+
+
+void
+OpenSteer::LatencyWindow::record( double seconds )
+{
+    if ( segments_[ current_ ].count() >= samplesPerSegment_ ) {
+        current_ = ( current_ + 1 ) % segments_.size();
+        segments_[ current_ ].clear();
+        stalls_[ current_ ] = 0;
+    }
+
+    segments_[ current_ ].record( seconds );
+    if ( seconds > stallThreshold_ ) {
+        ++stalls_[ current_ ];
+    }
+}
+
+
+
+void
+OpenSteer::LatencyWindow::clear()
+{
+    for ( size_t i = 0; i < segments_.size(); ++i ) {
+        segments_[ i ].clear();
+        stalls_[ i ] = 0;
+    }
+    current_ = 0;
+}
+
+
+
+OpenSteer::LatencyHistogram
+OpenSteer::LatencyWindow::histogram() const
+{
+    LatencyHistogram result;
+    for ( size_t i = 0; i < segments_.size(); ++i ) {
+        result.add( segments_[ i ] );
+    }
+    return result;
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::LatencyWindow::stallCount() const
+{
+    size_t result = 0;
+    for ( size_t i = 0; i < stalls_.size(); ++i ) {
+        result += stalls_[ i ];
+    }
+    return result;
+}
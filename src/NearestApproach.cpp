@@ -0,0 +1,181 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/NearestApproach.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::numeric_limits< float >::max
+#include <limits>
+
+#ifdef _MSC_VER
+#undef min
+#undef max
+#endif
+
+
+
+OpenSteer::NearestApproachBatch::NearestApproachBatch()
+    : size_( 0 ),
+      positionsX_( width, 0.0f ),
+      positionsY_( width, 0.0f ),
+      positionsZ_( width, 0.0f ),
+      velocitiesX_( width, 0.0f ),
+      velocitiesY_( width, 0.0f ),
+      velocitiesZ_( width, 0.0f )
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::NearestApproachBatch::reserve( size_t count )
+{
+    size_t const capacity = ( ( count + width - 1 ) / width ) * width;
+    if ( capacity > positionsX_.size() ) {
+        positionsX_.resize( capacity, 0.0f );
+        positionsY_.resize( capacity, 0.0f );
+        positionsZ_.resize( capacity, 0.0f );
+        velocitiesX_.resize( capacity, 0.0f );
+        velocitiesY_.resize( capacity, 0.0f );
+        velocitiesZ_.resize( capacity, 0.0f );
+    }
+}
+
+
+
+void
+OpenSteer::NearestApproachBatch::grow()
+{
+    reserve( positionsX_.size() + width );
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::NearestApproachBatch::position( size_t index ) const
+{
+    assert( index < size_ && "index out of range." );
+    return Vec3( positionsX_[ index ], positionsY_[ index ], positionsZ_[ index ] );
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::NearestApproachBatch::velocity( size_t index ) const
+{
+    assert( index < size_ && "index out of range." );
+    return Vec3( velocitiesX_[ index ], velocitiesY_[ index ], velocitiesZ_[ index ] );
+}
+
+
+
+bool
+OpenSteer::findMostImminentApproach( Vec3 const& position,
+                                     Vec3 const& velocity,
+                                     NearestApproachBatch const& neighbors,
+                                     float collisionDistance,
+                                     float maxTime,
+                                     NearestApproach& approach )
+{
+    size_t const width = NearestApproachBatch::width;
+    size_t const count = neighbors.size();
+    float const collisionDistanceSquared = collisionDistance * collisionDistance;
+    float const never = std::numeric_limits< float >::max();
+
+    float bestTime = maxTime;
+    size_t bestIndex = count;
+
+    for ( size_t base = 0; base < count; base += width ) {
+        float const* const px = neighbors.positionsX() + base;
+        float const* const py = neighbors.positionsY() + base;
+        float const* const pz = neighbors.positionsZ() + base;
+        float const* const vx = neighbors.velocitiesX() + base;
+        float const* const vy = neighbors.velocitiesY() + base;
+        float const* const vz = neighbors.velocitiesZ() + base;
+
+        // Time of the nearest approach of each neighbor or "never" if it
+        // isn't a threat. Same math as predictNearestApproachTime: imagine
+        // we are at the origin with no velocity and project the offset to us
+        // onto the neighbor's relative path. Dividing the projection by the
+        // squared relative speed spares the square root, the loop has no
+        // branches or calls to be vectorized.
+        float threatTime[ width ];
+        for ( size_t lane = 0; lane < width; ++lane ) {
+            float const relVelocityX = vx[ lane ] - velocity.x;
+            float const relVelocityY = vy[ lane ] - velocity.y;
+            float const relVelocityZ = vz[ lane ] - velocity.z;
+            float const relSpeedSquared = relVelocityX * relVelocityX +
+                                          relVelocityY * relVelocityY +
+                                          relVelocityZ * relVelocityZ;
+
+            float const relPositionX = position.x - px[ lane ];
+            float const relPositionY = position.y - py[ lane ];
+            float const relPositionZ = position.z - pz[ lane ];
+
+            // Parallel paths keep their distance, their nearest approach is
+            // now. Then the relative velocity and with it the projection are
+            // zero, dividing by one instead of zero yields a time of zero.
+            float const divisor = ( relSpeedSquared > 0.0f ) ? relSpeedSquared : 1.0f;
+            float const projection = relVelocityX * relPositionX +
+                                     relVelocityY * relPositionY +
+                                     relVelocityZ * relPositionZ;
+            float const time = projection / divisor;
+
+            // Offset from us to the neighbor at that time.
+            float const missX = relVelocityX * time - relPositionX;
+            float const missY = relVelocityY * time - relPositionY;
+            float const missZ = relVelocityZ * time - relPositionZ;
+            float const missSquared = missX * missX + missY * missY + missZ * missZ;
+
+            bool const threat = ( time >= 0.0f ) & ( missSquared < collisionDistanceSquared );
+            threatTime[ lane ] = threat ? time : never;
+        }
+
+        // Lanes past the last neighbor hold stale or padding values.
+        size_t const lanes = ( count - base < width ) ? ( count - base ) : width;
+        for ( size_t lane = 0; lane < lanes; ++lane ) {
+            if ( threatTime[ lane ] < bestTime ) {
+                bestTime = threatTime[ lane ];
+                bestIndex = base + lane;
+            }
+        }
+    }
+
+    if ( bestIndex == count ) {
+        return false;
+    }
+
+    approach.index = bestIndex;
+    approach.time = bestTime;
+    approach.ourPosition = position + ( velocity * bestTime );
+    approach.neighborPosition = neighbors.position( bestIndex ) + ( neighbors.velocity( bestIndex ) * bestTime );
+    approach.distance = Vec3::distance( approach.ourPosition, approach.neighborPosition );
+    return true;
+}
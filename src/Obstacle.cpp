@@ -37,6 +37,7 @@
 
 
 #include "OpenSteer/Obstacle.h"
+#include "OpenSteer/Profiler.h"
 
 
 // ----------------------------------------------------------------------------
@@ -48,6 +49,8 @@ OpenSteer::Vec3
 OpenSteer::Obstacle::steerToAvoid (const AbstractVehicle& vehicle,
                                    const float minTimeToCollision) const
 {
+    OPENSTEER_PROFILE_ZONE ("Obstacle::steerToAvoid");
+
     // find nearest intersection with this obstacle along vehicle's path
     PathIntersection pi;
     findIntersectionWithVehiclePath (vehicle, pi);
@@ -94,6 +97,8 @@ firstPathIntersectionWithObstacleGroup (const AbstractVehicle& vehicle,
                                         PathIntersection& nearest,
                                         PathIntersection& next)
 {
+    OPENSTEER_PROFILE_ZONE ("Obstacle::firstPathIntersectionWithObstacleGroup");
+
     // test all obstacles in group for an intersection with the vehicle's
     // future path, select the one whose point of intersection is nearest
     next.intersect = false;
@@ -0,0 +1,317 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/PathCursor.h"
+
+// Include std::numeric_limits< float >::max
+#include <limits>
+
+// Include OpenSteer::distance
+#include "OpenSteer/Vec3Utilities.h"
+
+// Include OpenSteer::clamp, OpenSteer::modulo
+#include "OpenSteer/Utilities.h"
+
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
+#ifdef _MSC_VER
+#undef min
+#undef max
+#endif
+
+
+
+OpenSteer::PathCursor::PathCursor()
+    : valid_( false ),
+      jumpDistance_( std::numeric_limits< float >::max() ),
+      segmentIndex_( 0 ),
+      segmentStartDistance_( 0.0f ),
+      segmentDistance_( 0.0f ),
+      trackedPoint_( 0.0f, 0.0f, 0.0f ),
+      localSearchCount_( 0 ),
+      globalSearchCount_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathCursor::PathCursor( float jumpDistance )
+    : valid_( false ),
+      jumpDistance_( jumpDistance ),
+      segmentIndex_( 0 ),
+      segmentStartDistance_( 0.0f ),
+      segmentDistance_( 0.0f ),
+      trackedPoint_( 0.0f, 0.0f, 0.0f ),
+      localSearchCount_( 0 ),
+      globalSearchCount_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::PathCursor::reset()
+{
+    valid_ = false;
+    segmentIndex_ = 0;
+    segmentStartDistance_ = 0.0f;
+    segmentDistance_ = 0.0f;
+}
+
+
+
+float
+OpenSteer::PathCursor::track( SegmentedPathway const& pathway, Vec3 const& point )
+{
+    OPENSTEER_PROFILE_ZONE( "PathCursor::track" );
+
+    bool const jumped = valid_ && ( distance( point, trackedPoint_ ) > jumpDistance_ );
+
+    SegmentMapping mapping;
+    mapPoint( pathway, point, jumped, mapping );
+
+    valid_ = true;
+    segmentIndex_ = mapping.segmentIndex;
+    segmentStartDistance_ = mapping.segmentStartDistance;
+    segmentDistance_ = mapping.segmentDistance;
+    trackedPoint_ = point;
+
+    return pathDistance();
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::PathCursor::mapPointToPath( SegmentedPathway const& pathway,
+                                       Vec3 const& point,
+                                       Vec3& tangent,
+                                       float& outside,
+                                       float& pathDistance ) const
+{
+    OPENSTEER_PROFILE_ZONE( "PathCursor::mapPointToPath" );
+
+    SegmentMapping mapping;
+    mapPoint( pathway, point, false, mapping );
+
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    pathDistance = mapping.segmentStartDistance + mapping.segmentDistance;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+OpenSteer::Vec3
+OpenSteer::PathCursor::mapPathDistanceToPoint( SegmentedPathway const& pathway,
+                                               float pathDistance ) const
+{
+    OPENSTEER_PROFILE_ZONE( "PathCursor::mapPathDistanceToPoint" );
+
+    // Same treatment of distances beyond the path ends as
+    // @c DistanceToPathAlikeMapping::map.
+    float const pathLength = pathway.length();
+    if ( pathway.isCyclic() ) {
+        pathDistance = modulo( pathDistance, pathLength );
+    }
+    pathDistance = clamp( pathDistance, 0.0f, pathLength );
+
+    size_type const maxSegmentIndex = pathway.segmentCount() - 1;
+    bool const startAtCursor = valid_ && ( segmentIndex_ <= maxSegmentIndex );
+    size_type segmentIndex = startAtCursor ? segmentIndex_ : 0;
+    float segmentStartDistance = startAtCursor ? segmentStartDistance_ : 0.0f;
+
+    while ( ( segmentIndex > 0 ) && ( pathDistance < segmentStartDistance ) ) {
+        --segmentIndex;
+        segmentStartDistance -= pathway.segmentLength( segmentIndex );
+    }
+    if ( 0 == segmentIndex ) {
+        segmentStartDistance = 0.0f;
+    }
+
+    while ( ( segmentIndex < maxSegmentIndex ) &&
+            ( ( pathDistance - segmentStartDistance ) > pathway.segmentLength( segmentIndex ) ) ) {
+        segmentStartDistance += pathway.segmentLength( segmentIndex );
+        ++segmentIndex;
+    }
+
+    return pathway.mapSegmentDistanceToPoint( segmentIndex, pathDistance - segmentStartDistance );
+}
+
+
+
+void
+OpenSteer::PathCursor::resetSearchCounts()
+{
+    localSearchCount_ = 0;
+    globalSearchCount_ = 0;
+}
+
+
+
+void
+OpenSteer::PathCursor::mapPointToSegment( SegmentedPathway const& pathway,
+                                          size_type segmentIndex,
+                                          float segmentStartDistance,
+                                          Vec3 const& point,
+                                          SegmentMapping& mapping )
+{
+    mapping.segmentIndex = segmentIndex;
+    mapping.segmentStartDistance = segmentStartDistance;
+    pathway.mapPointToSegmentDistanceAndPointAndTangentAndRadius( segmentIndex,
+                                                                  point,
+                                                                  mapping.segmentDistance,
+                                                                  mapping.pointOnPathCenterLine,
+                                                                  mapping.tangent,
+                                                                  mapping.radius );
+    mapping.distancePointToPath = distance( point, mapping.pointOnPathCenterLine ) - mapping.radius;
+}
+
+
+
+void
+OpenSteer::PathCursor::mapPointGlobally( SegmentedPathway const& pathway,
+                                         Vec3 const& point,
+                                         SegmentMapping& mapping )
+{
+    // Same search as @c PointToPathAlikeMapping::map.
+    mapping.distancePointToPath = std::numeric_limits< float >::max();
+
+    float segmentStartDistance = 0.0f;
+    size_type const segmentCount = pathway.segmentCount();
+    for ( size_type segmentIndex = 0; segmentIndex < segmentCount; ++segmentIndex ) {
+
+        SegmentMapping candidate;
+        mapPointToSegment( pathway, segmentIndex, segmentStartDistance, point, candidate );
+
+        if ( candidate.distancePointToPath < mapping.distancePointToPath ) {
+            mapping = candidate;
+        }
+
+        segmentStartDistance += pathway.segmentLength( segmentIndex );
+    }
+}
+
+
+
+void
+OpenSteer::PathCursor::mapPointLocally( SegmentedPathway const& pathway,
+                                        Vec3 const& point,
+                                        SegmentMapping& mapping )
+{
+    // @a mapping contains the mapping to the start segment. Walk forward and
+    // then backward as long as the segments don't get farther away. Equally
+    // distant segments are passed to cross plateaus (e.g. around a vertex)
+    // but of equally near segments the one with the lowest index is kept to
+    // return the same results as a global search.
+    size_type const segmentCount = pathway.segmentCount();
+    size_type const maxSegmentIndex = segmentCount - 1;
+    bool const cyclic = pathway.isCyclic();
+    size_type const startSegmentIndex = mapping.segmentIndex;
+
+    SegmentMapping current = mapping;
+    size_type steps = 0;
+    while ( ++steps < segmentCount ) {
+        size_type nextIndex = current.segmentIndex + 1;
+        float nextStartDistance = current.segmentStartDistance + pathway.segmentLength( current.segmentIndex );
+        if ( current.segmentIndex == maxSegmentIndex ) {
+            if ( ! cyclic ) {
+                break;
+            }
+            nextIndex = 0;
+            nextStartDistance = 0.0f;
+        }
+
+        SegmentMapping next;
+        mapPointToSegment( pathway, nextIndex, nextStartDistance, point, next );
+        if ( next.distancePointToPath > current.distancePointToPath ) {
+            break;
+        }
+
+        if ( next.distancePointToPath < mapping.distancePointToPath ) {
+            mapping = next;
+        }
+        current = next;
+    }
+
+    if ( mapping.segmentIndex != startSegmentIndex ) {
+        return;
+    }
+
+    current = mapping;
+    while ( ++steps < segmentCount ) {
+        size_type previousIndex = 0;
+        float previousStartDistance = 0.0f;
+        if ( 0 == current.segmentIndex ) {
+            if ( ! cyclic ) {
+                break;
+            }
+            previousIndex = maxSegmentIndex;
+            previousStartDistance = pathway.length() - pathway.segmentLength( maxSegmentIndex );
+        } else {
+            previousIndex = current.segmentIndex - 1;
+            previousStartDistance = current.segmentStartDistance - pathway.segmentLength( previousIndex );
+        }
+
+        SegmentMapping previous;
+        mapPointToSegment( pathway, previousIndex, previousStartDistance, point, previous );
+        if ( previous.distancePointToPath > current.distancePointToPath ) {
+            break;
+        }
+
+        if ( previous.distancePointToPath <= mapping.distancePointToPath ) {
+            mapping = previous;
+        }
+        current = previous;
+    }
+}
+
+
+
+void
+OpenSteer::PathCursor::mapPoint( SegmentedPathway const& pathway,
+                                 Vec3 const& point,
+                                 bool jumped,
+                                 SegmentMapping& mapping ) const
+{
+    if ( valid_ && ! jumped && ( segmentIndex_ < pathway.segmentCount() ) ) {
+        mapPointToSegment( pathway, segmentIndex_, segmentStartDistance_, point, mapping );
+        mapPointLocally( pathway, point, mapping );
+
+        // Farther than a radius outside the pathway: the local minimum found
+        // might not be the global one.
+        if ( mapping.distancePointToPath <= mapping.radius ) {
+            ++localSearchCount_;
+            return;
+        }
+    }
+
+    mapPointGlobally( pathway, point, mapping );
+    ++globalSearchCount_;
+}
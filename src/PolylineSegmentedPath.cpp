@@ -53,6 +53,9 @@
 // Include OpenSteer::clamp, OpenSteer::shrinkToFit
 #include "OpenSteer/Utilities.h"
 
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
 
 
 namespace {
@@ -334,6 +337,8 @@ OpenSteer::PolylineSegmentedPath::mapPointToPath (const Vec3& point,
                                                   Vec3& tangent,
                                                   float& outside) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPath::mapPointToPath");
+
     PointToPathMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     tangent = mapping.tangent;
@@ -345,6 +350,8 @@ OpenSteer::PolylineSegmentedPath::mapPointToPath (const Vec3& point,
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPath::mapPathDistanceToPoint (float pathDistance) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPath::mapPathDistanceToPoint");
+
     PathDistanceToPointMapping mapping;
     mapDistanceToPathAlike( *this, pathDistance, mapping );
     return mapping.pointOnPathCenterLine;
@@ -354,6 +361,8 @@ OpenSteer::PolylineSegmentedPath::mapPathDistanceToPoint (float pathDistance) co
 float 
 OpenSteer::PolylineSegmentedPath::mapPointToPathDistance (const Vec3& point) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPath::mapPointToPathDistance");
+
     PointToPathDistanceMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     return mapping.distanceOnPath;
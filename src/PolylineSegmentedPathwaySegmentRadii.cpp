@@ -53,6 +53,9 @@
 // Include OPENSTEER_UNUSED_PARAMETER
 #include "OpenSteer/UnusedParameter.h"
 
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
 
 namespace {
     
@@ -229,6 +232,8 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPath (const Vec3& poi
                                                                  Vec3& tangent,
                                                                  float& outside) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySegmentRadii::mapPointToPath");
+
     PointToPathMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     tangent = mapping.tangent;
@@ -241,6 +246,8 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPath (const Vec3& poi
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPathDistanceToPoint (float pathDistance) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySegmentRadii::mapPathDistanceToPoint");
+
     PathDistanceToPointMapping mapping;
     mapDistanceToPathAlike( *this, pathDistance, mapping );
     return mapping.pointOnPathCenterLine;    
@@ -251,6 +258,8 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPathDistanceToPoint (float p
 float 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPathDistance (const Vec3& point) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySegmentRadii::mapPointToPathDistance");
+
     PointToPathDistanceMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     return mapping.distanceOnPath;    
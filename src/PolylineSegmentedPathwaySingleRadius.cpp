@@ -44,6 +44,9 @@
 // Include OPENSTEER_UNUSED_PARAMETER
 #include "OpenSteer/UnusedParameter.h"
 
+// Include OPENSTEER_PROFILE_ZONE
+#include "OpenSteer/Profiler.h"
+
 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleRadius()
     : path_(), radius_ ( 0.0f )
@@ -160,6 +163,8 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPath (const Vec3& poi
                                                                  Vec3& tangent,
                                                                  float& outside) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySingleRadius::mapPointToPath");
+
     PointToPathMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     tangent = mapping.tangent;
@@ -172,6 +177,8 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPath (const Vec3& poi
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPathDistanceToPoint (float pathDistance) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySingleRadius::mapPathDistanceToPoint");
+
     PathDistanceToPointMapping mapping;
     mapDistanceToPathAlike( *this, pathDistance, mapping );
     return mapping.pointOnPathCenterLine;
@@ -182,6 +189,8 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPathDistanceToPoint (float p
 float 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPathDistance (const Vec3& point) const
 {
+    OPENSTEER_PROFILE_ZONE ("PolylineSegmentedPathwaySingleRadius::mapPointToPathDistance");
+
     PointToPathDistanceMapping mapping;
     mapPointToPathAlike( *this, point, mapping );
     return mapping.distanceOnPath;
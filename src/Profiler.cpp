@@ -0,0 +1,472 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/Profiler.h"
+
+// Include std::ostream
+#include <ostream>
+
+// Include std::mutex
+#include <mutex>
+
+// Include std::unique_ptr
+#include <memory>
+
+// Include std::unordered_map
+#include <unordered_map>
+
+// Include std::chrono::steady_clock
+#include <chrono>
+
+// Include std::strcmp
+#include <cstring>
+
+// Include assert
+#include <cassert>
+
+
+
+namespace {
+
+    using OpenSteer::size_t;
+    typedef OpenSteer::Profiler::Zone Zone;
+    typedef long long Nanoseconds;
+
+    /**
+     * One call of a zone on one thread.
+     */
+    struct Event {
+        Zone zone;
+
+        /**
+         * Zone that was current before, restored on leaving.
+         */
+        Zone parent;
+
+        Nanoseconds begin;
+        Nanoseconds end;
+
+        /**
+         * Time of the zones called from this one on the same thread.
+         */
+        Nanoseconds nestedNanoseconds;
+    };
+
+    /**
+     * Zone call kept for the trace.
+     */
+    struct TraceEvent {
+        Zone zone;
+        size_t thread;
+        Nanoseconds begin;
+        Nanoseconds duration;
+    };
+
+    struct ZoneInfo {
+        char const* name;
+        Zone parent;
+        size_t depth;
+
+        size_t calls;
+        Nanoseconds nanoseconds;
+        Nanoseconds selfNanoseconds;
+    };
+
+    struct ChildKey {
+        Zone parent;
+        char const* name;
+
+        bool operator==( ChildKey const& other ) const {
+            return ( parent == other.parent ) && ( name == other.name );
+        }
+    };
+
+    struct ChildKeyHash {
+        size_t operator()( ChildKey const& key ) const {
+            return key.parent * 31 + std::hash< char const* >()( key.name );
+        }
+    };
+
+    /**
+     * Zones recorded by one thread. Only the owning thread writes, the
+     * buffer is read and cleared by @c Profiler::endFrame.
+     */
+    struct ThreadBuffer {
+        explicit ThreadBuffer( size_t threadIndex ) : index( threadIndex ), current( 0 ) {}
+
+        size_t index;
+        Zone current;
+        std::vector< Event > events;
+
+        /**
+         * Indices of the open events, innermost last.
+         */
+        std::vector< size_t > open;
+
+        /**
+         * Zones looked up by this thread, by parent and name address.
+         */
+        std::unordered_map< ChildKey, Zone, ChildKeyHash > children;
+    };
+
+    /**
+     * State shared by all threads, guarded by @c mutex.
+     */
+    struct Registry {
+        Registry()
+            : frames( 0 ),
+              recording( false ),
+              maxTraceEvents( 0 ),
+              epoch( std::chrono::steady_clock::now() ) {
+            ZoneInfo const root = { "", 0, 0, 0, 0, 0 };
+            zones.push_back( root );
+        }
+
+        std::mutex mutex;
+        std::vector< std::unique_ptr< ThreadBuffer > > buffers;
+
+        /**
+         * Index @c 0 is the root, the parent of the outermost zones.
+         */
+        std::vector< ZoneInfo > zones;
+        size_t frames;
+
+        bool recording;
+        size_t maxTraceEvents;
+        std::vector< TraceEvent > trace;
+
+        std::chrono::steady_clock::time_point const epoch;
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local ThreadBuffer* currentBuffer = 0;
+
+    /**
+     * Buffer of the calling thread, created on first use.
+     */
+    ThreadBuffer& threadBuffer()
+    {
+        if ( 0 == currentBuffer ) {
+            Registry& r = registry();
+            std::lock_guard< std::mutex > lock( r.mutex );
+            r.buffers.push_back( std::unique_ptr< ThreadBuffer >( new ThreadBuffer( r.buffers.size() ) ) );
+            currentBuffer = r.buffers.back().get();
+        }
+        return *currentBuffer;
+    }
+
+    Nanoseconds now()
+    {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - registry().epoch ).count();
+    }
+
+    /**
+     * Zone @a name nested in @a parent, created if new. Names are compared
+     * by content, the same text at different addresses is one zone.
+     */
+    Zone childZone( ThreadBuffer& buffer, Zone parent, char const* name )
+    {
+        ChildKey const key = { parent, name };
+        std::unordered_map< ChildKey, Zone, ChildKeyHash >::const_iterator const cached = buffer.children.find( key );
+        if ( cached != buffer.children.end() ) {
+            return cached->second;
+        }
+
+        Registry& r = registry();
+        std::lock_guard< std::mutex > lock( r.mutex );
+        Zone zone = 0;
+        for ( size_t i = 1; ( i < r.zones.size() ) && ( 0 == zone ); ++i ) {
+            if ( ( r.zones[ i ].parent == parent ) && ( 0 == std::strcmp( r.zones[ i ].name, name ) ) ) {
+                zone = i;
+            }
+        }
+        if ( 0 == zone ) {
+            ZoneInfo const info = { name, parent, ( 0 == parent ) ? 0 : r.zones[ parent ].depth + 1, 0, 0, 0 };
+            zone = r.zones.size();
+            r.zones.push_back( info );
+        }
+        buffer.children[ key ] = zone;
+        return zone;
+    }
+
+    /**
+     * Appends the zones nested in @a parent that were called, depth first.
+     */
+    void appendStatistics( Registry const& r,
+                           Zone parent,
+                           std::vector< OpenSteer::ProfileZoneStatistics >& result )
+    {
+        for ( size_t i = parent + 1; i < r.zones.size(); ++i ) {
+            ZoneInfo const& info = r.zones[ i ];
+            if ( info.parent != parent ) {
+                continue;
+            }
+            if ( 0 < info.calls ) {
+                OpenSteer::ProfileZoneStatistics const statistics = { info.name,
+                                                                       info.depth,
+                                                                       info.calls,
+                                                                       info.nanoseconds * 1.0e-9,
+                                                                       info.selfNanoseconds * 1.0e-9 };
+                result.push_back( statistics );
+            }
+            appendStatistics( r, i, result );
+        }
+    }
+
+    void writeJsonString( std::ostream& stream, char const* text )
+    {
+        stream << '"';
+        for ( ; '\0' != *text; ++text ) {
+            if ( ( '"' == *text ) || ( '\\' == *text ) ) {
+                stream << '\\';
+            }
+            stream << *text;
+        }
+        stream << '"';
+    }
+
+} // anonymous namespace
+
+
+
+std::atomic< bool > OpenSteer::Profiler::enabled_( false );
+
+
+
+void
+OpenSteer::Profiler::setEnabled( bool enabled )
+{
+    enabled_.store( enabled, std::memory_order_relaxed );
+}
+
+
+
+void
+OpenSteer::Profiler::beginZone( char const* name )
+{
+    ThreadBuffer& buffer = threadBuffer();
+    Event const event = { childZone( buffer, buffer.current, name ), buffer.current, 0, 0, 0 };
+    buffer.open.push_back( buffer.events.size() );
+    buffer.events.push_back( event );
+    buffer.current = event.zone;
+
+    // Last, so the bookkeeping above isn't timed.
+    buffer.events.back().begin = now();
+}
+
+
+
+void
+OpenSteer::Profiler::endZone()
+{
+    Nanoseconds const end = now();
+
+    ThreadBuffer& buffer = threadBuffer();
+    assert( ! buffer.open.empty() && "endZone without beginZone." );
+    Event& event = buffer.events[ buffer.open.back() ];
+    buffer.open.pop_back();
+    event.end = end;
+    buffer.current = event.parent;
+
+    if ( ! buffer.open.empty() ) {
+        buffer.events[ buffer.open.back() ].nestedNanoseconds += end - event.begin;
+    }
+}
+
+
+
+OpenSteer::Profiler::Zone
+OpenSteer::Profiler::currentZone()
+{
+    return ( 0 == currentBuffer ) ? 0 : currentBuffer->current;
+}
+
+
+
+void
+OpenSteer::Profiler::endFrame()
+{
+    assert( ( ( 0 == currentBuffer ) || currentBuffer->open.empty() ) && "endFrame inside a zone." );
+
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    for ( size_t b = 0; b < r.buffers.size(); ++b ) {
+        ThreadBuffer& buffer = *r.buffers[ b ];
+        if ( ! buffer.open.empty() ) {
+            // Still inside a zone, collected by a later call.
+            continue;
+        }
+        for ( size_t i = 0; i < buffer.events.size(); ++i ) {
+            Event const& event = buffer.events[ i ];
+            Nanoseconds const duration = event.end - event.begin;
+
+            ZoneInfo& info = r.zones[ event.zone ];
+            ++info.calls;
+            info.nanoseconds += duration;
+            info.selfNanoseconds += duration - event.nestedNanoseconds;
+
+            if ( r.recording && ( r.trace.size() < r.maxTraceEvents ) ) {
+                TraceEvent const traceEvent = { event.zone, buffer.index, event.begin, duration };
+                r.trace.push_back( traceEvent );
+            }
+        }
+        buffer.events.clear();
+    }
+    ++r.frames;
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::Profiler::frameCount()
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    return r.frames;
+}
+
+
+
+std::vector< OpenSteer::ProfileZoneStatistics >
+OpenSteer::Profiler::statistics()
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    std::vector< ProfileZoneStatistics > result;
+    appendStatistics( r, 0, result );
+    return result;
+}
+
+
+
+void
+OpenSteer::Profiler::resetStatistics()
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    for ( size_t i = 0; i < r.zones.size(); ++i ) {
+        r.zones[ i ].calls = 0;
+        r.zones[ i ].nanoseconds = 0;
+        r.zones[ i ].selfNanoseconds = 0;
+    }
+    r.frames = 0;
+}
+
+
+
+void
+OpenSteer::Profiler::setTraceRecording( bool recording, size_t maxEvents )
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    r.recording = recording;
+    r.maxTraceEvents = maxEvents;
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::Profiler::traceEventCount()
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    return r.trace.size();
+}
+
+
+
+void
+OpenSteer::Profiler::clearTrace()
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    r.trace.clear();
+}
+
+
+
+void
+OpenSteer::Profiler::writeChromeTrace( std::ostream& stream )
+{
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+
+    // Timestamps and durations are in microseconds.
+    std::ios_base::fmtflags const flags = stream.flags();
+    std::streamsize const precision = stream.precision();
+    stream.setf( std::ios_base::fixed, std::ios_base::floatfield );
+    stream.precision( 3 );
+
+    // One track per thread, named by the thread's buffer index.
+    stream << "{\"traceEvents\":[";
+    char const* separator = "\n";
+    for ( size_t b = 0; b < r.buffers.size(); ++b ) {
+        stream << separator
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << b
+               << ",\"args\":{\"name\":\"thread " << b << "\"}}";
+        separator = ",\n";
+    }
+    for ( size_t i = 0; i < r.trace.size(); ++i ) {
+        TraceEvent const& event = r.trace[ i ];
+        stream << separator << "{\"name\":";
+        writeJsonString( stream, r.zones[ event.zone ].name );
+        stream << ",\"cat\":\"OpenSteer\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+               << ",\"ts\":" << event.begin * 1.0e-3
+               << ",\"dur\":" << event.duration * 1.0e-3 << "}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    stream.flags( flags );
+    stream.precision( precision );
+}
+
+
+
+OpenSteer::ProfileZoneContext::ProfileZoneContext( Profiler::Zone zone )
+    : active_( Profiler::enabled() ),
+      previous_( 0 )
+{
+    if ( active_ ) {
+        ThreadBuffer& buffer = threadBuffer();
+        previous_ = buffer.current;
+        buffer.current = zone;
+    }
+}
+
+
+
+OpenSteer::ProfileZoneContext::~ProfileZoneContext()
+{
+    if ( active_ ) {
+        threadBuffer().current = previous_;
+    }
+}
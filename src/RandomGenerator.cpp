@@ -0,0 +1,121 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/RandomGenerator.h"
+
+// Include OpenSteer::normalizeVectors
+#include "OpenSteer/Vec3Utilities.h"
+
+
+
+void
+OpenSteer::RandomGenerator::random01s( float values[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        values[ i ] = random01();
+    }
+}
+
+
+
+void
+OpenSteer::RandomGenerator::vectorsInUnitRadiusSphere( Vec3 vectors[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        vectors[ i ] = vectorInUnitRadiusSphere();
+    }
+}
+
+
+
+void
+OpenSteer::RandomGenerator::vectorsOnUnitRadiusXZDisk( Vec3 vectors[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        vectors[ i ] = vectorOnUnitRadiusXZDisk();
+    }
+}
+
+
+
+void
+OpenSteer::RandomGenerator::unitVectors( Vec3 vectors[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        do {
+            vectors[ i ] = vectorInUnitRadiusSphere();
+        } while ( 0.0f == vectors[ i ].lengthSquared() );
+    }
+    normalizeVectors( vectors, count );
+}
+
+
+
+void
+OpenSteer::RandomGenerator::unitVectors( float xs[], float ys[], float zs[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        Vec3 v;
+        do {
+            v = vectorInUnitRadiusSphere();
+        } while ( 0.0f == v.lengthSquared() );
+        xs[ i ] = v.x;
+        ys[ i ] = v.y;
+        zs[ i ] = v.z;
+    }
+    normalizeVectors( xs, ys, zs, count );
+}
+
+
+
+void
+OpenSteer::RandomGenerator::unitVectorsOnXZPlane( Vec3 vectors[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        do {
+            vectors[ i ] = vectorOnUnitRadiusXZDisk();
+        } while ( 0.0f == vectors[ i ].lengthSquared() );
+    }
+    normalizeVectors( vectors, count );
+}
+
+
+
+void
+OpenSteer::RandomGenerator::unitVectorsOnXZPlane( float xs[], float ys[], float zs[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        Vec3 v;
+        do {
+            v = vectorOnUnitRadiusXZDisk();
+        } while ( 0.0f == v.lengthSquared() );
+        xs[ i ] = v.x;
+        ys[ i ] = v.y;
+        zs[ i ] = v.z;
+    }
+    normalizeVectors( xs, ys, zs, count );
+}
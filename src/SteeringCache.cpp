@@ -0,0 +1,245 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/SteeringCache.h"
+
+// Include assert
+#include <cassert>
+
+// Include std::floor
+#include <cmath>
+
+
+
+namespace {
+
+    typedef unsigned long long Signature;
+
+    /**
+     * Finalizer of splitmix64, spreads every input bit over the whole
+     * result.
+     */
+    Signature mix( Signature value )
+    {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+
+    Signature combine( Signature seed, Signature value )
+    {
+        return mix( seed ^ ( value + 0x9e3779b97f4a7c15ULL + ( seed << 6 ) + ( seed >> 2 ) ) );
+    }
+
+
+    Signature quantize( float value, float inverseTolerance )
+    {
+        return static_cast< Signature >( static_cast< long long >( std::floor( value * inverseTolerance ) ) );
+    }
+
+
+    Signature combine( Signature seed,
+                       OpenSteer::Vec3 const& v,
+                       float inverseTolerance )
+    {
+        seed = combine( seed, quantize( v.x, inverseTolerance ) );
+        seed = combine( seed, quantize( v.y, inverseTolerance ) );
+        return combine( seed, quantize( v.z, inverseTolerance ) );
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::SteeringCache::SteeringCache()
+    : enabled_( false ),
+      valid_( false ),
+      positionTolerance_( 0.25f ),
+      headingTolerance_( 0.05f ),
+      maxAge_( 8 ),
+      age_( 0 ),
+      signature_( 0 ),
+      pendingSignature_( 0 ),
+      force_( Vec3::zero ),
+      hits_( 0 ),
+      misses_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SteeringCache::SteeringCache( float positionTolerance,
+                                         float headingTolerance,
+                                         size_t maxAge )
+    : enabled_( true ),
+      valid_( false ),
+      positionTolerance_( positionTolerance ),
+      headingTolerance_( headingTolerance ),
+      maxAge_( maxAge ),
+      age_( 0 ),
+      signature_( 0 ),
+      pendingSignature_( 0 ),
+      force_( Vec3::zero ),
+      hits_( 0 ),
+      misses_( 0 )
+{
+    assert( 0.0f < positionTolerance && "positionTolerance must be greater than zero." );
+    assert( 0.0f < headingTolerance && "headingTolerance must be greater than zero." );
+}
+
+
+
+void
+OpenSteer::SteeringCache::setEnabled( bool enable )
+{
+    enabled_ = enable;
+    invalidate();
+}
+
+
+
+void
+OpenSteer::SteeringCache::setPositionTolerance( float tolerance )
+{
+    assert( 0.0f < tolerance && "tolerance must be greater than zero." );
+    positionTolerance_ = tolerance;
+    invalidate();
+}
+
+
+
+void
+OpenSteer::SteeringCache::setHeadingTolerance( float tolerance )
+{
+    assert( 0.0f < tolerance && "tolerance must be greater than zero." );
+    headingTolerance_ = tolerance;
+    invalidate();
+}
+
+
+
+bool
+OpenSteer::SteeringCache::lookup( AbstractVehicle const& vehicle,
+                                  AVGroup const& neighbors,
+                                  Vec3& force )
+{
+    if ( ! enabled_ ) {
+        return false;
+    }
+
+    pendingSignature_ = computeSignature( vehicle, neighbors );
+
+    if ( valid_ &&
+         ( pendingSignature_ == signature_ ) &&
+         ( ( 0 == maxAge_ ) || ( age_ < maxAge_ ) ) ) {
+        ++age_;
+        ++hits_;
+        force = force_;
+        return true;
+    }
+
+    ++misses_;
+    return false;
+}
+
+
+
+void
+OpenSteer::SteeringCache::store( Vec3 const& force )
+{
+    if ( ! enabled_ ) {
+        return;
+    }
+
+    signature_ = pendingSignature_;
+    force_ = force;
+    age_ = 0;
+    valid_ = true;
+}
+
+
+
+void
+OpenSteer::SteeringCache::invalidate()
+{
+    valid_ = false;
+    age_ = 0;
+}
+
+
+
+void
+OpenSteer::SteeringCache::resetCounters()
+{
+    hits_ = 0;
+    misses_ = 0;
+}
+
+
+
+unsigned long long
+OpenSteer::SteeringCache::computeSignature( AbstractVehicle const& vehicle,
+                                            AVGroup const& neighbors ) const
+{
+    float const inversePositionTolerance = 1.0f / positionTolerance_;
+    float const inverseHeadingTolerance = 1.0f / headingTolerance_;
+
+    Vec3 const position( vehicle.position() );
+    Vec3 const forward( vehicle.forward() );
+
+    // The world space orientation and speed of the vehicle itself are part of
+    // the signature because steering results are returned in world space.
+    Signature signature = combine( 0, forward, inverseHeadingTolerance );
+    signature = combine( signature, quantize( vehicle.speed(), inversePositionTolerance ) );
+
+    // Proximity databases don't guarantee a stable neighbor order, therefore
+    // the per neighbor hashes are summed up to be order independent.
+    Signature neighborSum = 0;
+    Signature neighborCount = 0;
+    for ( AVIterator i = neighbors.begin(); i != neighbors.end(); ++i ) {
+        AbstractVehicle const* other = *i;
+        if ( other == &vehicle ) {
+            continue;
+        }
+
+        Signature neighbor = mix( static_cast< Signature >( reinterpret_cast< size_t >( other ) ) );
+        neighbor = combine( neighbor, other->position() - position, inversePositionTolerance );
+        neighbor = combine( neighbor, other->forward() - forward, inverseHeadingTolerance );
+        neighbor = combine( neighbor, quantize( other->speed(), inversePositionTolerance ) );
+
+        neighborSum += neighbor;
+        ++neighborCount;
+    }
+
+    signature = combine( signature, neighborCount );
+    return combine( signature, neighborSum );
+}
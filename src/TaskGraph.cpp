@@ -0,0 +1,84 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/TaskGraph.h"
+
+// Include assert
+#include <cassert>
+
+
+
+OpenSteer::TaskGraph::TaskGraph()
+    : size_( 0 )
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::TaskGraph::Task
+OpenSteer::TaskGraph::add( std::function< void () > const& work )
+{
+    if ( size_ == nodes_.size() ) {
+        nodes_.push_back( Node() );
+    }
+
+    Node& node = nodes_[ size_ ];
+    node.work = work;
+    node.successors.clear();
+    node.predecessorCount = 0;
+    return size_++;
+}
+
+
+
+void
+OpenSteer::TaskGraph::precede( Task before, Task after )
+{
+    assert( before < size_ && after < size_ && "Unknown task." );
+    assert( before != after && "A task can't precede itself." );
+
+    nodes_[ before ].successors.push_back( after );
+    ++nodes_[ after ].predecessorCount;
+}
+
+
+
+void
+OpenSteer::TaskGraph::clear()
+{
+    // Keep the nodes, their works and successor lists are reused by add.
+    size_ = 0;
+}
+
+
+
+void
+OpenSteer::TaskGraph::reserve( size_t taskCount )
+{
+    nodes_.reserve( taskCount );
+}
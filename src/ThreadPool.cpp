@@ -0,0 +1,489 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+
+#include "OpenSteer/ThreadPool.h"
+
+// Include std::min, std::max
+#include <algorithm>
+
+// Include assert
+#include <cassert>
+
+// Include OpenSteer::TaskGraph
+#include "OpenSteer/TaskGraph.h"
+
+
+
+namespace {
+
+    /**
+     * Pool and index of the calling worker thread.
+     */
+    thread_local OpenSteer::ThreadPool const* currentPool = 0;
+    thread_local OpenSteer::size_t currentIndex = 0;
+
+    /**
+     * Tasks the calling thread is running, only the outermost one (which
+     * includes the time of nested ones) counts as busy time.
+     */
+    thread_local OpenSteer::size_t taskDepth = 0;
+
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Returns @a threadCount or, if @c 0, the number of hardware threads.
+     */
+    OpenSteer::size_t resolveThreadCount( OpenSteer::size_t threadCount )
+    {
+        if ( 0 == threadCount ) {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        return ( 0 == threadCount ) ? 1 : threadCount;
+    }
+
+    unsigned long long nanosecondsSince( Clock::time_point start )
+    {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - start ).count();
+    }
+
+} // anonymous namespace
+
+
+
+/**
+ * Runs the task @a begin of a graph and queues its successors once all
+ * their predecessors are done.
+ */
+class OpenSteer::ThreadPool::GraphJob : public OpenSteer::ThreadPool::Job {
+public:
+    GraphJob( ThreadPool& pool, TaskGraph& graph, Completion& completion )
+        : pool_( pool ), graph_( graph ), completion_( completion ) {}
+
+    virtual void operator()( size_t begin, size_t /* end */ ) const {
+        TaskGraph::Node& node = graph_.nodes_[ begin ];
+        node.work();
+
+        for ( size_t i = 0; i < node.successors.size(); ++i ) {
+            size_t const successor = node.successors[ i ];
+            if ( 1 == graph_.nodes_[ successor ].remainingPredecessors.fetch_sub( 1 ) ) {
+                Task const task = { this, successor, successor + 1, &completion_, Profiler::currentZone() };
+                pool_.push( pool_.currentThread(), task );
+            }
+        }
+    }
+
+private:
+    ThreadPool& pool_;
+    TaskGraph& graph_;
+    Completion& completion_;
+}; // class GraphJob
+
+
+
+/**
+ * Claims thread 0 for the calling thread if it is not a worker, nested
+ * loops and graphs of the same thread keep the claim.
+ */
+class OpenSteer::ThreadPool::Submission {
+public:
+    explicit Submission( ThreadPool& pool )
+        : pool_( pool ), owner_( false ) {
+        if ( &pool == currentPool ) {
+            // Workers don't claim anything.
+            return;
+        }
+
+        std::thread::id const self = std::this_thread::get_id();
+        std::thread::id expected;
+        owner_ = pool_.submitter_.compare_exchange_strong( expected, self ) || ( self == expected );
+        assert( owner_ && "Work started by two non-worker threads at the same time." );
+        if ( owner_ ) {
+            ++pool_.submissionDepth_;
+        }
+    }
+
+    ~Submission() {
+        if ( owner_ && ( 0 == --pool_.submissionDepth_ ) ) {
+            pool_.submitter_ = std::thread::id();
+        }
+    }
+
+private:
+    /**
+     * Not implemented to make it non-copyable.
+     */
+    Submission( Submission const& );
+
+    /**
+     * Not implemented to make it non-copyable.
+     */
+    Submission& operator=( Submission const& );
+
+private:
+    ThreadPool& pool_;
+    bool owner_;
+}; // class Submission
+
+
+
+OpenSteer::ThreadPool::ThreadPool( size_t threadCount )
+    : threadCount_( 0 ),
+      queuedTasks_( 0 ),
+      stopping_( false ),
+      submitter_( std::thread::id() ),
+      submissionDepth_( 0 )
+{
+    setThreadCount( threadCount );
+    // Workers are started by the first loop or graph.
+}
+
+
+
+OpenSteer::ThreadPool::~ThreadPool()
+{
+    stopWorkers();
+}
+
+
+
+void
+OpenSteer::ThreadPool::setThreadCount( size_t threadCount )
+{
+    assert( 0 == queuedTasks_ && "Thread count changed while work runs." );
+    stopWorkers();
+
+    threadCount_ = resolveThreadCount( threadCount );
+    threads_.clear();
+    for ( size_t i = 0; i < threadCount_; ++i ) {
+        threads_.push_back( std::unique_ptr< ThreadState >( new ThreadState() ) );
+    }
+    resetStatistics();
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::ThreadPool::grainSize( size_t count ) const
+{
+    return std::max( size_t( 1 ), count / ( threadCount_ * chunksPerThread ) );
+}
+
+
+
+void
+OpenSteer::ThreadPool::runRange( size_t count, Job const& job, size_t grainSize )
+{
+    if ( 0 == count ) {
+        return;
+    }
+    Submission const submission( *this );
+
+    if ( 0 == grainSize ) {
+        grainSize = this->grainSize( count );
+    }
+    size_t const chunkCount = ( count + grainSize - 1 ) / grainSize;
+
+    if ( ( 1 == threadCount_ ) || ( 1 == chunkCount ) ) {
+        // Nobody to share the work with, run the chunks right here.
+        ThreadState& state = *threads_[ currentThread() ];
+        Clock::time_point const start = Clock::now();
+        ++taskDepth;
+        for ( size_t begin = 0; begin < count; begin += grainSize ) {
+            job( begin, std::min( count, begin + grainSize ) );
+        }
+        --taskDepth;
+        if ( 0 == taskDepth ) {
+            state.busyNanoseconds += nanosecondsSince( start );
+        }
+        state.taskCount += chunkCount;
+        return;
+    }
+
+    startWorkers();
+
+    Completion completion( chunkCount );
+    Profiler::Zone const zone = Profiler::currentZone();
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        queuedTasks_ += chunkCount;
+    }
+
+    // Deal out a contiguous run of chunks to each thread, queued so that
+    // the owner takes them in index order and thieves from the end.
+    for ( size_t thread = 0; thread < threadCount_; ++thread ) {
+        size_t const firstChunk = ( chunkCount * thread ) / threadCount_;
+        size_t const endChunk = ( chunkCount * ( thread + 1 ) ) / threadCount_;
+
+        ThreadState& state = *threads_[ thread ];
+        std::lock_guard< std::mutex > lock( state.mutex );
+        for ( size_t chunk = endChunk; chunk-- > firstChunk; ) {
+            Task const task = { &job,
+                                chunk * grainSize,
+                                std::min( count, ( chunk + 1 ) * grainSize ),
+                                &completion,
+                                zone };
+            state.tasks.push_back( task );
+        }
+    }
+    wakeUp_.notify_all();
+
+    wait( currentThread(), completion );
+}
+
+
+
+void
+OpenSteer::ThreadPool::run( TaskGraph& graph )
+{
+    if ( graph.empty() ) {
+        return;
+    }
+    Submission const submission( *this );
+
+    if ( 1 < threadCount_ ) {
+        startWorkers();
+    }
+
+    Completion completion( graph.size() );
+    GraphJob const job( *this, graph, completion );
+
+    for ( size_t i = 0; i < graph.size(); ++i ) {
+        TaskGraph::Node& node = graph.nodes_[ i ];
+        node.remainingPredecessors = node.predecessorCount;
+    }
+
+    size_t const thread = currentThread();
+    size_t rootCount = 0;
+    for ( size_t i = 0; i < graph.size(); ++i ) {
+        if ( 0 == graph.nodes_[ i ].predecessorCount ) {
+            Task const task = { &job, i, i + 1, &completion, Profiler::currentZone() };
+            push( thread, task );
+            ++rootCount;
+        }
+    }
+    assert( 0 < rootCount && "Task graph has a cycle." );
+
+    wait( thread, completion );
+}
+
+
+
+void
+OpenSteer::ThreadPool::push( size_t thread, Task const& task )
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        ++queuedTasks_;
+    }
+    {
+        ThreadState& state = *threads_[ thread ];
+        std::lock_guard< std::mutex > lock( state.mutex );
+        state.tasks.push_back( task );
+    }
+    wakeUp_.notify_all();
+}
+
+
+
+bool
+OpenSteer::ThreadPool::runNextTask( size_t thread )
+{
+    Task task;
+
+    // Newest task of our own queue.
+    {
+        ThreadState& state = *threads_[ thread ];
+        std::unique_lock< std::mutex > lock( state.mutex );
+        if ( ! state.tasks.empty() ) {
+            task = state.tasks.back();
+            state.tasks.pop_back();
+            --queuedTasks_;
+            lock.unlock();
+            execute( thread, task, false );
+            return true;
+        }
+    }
+
+    // Oldest task of another queue.
+    for ( size_t offset = 1; offset < threadCount_; ++offset ) {
+        ThreadState& victim = *threads_[ ( thread + offset ) % threadCount_ ];
+        std::unique_lock< std::mutex > lock( victim.mutex );
+        if ( ! victim.tasks.empty() ) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            --queuedTasks_;
+            lock.unlock();
+            execute( thread, task, true );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+void
+OpenSteer::ThreadPool::execute( size_t thread, Task const& task, bool stolen )
+{
+    ThreadState& state = *threads_[ thread ];
+
+    Clock::time_point const start = Clock::now();
+    ++taskDepth;
+    {
+        ProfileZoneContext const context( task.zone );
+        ( *task.job )( task.begin, task.end );
+    }
+    --taskDepth;
+    if ( 0 == taskDepth ) {
+        state.busyNanoseconds += nanosecondsSince( start );
+    }
+    ++state.taskCount;
+    if ( stolen ) {
+        ++state.stealCount;
+    }
+
+    // The waiting thread may return and destroy the completion as soon as
+    // it reaches zero, so don't touch it afterwards.
+    if ( 1 == task.completion->fetch_sub( 1 ) ) {
+        { std::lock_guard< std::mutex > lock( mutex_ ); }
+        wakeUp_.notify_all();
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPool::wait( size_t thread, Completion& completion )
+{
+    while ( 0 != completion ) {
+        if ( runNextTask( thread ) ) {
+            continue;
+        }
+
+        std::unique_lock< std::mutex > lock( mutex_ );
+        while ( ( 0 != completion ) && ( 0 == queuedTasks_ ) ) {
+            wakeUp_.wait( lock );
+        }
+    }
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::ThreadPool::currentThread() const
+{
+    return ( this == currentPool ) ? currentIndex : 0;
+}
+
+
+
+std::vector< OpenSteer::ThreadStatistics >
+OpenSteer::ThreadPool::statistics() const
+{
+    double const elapsedSeconds = std::chrono::duration< double >( Clock::now() - statisticsStart_ ).count();
+
+    std::vector< ThreadStatistics > result( threadCount_ );
+    for ( size_t i = 0; i < threadCount_; ++i ) {
+        ThreadState const& state = *threads_[ i ];
+        result[ i ].busySeconds = state.busyNanoseconds * 1.0e-9;
+        result[ i ].utilization = ( elapsedSeconds > 0.0 ) ? float( result[ i ].busySeconds / elapsedSeconds ) : 0.0f;
+        result[ i ].taskCount = state.taskCount;
+        result[ i ].stealCount = state.stealCount;
+    }
+    return result;
+}
+
+
+
+void
+OpenSteer::ThreadPool::resetStatistics()
+{
+    for ( size_t i = 0; i < threads_.size(); ++i ) {
+        threads_[ i ]->busyNanoseconds = 0;
+        threads_[ i ]->taskCount = 0;
+        threads_[ i ]->stealCount = 0;
+    }
+    statisticsStart_ = Clock::now();
+}
+
+
+
+void
+OpenSteer::ThreadPool::startWorkers()
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    if ( ! workers_.empty() ) {
+        return;
+    }
+
+    stopping_ = false;
+    workers_.reserve( threadCount_ - 1 );
+    for ( size_t thread = 1; thread < threadCount_; ++thread ) {
+        workers_.push_back( std::thread( &ThreadPool::workerLoop, this, thread ) );
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPool::stopWorkers()
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        stopping_ = true;
+    }
+    wakeUp_.notify_all();
+
+    for ( size_t i = 0; i < workers_.size(); ++i ) {
+        workers_[ i ].join();
+    }
+    workers_.clear();
+}
+
+
+
+void
+OpenSteer::ThreadPool::workerLoop( size_t thread )
+{
+    currentPool = this;
+    currentIndex = thread;
+
+    for ( ;; ) {
+        if ( runNextTask( thread ) ) {
+            continue;
+        }
+
+        std::unique_lock< std::mutex > lock( mutex_ );
+        while ( ! stopping_ && ( 0 == queuedTasks_ ) ) {
+            wakeUp_.wait( lock );
+        }
+        if ( stopping_ ) {
+            return;
+        }
+    }
+}
@@ -31,11 +31,20 @@
 // Include assert
 #include <cassert>
 
+// Include std::fill
+#include <algorithm>
+
 
 
 // Include OpenSteer::clamp
 #include "OpenSteer/Utilities.h"
 
+// Include OpenSteer::Vec3Lanes, OPENSTEER_VEC3A_SSE
+#include "OpenSteer/Vec3Lanes.h"
+
+
+
+
 /**
  * @todo Is this useful?
 std::pair< Vec3, Vec3 >
@@ -86,3 +95,258 @@ OpenSteer::pointToSegmentDistance ( const Vec3& point,
 }
 
 
+
+void
+OpenSteer::normalizeVectors( Vec3 vectors[], size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes::load( vectors + i ).normalize().store( vectors + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        vectors[ i ] = vectors[ i ].normalize();
+    }
+}
+
+
+
+void
+OpenSteer::normalizeVectors( float xs[], float ys[], float zs[], size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes::load( xs + i, ys + i, zs + i ).normalize().store( xs + i, ys + i, zs + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        Vec3 const v = Vec3( xs[ i ], ys[ i ], zs[ i ] ).normalize();
+        xs[ i ] = v.x;
+        ys[ i ] = v.y;
+        zs[ i ] = v.z;
+    }
+}
+
+
+
+void
+OpenSteer::truncateLengths( Vec3 vectors[], float const maxLengths[], size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const v = Vec3Lanes::load( vectors + i );
+        v.truncateLength( _mm_loadu_ps( maxLengths + i ) ).store( vectors + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        vectors[ i ] = vectors[ i ].truncateLength( maxLengths[ i ] );
+    }
+}
+
+
+
+void
+OpenSteer::truncateLengths( float xs[], float ys[], float zs[], float const maxLengths[], size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const v = Vec3Lanes::load( xs + i, ys + i, zs + i );
+        v.truncateLength( _mm_loadu_ps( maxLengths + i ) ).store( xs + i, ys + i, zs + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        Vec3 const v = Vec3( xs[ i ], ys[ i ], zs[ i ] ).truncateLength( maxLengths[ i ] );
+        xs[ i ] = v.x;
+        ys[ i ] = v.y;
+        zs[ i ] = v.z;
+    }
+}
+
+
+
+void
+OpenSteer::setYsToZero( Vec3 vectors[], size_t count )
+{
+    for ( size_t i = 0; i < count; ++i ) {
+        vectors[ i ].y = 0.0f;
+    }
+}
+
+
+
+void
+OpenSteer::setYsToZero( float ys[], size_t count )
+{
+    std::fill( ys, ys + count, 0.0f );
+}
+
+
+
+void
+OpenSteer::limitMaxDeviationAngles( Vec3 sources[], 
+                                    float cosineOfConeAngle, 
+                                    Vec3 const bases[], 
+                                    size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    __m128 const cosine = _mm_set1_ps( cosineOfConeAngle );
+    __m128 const sine = _mm_set1_ps( sqrtXXX( 1 - ( cosineOfConeAngle * cosineOfConeAngle ) ) );
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const source = Vec3Lanes::load( sources + i );
+        source.limitMaxDeviationAngle( cosine, sine, Vec3Lanes::load( bases + i ) ).store( sources + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        sources[ i ] = limitMaxDeviationAngle( sources[ i ], cosineOfConeAngle, bases[ i ] );
+    }
+}
+
+
+
+void
+OpenSteer::limitMaxDeviationAngles( float sourceXs[], float sourceYs[], float sourceZs[],
+                                    float cosineOfConeAngle, 
+                                    float const basisXs[], float const basisYs[], float const basisZs[],
+                                    size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    __m128 const cosine = _mm_set1_ps( cosineOfConeAngle );
+    __m128 const sine = _mm_set1_ps( sqrtXXX( 1 - ( cosineOfConeAngle * cosineOfConeAngle ) ) );
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const source = Vec3Lanes::load( sourceXs + i, sourceYs + i, sourceZs + i );
+        Vec3Lanes const basis = Vec3Lanes::load( basisXs + i, basisYs + i, basisZs + i );
+        source.limitMaxDeviationAngle( cosine, sine, basis ).store( sourceXs + i, sourceYs + i, sourceZs + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        Vec3 const v = limitMaxDeviationAngle( Vec3( sourceXs[ i ], sourceYs[ i ], sourceZs[ i ] ),
+                                               cosineOfConeAngle,
+                                               Vec3( basisXs[ i ], basisYs[ i ], basisZs[ i ] ) );
+        sourceXs[ i ] = v.x;
+        sourceYs[ i ] = v.y;
+        sourceZs[ i ] = v.z;
+    }
+}
+
+
+
+void
+OpenSteer::globalizePositions( Vec3 const& side,
+                               Vec3 const& up,
+                               Vec3 const& forward,
+                               Vec3 const& position,
+                               Vec3 const localPositions[],
+                               Vec3 globalPositions[],
+                               size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    Vec3Lanes const sides = Vec3Lanes::splat( side );
+    Vec3Lanes const ups = Vec3Lanes::splat( up );
+    Vec3Lanes const forwards = Vec3Lanes::splat( forward );
+    Vec3Lanes const positions = Vec3Lanes::splat( position );
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const local = Vec3Lanes::load( localPositions + i );
+        Vec3Lanes const global = positions + ( ( ( sides * local.x ) + ( ups * local.y ) ) + ( forwards * local.z ) );
+        global.store( globalPositions + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        Vec3 const& local = localPositions[ i ];
+        globalPositions[ i ] = position + ( ( ( side * local.x ) + ( up * local.y ) ) + ( forward * local.z ) );
+    }
+}
+
+
+
+void
+OpenSteer::localizePositions( Vec3 const& side,
+                              Vec3 const& up,
+                              Vec3 const& forward,
+                              Vec3 const& position,
+                              Vec3 const globalPositions[],
+                              Vec3 localPositions[],
+                              size_t count )
+{
+    size_t i = 0;
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    Vec3Lanes const sides = Vec3Lanes::splat( side );
+    Vec3Lanes const ups = Vec3Lanes::splat( up );
+    Vec3Lanes const forwards = Vec3Lanes::splat( forward );
+    Vec3Lanes const positions = Vec3Lanes::splat( position );
+    for ( ; i + 4 <= count; i += 4 ) {
+        Vec3Lanes const offset = Vec3Lanes::load( globalPositions + i ) - positions;
+        Vec3Lanes const local( offset.dot( sides ), offset.dot( ups ), offset.dot( forwards ) );
+        local.store( localPositions + i );
+    }
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( ; i < count; ++i ) {
+        Vec3 const offset = globalPositions[ i ] - position;
+        localPositions[ i ] = Vec3( offset.dot( side ), offset.dot( up ), offset.dot( forward ) );
+    }
+}
+
+
+
+void
+OpenSteer::globalizePositionGrid( Vec3 const& side,
+                                  Vec3 const& up,
+                                  Vec3 const& forward,
+                                  Vec3 const& position,
+                                  Vec3 const& localOrigin,
+                                  Vec3 const& localRowStep,
+                                  size_t rowCount,
+                                  Vec3 const& localColumnStep,
+                                  size_t columnCount,
+                                  Vec3 globalPositions[] )
+{
+    Vec3 const origin = position + ( ( ( side * localOrigin.x ) + ( up * localOrigin.y ) ) + ( forward * localOrigin.z ) );
+    Vec3 const rowStep = ( ( side * localRowStep.x ) + ( up * localRowStep.y ) ) + ( forward * localRowStep.z );
+    Vec3 const columnStep = ( ( side * localColumnStep.x ) + ( up * localColumnStep.y ) ) + ( forward * localColumnStep.z );
+    
+#ifdef OPENSTEER_VEC3A_SSE
+    Vec3Lanes const columnSteps = Vec3Lanes::splat( columnStep );
+#endif // OPENSTEER_VEC3A_SSE
+    
+    for ( size_t row = 0; row < rowCount; ++row ) {
+        Vec3 const rowOrigin = origin + ( rowStep * static_cast< float >( row ) );
+        Vec3* const rowPositions = globalPositions + ( row * columnCount );
+        size_t column = 0;
+        
+#ifdef OPENSTEER_VEC3A_SSE
+        Vec3Lanes const rowOrigins = Vec3Lanes::splat( rowOrigin );
+        __m128 columns = _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f );
+        __m128 const four = _mm_set1_ps( 4.0f );
+        for ( ; column + 4 <= columnCount; column += 4 ) {
+            ( rowOrigins + ( columnSteps * columns ) ).store( rowPositions + column );
+            columns = _mm_add_ps( columns, four );
+        }
+#endif // OPENSTEER_VEC3A_SSE
+        
+        for ( ; column < columnCount; ++column ) {
+            rowPositions[ column ] = rowOrigin + ( columnStep * static_cast< float >( column ) );
+        }
+    }
+}
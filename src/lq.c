@@ -207,6 +207,11 @@ lqClientProxy** lqBinForLocation (lqInternalDB* lq,
     iy = (int) (((y - lq->originy) / lq->sizey) * lq->divy);
     iz = (int) (((z - lq->originz) / lq->sizez) * lq->divz);
 
+    /* a point just inside the far faces may round up to the bin beyond */
+    if (ix >= lq->divx) ix = lq->divx - 1;
+    if (iy >= lq->divy) iy = lq->divy - 1;
+    if (iz >= lq->divz) iz = lq->divz - 1;
+
     /* convert to linear bin number */
     i = lqBinCoordsToBinIndex (lq, ix, iy, iz);
 
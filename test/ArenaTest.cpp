@@ -0,0 +1,404 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "ArenaTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::bad_alloc
+#include <new>
+
+// Include OpenSteer::Arena
+#include "OpenSteer/Arena.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ArenaTest );
+
+
+
+namespace {
+
+    using OpenSteer::Arena;
+    using OpenSteer::size_t;
+
+    /**
+     * Records its id in @a log_ when destroyed and the arena it was
+     * constructed in.
+     */
+    class alignas( 64 ) Tracked {
+    public:
+        Tracked( int id, std::vector< int >& log )
+            : id_( id ), log_( log ), constructedIn_( Arena::current() ) {}
+        ~Tracked() { log_.push_back( id_ ); }
+
+        Arena* constructedIn() const { return constructedIn_; }
+
+    private:
+        int id_;
+        std::vector< int >& log_;
+        Arena* constructedIn_;
+    }; // class Tracked
+
+    /**
+     * Allocates a buffer from the arena creating it and releases it when
+     * destroyed, like the trail of an @c AnnotationMixin.
+     */
+    class WithBuffer {
+    public:
+        WithBuffer()
+            : arena_( Arena::current() ), buffer_( arena_->allocateArray< float >( bufferSize ) ) {}
+        ~WithBuffer() { arena_->releaseArray( buffer_, bufferSize ); }
+
+        float* buffer() const { return buffer_; }
+
+        enum { bufferSize = 100 };
+
+    private:
+        Arena* arena_;
+        float* buffer_;
+    }; // class WithBuffer
+
+    /**
+     * Records the arena @c Arena::creating returns for it.
+     */
+    class Probe {
+    public:
+        Probe() : creating_( Arena::creating( this ) ) {}
+
+        Arena* creating() const { return creating_; }
+
+    private:
+        Arena* creating_;
+    }; // class Probe
+
+    /**
+     * Holds one probe as a member and constructs another one on the heap.
+     */
+    class WithProbes {
+    public:
+        WithProbes() : member_(), heap_( new Probe() ) {}
+        ~WithProbes() { delete heap_; }
+
+        Probe const& member() const { return member_; }
+        Probe const& heap() const { return *heap_; }
+
+    private:
+        WithProbes( WithProbes const& );
+        WithProbes& operator=( WithProbes const& );
+
+        Probe member_;
+        Probe* heap_;
+    }; // class WithProbes
+
+    /**
+     * Throws from its constructor, after allocating from the current arena
+     * like @c WithBuffer.
+     */
+    class Throwing {
+    public:
+        Throwing() : buffer_( Arena::current()->allocateArray< float >( 4 ) ) { throw 1; }
+        ~Throwing() {}
+
+    private:
+        float* buffer_;
+    }; // class Throwing
+
+    bool isAligned( void const* p, size_t alignment ) {
+        return 0 == ( reinterpret_cast< size_t >( p ) & ( alignment - 1 ) );
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::ArenaTest::ArenaTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ArenaTest::~ArenaTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::ArenaTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::ArenaTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::ArenaTest::testAllocationsAreAlignedAndAdjacent()
+{
+    Arena arena( 1024 );
+
+    char* const a = static_cast< char* >( arena.allocate( 3, 1 ) );
+    char* const b = static_cast< char* >( arena.allocate( 16, 16 ) );
+    char* const c = static_cast< char* >( arena.allocate( 64, 64 ) );
+    float* const d = arena.allocateArray< float >( 5 );
+
+    CPPUNIT_ASSERT( isAligned( b, 16 ) );
+    CPPUNIT_ASSERT( isAligned( c, 64 ) );
+    CPPUNIT_ASSERT( isAligned( d, alignof( float ) ) );
+
+    // Creation order is memory order within a chunk.
+    CPPUNIT_ASSERT( a < b );
+    CPPUNIT_ASSERT( b + 16 <= c );
+    CPPUNIT_ASSERT( c + 64 <= reinterpret_cast< char* >( d ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), arena.chunkCount() );
+
+    for ( size_t i = 0; i < 5; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 0.0f, d[ i ] );
+    }
+
+    arena.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), arena.chunkCount() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), arena.bytesAllocated() );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testLargeAllocationGetsOwnChunk()
+{
+    Arena arena( 256 );
+
+    arena.allocate( 64, 8 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), arena.chunkCount() );
+
+    char* const large = static_cast< char* >( arena.allocate( 10000, 64 ) );
+    CPPUNIT_ASSERT( isAligned( large, 64 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), arena.chunkCount() );
+
+    // The whole block is usable.
+    for ( size_t i = 0; i < 10000; ++i ) {
+        large[ i ] = static_cast< char >( i );
+    }
+    CPPUNIT_ASSERT( arena.bytesAllocated() >= 10064 );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testClearDestroysInReverseOrder()
+{
+    std::vector< int > log;
+    {
+        Arena arena;
+        for ( int i = 0; i < 4; ++i ) {
+            Tracked* const t = arena.create< Tracked >( i, log );
+            CPPUNIT_ASSERT( isAligned( t, 64 ) );
+        }
+        CPPUNIT_ASSERT( log.empty() );
+
+        arena.clear();
+        CPPUNIT_ASSERT_EQUAL( size_t( 4 ), log.size() );
+        for ( int i = 0; i < 4; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( 3 - i, log[ i ] );
+        }
+
+        // Usable again after clear, the destructor cleans up.
+        arena.create< Tracked >( 4, log );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 5 ), log.size() );
+    CPPUNIT_ASSERT_EQUAL( 4, log.back() );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testDestroySingleObject()
+{
+    std::vector< int > log;
+    Arena arena;
+
+    arena.create< Tracked >( 0, log );
+    Tracked* const middle = arena.create< Tracked >( 1, log );
+    arena.create< Tracked >( 2, log );
+
+    arena.destroy( middle );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), log.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, log[ 0 ] );
+
+    arena.destroy( static_cast< Tracked* >( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), log.size() );
+
+    // The destroyed object is not destroyed again.
+    arena.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), log.size() );
+    CPPUNIT_ASSERT_EQUAL( 2, log[ 1 ] );
+    CPPUNIT_ASSERT_EQUAL( 0, log[ 2 ] );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testDestroyedMemoryIsReused()
+{
+    Arena arena( 1024 );
+    std::vector< WithBuffer* > objects;
+    for ( size_t i = 0; i < 100; ++i ) {
+        objects.push_back( arena.create< WithBuffer >() );
+    }
+    size_t const bytes = arena.bytesAllocated();
+
+    // The next object of the same type takes the place of the last one
+    // destroyed, together with its buffer.
+    WithBuffer* const last = objects.back();
+    float* const lastBuffer = last->buffer();
+    arena.destroy( last );
+    objects.back() = arena.create< WithBuffer >();
+    CPPUNIT_ASSERT( last == objects.back() );
+    CPPUNIT_ASSERT( lastBuffer == objects.back()->buffer() );
+
+    // Halving and doubling the population again and again needs no
+    // further memory.
+    for ( int cycle = 0; cycle < 8; ++cycle ) {
+        while ( objects.size() > 50 ) {
+            arena.destroy( objects.back() );
+            objects.pop_back();
+        }
+        while ( objects.size() < 100 ) {
+            objects.push_back( arena.create< WithBuffer >() );
+        }
+        CPPUNIT_ASSERT_EQUAL( bytes, arena.bytesAllocated() );
+    }
+
+    // Other sizes don't take released blocks.
+    arena.destroy( objects.back() );
+    arena.allocate( sizeof( WithBuffer ) + 1, alignof( WithBuffer ) );
+    CPPUNIT_ASSERT( arena.bytesAllocated() > bytes );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testCurrentDuringCreate()
+{
+    std::vector< int > log;
+    Arena outer;
+    Arena inner;
+
+    CPPUNIT_ASSERT( 0 == Arena::current() );
+
+    Tracked* const a = outer.create< Tracked >( 0, log );
+    Tracked* const b = inner.create< Tracked >( 1, log );
+
+    CPPUNIT_ASSERT( &outer == a->constructedIn() );
+    CPPUNIT_ASSERT( &inner == b->constructedIn() );
+    CPPUNIT_ASSERT( 0 == Arena::current() );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testCreatingOnlyInsideCreatedObject()
+{
+    Arena arena;
+
+    WithProbes* const object = arena.create< WithProbes >();
+
+    CPPUNIT_ASSERT( &arena == object->member().creating() );
+    CPPUNIT_ASSERT( 0 == object->heap().creating() );
+    CPPUNIT_ASSERT( 0 == Arena::creating( object ) );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testFailedAllocationThrows()
+{
+    Arena arena( 1024 );
+    arena.allocate( 16, 16 );
+
+    // No system can provide half of the address space in one block.
+    bool thrown = false;
+    try {
+        arena.allocate( static_cast< size_t >( -1 ) / 2, 16 );
+    } catch ( std::bad_alloc const& ) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT( thrown );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), arena.chunkCount() );
+
+    // The arena stays usable.
+    CPPUNIT_ASSERT( 0 != arena.allocate( 16, 16 ) );
+}
+
+
+
+void
+OpenSteer::ArenaTest::testThrowingConstructor()
+{
+    std::vector< int > log;
+    Arena outer;
+    Arena inner;
+
+    // Remember where the next object of the size of Throwing goes.
+    void* const block = inner.allocate( sizeof( Throwing ), alignof( Throwing ) );
+    inner.release( block, sizeof( Throwing ), alignof( Throwing ) );
+
+    Tracked* const a = outer.create< Tracked >( 0, log );
+    CPPUNIT_ASSERT( &outer == a->constructedIn() );
+
+    bool thrown = false;
+    try {
+        inner.create< Throwing >();
+    } catch ( int ) {
+        thrown = true;
+    }
+    CPPUNIT_ASSERT( thrown );
+    CPPUNIT_ASSERT( 0 == Arena::current() );
+
+    // The block of the failed object is free again.
+    CPPUNIT_ASSERT( block == inner.allocate( sizeof( Throwing ), alignof( Throwing ) ) );
+
+    // Nothing was recorded for destruction.
+    inner.clear();
+    outer.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), log.size() );
+}
@@ -0,0 +1,336 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "BatchIntegratorTest.h"
+
+
+// Include std::pow
+#include <cmath>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+// Include OpenSteer::clip, OpenSteer::blendIntoAccumulator
+#include "OpenSteer/Utilities.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::BatchIntegratorTest );
+
+
+
+namespace {
+
+    using OpenSteer::MotionState;
+    using OpenSteer::RandomGenerator;
+    using OpenSteer::Vec3;
+
+    /**
+     * Vehicle heading somewhere at a speed between standing and full speed,
+     * about a third of them slow enough to have their forces adjusted.
+     */
+    MotionState randomState( RandomGenerator& random ) {
+        MotionState state;
+        state.forward = random.unitVector();
+        state.up = Vec3( 0.0f, 1.0f, 0.0f );
+        state.side = crossProduct( state.forward, state.up ).normalize();
+        state.up = crossProduct( state.side, state.forward );
+        state.position = random.vectorInUnitRadiusSphere() * 50.0f;
+        state.mass = random.random2( 0.5f, 2.0f );
+        state.maxSpeed = random.random2( 1.0f, 10.0f );
+        state.maxForce = random.random2( 1.0f, 10.0f );
+        state.speed = ( random.random01() < 0.3f ) ? random.random2( 0.0f, 0.2f * state.maxSpeed ) : random.random2( 0.0f, state.maxSpeed );
+        state.smoothedAcceleration = Vec3::zero;
+        state.smoothedPosition = Vec3::zero;
+        state.curvature = 0.0f;
+        state.smoothedCurvature = 0.0f;
+        state.lastForward = Vec3::zero;
+        state.lastPosition = Vec3::zero;
+        state.basisTolerance = 0.0f;
+        return state;
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::BatchIntegratorTest::BatchIntegratorTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::BatchIntegratorTest::~BatchIntegratorTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::testEmpty()
+{
+    BatchIntegrator integrator;
+    CPPUNIT_ASSERT( integrator.empty() );
+    integrator.integrate( 0.1f );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), integrator.size() );
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::testCompareWithScalarIntegration()
+{
+    RandomGenerator random( 11 );
+    size_t const vehicleCount = 103;
+    float const elapsedTime = 1.0f / 60.0f;
+
+    std::vector< MotionState > expected;
+    for ( size_t i = 0; i < vehicleCount; ++i ) {
+        expected.push_back( randomState( random ) );
+    }
+
+    // A standing vehicle and a moving one without force.
+    expected[ 3 ].speed = 0.0f;
+
+    std::vector< MotionState > states( expected );
+    BatchIntegrator integrator;
+    for ( int frame = 0; frame < 20; ++frame ) {
+        integrator.clear();
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            Vec3 const force = ( 3 == i || 4 == i ) ? Vec3::zero : random.vectorInUnitRadiusSphere() * 10.0f;
+            applySteeringForce( expected[ i ], force, elapsedTime );
+            CPPUNIT_ASSERT_EQUAL( i, integrator.add( states[ i ], force ) );
+        }
+
+        integrator.integrate( elapsedTime );
+
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            states[ i ] = integrator.state( i );
+            assertEqual( expected[ i ], states[ i ], 0.001f );
+        }
+    }
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::testZeroElapsedTime()
+{
+    RandomGenerator random( 12 );
+    MotionState expected = randomState( random );
+    MotionState const start = expected;
+    Vec3 const force( 1.0f, 2.0f, 3.0f );
+    applySteeringForce( expected, force, 0.0f );
+
+    BatchIntegrator integrator;
+    integrator.add( start, force );
+    integrator.integrate( 0.0f );
+
+    MotionState const state = integrator.state( 0 );
+    assertEqual( expected, state, 0.0001f );
+    CPPUNIT_ASSERT( start.position == state.position );
+    CPPUNIT_ASSERT( start.smoothedAcceleration == state.smoothedAcceleration );
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::testClearKeepsWorking()
+{
+    RandomGenerator random( 13 );
+    BatchIntegrator integrator;
+    for ( size_t i = 0; i < 9; ++i ) {
+        integrator.add( randomState( random ), Vec3::zero );
+    }
+    integrator.clear();
+    CPPUNIT_ASSERT( integrator.empty() );
+
+    MotionState expected = randomState( random );
+    Vec3 const force( 0.0f, 0.0f, 5.0f );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), integrator.add( expected, force ) );
+    integrator.integrate( 0.1f );
+    applySteeringForce( expected, force, 0.1f );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), integrator.size() );
+    assertEqual( expected, integrator.state( 0 ), 0.0001f );
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::testLazyBasis()
+{
+    RandomGenerator random( 14 );
+    size_t const vehicleCount = 21;
+    float const elapsedTime = 1.0f / 60.0f;
+    float const basisTolerance = 0.01f;
+
+    std::vector< MotionState > expected;
+    for ( size_t i = 0; i < vehicleCount; ++i ) {
+        expected.push_back( randomState( random ) );
+        expected.back().basisTolerance = basisTolerance;
+    }
+
+    BatchIntegrator integrator;
+    size_t keptBases = 0;
+    for ( int frame = 0; frame < 20; ++frame ) {
+        integrator.clear();
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            Vec3 const force = random.vectorInUnitRadiusSphere();
+            MotionState const start = expected[ i ];
+            OpenSteer::applySteeringForce( expected[ i ], force, elapsedTime );
+            integrator.add( start, force );
+
+            if ( ( expected[ i ].side == start.side ) && ( expected[ i ].forward != start.forward ) ) {
+                ++keptBases;
+            }
+            CPPUNIT_ASSERT( std::fabs( expected[ i ].forward.dot( expected[ i ].side ) ) <= basisTolerance );
+            CPPUNIT_ASSERT( std::fabs( expected[ i ].forward.dot( expected[ i ].up ) ) <= basisTolerance );
+        }
+
+        integrator.integrate( elapsedTime );
+
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            MotionState const state = integrator.state( i );
+            assertEqual( expected[ i ], state, 0.001f );
+            CPPUNIT_ASSERT_EQUAL( basisTolerance, state.basisTolerance );
+
+            // Keep both in step despite rounding.
+            expected[ i ] = state;
+        }
+    }
+
+    // Most updates only turn forward.
+    CPPUNIT_ASSERT( keptBases > vehicleCount * 10 );
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::applySteeringForce( MotionState& state, Vec3 const& force, float elapsedTime )
+{
+    // adjustRawSteeringForce
+    Vec3 adjustedForce = force;
+    float const maxAdjustedSpeed = 0.2f * state.maxSpeed;
+    if ( ( state.speed <= maxAdjustedSpeed ) && ( force != Vec3::zero ) ) {
+        float const range = state.speed / maxAdjustedSpeed;
+        float const cosine = interpolate( static_cast< float >( std::pow( range, 20 ) ), 1.0f, -1.0f );
+        adjustedForce = limitMaxDeviationAngle( force, cosine, state.forward );
+    }
+
+    Vec3 const clippedForce = adjustedForce.truncateLength( state.maxForce );
+    Vec3 const newAcceleration = clippedForce / state.mass;
+    Vec3 newVelocity = state.forward * state.speed;
+
+    if ( elapsedTime > 0 ) {
+        float const smoothRate = clip( 9 * elapsedTime, 0.15f, 0.4f );
+        blendIntoAccumulator( smoothRate, newAcceleration, state.smoothedAcceleration );
+    }
+
+    newVelocity += state.smoothedAcceleration * elapsedTime;
+    newVelocity = newVelocity.truncateLength( state.maxSpeed );
+    state.speed = newVelocity.length();
+    state.position = state.position + ( newVelocity * elapsedTime );
+
+    // regenerateLocalSpace
+    if ( state.speed > 0 ) {
+        state.forward = newVelocity / state.speed;
+        state.side.cross( state.forward, state.up );
+        state.side = state.side.normalize();
+        state.up.cross( state.side, state.forward );
+    }
+
+    // measurePathCurvature
+    if ( elapsedTime > 0 ) {
+        Vec3 const dP = state.lastPosition - state.position;
+        Vec3 const dF = ( state.lastForward - state.forward ) / dP.length();
+        Vec3 const lateral = dF.perpendicularComponent( state.forward );
+        float const sign = ( lateral.dot( state.side ) < 0 ) ? 1.0f : -1.0f;
+        state.curvature = lateral.length() * sign;
+        blendIntoAccumulator( elapsedTime * 4.0f, state.curvature, state.smoothedCurvature );
+        state.lastForward = state.forward;
+        state.lastPosition = state.position;
+    }
+
+    blendIntoAccumulator( elapsedTime * 0.06f, state.position, state.smoothedPosition );
+}
+
+
+
+void
+OpenSteer::BatchIntegratorTest::assertEqual( MotionState const& expected, MotionState const& state, float tolerance )
+{
+    Vec3 const MotionState::* const vectors[] = {
+        &MotionState::side, &MotionState::up, &MotionState::forward, &MotionState::position,
+        &MotionState::smoothedAcceleration, &MotionState::smoothedPosition,
+        &MotionState::lastForward, &MotionState::lastPosition
+    };
+    for ( size_t i = 0; i < sizeof( vectors ) / sizeof( vectors[ 0 ] ); ++i ) {
+        Vec3 const& e = expected.*vectors[ i ];
+        Vec3 const& v = state.*vectors[ i ];
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( e.x, v.x, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( e.y, v.y, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( e.z, v.z, tolerance );
+    }
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.speed, state.speed, tolerance );
+
+    // Standing vehicles measure a curvature of NaN.
+    if ( expected.smoothedCurvature != expected.smoothedCurvature ) {
+        CPPUNIT_ASSERT( state.smoothedCurvature != state.smoothedCurvature );
+    } else {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.smoothedCurvature, state.smoothedCurvature, tolerance );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( expected.mass, state.mass );
+    CPPUNIT_ASSERT_EQUAL( expected.maxForce, state.maxForce );
+    CPPUNIT_ASSERT_EQUAL( expected.maxSpeed, state.maxSpeed );
+}
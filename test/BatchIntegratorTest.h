@@ -0,0 +1,96 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::BatchIntegrator.
+ */
+
+#ifndef OPENSTEER_BATCHINTEGRATORTEST_H
+#define OPENSTEER_BATCHINTEGRATORTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+// Include OpenSteer::BatchIntegrator, OpenSteer::MotionState
+#include "OpenSteer/BatchIntegrator.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class BatchIntegratorTest : public CppUnit::TestFixture {
+    public:
+        BatchIntegratorTest();
+        virtual ~BatchIntegratorTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(BatchIntegratorTest);
+        CPPUNIT_TEST(testEmpty);
+        CPPUNIT_TEST(testCompareWithScalarIntegration);
+        CPPUNIT_TEST(testZeroElapsedTime);
+        CPPUNIT_TEST(testClearKeepsWorking);
+        CPPUNIT_TEST(testLazyBasis);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        BatchIntegratorTest( BatchIntegratorTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        BatchIntegratorTest& operator=( BatchIntegratorTest );
+
+    private:
+        void testEmpty();
+        void testCompareWithScalarIntegration();
+        void testZeroElapsedTime();
+        void testClearKeepsWorking();
+        void testLazyBasis();
+
+        /**
+         * Steps of @c SimpleVehicle::applySteeringForce applied to @a state.
+         */
+        static void applySteeringForce( MotionState& state, Vec3 const& force, float elapsedTime );
+
+        static void assertEqual( MotionState const& expected, MotionState const& state, float tolerance );
+
+    }; // BatchIntegratorTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_BATCHINTEGRATORTEST_H
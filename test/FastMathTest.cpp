@@ -0,0 +1,219 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "FastMathTest.h"
+
+
+// Include std::sqrt, std::log2, std::exp2, std::pow, std::fabs
+#include <cmath>
+
+// Include FLT_MIN
+#include <cfloat>
+
+// Include std::memcpy
+#include <cstring>
+
+// Include OpenSteer::fastInverseSqrt, OpenSteer::fastLog2, OpenSteer::fastExp2, OpenSteer::fastPow
+#include "OpenSteer/FastMath.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FastMathTest );
+
+
+
+namespace {
+
+    using OpenSteer::Vec3;
+
+    /**
+     * Normal float with the bit pattern @a bits.
+     */
+    float floatFromBits( unsigned int bits ) {
+        float result = 0.0f;
+        std::memcpy( &result, &bits, sizeof( result ) );
+        return result;
+    }
+
+    /**
+     * Bit patterns of the positive normal floats are stepped through with a
+     * prime stride, that covers all exponents and many mantissas.
+     */
+    unsigned int const firstNormal = 0x00800000u;
+    unsigned int const lastFinite = 0x7f7fffffu;
+    unsigned int const stride = 4099u;
+
+    double relativeError( double value, double exact ) {
+        return std::fabs( value / exact - 1.0 );
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::FastMathTest::FastMathTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FastMathTest::~FastMathTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::FastMathTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::FastMathTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::FastMathTest::testFastInverseSqrt()
+{
+    double maxError = 0.0;
+    for ( unsigned int bits = firstNormal; bits <= lastFinite - stride; bits += stride ) {
+        float const x = floatFromBits( bits );
+        double const error = relativeError( fastInverseSqrt( x ), 1.0 / std::sqrt( static_cast< double >( x ) ) );
+        maxError = ( error > maxError ) ? error : maxError;
+    }
+    CPPUNIT_ASSERT( maxError < 5e-6 );
+
+    CPPUNIT_ASSERT( relativeError( fastInverseSqrt( FLT_MIN ), 1.0 / std::sqrt( static_cast< double >( FLT_MIN ) ) ) < 5e-6 );
+    CPPUNIT_ASSERT( relativeError( fastInverseSqrt( 1.0f ), 1.0 ) < 5e-6 );
+}
+
+
+
+void
+OpenSteer::FastMathTest::testFastLog2()
+{
+    double maxError = 0.0;
+    for ( unsigned int bits = firstNormal; bits <= lastFinite - stride; bits += stride ) {
+        float const x = floatFromBits( bits );
+        double const error = std::fabs( fastLog2( x ) - std::log2( static_cast< double >( x ) ) );
+        maxError = ( error > maxError ) ? error : maxError;
+    }
+    CPPUNIT_ASSERT( maxError < 5e-6 );
+
+    maxError = 0.0;
+    for ( float x = 0.5f; x < 2.0f; x += 0.0001f ) {
+        double const error = std::fabs( fastLog2( x ) - std::log2( static_cast< double >( x ) ) );
+        maxError = ( error > maxError ) ? error : maxError;
+    }
+    CPPUNIT_ASSERT( maxError < 1.2e-6 );
+}
+
+
+
+void
+OpenSteer::FastMathTest::testFastExp2()
+{
+    double maxError = 0.0;
+    for ( float x = -126.0f; x < 127.9f; x += 0.0013f ) {
+        double const error = relativeError( fastExp2( x ), std::exp2( static_cast< double >( x ) ) );
+        maxError = ( error > maxError ) ? error : maxError;
+    }
+    CPPUNIT_ASSERT( maxError < 1e-6 );
+
+    CPPUNIT_ASSERT_EQUAL( 1.0f, fastExp2( 0.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, fastExp2( -127.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, fastExp2( -1000.0f ) );
+}
+
+
+
+void
+OpenSteer::FastMathTest::testFastPow()
+{
+    float const exponents[] = { -3.0f, 0.5f, 1.0f, 2.0f, 6.0f, 20.0f, 100.0f };
+    for ( size_t i = 0; i < sizeof( exponents ) / sizeof( exponents[ 0 ] ); ++i ) {
+        float const y = exponents[ i ];
+        double const bound = 4e-6 * ( std::fabs( y ) + 1.0 );
+
+        for ( unsigned int bits = firstNormal; bits <= lastFinite - stride; bits += stride ) {
+            float const x = floatFromBits( bits );
+            double const exact = std::pow( static_cast< double >( x ), static_cast< double >( y ) );
+
+            // Only results in the normal float range are approximated.
+            if ( exact < FLT_MIN || exact > FLT_MAX / 2.0 ) {
+                continue;
+            }
+            CPPUNIT_ASSERT( relativeError( fastPow( x, y ), exact ) < bound );
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 0.0f, fastPow( 0.0f, 20.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, fastPow( 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, fastPow( 0.1f, 100.0f ) );
+}
+
+
+
+void
+OpenSteer::FastMathTest::testVec3Operations()
+{
+    // Same bounds in both modes, in exact mode they hold trivially.
+    for ( int i = 1; i < 1000; ++i ) {
+        float const scale = 0.001f * i * i;
+        Vec3 const v( 0.3f * scale, -0.7f * scale, 0.2f * scale + 0.01f );
+        double const exactLength = std::sqrt( static_cast< double >( v.x ) * v.x +
+                                              static_cast< double >( v.y ) * v.y +
+                                              static_cast< double >( v.z ) * v.z );
+
+        CPPUNIT_ASSERT( relativeError( v.length(), exactLength ) < 5e-6 );
+        CPPUNIT_ASSERT( relativeError( v.normalize().length(), 1.0 ) < 1e-5 );
+
+        float const maxLength = 0.5f * scale;
+        Vec3 const truncated = v.truncateLength( maxLength );
+        CPPUNIT_ASSERT( relativeError( truncated.length(), maxLength ) < 1e-5 );
+        CPPUNIT_ASSERT( relativeError( truncated.dot( v ), truncated.length() * exactLength ) < 1e-5 );
+    }
+
+    CPPUNIT_ASSERT( Vec3::zero == Vec3::zero.normalize() );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, Vec3::zero.length() );
+    CPPUNIT_ASSERT( Vec3::zero == Vec3::zero.truncateLength( 0.0f ) );
+
+    Vec3 const shortVector( 0.5f, 0.0f, 0.0f );
+    CPPUNIT_ASSERT( shortVector == shortVector.truncateLength( 1.0f ) );
+}
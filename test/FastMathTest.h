@@ -0,0 +1,85 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Accuracy tests of the approximations in @c OpenSteer/FastMath.h and of
+ * the @c Vec3 operations using them.
+ */
+
+#ifndef OPENSTEER_FASTMATHTEST_H
+#define OPENSTEER_FASTMATHTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+
+
+    class FastMathTest : public CppUnit::TestFixture {
+    public:
+        FastMathTest();
+        virtual ~FastMathTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(FastMathTest);
+        CPPUNIT_TEST(testFastInverseSqrt);
+        CPPUNIT_TEST(testFastLog2);
+        CPPUNIT_TEST(testFastExp2);
+        CPPUNIT_TEST(testFastPow);
+        CPPUNIT_TEST(testVec3Operations);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FastMathTest( FastMathTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FastMathTest& operator=( FastMathTest );
+
+    private:
+        void testFastInverseSqrt();
+        void testFastLog2();
+        void testFastExp2();
+        void testFastPow();
+        void testVec3Operations();
+
+    }; // FastMathTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_FASTMATHTEST_H
@@ -0,0 +1,224 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "HeadlessVehicleTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::BatchIntegrator
+#include "OpenSteer/BatchIntegrator.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::PathCursor
+#include "OpenSteer/PathCursor.h"
+
+// Include OpenSteer::SphereObstacle, OpenSteer::ObstacleGroup
+#include "OpenSteer/Obstacle.h"
+
+// Include OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::HeadlessVehicleTest );
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    /**
+     * Vehicle doing nothing on its own, steered by the test.
+     */
+    class TestVehicle : public HeadlessVehicle {
+    public:
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) {}
+    };
+
+
+    bool isFinite( Vec3 const& v ) {
+        // NaN compares unequal to itself, infinity minus itself is NaN.
+        Vec3 const d = v - v;
+        return d.x == 0.0f && d.y == 0.0f && d.z == 0.0f;
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::HeadlessVehicleTest::HeadlessVehicleTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::HeadlessVehicleTest::~HeadlessVehicleTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::HeadlessVehicleTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::HeadlessVehicleTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::HeadlessVehicleTest::testReset()
+{
+    TestVehicle vehicle;
+    vehicle.setPosition( Vec3( 1.0f, 2.0f, 3.0f ) );
+    vehicle.setSpeed( 4.0f );
+    vehicle.setMaxSpeed( 5.0f );
+    vehicle.applySteeringForce( Vec3( 1.0f, 0.0f, 0.0f ), 0.1f );
+
+    vehicle.reset();
+
+    CPPUNIT_ASSERT( Vec3::zero == vehicle.position() );
+    CPPUNIT_ASSERT( Vec3::forward == vehicle.forward() );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, vehicle.mass() );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, vehicle.speed() );
+    CPPUNIT_ASSERT_EQUAL( 0.5f, vehicle.radius() );
+    CPPUNIT_ASSERT_EQUAL( 0.1f, vehicle.maxForce() );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, vehicle.maxSpeed() );
+    CPPUNIT_ASSERT( Vec3::zero == vehicle.smoothedAcceleration() );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, vehicle.smoothedCurvature() );
+}
+
+
+
+void
+OpenSteer::HeadlessVehicleTest::testCompareWithBatchIntegrator()
+{
+    size_t const vehicleCount = 9;
+    float const elapsedTime = 1.0f / 60.0f;
+
+    std::vector< TestVehicle > vehicles( vehicleCount );
+    for ( size_t i = 0; i < vehicleCount; ++i ) {
+        vehicles[ i ].randomizeHeadingOnXZPlane();
+        vehicles[ i ].setPosition( vehicles[ i ].randomGenerator().vectorInUnitRadiusSphere() * 10.0f );
+        vehicles[ i ].setMaxSpeed( 5.0f );
+        vehicles[ i ].setMaxForce( 3.0f );
+        vehicles[ i ].setSpeed( i * 0.5f );
+
+        // Every other vehicle regenerates its basis lazily.
+        vehicles[ i ].setBasisTolerance( ( i % 2 ) ? 0.01f : 0.0f );
+    }
+
+    BatchIntegrator integrator;
+    for ( int frame = 0; frame < 30; ++frame ) {
+        integrator.clear();
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            Vec3 const force = vehicles[ i ].steerForSeek( Vec3( 20.0f, 0.0f, 5.0f ) );
+            integrator.add( vehicles[ i ].motionState(), force );
+            vehicles[ i ].applySteeringForce( force, elapsedTime );
+        }
+        integrator.integrate( elapsedTime );
+
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            MotionState const state = integrator.state( i );
+            float const tolerance = 0.0001f;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( state.speed, vehicles[ i ].speed(), tolerance );
+            CPPUNIT_ASSERT( Vec3::distance( state.position, vehicles[ i ].position() ) < tolerance );
+            CPPUNIT_ASSERT( Vec3::distance( state.forward, vehicles[ i ].forward() ) < tolerance );
+            CPPUNIT_ASSERT( Vec3::distance( state.side, vehicles[ i ].side() ) < tolerance );
+
+            // Keep both in step despite rounding.
+            vehicles[ i ].setMotionState( state );
+        }
+    }
+}
+
+
+
+void
+OpenSteer::HeadlessVehicleTest::testSteeringBehaviors()
+{
+    Vec3 const points[] = { Vec3( -20.0f, 0.0f, 0.0f ), Vec3( 0.0f, 0.0f, 20.0f ), Vec3( 20.0f, 0.0f, 0.0f ) };
+    PolylineSegmentedPathwaySingleRadius path( 3, points, 2.0f, false );
+
+    SphereObstacle obstacle( 3.0f, Vec3( 0.0f, 0.0f, 10.0f ) );
+    ObstacleGroup obstacles;
+    obstacles.push_back( &obstacle );
+
+    size_t const vehicleCount = 6;
+    std::vector< TestVehicle > vehicles( vehicleCount );
+    std::vector< PathCursor > cursors( vehicleCount );
+    AVGroup all;
+    for ( size_t i = 0; i < vehicleCount; ++i ) {
+        vehicles[ i ].randomizeHeadingOnXZPlane();
+        vehicles[ i ].setPosition( points[ 0 ] + Vec3( i * 1.5f, 0.0f, i * 0.5f ) );
+        vehicles[ i ].setMaxSpeed( 2.0f );
+        vehicles[ i ].setMaxForce( 8.0f );
+        vehicles[ i ].setSpeed( 1.0f );
+        all.push_back( &vehicles[ i ] );
+    }
+
+    // Runs the behaviors calling annotation hooks, which must compile and
+    // do nothing.
+    float const elapsedTime = 1.0f / 30.0f;
+    for ( int frame = 0; frame < 100; ++frame ) {
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            TestVehicle& vehicle = vehicles[ i ];
+            TestVehicle const& quarry = vehicles[ ( i + 1 ) % vehicleCount ];
+            Vec3 force = vehicle.steerToFollowPath( +1, 3.0f, path, cursors[ i ] );
+            force += vehicle.steerToStayOnPath( 3.0f, path );
+            force += vehicle.steerToAvoidObstacles( 6.0f, obstacles );
+            force += vehicle.steerToAvoidNeighbors( 3.0f, all );
+            force += vehicle.steerToAvoidCloseNeighbors( 0.0f, all );
+            force += vehicle.steerForPursuit( quarry, 2.0f ) * 0.1f;
+            vehicle.applySteeringForce( force, elapsedTime );
+
+            CPPUNIT_ASSERT( isFinite( vehicle.position() ) );
+            CPPUNIT_ASSERT( isFinite( vehicle.forward() ) );
+        }
+    }
+}
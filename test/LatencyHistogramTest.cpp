@@ -0,0 +1,228 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "LatencyHistogramTest.h"
+
+
+// Include OpenSteer::LatencyHistogram, OpenSteer::LatencyWindow
+#include "OpenSteer/LatencyHistogram.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::LatencyHistogramTest );
+
+
+
+OpenSteer::LatencyHistogramTest::LatencyHistogramTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::LatencyHistogramTest::~LatencyHistogramTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testEmptyHistogram()
+{
+    LatencyHistogram const histogram;
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), histogram.count() );
+    CPPUNIT_ASSERT_EQUAL( 0.0, histogram.percentile( 0.99 ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0, histogram.max() );
+    CPPUNIT_ASSERT_EQUAL( 0.0, histogram.mean() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), histogram.countAbove( 0.0 ) );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testBucketsCoverDurationsContiguously()
+{
+    CPPUNIT_ASSERT_EQUAL( 0.0, LatencyHistogram::bucketLowerBound( 0 ) );
+    for ( size_t i = 0; i + 1 < LatencyHistogram::bucketCount; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( LatencyHistogram::bucketUpperBound( i ), LatencyHistogram::bucketLowerBound( i + 1 ) );
+        CPPUNIT_ASSERT( LatencyHistogram::bucketLowerBound( i ) < LatencyHistogram::bucketUpperBound( i ) );
+
+        // Bucket width relative to its start.
+        double const lower = LatencyHistogram::bucketLowerBound( i );
+        double const width = LatencyHistogram::bucketUpperBound( i ) - lower;
+        CPPUNIT_ASSERT( ( i < 2 * LatencyHistogram::subBucketCount ) || ( width <= lower / LatencyHistogram::subBucketCount * ( 1.0 + 1.0e-9 ) ) );
+    }
+
+    double const durations[] = { 1.0e-9, 63.0e-9, 64.0e-9, 0.001, 0.0166667, 0.5, 100.0 };
+    for ( size_t d = 0; d < sizeof( durations ) / sizeof( durations[ 0 ] ); ++d ) {
+        size_t const index = LatencyHistogram::bucketIndex( durations[ d ] );
+        CPPUNIT_ASSERT( LatencyHistogram::bucketLowerBound( index ) <= durations[ d ] * ( 1.0 + 1.0e-12 ) );
+        CPPUNIT_ASSERT( durations[ d ] < LatencyHistogram::bucketUpperBound( index ) );
+    }
+
+    // Beyond the tracked range all durations share the last bucket.
+    CPPUNIT_ASSERT_EQUAL( size_t( LatencyHistogram::bucketCount - 1 ), LatencyHistogram::bucketIndex( 1.0e6 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), LatencyHistogram::bucketIndex( -1.0 ) );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testPercentilesWithinBucketError()
+{
+    // 1 ms to 100 ms in steps of 0.1 ms.
+    LatencyHistogram histogram;
+    for ( size_t i = 0; i < 991; ++i ) {
+        histogram.record( 0.001 + i * 0.0001 );
+    }
+
+    double const fractions[] = { 0.5, 0.9, 0.95, 0.99 };
+    for ( size_t f = 0; f < sizeof( fractions ) / sizeof( fractions[ 0 ] ); ++f ) {
+        double const exact = 0.001 + ( fractions[ f ] * 991 - 1 ) * 0.0001;
+        double const percentile = histogram.percentile( fractions[ f ] );
+        CPPUNIT_ASSERT( percentile >= exact - 0.0001 );
+        CPPUNIT_ASSERT( percentile <= exact * ( 1.0 + 1.0 / LatencyHistogram::subBucketCount ) + 0.0001 );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( histogram.max(), histogram.percentile( 1.0 ) );
+    CPPUNIT_ASSERT( histogram.percentile( 0.0 ) <= 0.001 * ( 1.0 + 1.0 / LatencyHistogram::subBucketCount ) );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testMaxAndMeanAreExact()
+{
+    LatencyHistogram histogram;
+    histogram.record( 0.010 );
+    histogram.record( 0.020 );
+    histogram.record( 0.0333 );
+
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), histogram.count() );
+    CPPUNIT_ASSERT_EQUAL( 0.0333, histogram.max() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0211, histogram.mean(), 1.0e-12 );
+    CPPUNIT_ASSERT_EQUAL( 0.0333, histogram.percentile( 0.99 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), histogram.countAbove( 0.015 ) );
+
+    histogram.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), histogram.count() );
+    CPPUNIT_ASSERT_EQUAL( 0.0, histogram.max() );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testAddMergesCounts()
+{
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for ( size_t i = 0; i < 90; ++i ) {
+        fast.record( 0.001 );
+    }
+    for ( size_t i = 0; i < 10; ++i ) {
+        slow.record( 0.050 );
+    }
+
+    LatencyHistogram all;
+    all.add( fast );
+    all.add( slow );
+    CPPUNIT_ASSERT_EQUAL( size_t( 100 ), all.count() );
+    CPPUNIT_ASSERT_EQUAL( 0.050, all.max() );
+    CPPUNIT_ASSERT( all.percentile( 0.90 ) < 0.0011 );
+    CPPUNIT_ASSERT( all.percentile( 0.91 ) > 0.049 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0059, all.mean(), 1.0e-12 );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testWindowDropsOldestSegment()
+{
+    LatencyWindow window( 3, 10, 1.0 );
+    for ( size_t i = 0; i < 10; ++i ) {
+        window.record( 0.5 );
+    }
+    for ( size_t i = 0; i < 20; ++i ) {
+        window.record( 0.001 );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 30 ), window.histogram().count() );
+    CPPUNIT_ASSERT_EQUAL( 0.5, window.histogram().max() );
+
+    // The next sample starts a new segment replacing the slow one.
+    window.record( 0.001 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 21 ), window.histogram().count() );
+    CPPUNIT_ASSERT( window.histogram().max() < 0.0011 );
+
+    window.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), window.histogram().count() );
+}
+
+
+
+void
+OpenSteer::LatencyHistogramTest::testWindowCountsStalls()
+{
+    LatencyWindow window( 2, 4, 0.020 );
+    window.record( 0.010 );
+    window.record( 0.030 );
+    window.record( 0.020 );
+    window.record( 0.040 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), window.stallCount() );
+
+    for ( size_t i = 0; i < 4; ++i ) {
+        window.record( 0.010 );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), window.stallCount() );
+
+    // Drops the segment with the stalls.
+    window.record( 0.010 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), window.stallCount() );
+
+    window.setStallThreshold( 0.005 );
+    window.record( 0.010 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), window.stallCount() );
+}
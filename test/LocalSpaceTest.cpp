@@ -0,0 +1,237 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "LocalSpaceTest.h"
+
+
+// Include std::sin, std::cos, std::fabs
+#include <cmath>
+
+// Include OpenSteer::LocalSpace
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::LocalSpaceTest );
+
+
+
+namespace {
+
+    using OpenSteer::LocalSpace;
+    using OpenSteer::Vec3;
+
+    /**
+     * Unit vector on the XZ plane @a heading radians from +Z.
+     */
+    Vec3 headingOnXZPlane( float heading ) {
+        return Vec3( std::sin( heading ), 0.0f, std::cos( heading ) );
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::LocalSpaceTest::LocalSpaceTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::LocalSpaceTest::~LocalSpaceTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testLazyRegenerationWithoutTolerance()
+{
+    LocalSpace eager;
+    LocalSpace lazy;
+    Vec3 const tilted = Vec3( 0.3f, 0.2f, 1.0f ).normalize();
+
+    for ( int i = 0; i < 50; ++i ) {
+        Vec3 const forward = ( headingOnXZPlane( i * 0.01f ) + tilted * 0.1f ).normalize();
+        eager.regenerateOrthonormalBasisUF( forward );
+        CPPUNIT_ASSERT( lazy.lazyRegenerateOrthonormalBasisUF( forward, 0.0f ) );
+
+        CPPUNIT_ASSERT( eager.side() == lazy.side() );
+        CPPUNIT_ASSERT( eager.up() == lazy.up() );
+        CPPUNIT_ASSERT( eager.forward() == lazy.forward() );
+    }
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testLazyRegenerationKeepsBasisWithinTolerance()
+{
+    float const tolerance = 0.01f;
+    LocalSpace space;
+    int regenerations = 0;
+
+    // Turn slowly on the ground plane, about 0.001 radians per update.
+    for ( int i = 0; i < 1000; ++i ) {
+        Vec3 const forward = headingOnXZPlane( i * 0.001f );
+        if ( space.lazyRegenerateOrthonormalBasisUF( forward, tolerance ) ) {
+            ++regenerations;
+        }
+
+        CPPUNIT_ASSERT( space.forward() == forward );
+        CPPUNIT_ASSERT( std::fabs( space.forward().dot( space.side() ) ) <= tolerance );
+        CPPUNIT_ASSERT( std::fabs( space.forward().dot( space.up() ) ) <= tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, space.up().y, 0.0001f );
+    }
+
+    // The side drifts by about 0.001 per update, regenerated every tenth.
+    CPPUNIT_ASSERT( regenerations < 150 );
+    CPPUNIT_ASSERT( regenerations > 50 );
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testLazyRegenerationOfReversedForward()
+{
+    LocalSpace space;
+    Vec3 const side = space.side();
+
+    CPPUNIT_ASSERT( space.lazyRegenerateOrthonormalBasisUF( -space.forward(), 0.5f ) );
+    CPPUNIT_ASSERT( Vec3::distance( space.side(), -side ) < 0.00001f );
+    CPPUNIT_ASSERT( Vec3::distance( space.up(), Vec3::up ) < 0.00001f );
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testBatchTransformations()
+{
+    LocalSpace space;
+    space.setPosition( Vec3( 3.0f, -1.0f, 7.0f ) );
+    space.regenerateOrthonormalBasis( Vec3( 0.3f, 0.2f, 1.0f ), Vec3( 0.1f, 1.0f, 0.0f ) );
+
+    // Not a multiple of four to cover the scalar remainder.
+    size_t const count = 11;
+    Vec3 points[ count ];
+    for ( size_t i = 0; i < count; ++i ) {
+        points[ i ] = Vec3( i * 0.5f - 2.0f, i * 0.25f, 10.0f - i );
+    }
+
+    Vec3 globals[ count ];
+    space.globalizePositions( points, globals, count );
+    for ( size_t i = 0; i < count; ++i ) {
+        CPPUNIT_ASSERT( globals[ i ] == space.globalizePosition( points[ i ] ) );
+    }
+
+    Vec3 locals[ count ];
+    space.localizePositions( globals, locals, count );
+    for ( size_t i = 0; i < count; ++i ) {
+        // The dot products of Vec3A add up in a different order.
+        CPPUNIT_ASSERT( Vec3::distance( locals[ i ], space.localizePosition( globals[ i ] ) ) < 0.00001f );
+        CPPUNIT_ASSERT( Vec3::distance( locals[ i ], points[ i ] ) < 0.0001f );
+    }
+
+    // In place.
+    space.globalizePositions( points, points, count );
+    for ( size_t i = 0; i < count; ++i ) {
+        CPPUNIT_ASSERT( points[ i ] == globals[ i ] );
+    }
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testGlobalizePositionGrid()
+{
+    LocalSpace space;
+    space.setPosition( Vec3( -4.0f, 0.0f, 2.0f ) );
+    space.regenerateOrthonormalBasisUF( headingOnXZPlane( 0.7f ) );
+
+    Vec3 const origin( -1.0f, 0.0f, -2.5f );
+    Vec3 const rowStep( 0.25f, 0.0f, 0.0f );
+    Vec3 const columnStep( 0.0f, 0.0f, 0.25f );
+    size_t const rowCount = 9;
+    size_t const columnCount = 21;
+
+    Vec3 samples[ rowCount * columnCount ];
+    space.globalizePositionGrid( origin, rowStep, rowCount, columnStep, columnCount, samples );
+
+    for ( size_t row = 0; row < rowCount; ++row ) {
+        for ( size_t column = 0; column < columnCount; ++column ) {
+            Vec3 const local = origin + rowStep * static_cast< float >( row ) + columnStep * static_cast< float >( column );
+            Vec3 const expected = space.globalizePosition( local );
+            CPPUNIT_ASSERT( Vec3::distance( samples[ row * columnCount + column ], expected ) < 0.0001f );
+        }
+    }
+}
+
+
+
+void
+OpenSteer::LocalSpaceTest::testGlobalizeEmptyPositionGrid()
+{
+    LocalSpace space;
+    space.setPosition( Vec3( -4.0f, 0.0f, 2.0f ) );
+    space.regenerateOrthonormalBasisUF( headingOnXZPlane( 0.7f ) );
+
+    Vec3 const origin( -1.0f, 0.0f, -2.5f );
+    Vec3 const rowStep( 0.25f, 0.0f, 0.0f );
+    Vec3 const columnStep( 0.0f, 0.0f, 0.25f );
+    Vec3 const untouched( 1.0f, 2.0f, 3.0f );
+
+    // An empty z range gives rows without columns, an empty x range no rows.
+    Vec3 samples[ 4 ] = { untouched, untouched, untouched, untouched };
+    space.globalizePositionGrid( origin, rowStep, 4, columnStep, 0, samples );
+    space.globalizePositionGrid( origin, rowStep, 0, columnStep, 4, samples );
+    space.globalizePositionGrid( origin, rowStep, 0, columnStep, 0, samples );
+
+    for ( size_t i = 0; i < 4; ++i ) {
+        CPPUNIT_ASSERT( samples[ i ] == untouched );
+    }
+}
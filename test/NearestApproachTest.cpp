@@ -0,0 +1,203 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "NearestApproachTest.h"
+
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::NearestApproachTest );
+
+
+
+OpenSteer::NearestApproachTest::NearestApproachTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::NearestApproachTest::~NearestApproachTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::testEmptyBatch()
+{
+    NearestApproachBatch const neighbors;
+    NearestApproach approach;
+
+    CPPUNIT_ASSERT( neighbors.empty() );
+    CPPUNIT_ASSERT( ! findMostImminentApproach( Vec3::zero, Vec3( 1.0f, 0.0f, 0.0f ), neighbors, 1.0f, 10.0f, approach ) );
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::testCompareWithScalarPrediction()
+{
+    RandomGenerator random( 42 );
+    NearestApproachBatch neighbors;
+
+    float const collisionDistance = 1.0f;
+    float const maxTime = 3.0f;
+    size_t threatsFound = 0;
+
+    // Crowds of all sizes around one vehicle, also sizes that aren't a
+    // multiple of the batch width.
+    for ( size_t round = 0; round < 400; ++round ) {
+        Vec3 const position( random.vectorOnUnitRadiusXZDisk() * 5.0f );
+        Vec3 const velocity( random.unitVectorOnXZPlane() * random.random2( 0.0f, 2.0f ) );
+
+        neighbors.clear();
+        size_t const count = round % 41;
+        for ( size_t i = 0; i < count; ++i ) {
+            neighbors.add( random.vectorOnUnitRadiusXZDisk() * 8.0f,
+                           random.unitVectorOnXZPlane() * random.random2( 0.0f, 2.0f ) );
+        }
+
+        float expectedTime = 0.0f;
+        size_t const expectedIndex = findMostImminentApproachScalar( position, velocity, neighbors, collisionDistance, maxTime, expectedTime );
+
+        NearestApproach approach;
+        bool const found = findMostImminentApproach( position, velocity, neighbors, collisionDistance, maxTime, approach );
+
+        CPPUNIT_ASSERT_EQUAL( expectedIndex != count, found );
+        if ( found ) {
+            ++threatsFound;
+            CPPUNIT_ASSERT_EQUAL( expectedIndex, approach.index );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expectedTime, approach.time, 0.0001f );
+            CPPUNIT_ASSERT( approach.distance < collisionDistance );
+            CPPUNIT_ASSERT( ( approach.ourPosition - ( position + velocity * approach.time ) ).length() < 0.0001f );
+        }
+    }
+
+    // The scenario has to produce threats to test anything.
+    CPPUNIT_ASSERT( threatsFound > 100 );
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::testParallelPaths()
+{
+    Vec3 const velocity( 1.0f, 0.0f, 0.0f );
+    NearestApproachBatch neighbors;
+    neighbors.add( Vec3( 0.0f, 0.0f, 3.0f ), velocity );
+    neighbors.add( Vec3( 0.0f, 0.0f, 0.5f ), velocity );
+
+    // Parallel paths keep their distance, the near one is a threat now.
+    NearestApproach approach;
+    CPPUNIT_ASSERT( findMostImminentApproach( Vec3::zero, velocity, neighbors, 1.0f, 10.0f, approach ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), approach.index );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, approach.time, 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5f, approach.distance, 0.0001f );
+}
+
+
+
+void
+OpenSteer::NearestApproachTest::testFirstOfEquallySoonThreats()
+{
+    NearestApproachBatch neighbors;
+    neighbors.add( Vec3( 0.0f, 0.0f, 50.0f ), Vec3::zero );
+    for ( size_t i = 0; i < 2 * NearestApproachBatch::width; ++i ) {
+        neighbors.add( Vec3( 10.0f, 0.0f, 0.0f ), Vec3::zero );
+    }
+
+    NearestApproach approach;
+    CPPUNIT_ASSERT( findMostImminentApproach( Vec3::zero, Vec3( 2.0f, 0.0f, 0.0f ), neighbors, 1.0f, 10.0f, approach ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), approach.index );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0f, approach.time, 0.0001f );
+
+    // Not looking far enough into the future.
+    CPPUNIT_ASSERT( ! findMostImminentApproach( Vec3::zero, Vec3( 2.0f, 0.0f, 0.0f ), neighbors, 1.0f, 5.0f, approach ) );
+}
+
+
+
+OpenSteer::size_t
+OpenSteer::NearestApproachTest::findMostImminentApproachScalar( Vec3 const& position,
+                                                                Vec3 const& velocity,
+                                                                NearestApproachBatch const& neighbors,
+                                                                float collisionDistance,
+                                                                float maxTime,
+                                                                float& time )
+{
+    size_t threat = neighbors.size();
+    float minTime = maxTime;
+
+    for ( size_t i = 0; i < neighbors.size(); ++i ) {
+        // predictNearestApproachTime
+        Vec3 const relVelocity = neighbors.velocity( i ) - velocity;
+        float const relSpeed = relVelocity.length();
+        float neighborTime = 0.0f;
+        if ( relSpeed != 0.0f ) {
+            Vec3 const relTangent = relVelocity / relSpeed;
+            Vec3 const relPosition = position - neighbors.position( i );
+            neighborTime = relTangent.dot( relPosition ) / relSpeed;
+        }
+
+        if ( ( neighborTime >= 0.0f ) && ( neighborTime < minTime ) ) {
+            // computeNearestApproachPositions
+            Vec3 const ourFinal = position + velocity * neighborTime;
+            Vec3 const neighborFinal = neighbors.position( i ) + neighbors.velocity( i ) * neighborTime;
+            if ( Vec3::distance( ourFinal, neighborFinal ) < collisionDistance ) {
+                minTime = neighborTime;
+                threat = i;
+            }
+        }
+    }
+
+    time = minTime;
+    return threat;
+}
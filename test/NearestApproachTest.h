@@ -0,0 +1,98 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::findMostImminentApproach.
+ */
+
+#ifndef OPENSTEER_NEARESTAPPROACHTEST_H
+#define OPENSTEER_NEARESTAPPROACHTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+// Include OpenSteer::NearestApproachBatch
+#include "OpenSteer/NearestApproach.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class NearestApproachTest : public CppUnit::TestFixture {
+    public:
+        NearestApproachTest();
+        virtual ~NearestApproachTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(NearestApproachTest);
+        CPPUNIT_TEST(testEmptyBatch);
+        CPPUNIT_TEST(testCompareWithScalarPrediction);
+        CPPUNIT_TEST(testParallelPaths);
+        CPPUNIT_TEST(testFirstOfEquallySoonThreats);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        NearestApproachTest( NearestApproachTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        NearestApproachTest& operator=( NearestApproachTest );
+
+    private:
+        void testEmptyBatch();
+        void testCompareWithScalarPrediction();
+        void testParallelPaths();
+        void testFirstOfEquallySoonThreats();
+
+        /**
+         * Neighbor by neighbor search of @c steerToAvoidNeighbors before it
+         * used the batch, returns the neighbor count if there is no threat.
+         */
+        static size_t findMostImminentApproachScalar( Vec3 const& position,
+                                                      Vec3 const& velocity,
+                                                      NearestApproachBatch const& neighbors,
+                                                      float collisionDistance,
+                                                      float maxTime,
+                                                      float& time );
+
+    }; // NearestApproachTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_NEARESTAPPROACHTEST_H
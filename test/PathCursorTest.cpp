@@ -0,0 +1,185 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ */
+#include "PathCursorTest.h"
+
+
+// Include std::sin, std::cos, std::fabs
+#include <cmath>
+
+// Include OpenSteer::PathCursor
+#include "OpenSteer/PathCursor.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PathCursorTest );
+
+
+OpenSteer::size_t const OpenSteer::PathCursorTest::pointCount_;
+float const OpenSteer::PathCursorTest::radius_ = 2.0f;
+
+
+
+OpenSteer::PathCursorTest::PathCursorTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathCursorTest::~PathCursorTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::PathCursorTest::setUp()
+{
+    TestFixture::setUp();
+
+    // Wobbly circle in the XZ plane, its segments don't overlap.
+    for ( size_t i = 0; i < pointCount_; ++i ) {
+        float const angle = ( 6.2831853f * i ) / pointCount_;
+        float const r = 30.0f + ( i % 3 );
+        points_[ i ] = Vec3( std::cos( angle ) * r, 0.0f, std::sin( angle ) * r );
+    }
+}
+
+
+
+void
+OpenSteer::PathCursorTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::PathCursorTest::testCompareWithGlobalSearch()
+{
+    compareWithGlobalSearch( false );
+}
+
+
+
+void
+OpenSteer::PathCursorTest::testCompareWithGlobalSearchCyclicPath()
+{
+    compareWithGlobalSearch( true );
+}
+
+
+
+void
+OpenSteer::PathCursorTest::testJump()
+{
+    PolylineSegmentedPathwaySingleRadius const pathway( pointCount_, points_, radius_, false );
+    PathCursor cursor( 5.0f );
+
+    cursor.track( pathway, points_[ 1 ] );
+    CPPUNIT_ASSERT( cursor.isValid() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), cursor.globalSearchCount() );
+
+    // A small step is answered locally.
+    cursor.track( pathway, points_[ 1 ] + Vec3( 0.5f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), cursor.globalSearchCount() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), cursor.localSearchCount() );
+
+    // Jumping to the other side of the circle requires a global search.
+    Vec3 const farPoint( points_[ pointCount_ / 2 ] );
+    float const distance = cursor.track( pathway, farPoint );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), cursor.globalSearchCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( pathway.mapPointToPathDistance( farPoint ), distance, 0.001f );
+
+    cursor.reset();
+    CPPUNIT_ASSERT( ! cursor.isValid() );
+}
+
+
+
+float
+OpenSteer::PathCursorTest::pathDistanceDifference( Pathway const& pathway, float lhs, float rhs )
+{
+    // On cyclic pathways the start and the end point are the same.
+    float difference = std::fabs( lhs - rhs );
+    if ( pathway.isCyclic() && ( difference > 0.5f * pathway.length() ) ) {
+        difference = pathway.length() - difference;
+    }
+    return difference;
+}
+
+
+
+void
+OpenSteer::PathCursorTest::compareWithGlobalSearch( bool cyclic )
+{
+    PolylineSegmentedPathwaySingleRadius const pathway( pointCount_, points_, radius_, cyclic );
+    PathCursor cursor;
+
+    float const tolerance = 0.001f;
+    float const pathLength = pathway.length();
+
+    // Walk along the pathway wobbling around its center line, twice around
+    // the cyclic one.
+    float const stepLength = cyclic ? 0.5f : 0.2f;
+    for ( size_t step = 0; step < 800; ++step ) {
+        float const distanceOnPath = stepLength * step;
+        Vec3 const wobble( std::sin( 0.1f * step ), 0.0f, std::cos( 0.13f * step ) );
+        Vec3 const point( pathway.mapPathDistanceToPoint( distanceOnPath ) + wobble * 1.5f );
+
+        float const trackedDistance = cursor.track( pathway, point );
+        float const expectedDistance = pathway.mapPointToPathDistance( point );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, pathDistanceDifference( pathway, expectedDistance, trackedDistance ), tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( trackedDistance, cursor.pathDistance(), tolerance );
+
+        Vec3 const futurePoint( point + Vec3( 3.0f, 0.0f, 1.0f ) );
+        Vec3 tangent( 0.0f, 0.0f, 0.0f );
+        Vec3 expectedTangent( 0.0f, 0.0f, 0.0f );
+        float outside = 0.0f;
+        float expectedOutside = 0.0f;
+        float futureDistance = 0.0f;
+        Vec3 const onPath = cursor.mapPointToPath( pathway, futurePoint, tangent, outside, futureDistance );
+        Vec3 const expectedOnPath = pathway.mapPointToPath( futurePoint, expectedTangent, expectedOutside );
+        CPPUNIT_ASSERT( ( onPath - expectedOnPath ).length() < tolerance );
+        CPPUNIT_ASSERT( ( tangent - expectedTangent ).length() < tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expectedOutside, outside, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, pathDistanceDifference( pathway, pathway.mapPointToPathDistance( futurePoint ), futureDistance ), tolerance );
+
+        float const targetDistance = trackedDistance + ( 0.1f * pathLength );
+        Vec3 const target = cursor.mapPathDistanceToPoint( pathway, targetDistance );
+        Vec3 const expectedTarget = pathway.mapPathDistanceToPoint( targetDistance );
+        CPPUNIT_ASSERT( ( target - expectedTarget ).length() < tolerance );
+    }
+
+    // Most queries must have been answered locally.
+    CPPUNIT_ASSERT( cursor.localSearchCount() > 10 * cursor.globalSearchCount() );
+}
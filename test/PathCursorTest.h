@@ -0,0 +1,95 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PathCursor.
+ */
+
+#ifndef OPENSTEER_PATHCURSORTEST_H
+#define OPENSTEER_PATHCURSORTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+// Include OpenSteer::Pathway
+#include "OpenSteer/Pathway.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class PathCursorTest : public CppUnit::TestFixture {
+    public:
+        PathCursorTest();
+        virtual ~PathCursorTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(PathCursorTest);
+        CPPUNIT_TEST(testCompareWithGlobalSearch);
+        CPPUNIT_TEST(testCompareWithGlobalSearchCyclicPath);
+        CPPUNIT_TEST(testJump);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathCursorTest( PathCursorTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathCursorTest& operator=( PathCursorTest );
+
+    private:
+        void testCompareWithGlobalSearch();
+        void testCompareWithGlobalSearchCyclicPath();
+        void testJump();
+
+        void compareWithGlobalSearch( bool cyclic );
+        static float pathDistanceDifference( Pathway const& pathway, float lhs, float rhs );
+
+        static size_t const pointCount_ = 24;
+        static float const radius_;
+        Vec3 points_[ pointCount_ ];
+
+    }; // PathCursorTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_PATHCURSORTEST_H
@@ -0,0 +1,294 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "ProfilerTest.h"
+
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include std::strcmp
+#include <cstring>
+
+// Include OpenSteer::Profiler, OpenSteer::ProfileZone
+#include "OpenSteer/Profiler.h"
+
+// Include OpenSteer::ThreadPool
+#include "OpenSteer/ThreadPool.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ProfilerTest );
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    size_t const notFound = static_cast< size_t >( -1 );
+
+    /**
+     * Returns the index of the zone named @a name in @a statistics or
+     * @c notFound.
+     */
+    size_t findZone( std::vector< ProfileZoneStatistics > const& statistics, char const* name )
+    {
+        for ( size_t i = 0; i < statistics.size(); ++i ) {
+            if ( 0 == std::strcmp( statistics[ i ].name, name ) ) {
+                return i;
+            }
+        }
+        return notFound;
+    }
+
+
+    /**
+     * Keeps the calling thread busy for a moment.
+     */
+    float spin( size_t iterations )
+    {
+        volatile float sum = 0.0f;
+        for ( size_t i = 0; i < iterations; ++i ) {
+            sum = sum + 1.0f;
+        }
+        return sum;
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::ProfilerTest::ProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ProfilerTest::~ProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::ProfilerTest::setUp()
+{
+    TestFixture::setUp();
+    Profiler::setEnabled( true );
+    Profiler::resetStatistics();
+}
+
+
+
+void
+OpenSteer::ProfilerTest::tearDown()
+{
+    Profiler::setEnabled( false );
+    Profiler::setTraceRecording( false );
+    Profiler::clearTrace();
+    Profiler::resetStatistics();
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testDisabledProfilerRecordsNothing()
+{
+    Profiler::setEnabled( false );
+    {
+        ProfileZone const zone( "ProfilerTest disabled" );
+        spin( 1000 );
+    }
+    Profiler::endFrame();
+
+    CPPUNIT_ASSERT_EQUAL( notFound, findZone( Profiler::statistics(), "ProfilerTest disabled" ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), Profiler::frameCount() );
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testNestedZonesFormHierarchy()
+{
+    for ( size_t frame = 0; frame < 3; ++frame ) {
+        ProfileZone const outer( "ProfilerTest outer" );
+        {
+            ProfileZone const inner( "ProfilerTest inner" );
+        }
+        {
+            ProfileZone const inner( "ProfilerTest inner" );
+        }
+    }
+    {
+        // Same name, different parent: a zone of its own.
+        ProfileZone const inner( "ProfilerTest inner" );
+    }
+    Profiler::endFrame();
+
+    std::vector< ProfileZoneStatistics > const statistics = Profiler::statistics();
+    size_t const outer = findZone( statistics, "ProfilerTest outer" );
+    CPPUNIT_ASSERT( notFound != outer );
+    CPPUNIT_ASSERT( outer + 1 < statistics.size() );
+
+    // Nested zones directly follow their parent.
+    ProfileZoneStatistics const& nested = statistics[ outer + 1 ];
+    CPPUNIT_ASSERT_EQUAL( std::string( "ProfilerTest inner" ), std::string( nested.name ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), statistics[ outer ].depth );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), nested.depth );
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), statistics[ outer ].calls );
+    CPPUNIT_ASSERT_EQUAL( size_t( 6 ), nested.calls );
+
+    size_t outermostInnerCalls = 0;
+    for ( size_t i = 0; i < statistics.size(); ++i ) {
+        if ( ( 0 == statistics[ i ].depth ) && ( std::string( "ProfilerTest inner" ) == statistics[ i ].name ) ) {
+            outermostInnerCalls += statistics[ i ].calls;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), outermostInnerCalls );
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testSelfTimeExcludesNestedZones()
+{
+    {
+        ProfileZone const outer( "ProfilerTest self outer" );
+        spin( 100000 );
+        {
+            ProfileZone const inner( "ProfilerTest self inner" );
+            spin( 100000 );
+        }
+    }
+    Profiler::endFrame();
+
+    std::vector< ProfileZoneStatistics > const statistics = Profiler::statistics();
+    size_t const outer = findZone( statistics, "ProfilerTest self outer" );
+    size_t const inner = findZone( statistics, "ProfilerTest self inner" );
+    CPPUNIT_ASSERT( notFound != outer );
+    CPPUNIT_ASSERT( notFound != inner );
+
+    CPPUNIT_ASSERT( statistics[ inner ].seconds > 0.0 );
+    CPPUNIT_ASSERT( statistics[ outer ].selfSeconds > 0.0 );
+    CPPUNIT_ASSERT( statistics[ outer ].selfSeconds < statistics[ outer ].seconds );
+    CPPUNIT_ASSERT_EQUAL( statistics[ inner ].seconds, statistics[ inner ].selfSeconds );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( statistics[ outer ].seconds,
+                                  statistics[ outer ].selfSeconds + statistics[ inner ].seconds,
+                                  1.0e-9 );
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testThreadPoolTasksNestInCallingZone()
+{
+    ThreadPool pool( 3 );
+    for ( size_t frame = 0; frame < 4; ++frame ) {
+        {
+            ProfileZone const zone( "ProfilerTest parallel" );
+            pool.parallelFor( 64, []( size_t begin, size_t end ) {
+                for ( size_t i = begin; i < end; ++i ) {
+                    ProfileZone const task( "ProfilerTest task" );
+                    spin( 100 );
+                }
+            } );
+        }
+        Profiler::endFrame();
+    }
+
+    std::vector< ProfileZoneStatistics > const statistics = Profiler::statistics();
+    size_t const parallel = findZone( statistics, "ProfilerTest parallel" );
+    CPPUNIT_ASSERT( notFound != parallel );
+    CPPUNIT_ASSERT( parallel + 1 < statistics.size() );
+
+    // All task zones, on whichever thread they ran, count as nested.
+    ProfileZoneStatistics const& task = statistics[ parallel + 1 ];
+    CPPUNIT_ASSERT_EQUAL( std::string( "ProfilerTest task" ), std::string( task.name ) );
+    CPPUNIT_ASSERT_EQUAL( statistics[ parallel ].depth + 1, task.depth );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), statistics[ parallel ].calls );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 * 64 ), task.calls );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), Profiler::frameCount() );
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testResetStatistics()
+{
+    {
+        ProfileZone const zone( "ProfilerTest reset" );
+    }
+    Profiler::endFrame();
+    CPPUNIT_ASSERT( notFound != findZone( Profiler::statistics(), "ProfilerTest reset" ) );
+
+    Profiler::resetStatistics();
+    CPPUNIT_ASSERT_EQUAL( notFound, findZone( Profiler::statistics(), "ProfilerTest reset" ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), Profiler::frameCount() );
+}
+
+
+
+void
+OpenSteer::ProfilerTest::testChromeTraceListsZoneCalls()
+{
+    Profiler::clearTrace();
+    Profiler::setTraceRecording( true );
+    {
+        ProfileZone const zone( "ProfilerTest \"trace\"" );
+    }
+    Profiler::endFrame();
+    Profiler::setTraceRecording( false );
+
+    // Not recording anymore.
+    {
+        ProfileZone const zone( "ProfilerTest \"trace\"" );
+    }
+    Profiler::endFrame();
+
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), Profiler::traceEventCount() );
+
+    std::ostringstream stream;
+    Profiler::writeChromeTrace( stream );
+    std::string const trace = stream.str();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), trace.find( "{\"traceEvents\":[" ) );
+    CPPUNIT_ASSERT( std::string::npos != trace.find( "\"name\":\"ProfilerTest \\\"trace\\\"\"" ) );
+    CPPUNIT_ASSERT( std::string::npos != trace.find( "\"ph\":\"X\"" ) );
+    CPPUNIT_ASSERT( std::string::npos != trace.find( "\"thread_name\"" ) );
+}
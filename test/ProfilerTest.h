@@ -0,0 +1,84 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Profiler.
+ */
+
+#ifndef OPENSTEER_PROFILERTEST_H
+#define OPENSTEER_PROFILERTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+
+
+    class ProfilerTest : public CppUnit::TestFixture {
+    public:
+        ProfilerTest();
+        virtual ~ProfilerTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(ProfilerTest);
+        CPPUNIT_TEST(testDisabledProfilerRecordsNothing);
+        CPPUNIT_TEST(testNestedZonesFormHierarchy);
+        CPPUNIT_TEST(testSelfTimeExcludesNestedZones);
+        CPPUNIT_TEST(testThreadPoolTasksNestInCallingZone);
+        CPPUNIT_TEST(testResetStatistics);
+        CPPUNIT_TEST(testChromeTraceListsZoneCalls);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProfilerTest( ProfilerTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProfilerTest& operator=( ProfilerTest );
+
+    private:
+        void testDisabledProfilerRecordsNothing();
+        void testNestedZonesFormHierarchy();
+        void testSelfTimeExcludesNestedZones();
+        void testThreadPoolTasksNestInCallingZone();
+        void testResetStatistics();
+        void testChromeTraceListsZoneCalls();
+
+    }; // ProfilerTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_PROFILERTEST_H
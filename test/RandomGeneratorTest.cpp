@@ -0,0 +1,240 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "RandomGeneratorTest.h"
+
+
+// Include std::min, std::max
+#include <algorithm>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::RandomGeneratorTest );
+
+
+
+namespace {
+
+    using OpenSteer::RandomGenerator;
+    using OpenSteer::Vec3;
+    using OpenSteer::size_t;
+
+    size_t const drawCount = 1000;
+    float const tolerance = 0.0001f;
+
+} // anonymous namespace
+
+
+
+OpenSteer::RandomGeneratorTest::RandomGeneratorTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::RandomGeneratorTest::~RandomGeneratorTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::testSeedReproducesStream()
+{
+    RandomGenerator first( 42 );
+    RandomGenerator second( 42 );
+    std::vector< RandomGenerator::result_type > values;
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        values.push_back( first.next() );
+        CPPUNIT_ASSERT( values.back() == second.next() );
+    }
+
+    // Seeding again restarts the stream.
+    first.seed( 42 );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT( values[ i ] == first.next() );
+    }
+
+    // So do copies, they continue independently.
+    first.seed( 42 );
+    first.next();
+    RandomGenerator copy( first );
+    CPPUNIT_ASSERT( values[ 1 ] == copy.next() );
+    CPPUNIT_ASSERT( values[ 1 ] == first.next() );
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::testDifferentSeedsGiveDifferentStreams()
+{
+    // Consecutive seeds like vehicle serial numbers.
+    RandomGenerator first( 7 );
+    RandomGenerator second( 8 );
+    size_t equal = 0;
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        if ( first.next() == second.next() ) {
+            ++equal;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), equal );
+
+    // The default seed is zero.
+    RandomGenerator defaultSeeded;
+    RandomGenerator zeroSeeded( 0 );
+    CPPUNIT_ASSERT( defaultSeeded.next() == zeroSeeded.next() );
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::testRanges()
+{
+    RandomGenerator random( 1 );
+    float minimum = 1.0f;
+    float maximum = 0.0f;
+    float sum = 0.0f;
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        float const value = random.random01();
+        CPPUNIT_ASSERT( 0.0f <= value && value < 1.0f );
+        minimum = std::min( minimum, value );
+        maximum = std::max( maximum, value );
+        sum += value;
+    }
+
+    // Spread over the whole interval.
+    CPPUNIT_ASSERT( minimum < 0.01f );
+    CPPUNIT_ASSERT( maximum > 0.99f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5f, sum / drawCount, 0.05f );
+
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        float const value = random.random2( -3.0f, 5.0f );
+        CPPUNIT_ASSERT( -3.0f <= value && value < 5.0f );
+
+        float const walk = random.randomWalk( 0.9f, 0.5f, -1.0f, 1.0f );
+        CPPUNIT_ASSERT( 0.4f <= walk && walk <= 1.0f );
+
+        Vec3 const inSphere = random.vectorInUnitRadiusSphere();
+        CPPUNIT_ASSERT( inSphere.lengthSquared() < 1.0f );
+
+        Vec3 const onDisk = random.vectorOnUnitRadiusXZDisk();
+        CPPUNIT_ASSERT( onDisk.lengthSquared() < 1.0f );
+        CPPUNIT_ASSERT_EQUAL( 0.0f, onDisk.y );
+    }
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::testUnitVectors()
+{
+    RandomGenerator random( 2 );
+    Vec3 sum = Vec3::zero;
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        Vec3 const direction = random.unitVector();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, direction.length(), tolerance );
+        sum += direction;
+
+        Vec3 const onPlane = random.unitVectorOnXZPlane();
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, onPlane.length(), tolerance );
+        CPPUNIT_ASSERT_EQUAL( 0.0f, onPlane.y );
+    }
+
+    // No preferred direction.
+    CPPUNIT_ASSERT( ( sum / drawCount ).length() < 0.1f );
+}
+
+
+
+void
+OpenSteer::RandomGeneratorTest::testBatchEqualsScalar()
+{
+    RandomGenerator scalar( 3 );
+    RandomGenerator batch( 3 );
+
+    std::vector< float > values( drawCount );
+    batch.random01s( &values[ 0 ], drawCount );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( scalar.random01(), values[ i ] );
+    }
+
+    std::vector< Vec3 > vectors( drawCount );
+    batch.vectorsInUnitRadiusSphere( &vectors[ 0 ], drawCount );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT( scalar.vectorInUnitRadiusSphere() == vectors[ i ] );
+    }
+
+    batch.vectorsOnUnitRadiusXZDisk( &vectors[ 0 ], drawCount );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT( scalar.vectorOnUnitRadiusXZDisk() == vectors[ i ] );
+    }
+
+    // The unit vector batches normalize with a different kernel, see
+    // Vec3UtilitiesTest::testRandomUnitVectors for their SoA versions.
+    batch.unitVectors( &vectors[ 0 ], drawCount );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT( Vec3::distance( scalar.unitVector(), vectors[ i ] ) < tolerance );
+    }
+
+    batch.unitVectorsOnXZPlane( &vectors[ 0 ], drawCount );
+    for ( size_t i = 0; i < drawCount; ++i ) {
+        CPPUNIT_ASSERT( Vec3::distance( scalar.unitVectorOnXZPlane(), vectors[ i ] ) < tolerance );
+    }
+
+    // Both have drawn the same number of values.
+    CPPUNIT_ASSERT( scalar.next() == batch.next() );
+}
@@ -0,0 +1,195 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "ScratchBufferTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::thread
+#include <thread>
+
+// Include OpenSteer::ScratchBuffer, OpenSteer::scratchBufferAllocationCount
+#include "OpenSteer/ScratchBuffer.h"
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ScratchBufferTest );
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    /**
+     * Vehicle doing nothing on its own, steered by the test.
+     */
+    class TestVehicle : public HeadlessVehicle {
+    public:
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) {}
+    };
+
+} // anonymous namespace
+
+
+
+OpenSteer::ScratchBufferTest::ScratchBufferTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ScratchBufferTest::~ScratchBufferTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::testBorrowedBufferIsEmptyAndReused()
+{
+    std::vector< int >* first = 0;
+    {
+        ScratchBuffer< std::vector< int > > buffer;
+        CPPUNIT_ASSERT( buffer->empty() );
+        CPPUNIT_ASSERT( buffer->capacity() >= size_t( ScratchBuffer< std::vector< int > >::initialCapacity ) );
+        buffer->push_back( 1 );
+        buffer->push_back( 2 );
+        first = &*buffer;
+    }
+
+    size_t const allocations = scratchBufferAllocationCount();
+    {
+        ScratchBuffer< std::vector< int > > buffer;
+        CPPUNIT_ASSERT( first == &*buffer );
+        CPPUNIT_ASSERT( buffer->empty() );
+    }
+    CPPUNIT_ASSERT_EQUAL( allocations, scratchBufferAllocationCount() );
+
+    // Growing beyond the capacity is counted.
+    {
+        ScratchBuffer< std::vector< int > > buffer;
+        buffer->resize( buffer->capacity() + 1 );
+    }
+    CPPUNIT_ASSERT_EQUAL( allocations + 1, scratchBufferAllocationCount() );
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::testNestedBuffersAreDistinct()
+{
+    ScratchBuffer< std::vector< int > > outer;
+    outer->push_back( 1 );
+    {
+        ScratchBuffer< std::vector< int > > inner;
+        CPPUNIT_ASSERT( &*outer != &*inner );
+        CPPUNIT_ASSERT( inner->empty() );
+        inner->push_back( 2 );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), outer->size() );
+    CPPUNIT_ASSERT_EQUAL( 1, ( *outer )[ 0 ] );
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::testThreadsHaveOwnBuffers()
+{
+    ScratchBuffer< std::vector< int > > mine;
+    std::vector< int >* theirs = 0;
+
+    std::thread other( [ &theirs ]() {
+        ScratchBuffer< std::vector< int > > buffer;
+        theirs = &*buffer;
+    } );
+    other.join();
+
+    CPPUNIT_ASSERT( 0 != theirs );
+    CPPUNIT_ASSERT( &*mine != theirs );
+}
+
+
+
+void
+OpenSteer::ScratchBufferTest::testSteadyStateSteeringDoesNotAllocate()
+{
+    // A crowd on a grid heading into each other.
+    size_t const rowCount = 8;
+    std::vector< TestVehicle > vehicles( rowCount * rowCount );
+    AVGroup crowd;
+    for ( size_t i = 0; i < vehicles.size(); ++i ) {
+        TestVehicle& vehicle = vehicles[ i ];
+        vehicle.setPosition( Vec3( float( i % rowCount ), 0.0f, float( i / rowCount ) ) * 2.0f );
+        vehicle.regenerateOrthonormalBasisUF( ( i % 2 ) ? Vec3::forward : -Vec3::forward );
+        vehicle.setSpeed( vehicle.maxSpeed() );
+        crowd.push_back( &vehicle );
+    }
+
+    size_t allocations = 0;
+    for ( size_t frame = 0; frame < 4; ++frame ) {
+        allocations = scratchBufferAllocationCount();
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            ScratchBuffer< AVGroup > neighbors;
+            neighbors->assign( crowd.begin(), crowd.end() );
+            Vec3 const steering = vehicles[ i ].steerToAvoidNeighbors( 3.0f, *neighbors )
+                                + vehicles[ i ].steerForSeparation( 5.0f, -0.707f, *neighbors );
+            vehicles[ i ].applySteeringForce( steering, 0.1f );
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL( allocations, scratchBufferAllocationCount() );
+}
@@ -0,0 +1,294 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "SteeringCacheTest.h"
+
+
+// Include std::swap
+#include <algorithm>
+
+// Include OpenSteer::SteeringCache
+#include "OpenSteer/SteeringCache.h"
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SteeringCacheTest );
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    /**
+     * Vehicle doing nothing on its own, placed by the test.
+     */
+    class TestVehicle : public HeadlessVehicle {
+    public:
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) {}
+    };
+
+
+    float const positionTolerance = 0.25f;
+    float const headingTolerance = 0.05f;
+    size_t const maxAge = 3;
+
+
+    /**
+     * Vehicle at the origin with two neighbors, all positions in the
+     * middle of their quantization cells.
+     */
+    class Neighborhood {
+    public:
+        Neighborhood() {
+            first.setPosition( Vec3( 2.1f, 0.0f, 0.6f ) );
+            second.setPosition( Vec3( -1.1f, 0.0f, 3.1f ) );
+            neighbors.push_back( &vehicle );
+            neighbors.push_back( &first );
+            neighbors.push_back( &second );
+        }
+
+        TestVehicle vehicle;
+        TestVehicle first;
+        TestVehicle second;
+        AVGroup neighbors;
+    };
+
+
+    /**
+     * Misses and stores @a force, asserting the miss.
+     */
+    void fill( SteeringCache& cache, Neighborhood const& neighborhood, Vec3 const& force ) {
+        Vec3 cached;
+        CPPUNIT_ASSERT( ! cache.lookup( neighborhood.vehicle, neighborhood.neighbors, cached ) );
+        cache.store( force );
+    }
+
+
+    bool hits( SteeringCache& cache, Neighborhood const& neighborhood ) {
+        Vec3 cached;
+        return cache.lookup( neighborhood.vehicle, neighborhood.neighbors, cached );
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::SteeringCacheTest::SteeringCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SteeringCacheTest::~SteeringCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testDisabledByDefault()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache;
+    CPPUNIT_ASSERT( ! cache.enabled() );
+
+    cache.store( Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( ! hits( cache, neighborhood ) );
+    CPPUNIT_ASSERT( ! hits( cache, neighborhood ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.hits() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.misses() );
+
+    cache.setEnabled( true );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testHitOnUnchangedNeighborhood()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, maxAge );
+    Vec3 const force( 1.0f, 2.0f, 3.0f );
+    fill( cache, neighborhood, force );
+
+    Vec3 cached;
+    CPPUNIT_ASSERT( cache.lookup( neighborhood.vehicle, neighborhood.neighbors, cached ) );
+    CPPUNIT_ASSERT( force == cached );
+
+    // The order of the neighbors doesn't matter.
+    std::swap( neighborhood.neighbors[ 1 ], neighborhood.neighbors[ 2 ] );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testMissOnAddedOrRemovedNeighbor()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, maxAge );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+
+    TestVehicle third;
+    third.setPosition( Vec3( 0.6f, 0.0f, -2.1f ) );
+    neighborhood.neighbors.push_back( &third );
+    fill( cache, neighborhood, Vec3( 2.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    neighborhood.neighbors.erase( neighborhood.neighbors.begin() + 1 );
+    fill( cache, neighborhood, Vec3( 3.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testMissOnMovePastTolerance()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, 0 );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+
+    // Moving within the quantization cell keeps the result.
+    neighborhood.first.setPosition( Vec3( 2.2f, 0.0f, 0.6f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    // Moving past the cell boundary doesn't.
+    neighborhood.first.setPosition( Vec3( 2.3f, 0.0f, 0.6f ) );
+    fill( cache, neighborhood, Vec3( 2.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    // Neither does the steering vehicle turning or speeding up.
+    neighborhood.vehicle.regenerateOrthonormalBasisUF( Vec3( 1.0f, 0.0f, 1.0f ).normalize() );
+    fill( cache, neighborhood, Vec3( 3.0f, 0.0f, 0.0f ) );
+    neighborhood.vehicle.setSpeed( 1.0f );
+    fill( cache, neighborhood, Vec3( 4.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testExpiryAfterMaxAge()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, maxAge );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+
+    for ( size_t i = 0; i < maxAge; ++i ) {
+        CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+    }
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    // Without age limit the result is kept for good.
+    cache.setMaxAge( 0 );
+    for ( size_t i = 0; i < 10 * maxAge; ++i ) {
+        CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+    }
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testInvalidate()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, maxAge );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    cache.invalidate();
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+
+    // Changing a tolerance invalidates as well.
+    cache.setPositionTolerance( 0.5f );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    cache.setHeadingTolerance( 0.1f );
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+}
+
+
+
+void
+OpenSteer::SteeringCacheTest::testCounters()
+{
+    Neighborhood neighborhood;
+    SteeringCache cache( positionTolerance, headingTolerance, maxAge );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.hits() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.misses() );
+
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), cache.hits() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), cache.misses() );
+
+    // Invalidating keeps the counters.
+    cache.invalidate();
+    fill( cache, neighborhood, Vec3( 1.0f, 0.0f, 0.0f ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), cache.hits() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), cache.misses() );
+
+    cache.resetCounters();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.hits() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), cache.misses() );
+    CPPUNIT_ASSERT( hits( cache, neighborhood ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 1 ), cache.hits() );
+}
@@ -0,0 +1,432 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "ThreadPoolTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::atomic
+#include <atomic>
+
+// Include std::thread
+#include <thread>
+
+// Include OpenSteer::ThreadPool
+#include "OpenSteer/ThreadPool.h"
+
+// Include OpenSteer::TaskGraph
+#include "OpenSteer/TaskGraph.h"
+
+// Include OpenSteer::computeSteeringForces, OpenSteer::applySteeringForces
+#include "OpenSteer/ParallelUpdate.h"
+
+// Include OpenSteer::HeadlessVehicle
+#include "OpenSteer/HeadlessVehicle.h"
+
+// Include OpenSteer::AVGroup
+#include "OpenSteer/AbstractVehicle.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ThreadPoolTest );
+
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    /**
+     * Vehicle doing nothing on its own, steered by the test.
+     */
+    class TestVehicle : public HeadlessVehicle {
+    public:
+        void update( float const /* currentTime */, float const /* elapsedTime */ ) {}
+    };
+
+
+    /**
+     * Places the vehicles of @a vehicles on a grid, heading into each
+     * other, and collects them in @a crowd.
+     */
+    void makeCrowd( std::vector< TestVehicle >& vehicles, AVGroup& crowd )
+    {
+        size_t const rowCount = 8;
+        vehicles.resize( rowCount * rowCount );
+        crowd.clear();
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            TestVehicle& vehicle = vehicles[ i ];
+            vehicle.setPosition( Vec3( float( i % rowCount ), 0.0f, float( i / rowCount ) ) * 2.0f );
+            vehicle.regenerateOrthonormalBasisUF( ( i % 2 ) ? Vec3::forward : -Vec3::forward );
+            vehicle.setSpeed( vehicle.maxSpeed() );
+            crowd.push_back( &vehicle );
+        }
+    }
+
+
+    /**
+     * Runs @a frameCount two phase updates of @a crowd, steering with the
+     * threads of @a pool.
+     */
+    void simulate( ThreadPool* pool, AVGroup const& crowd, size_t frameCount )
+    {
+        std::vector< Vec3 > forces;
+        for ( size_t frame = 0; frame < frameCount; ++frame ) {
+            computeSteeringForces( pool, crowd, forces, [ &crowd ]( AbstractVehicle& vehicle ) {
+                TestVehicle& self = static_cast< TestVehicle& >( vehicle );
+                return self.steerToAvoidNeighbors( 3.0f, crowd )
+                     + self.steerForSeparation( 5.0f, -0.707f, crowd )
+                     + self.steerForCohesion( 9.0f, -0.15f, crowd );
+            } );
+            applySteeringForces( pool, crowd, [ &forces ]( AbstractVehicle& vehicle, size_t i ) {
+                static_cast< TestVehicle& >( vehicle ).applySteeringForce( forces[ i ], 0.1f );
+            }, []( AbstractVehicle&, size_t ) {} );
+        }
+    }
+
+} // anonymous namespace
+
+
+
+OpenSteer::ThreadPoolTest::ThreadPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ThreadPoolTest::~ThreadPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testParallelForCoversEveryIndexOnce()
+{
+    size_t const threadCounts[] = { 1, 2, 3, 8 };
+    size_t const counts[] = { 0, 1, 2, 7, 100, 1001 };
+
+    for ( size_t t = 0; t < sizeof( threadCounts ) / sizeof( threadCounts[ 0 ] ); ++t ) {
+        ThreadPool pool( threadCounts[ t ] );
+        CPPUNIT_ASSERT_EQUAL( threadCounts[ t ], pool.threadCount() );
+
+        for ( size_t c = 0; c < sizeof( counts ) / sizeof( counts[ 0 ] ); ++c ) {
+            std::vector< int > visits( counts[ c ], 0 );
+            pool.parallelFor( counts[ c ], [ &visits ]( size_t begin, size_t end ) {
+                for ( size_t i = begin; i < end; ++i ) {
+                    ++visits[ i ];
+                }
+            } );
+
+            for ( size_t i = 0; i < visits.size(); ++i ) {
+                CPPUNIT_ASSERT_EQUAL( 1, visits[ i ] );
+            }
+        }
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testParallelForRespectsGrainSize()
+{
+    ThreadPool pool( 3 );
+    std::vector< int > visits( 100, 0 );
+    std::atomic< size_t > calls( 0 );
+    std::atomic< size_t > oversizedCalls( 0 );
+
+    pool.parallelFor( visits.size(), [ & ]( size_t begin, size_t end ) {
+        ++calls;
+        if ( end - begin > 7 ) {
+            ++oversizedCalls;
+        }
+        for ( size_t i = begin; i < end; ++i ) {
+            ++visits[ i ];
+        }
+    }, 7 );
+
+    CPPUNIT_ASSERT_EQUAL( size_t( 15 ), size_t( calls ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), size_t( oversizedCalls ) );
+    for ( size_t i = 0; i < visits.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 1, visits[ i ] );
+    }
+
+    // Without a grain size every thread gets several chunks to share.
+    CPPUNIT_ASSERT_EQUAL( size_t( 1000 / ( 3 * ThreadPool::chunksPerThread ) ), pool.grainSize( 1000 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), pool.grainSize( 5 ) );
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testNestedParallelForCoversEveryIndexOnce()
+{
+    ThreadPool pool( 4 );
+    size_t const outerCount = 6;
+    size_t const innerCount = 50;
+    std::vector< int > visits( outerCount * innerCount, 0 );
+
+    pool.parallelFor( outerCount, [ & ]( size_t outerBegin, size_t outerEnd ) {
+        for ( size_t outer = outerBegin; outer < outerEnd; ++outer ) {
+            pool.parallelFor( innerCount, [ & ]( size_t begin, size_t end ) {
+                for ( size_t inner = begin; inner < end; ++inner ) {
+                    ++visits[ outer * innerCount + inner ];
+                }
+            }, 5 );
+        }
+    }, 1 );
+
+    for ( size_t i = 0; i < visits.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 1, visits[ i ] );
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testSetThreadCountRestartsWorkers()
+{
+    ThreadPool pool( 2 );
+    std::vector< int > visits( 100, 0 );
+    auto visit = [ &visits ]( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i ) {
+            ++visits[ i ];
+        }
+    };
+
+    pool.parallelFor( visits.size(), visit );
+    pool.setThreadCount( 5 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 5 ), pool.threadCount() );
+    pool.parallelFor( visits.size(), visit );
+    pool.parallelFor( visits.size(), visit );
+    pool.setThreadCount( 1 );
+    pool.parallelFor( visits.size(), visit );
+
+    for ( size_t i = 0; i < visits.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 4, visits[ i ] );
+    }
+
+    pool.setThreadCount( 0 );
+    CPPUNIT_ASSERT( pool.threadCount() >= 1 );
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testSteeringIndependentOfThreadCount()
+{
+    std::vector< TestVehicle > serialVehicles;
+    std::vector< TestVehicle > parallelVehicles;
+    AVGroup serialCrowd;
+    AVGroup parallelCrowd;
+    makeCrowd( serialVehicles, serialCrowd );
+    makeCrowd( parallelVehicles, parallelCrowd );
+
+    ThreadPool pool( 4 );
+    simulate( 0, serialCrowd, 20 );
+    simulate( &pool, parallelCrowd, 20 );
+
+    for ( size_t i = 0; i < serialVehicles.size(); ++i ) {
+        CPPUNIT_ASSERT( serialVehicles[ i ].position() == parallelVehicles[ i ].position() );
+        CPPUNIT_ASSERT( serialVehicles[ i ].forward() == parallelVehicles[ i ].forward() );
+        CPPUNIT_ASSERT( serialVehicles[ i ].speed() == parallelVehicles[ i ].speed() );
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testTaskGraphRespectsOrder()
+{
+    size_t const threadCounts[] = { 1, 4 };
+
+    for ( size_t t = 0; t < sizeof( threadCounts ) / sizeof( threadCounts[ 0 ] ); ++t ) {
+        ThreadPool pool( threadCounts[ t ] );
+
+        // A diamond followed by a chain: a -> b, a -> c, b -> d, c -> d,
+        // d -> e[ 0 ] -> e[ 1 ] -> ...
+        std::atomic< size_t > clock( 0 );
+        std::vector< size_t > finished( 16, 0 );
+        auto stamp = [ & ]( size_t task ) {
+            return [ &, task ]() { finished[ task ] = ++clock; };
+        };
+
+        TaskGraph graph;
+        for ( size_t i = 0; i < finished.size(); ++i ) {
+            CPPUNIT_ASSERT_EQUAL( i, graph.add( stamp( i ) ) );
+        }
+        graph.precede( 0, 1 );
+        graph.precede( 0, 2 );
+        graph.precede( 1, 3 );
+        graph.precede( 2, 3 );
+        for ( size_t i = 3; i + 1 < finished.size(); ++i ) {
+            graph.precede( i, i + 1 );
+        }
+
+        // Run twice to check the graph can be reused.
+        for ( size_t run = 0; run < 2; ++run ) {
+            clock = 0;
+            pool.run( graph );
+
+            CPPUNIT_ASSERT( finished[ 0 ] < finished[ 1 ] );
+            CPPUNIT_ASSERT( finished[ 0 ] < finished[ 2 ] );
+            CPPUNIT_ASSERT( finished[ 1 ] < finished[ 3 ] );
+            CPPUNIT_ASSERT( finished[ 2 ] < finished[ 3 ] );
+            for ( size_t i = 3; i + 1 < finished.size(); ++i ) {
+                CPPUNIT_ASSERT( finished[ i ] < finished[ i + 1 ] );
+            }
+            CPPUNIT_ASSERT_EQUAL( finished.size(), size_t( clock ) );
+        }
+
+        // Cleared graphs start over with task 0.
+        graph.clear();
+        CPPUNIT_ASSERT( graph.empty() );
+        size_t ran = 0;
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), graph.add( [ &ran ]() { ++ran; } ) );
+        pool.run( graph );
+        CPPUNIT_ASSERT_EQUAL( size_t( 1 ), ran );
+    }
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testStatisticsCountTasks()
+{
+    ThreadPool pool( 3 );
+    pool.parallelFor( 10, []( size_t, size_t ) {} );
+    pool.resetStatistics();
+
+    pool.parallelFor( 64, []( size_t, size_t ) {}, 1 );
+    pool.parallelFor( 30, []( size_t, size_t ) {}, 10 );
+
+    std::vector< ThreadStatistics > const statistics = pool.statistics();
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), statistics.size() );
+
+    size_t taskCount = 0;
+    for ( size_t i = 0; i < statistics.size(); ++i ) {
+        taskCount += statistics[ i ].taskCount;
+        CPPUNIT_ASSERT( statistics[ i ].stealCount <= statistics[ i ].taskCount );
+        CPPUNIT_ASSERT( statistics[ i ].busySeconds >= 0.0 );
+        CPPUNIT_ASSERT( statistics[ i ].utilization >= 0.0f );
+        CPPUNIT_ASSERT( statistics[ i ].utilization <= 1.0f );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 64 + 3 ), taskCount );
+
+    pool.resetStatistics();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pool.statistics()[ 0 ].taskCount );
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testSubmittersTakeTurns()
+{
+    ThreadPool pool( 3 );
+    std::atomic< size_t > sum( 0 );
+    auto const body = [ &sum ]( size_t begin, size_t end ) { sum += end - begin; };
+
+    // Non-worker threads one after the other, the second one finds the
+    // workers started by the first.
+    std::thread first( [ &pool, &body ]() { pool.parallelFor( 100, body, 1 ); } );
+    first.join();
+    pool.parallelFor( 100, body, 1 );
+    std::thread second( [ &pool, &body ]() { pool.parallelFor( 100, body, 1 ); } );
+    second.join();
+
+    CPPUNIT_ASSERT_EQUAL( size_t( 300 ), size_t( sum ) );
+
+    size_t taskCount = 0;
+    std::vector< ThreadStatistics > const statistics = pool.statistics();
+    for ( size_t i = 0; i < statistics.size(); ++i ) {
+        taskCount += statistics[ i ].taskCount;
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 300 ), taskCount );
+}
+
+
+
+void
+OpenSteer::ThreadPoolTest::testApplySteeringForcesCommitsInOrder()
+{
+    std::vector< TestVehicle > vehicles;
+    AVGroup crowd;
+    makeCrowd( vehicles, crowd );
+
+    ThreadPool pool( 4 );
+    ThreadPool* const pools[] = { 0, &pool };
+    for ( size_t p = 0; p < 2; ++p ) {
+        std::vector< int > integrated( crowd.size(), 0 );
+        std::vector< size_t > committed;
+        size_t integratedBeforeCommit = 0;
+        std::atomic< size_t > wrongVehicles( 0 );
+
+        applySteeringForces( pools[ p ], crowd, [ & ]( AbstractVehicle& vehicle, size_t i ) {
+            if ( &vehicle != crowd[ i ] ) {
+                ++wrongVehicles;
+            }
+            ++integrated[ i ];
+        }, [ & ]( AbstractVehicle& vehicle, size_t i ) {
+            if ( &vehicle != crowd[ i ] ) {
+                ++wrongVehicles;
+            }
+            integratedBeforeCommit += integrated[ i ];
+            committed.push_back( i );
+        } );
+
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), size_t( wrongVehicles ) );
+        CPPUNIT_ASSERT_EQUAL( crowd.size(), committed.size() );
+        CPPUNIT_ASSERT_EQUAL( crowd.size(), integratedBeforeCommit );
+        for ( size_t i = 0; i < crowd.size(); ++i ) {
+            CPPUNIT_ASSERT_EQUAL( 1, integrated[ i ] );
+            CPPUNIT_ASSERT_EQUAL( i, committed[ i ] );
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "Vec3ATest.h"
+
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::Vec3ATest );
+
+
+
+OpenSteer::Vec3ATest::Vec3ATest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Vec3ATest::~Vec3ATest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::Vec3ATest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::Vec3ATest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::Vec3ATest::testLayout()
+{
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 16 ), sizeof( Vec3A ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 16 ), alignof( Vec3A ) );
+
+    Vec3A const arr[ 2 ];
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), reinterpret_cast< size_t >( &arr[ 1 ] ) % 16 );
+}
+
+
+
+void
+OpenSteer::Vec3ATest::testConversion()
+{
+    Vec3 const v( 1.0f, -2.0f, 3.5f );
+    Vec3A const a( v );
+
+    CPPUNIT_ASSERT_EQUAL( 1.0f, a.x );
+    CPPUNIT_ASSERT_EQUAL( -2.0f, a.y );
+    CPPUNIT_ASSERT_EQUAL( 3.5f, a.z );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, a.w );
+    CPPUNIT_ASSERT( v == a.toVec3() );
+
+    Vec3 const back = a;
+    CPPUNIT_ASSERT( v == back );
+}
+
+
+
+void
+OpenSteer::Vec3ATest::testArithmetic()
+{
+    Vec3A const a( 1.0f, 2.0f, 3.0f );
+    Vec3A const b( 4.0f, -5.0f, 6.0f );
+
+    CPPUNIT_ASSERT( Vec3A( 5.0f, -3.0f, 9.0f ) == a + b );
+    CPPUNIT_ASSERT( Vec3A( -3.0f, 7.0f, -3.0f ) == a - b );
+    CPPUNIT_ASSERT( Vec3A( -1.0f, -2.0f, -3.0f ) == -a );
+    CPPUNIT_ASSERT( Vec3A( 2.0f, 4.0f, 6.0f ) == a * 2.0f );
+    CPPUNIT_ASSERT( Vec3A( 2.0f, 4.0f, 6.0f ) == 2.0f * a );
+    CPPUNIT_ASSERT( Vec3A( 0.5f, 1.0f, 1.5f ) == a / 2.0f );
+    CPPUNIT_ASSERT_EQUAL( 12.0f, a.dot( b ) );
+    CPPUNIT_ASSERT( Vec3A( 27.0f, 6.0f, -13.0f ) == crossProduct( a, b ) );
+
+    Vec3A c( a );
+    c += b;
+    c -= a;
+    CPPUNIT_ASSERT( b == c );
+    c *= 2.0f;
+    c /= 4.0f;
+    CPPUNIT_ASSERT( Vec3A( 2.0f, -2.5f, 3.0f ) == c );
+
+    // Division must keep the padding zero.
+    CPPUNIT_ASSERT_EQUAL( 0.0f, ( a / 0.5f ).w );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, crossProduct( a, b ).w );
+}
+
+
+
+void
+OpenSteer::Vec3ATest::testCompareWithVec3()
+{
+    RandomGenerator random( 7 );
+    float const tolerance = 0.0001f;
+
+    for ( int i = 0; i < 1000; ++i ) {
+        Vec3 const v = random.vectorInUnitRadiusSphere() * 10.0f;
+        Vec3 const w = random.vectorInUnitRadiusSphere() * 10.0f;
+        Vec3 const unit = random.unitVector();
+        float const s = random.random2( 0.5f, 5.0f );
+        Vec3A const va( v );
+        Vec3A const wa( w );
+
+        assertEqual( v + w, va + wa, tolerance );
+        assertEqual( v - w, va - wa, tolerance );
+        assertEqual( v * s, va * s, tolerance );
+        assertEqual( v / s, va / s, tolerance );
+        assertEqual( crossProduct( v, w ), crossProduct( va, wa ), tolerance * 10.0f );
+        assertEqual( v.normalize(), va.normalize(), tolerance );
+        assertEqual( v.truncateLength( s ), va.truncateLength( s ), tolerance );
+        assertEqual( v.parallelComponent( unit ), va.parallelComponent( unit ), tolerance );
+        assertEqual( v.perpendicularComponent( unit ), va.perpendicularComponent( unit ), tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( v.dot( w ), va.dot( wa ), tolerance * 10.0f );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( v.length(), va.length(), tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( Vec3::distance( v, w ), Vec3A::distance( va, wa ), tolerance );
+    }
+}
+
+
+
+void
+OpenSteer::Vec3ATest::testNormalizeZero()
+{
+    Vec3A const zero;
+    CPPUNIT_ASSERT( zero == zero.normalize() );
+    CPPUNIT_ASSERT( zero == zero.truncateLength( 1.0f ) );
+}
+
+
+
+void
+OpenSteer::Vec3ATest::assertEqual( Vec3 const& a, Vec3A const& b, float tolerance )
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( a.x, b.x, tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( a.y, b.y, tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( a.z, b.z, tolerance );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, b.w );
+}
@@ -0,0 +1,95 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Vec3A.
+ */
+
+#ifndef OPENSTEER_VEC3ATEST_H
+#define OPENSTEER_VEC3ATEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+// Include OpenSteer::Vec3A
+#include "OpenSteer/Vec3A.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class Vec3ATest : public CppUnit::TestFixture {
+    public:
+        Vec3ATest();
+        virtual ~Vec3ATest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(Vec3ATest);
+        CPPUNIT_TEST(testLayout);
+        CPPUNIT_TEST(testConversion);
+        CPPUNIT_TEST(testArithmetic);
+        CPPUNIT_TEST(testCompareWithVec3);
+        CPPUNIT_TEST(testNormalizeZero);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3ATest( Vec3ATest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3ATest& operator=( Vec3ATest );
+
+    private:
+        void testLayout();
+        void testConversion();
+        void testArithmetic();
+        void testCompareWithVec3();
+        void testNormalizeZero();
+
+        /**
+         * Asserts that @a a and @a b differ by no more than @a tolerance
+         * per coordinate.
+         */
+        static void assertEqual( Vec3 const& a, Vec3A const& b, float tolerance );
+
+    }; // Vec3ATest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_VEC3ATEST_H
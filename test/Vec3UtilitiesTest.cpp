@@ -0,0 +1,280 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ */
+#include "Vec3UtilitiesTest.h"
+
+
+// Include OpenSteer::normalizeVectors, OpenSteer::truncateLengths, ...
+#include "OpenSteer/Vec3Utilities.h"
+
+// Include OpenSteer::RandomGenerator
+#include "OpenSteer/RandomGenerator.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// Register test suite.
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::Vec3UtilitiesTest );
+
+
+
+namespace {
+    
+    size_t const vectorCount = 203;
+    
+    float const tolerance = 0.00001f;
+    
+} // anonymous namespace
+
+
+
+OpenSteer::Vec3UtilitiesTest::Vec3UtilitiesTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Vec3UtilitiesTest::~Vec3UtilitiesTest()
+{
+    // Nothing to do.
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::testNormalizeVectors()
+{
+    std::vector< Vec3 > vectors = randomVectors( 1 );
+    std::vector< float > xs, ys, zs;
+    split( vectors, xs, ys, zs );
+
+    std::vector< Vec3 > expected;
+    for ( size_t i = 0; i < vectors.size(); ++i ) {
+        expected.push_back( vectors[ i ].normalize() );
+    }
+
+    normalizeVectors( &vectors[ 0 ], vectors.size() );
+    normalizeVectors( &xs[ 0 ], &ys[ 0 ], &zs[ 0 ], xs.size() );
+
+    assertEqual( expected, vectors, xs, ys, zs );
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::testTruncateLengths()
+{
+    RandomGenerator random( 2 );
+    std::vector< Vec3 > vectors = randomVectors( 2 );
+    std::vector< float > xs, ys, zs;
+    split( vectors, xs, ys, zs );
+
+    std::vector< float > maxLengths;
+    std::vector< Vec3 > expected;
+    for ( size_t i = 0; i < vectors.size(); ++i ) {
+        maxLengths.push_back( random.random2( 0.0f, 10.0f ) );
+        expected.push_back( vectors[ i ].truncateLength( maxLengths[ i ] ) );
+    }
+
+    truncateLengths( &vectors[ 0 ], &maxLengths[ 0 ], vectors.size() );
+    truncateLengths( &xs[ 0 ], &ys[ 0 ], &zs[ 0 ], &maxLengths[ 0 ], xs.size() );
+
+    assertEqual( expected, vectors, xs, ys, zs );
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::testSetYsToZero()
+{
+    std::vector< Vec3 > vectors = randomVectors( 3 );
+    std::vector< float > xs, ys, zs;
+    split( vectors, xs, ys, zs );
+
+    std::vector< Vec3 > expected;
+    for ( size_t i = 0; i < vectors.size(); ++i ) {
+        expected.push_back( vectors[ i ].setYtoZero() );
+    }
+
+    setYsToZero( &vectors[ 0 ], vectors.size() );
+    setYsToZero( &ys[ 0 ], ys.size() );
+
+    assertEqual( expected, vectors, xs, ys, zs );
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::testLimitMaxDeviationAngles()
+{
+    RandomGenerator random( 4 );
+    std::vector< Vec3 > vectors = randomVectors( 4 );
+    std::vector< Vec3 > bases;
+    for ( size_t i = 0; i < vectors.size(); ++i ) {
+        bases.push_back( random.unitVector() );
+    }
+
+    // Sources parallel and antiparallel to their basis.
+    bases[ 5 ] = vectors[ 5 ].normalize();
+    bases[ 6 ] = -vectors[ 6 ].normalize();
+
+    std::vector< float > basisXs, basisYs, basisZs;
+    split( bases, basisXs, basisYs, basisZs );
+
+    float const cosineOfConeAngles[] = { -0.5f, 0.0f, 0.7f, 1.0f };
+    for ( size_t c = 0; c < sizeof( cosineOfConeAngles ) / sizeof( cosineOfConeAngles[ 0 ] ); ++c ) {
+        float const cosineOfConeAngle = cosineOfConeAngles[ c ];
+
+        std::vector< Vec3 > sources( vectors );
+        std::vector< float > xs, ys, zs;
+        split( sources, xs, ys, zs );
+
+        std::vector< Vec3 > expected;
+        for ( size_t i = 0; i < sources.size(); ++i ) {
+            expected.push_back( limitMaxDeviationAngle( sources[ i ], cosineOfConeAngle, bases[ i ] ) );
+        }
+
+        limitMaxDeviationAngles( &sources[ 0 ], cosineOfConeAngle, &bases[ 0 ], sources.size() );
+        limitMaxDeviationAngles( &xs[ 0 ], &ys[ 0 ], &zs[ 0 ],
+                                 cosineOfConeAngle,
+                                 &basisXs[ 0 ], &basisYs[ 0 ], &basisZs[ 0 ],
+                                 xs.size() );
+
+        assertEqual( expected, sources, xs, ys, zs );
+    }
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::testRandomUnitVectors()
+{
+    RandomGenerator scalarRandom( 5 );
+    std::vector< Vec3 > expected;
+    for ( size_t i = 0; i < vectorCount; ++i ) {
+        expected.push_back( scalarRandom.unitVector() );
+    }
+    std::vector< Vec3 > expectedOnXZPlane;
+    for ( size_t i = 0; i < vectorCount; ++i ) {
+        expectedOnXZPlane.push_back( scalarRandom.unitVectorOnXZPlane() );
+    }
+
+    RandomGenerator random( 5 );
+    std::vector< Vec3 > vectors( vectorCount );
+    random.unitVectors( &vectors[ 0 ], vectors.size() );
+    std::vector< Vec3 > vectorsOnXZPlane( vectorCount );
+    random.unitVectorsOnXZPlane( &vectorsOnXZPlane[ 0 ], vectorsOnXZPlane.size() );
+
+    RandomGenerator soaRandom( 5 );
+    std::vector< float > xs( vectorCount ), ys( vectorCount ), zs( vectorCount );
+    soaRandom.unitVectors( &xs[ 0 ], &ys[ 0 ], &zs[ 0 ], vectorCount );
+    assertEqual( expected, vectors, xs, ys, zs );
+
+    soaRandom.unitVectorsOnXZPlane( &xs[ 0 ], &ys[ 0 ], &zs[ 0 ], vectorCount );
+    assertEqual( expectedOnXZPlane, vectorsOnXZPlane, xs, ys, zs );
+
+    for ( size_t i = 0; i < vectorCount; ++i ) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, vectors[ i ].length(), tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, vectorsOnXZPlane[ i ].length(), tolerance );
+        CPPUNIT_ASSERT_EQUAL( 0.0f, vectorsOnXZPlane[ i ].y );
+    }
+}
+
+
+
+std::vector< OpenSteer::Vec3 >
+OpenSteer::Vec3UtilitiesTest::randomVectors( unsigned long long seed )
+{
+    RandomGenerator random( seed );
+    std::vector< Vec3 > vectors;
+    for ( size_t i = 0; i < vectorCount; ++i ) {
+        vectors.push_back( random.vectorInUnitRadiusSphere() * 10.0f );
+    }
+
+    vectors[ 0 ] = Vec3::zero;
+    vectors[ 7 ] = Vec3::zero;
+    vectors[ vectorCount - 1 ] = Vec3::zero;
+    return vectors;
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::split( std::vector< Vec3 > const& vectors,
+                                     std::vector< float >& xs,
+                                     std::vector< float >& ys,
+                                     std::vector< float >& zs )
+{
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    for ( size_t i = 0; i < vectors.size(); ++i ) {
+        xs.push_back( vectors[ i ].x );
+        ys.push_back( vectors[ i ].y );
+        zs.push_back( vectors[ i ].z );
+    }
+}
+
+
+
+void
+OpenSteer::Vec3UtilitiesTest::assertEqual( std::vector< Vec3 > const& expected,
+                                           std::vector< Vec3 > const& vectors,
+                                           std::vector< float > const& xs,
+                                           std::vector< float > const& ys,
+                                           std::vector< float > const& zs )
+{
+    CPPUNIT_ASSERT_EQUAL( expected.size(), vectors.size() );
+    CPPUNIT_ASSERT_EQUAL( expected.size(), xs.size() );
+
+    for ( size_t i = 0; i < expected.size(); ++i ) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].x, vectors[ i ].x, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].y, vectors[ i ].y, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].z, vectors[ i ].z, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].x, xs[ i ], tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].y, ys[ i ], tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[ i ].z, zs[ i ], tolerance );
+    }
+}
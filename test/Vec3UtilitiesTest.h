@@ -0,0 +1,110 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the array kernels of @c OpenSteer/Vec3Utilities.h.
+ */
+
+#ifndef OPENSTEER_VEC3UTILITIESTEST_H
+#define OPENSTEER_VEC3UTILITIESTEST_H
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class Vec3UtilitiesTest : public CppUnit::TestFixture {
+    public:
+        Vec3UtilitiesTest();
+        virtual ~Vec3UtilitiesTest();
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        CPPUNIT_TEST_SUITE(Vec3UtilitiesTest);
+        CPPUNIT_TEST(testNormalizeVectors);
+        CPPUNIT_TEST(testTruncateLengths);
+        CPPUNIT_TEST(testSetYsToZero);
+        CPPUNIT_TEST(testLimitMaxDeviationAngles);
+        CPPUNIT_TEST(testRandomUnitVectors);
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3UtilitiesTest( Vec3UtilitiesTest const& );
+
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3UtilitiesTest& operator=( Vec3UtilitiesTest );
+
+    private:
+        void testNormalizeVectors();
+        void testTruncateLengths();
+        void testSetYsToZero();
+        void testLimitMaxDeviationAngles();
+        void testRandomUnitVectors();
+
+        /**
+         * Random vectors of lengths up to ten, a count which isn't a
+         * multiple of the kernel widths, some of them zero.
+         */
+        static std::vector< Vec3 > randomVectors( unsigned long long seed );
+
+        static void split( std::vector< Vec3 > const& vectors,
+                           std::vector< float >& xs,
+                           std::vector< float >& ys,
+                           std::vector< float >& zs );
+
+        /**
+         * Asserts that @a vectors equals @a expected and @a xs, @a ys, @a zs
+         * hold the same coordinates.
+         */
+        static void assertEqual( std::vector< Vec3 > const& expected,
+                                 std::vector< Vec3 > const& vectors,
+                                 std::vector< float > const& xs,
+                                 std::vector< float > const& ys,
+                                 std::vector< float > const& zs );
+
+    }; // Vec3UtilitiesTest
+
+
+} // namespace OpenSteer
+
+#endif // OPENSTEER_VEC3UTILITIESTEST_H